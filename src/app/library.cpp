@@ -19,6 +19,8 @@
 #include "../inc/aiff.h"
 #include "../inc/alac.h"
 #include "../inc/mp3.h"
+#include "../inc/sysutils.h"
+#include "../inc/threadpool.h"
 #include "../config.h"
 #include "library.h"
 
@@ -37,8 +39,140 @@ namespace music {
 #define ALBUM_SEARCH_URL WIKIPEDIA_SEARCH_URL
 #define SONG_SEARCH_URL ALLMUSIC_SONG_URL
 
+// Library scanner thread dispatcher
+static void* scannerThreadDispatcher(void *thread) {
+	if (util::assigned(thread)) {
+		return (void *)(long)(static_cast<music::TLibrary*>(thread))->scannerThreadHandler();
+	} else {
+		return (void *)(long)(EXIT_FAILURE);
+	}
+}
+
+
+TLibrarySearchIndex::TLibrarySearchIndex() {
+}
+
+TLibrarySearchIndex::~TLibrarySearchIndex() {
+	clear();
+}
+
+void TLibrarySearchIndex::clear() {
+	albums.clear();
+	trigrams.clear();
+	keys.clear();
+}
+
+void TLibrarySearchIndex::addText(const std::string& text) {
+	if (text.size() >= 3) {
+		const char* p = text.c_str();
+		size_t n = text.size() - 2;
+		for (size_t i=0; i<n; ++i, ++p) {
+			// Search words never contain blanks
+			if (p[0] != ' ' && p[1] != ' ' && p[2] != ' ')
+				keys.push_back(trigram(p));
+		}
+	}
+}
+
+void TLibrarySearchIndex::add(const TAlbum& album) {
+	uint32_t index = (uint32_t)albums.size();
+	albums.push_back(&album);
+
+	// Collect trigrams of all fields checked by TLibrary::filterSearchAlbum()
+	keys.clear();
+	addText(album.artist);
+	addText(album.name);
+	if (!album.songs.empty()) {
+		PSong o = album.songs[0];
+		if (util::assigned(o)) {
+			addText(o->getYear());
+			addText(o->getCodec());
+		}
+		for (size_t i=0; i<album.songs.size(); ++i) {
+			o = album.songs[i];
+			if (util::assigned(o)) {
+				addText(o->getTitle());
+				addText(o->getArtist());
+				addText(o->getOriginalArtist());
+				addText(o->getOriginalAlbumArtist());
+				addText(o->getConductor());
+				addText(o->getComposer());
+			}
+		}
+	}
+
+	// Add album index once for each distinct trigram
+	// --> Postings are ordered by album index
+	if (!keys.empty()) {
+		std::sort(keys.begin(), keys.end());
+		TSearchPostings::const_iterator end = std::unique(keys.begin(), keys.end());
+		TSearchPostings::const_iterator it = keys.begin();
+		while (it != end) {
+			trigrams[*it].push_back(index);
+			++it;
+		}
+	}
+}
+
+bool postingSizeSorterAsc(const TSearchPostings* o, const TSearchPostings* p) {
+	return o->size() < p->size();
+}
+
+size_t TLibrarySearchIndex::find(const util::TStringList& search, TConstAlbumList& result) const {
+	result.clear();
+	if (albums.empty())
+		return 0;
+
+	// Get posting lists for all trigrams of all search words
+	TSearchPostingList postings;
+	for (size_t i=0; i<search.size(); ++i) {
+		const std::string& word = search[i];
+		if (word.size() >= 3) {
+			const char* p = word.c_str();
+			size_t n = word.size() - 2;
+			for (size_t j=0; j<n; ++j, ++p) {
+				TSearchTrigramMap::const_iterator it = trigrams.find(trigram(p));
+				if (it == trigrams.end()) {
+					// Trigram not in any album
+					return 0;
+				}
+				postings.push_back(&it->second);
+			}
+		}
+	}
+
+	// No search word long enough to be indexed
+	// --> all albums are candidates
+	if (postings.empty()) {
+		result = albums;
+		return result.size();
+	}
+
+	// Intersect posting lists starting with shortest list
+	std::sort(postings.begin(), postings.end(), postingSizeSorterAsc);
+	TSearchPostings candidates(*postings[0]);
+	TSearchPostings intersection;
+	for (size_t i=1; i<postings.size() && !candidates.empty(); ++i) {
+		const TSearchPostings& list = *postings[i];
+		if (&list != postings[i-1]) {
+			intersection.clear();
+			std::set_intersection(candidates.begin(), candidates.end(), list.begin(), list.end(), std::back_inserter(intersection));
+			candidates.swap(intersection);
+		}
+	}
+
+	result.reserve(candidates.size());
+	for (size_t i=0; i<candidates.size(); ++i) {
+		result.push_back(albums[candidates[i]]);
+	}
+	return result.size();
+}
+
+
 TLibrary::TLibrary() {
 	onProgressCallback = nil;
+	scannerThreads = 0;
+	binaryDatabase = true;
 	init();
 }
 
@@ -57,6 +191,7 @@ void TLibrary::init() {
 	albumsCount = 0;
 	searchCount = 0;
 	updatedCount = 0;
+	rescanCount = 0;
 	contentSize = 0;
 	duration = 0;
 	artistResult.albums = 0;
@@ -77,6 +212,7 @@ void TLibrary::init() {
 	setSortMode(ELS_DEFAULT);
 	thread.setName("app::TLibrary::unlink()");
 	thread.setExecHandler(&music::TLibrary::unlinkThreadMethod, this);
+	thread.setPriority(app::ETP_LOW);
 }
 
 void TLibrary::setSortMode(const ELibrarySortMode value) {
@@ -95,6 +231,7 @@ void TLibrary::configure(const TLibraryConfig& config) {
 	setDeepNameInspection(config.allowDeepNameInspection);
 	setVariousArtistsRename(config.allowVariousArtistsRename);
 	setMovePreamble(config.allowMovePreamble);
+	setScannerThreads(config.scannerThreads);
 	setSortMode(config.sortCaseSensitive ? music::TLibrary::ELS_CASE_SENSITIVE : music::TLibrary::ELS_CASE_INSENSITIVE);
 }
 
@@ -109,24 +246,21 @@ void TLibrary::configure(const CConfigValues& config) {
 	setSortMode(config.sortCaseSensitive ? music::TLibrary::ELS_CASE_SENSITIVE : music::TLibrary::ELS_CASE_INSENSITIVE);
 }
 
-void importSong(TLibrary& owner, const std::string& fileName, const util::TInodeHandle node, const bool rebuild) {
-	owner.importFile(fileName, node, rebuild);
+void queueSong(TLibrary& owner, const std::string& fileName, const util::TInodeHandle node, const bool rebuild) {
+	owner.queueFile(fileName, node);
 }
 
 int TLibrary::import(const std::string& path, const app::TStringVector& patterns, const bool recursive) {
 	clear();
-	readDirektory(path, patterns, importSong, true, recursive);
+	rescanCount = 0;
+	scan(path, patterns, ESA_IMPORT, true, recursive);
 	updateLibraryMappings();
 	return (int)library.tracks.songs.size();
 }
 
-void checkSong(TLibrary& owner, const std::string& fileName, const util::TInodeHandle node,  const bool rebuild) {
-	owner.updateFile(fileName, node, rebuild);
-}
-
 int TLibrary::rescan(const std::string& path, const app::TStringVector& patterns, const bool rebuild, const bool recursive) {
 	prepare();
-	readDirektory(path, patterns, checkSong, rebuild, recursive);
+	scan(path, patterns, ESA_UPDATE, rebuild, recursive);
 	commit();
 	return (int)library.tracks.songs.size();
 }
@@ -139,7 +273,7 @@ void TLibrary::prepare() {
 }
 
 int TLibrary::update(const std::string& path, const app::TStringVector& patterns, const bool rebuild, const bool recursive) {
-	readDirektory(path, patterns, checkSong, rebuild, recursive);
+	scan(path, patterns, ESA_UPDATE, rebuild, recursive);
 	return (int)library.tracks.songs.size();
 }
 
@@ -229,6 +363,267 @@ bool TLibrary::match(struct dirent *file, const std::string& pattern) {
 	return false;
 }
 
+size_t TLibrary::scan(const std::string& path, const app::TStringVector& patterns, const EScannerAction action, const bool rebuild, const bool recursive) {
+	// Walk directory tree and queue all matching files
+	scanner.clear();
+	scanner.action = action;
+	readDirektory(path, patterns, queueSong, rebuild, recursive);
+	size_t count = scanner.items.size();
+	if (count <= 0) {
+		scanner.clear();
+		return 0;
+	}
+
+	// Start metadata reader threads
+	TScannerThreadList threads;
+	size_t workers = getScannerThreadCount(count);
+	for (size_t i=0; i<workers; ++i) {
+		pthread_t thread = 0;
+		if (app::TThreadUtil::createJoinableThread(thread, scannerThreadDispatcher, this, "Library-Scanner")) {
+			threads.push_back(thread);
+		}
+	}
+	if (debug) std::cout << "TLibrary::scan() Scan " << count << " files in <" << path << "> using " << threads.size() << " reader threads." << std::endl;
+
+	// Commit songs to library in directory order
+	// --> Song order does not depend on thread timing
+	// --> Files not yet taken by a reader thread are read by the calling thread
+	try {
+		for (size_t i=0; i<count; ++i) {
+			TLibraryScanItem& item = scanner.items[i];
+			waitForScanItem(item, action);
+			commitScanItem(item, action, rebuild);
+		}
+	} catch (...) {
+		terminateScanner(threads);
+		throw;
+	}
+	terminateScanner(threads);
+
+	return count;
+}
+
+void TLibrary::terminateScanner(TScannerThreadList& threads) {
+	// Prevent reader threads from taking further items
+	{
+		app::TLockGuard<app::TCondition> lock(scanner.event);
+		scanner.index = scanner.items.size();
+	}
+
+	// Wait for reader threads
+	for (size_t i=0; i<threads.size(); ++i) {
+		int r = app::TThreadUtil::terminateThread(threads[i]);
+		if (util::checkFailed(r)) {
+			if (debug) std::cout << "TLibrary::terminateScanner() Waiting for reader thread failed (" << r << ")" << std::endl;
+		}
+	}
+	threads.clear();
+
+	// Delete songs that were read but not committed
+	for (size_t i=0; i<scanner.items.size(); ++i) {
+		TLibraryScanItem& item = scanner.items[i];
+		if (!item.found) {
+			util::freeAndNil(item.song);
+		}
+	}
+	scanner.clear();
+}
+
+size_t TLibrary::getScannerThreadCount(const size_t files) const {
+	// Configured value includes calling thread
+	// --> Use one thread per processor core by default
+	size_t count = scannerThreads;
+	if (count <= 0) {
+		count = sysutil::getProcessorCount();
+		if (std::string::npos == count)
+			count = 1;
+	}
+	if (count > LIBRARY_SCANNER_MAX_THREADS)
+		count = LIBRARY_SCANNER_MAX_THREADS;
+
+	// Do not start threads for small folders
+	size_t limit = files / LIBRARY_SCANNER_FILES_PER_THREAD;
+	if (count > limit)
+		count = limit;
+
+	return (count > 1) ? count - 1 : 0;
+}
+
+void TLibrary::queueFile(const std::string& fileName, const util::TInodeHandle node) {
+	scanner.items.push_back(TLibraryScanItem(fileName, node));
+}
+
+PLibraryScanItem TLibrary::getNextScanItem() {
+	app::TLockGuard<app::TCondition> lock(scanner.event);
+	while (scanner.index < scanner.items.size()) {
+		PLibraryScanItem item = &scanner.items[scanner.index++];
+		if (ESS_QUEUED == item->state) {
+			item->state = ESS_READING;
+			return item;
+		}
+	}
+	return nil;
+}
+
+int TLibrary::scannerThreadHandler() {
+	PLibraryScanItem item;
+	while (util::assigned(item = getNextScanItem())) {
+		readScanItem(*item, scanner.action);
+		app::TLockGuard<app::TCondition> lock(scanner.event);
+		item->state = ESS_READY;
+		scanner.event.signal();
+	}
+	return EXIT_SUCCESS;
+}
+
+void TLibrary::waitForScanItem(TLibraryScanItem& item, const EScannerAction action) {
+	bool owner = false;
+	{
+		app::TLockGuard<app::TCondition> lock(scanner.event);
+		if (ESS_QUEUED == item.state) {
+			item.state = ESS_READING;
+			owner = true;
+		} else {
+			while (ESS_READY != item.state) {
+				scanner.event.wait();
+			}
+		}
+	}
+	if (owner) {
+		readScanItem(item, action);
+		app::TLockGuard<app::TCondition> lock(scanner.event);
+		item.state = ESS_READY;
+	}
+}
+
+void TLibrary::readScanItem(TLibraryScanItem& item, const EScannerAction action) {
+	// Called by reader threads:
+	// --> Do NOT change library content or counters here
+	// --> Song lookup is protected against concurrent inserts by committing thread
+	try {
+		if (ESA_UPDATE == action) {
+			TAudioFile file(item.file, item.tag);
+			app::TLockGuard<app::TCondition> lock(scanner.event);
+			PSong p = findFile(item.tag.file.hash);
+			if (util::assigned(p)) {
+				// Song is in list, check if timestamp or size has been changed
+				item.song = p;
+				item.found = true;
+				item.changed = (item.tag.file.time != p->getFileTime() || item.tag.file.size != p->getFileSize());
+				return;
+			}
+		}
+
+		// Read metadata tags for new song
+		PSong o = newSong(item.file);
+		if (util::assigned(o)) {
+			item.song = o;
+			if (ESA_UPDATE == action)
+				o->setFileProperties(item.tag);
+			else
+				o->setFileProperties(item.file);
+			item.result = o->readMetadataTags(allowArtistNameRestore, allowFullNameSwap, allowGroupNameSwap,
+								allowTheBandPrefixSwap, allowVariousArtistsRename, allowMovePreamble);
+			if (EXIT_SUCCESS == item.result) {
+				o->updateProperties();
+			}
+		} else {
+			item.result = -999;
+		}
+	} catch (const std::exception& e) {
+		if (debug) std::cout << "TLibrary::readScanItem() Exception for <" << item.file << "> : " << e.what() << std::endl;
+		item.result = -10;
+	} catch (...) {
+		if (debug) std::cout << "TLibrary::readScanItem() Unknown exception for <" << item.file << ">" << std::endl;
+		item.result = -10;
+	}
+}
+
+PSong TLibrary::commitScanItem(TLibraryScanItem& item, const EScannerAction action, const bool rebuild) {
+	PSong p = nil;
+
+	// File may have been added by previous item of current scan (e.g. nested music folders)
+	if (!item.found && ESA_UPDATE == action) {
+		p = findFile(item.tag.file.hash);
+		if (util::assigned(p)) {
+			util::freeAndNil(item.song);
+			item.song = p;
+			item.found = true;
+			item.changed = false;
+		}
+	}
+
+	if (item.found) {
+		// Song is in list
+		p = item.song;
+		p->setLoaded(true);
+
+		// Check if timestamp or size has been changed
+		if (item.changed) {
+
+			// Update song in list
+			p->setLoaded(false);
+			if (debug) std::cout << "TLibrary::updateFile() Song \"" << p->getFileName() << "\" was changed." << std::endl;
+
+			// Update existing song object
+			int r = updateSong(p);
+			if (EXIT_SUCCESS == r) {
+				p->tags.file = item.tag.file;
+				p->setLoaded(true);
+				p->setInsertedTime(util::now());
+				++updatedCount;
+				if (debug) std::cout << "TLibrary::updateFile() Song \"" << p->getFileName() << "\" is updated." << std::endl;
+			} else {
+				if (debug) std::cout << "TLibrary::updateFile() Song \"" << p->getFileName() << "\" failed (" << r << ")" << std::endl;
+			}
+		}
+
+	} else {
+		// File not yet in list
+		// --> Add new song to list if tags are valid
+		PSong o = item.song;
+		item.song = nil;
+		if (util::assigned(o)) {
+			if (EXIT_SUCCESS == item.result) {
+				app::TLockGuard<app::TCondition> lock(scanner.event);
+				addSong(o);
+				p = o;
+			} else {
+				std::cout << "TLibrary::addSong() Invalid song <" << item.file << "> (" << item.result << ")" << std::endl;
+				addError(item.file, item.result, o->getError());
+				util::freeAndNil(o);
+			}
+		} else {
+			std::cout << "TPlaylist::addSong() Unknown song type <" << item.file << ">" << std::endl;
+			addError(item.file, -999, util::fileExtName(item.file));
+		}
+
+		if (util::assigned(p)) {
+			p->setLoaded(true);
+			if (ESA_UPDATE == action) {
+				p->setInsertedTime(rebuild ? p->getFileTime() : util::now());
+				++updatedCount;
+				if (debug) std::cout << "TLibrary::updateFile() Song \"" << p->getFileName() << "\" added (" << library.tracks.songs.size() << ")" << std::endl;
+			} else {
+				p->setInsertedTime(p->getFileTime());
+			}
+		}
+	}
+
+	// Set folder inode as location identifier
+	if (util::assigned(p)) {
+		p->setNode(item.node);
+	}
+
+	// Event callback for (re)scanned files
+	++rescanCount;
+	if (0 == rescanCount % 333) {
+		onScannerCallback(rescanCount, item.file);
+	}
+
+	return p;
+}
+
 PSong TLibrary::newSong(const std::string& fileName) {
 	ECodecType type = TSong::getFileType(fileName);
 	return newSong(type);
@@ -469,69 +864,15 @@ void TLibrary::reindex() {
 
 
 PSong TLibrary::updateFile(const std::string& fileName, const util::TInodeHandle node, const bool rebuild) {
-	TFileTag tag;
-	TAudioFile file(fileName, tag);
-	PSong p = findFile(tag.file.hash);
-	if (util::assigned(p)) {
-		// Song is in list
-		p->setLoaded(true);
-
-		// Check if timestamp or size has been changed
-		if (tag.file.time != p->getFileTime() ||
-			tag.file.size != p->getFileSize()) {
-
-			// Update song in list
-			p->setLoaded(false);
-			if (debug) std::cout << "TLibrary::updateFile() Song \"" << p->getFileName() << "\" was changed." << std::endl;
-
-			// Update existing song object
-			int r = updateSong(p);
-			if (EXIT_SUCCESS == r) {
-				p->tags.file = tag.file;
-				p->setLoaded(true);
-				p->setInsertedTime(util::now());
-				++updatedCount;
-				if (debug) std::cout << "TLibrary::updateFile() Song \"" << p->getFileName() << "\" is updated." << std::endl;
-			} else {
-				if (debug) std::cout << "TLibrary::updateFile() Song \"" << p->getFileName() << "\" failed (" << r << ")" << std::endl;
-			}
-		}
-
-	} else {
-		// File not yet in list
-		// --> Add new song to list!
-		p = addFile(fileName, tag);
-		if (util::assigned(p)) {
-			p->setLoaded(true);
-			p->setInsertedTime(rebuild ? p->getFileTime() : util::now());
-			++updatedCount;
-			if (debug) std::cout << "TLibrary::updateFile() Song \"" << p->getFileName() << "\" added (" << library.tracks.songs.size() << ")" << std::endl;
-		}
-
-	}
-
-	// Set folder inode as location identifier
-	if (util::assigned(p)) {
-		p->setNode(node);
-	}
-
-	// Event callback for (re)scanned files
-	++rescanCount;
-	if (0 == rescanCount % 333) {
-		onScannerCallback(rescanCount, p->getFileName());
-	}
-
-	return p;
+	TLibraryScanItem item(fileName, node);
+	readScanItem(item, ESA_UPDATE);
+	return commitScanItem(item, ESA_UPDATE, rebuild);
 }
 
 PSong TLibrary::importFile(const std::string& fileName, const util::TInodeHandle node, const bool rebuild) {
-	PSong p = addFile(fileName);
-	if (util::assigned(p)) {
-		p->setLoaded(true);
-		p->setNode(node);
-		p->setInsertedTime(p->getFileTime());
-	}
-	return p;
+	TLibraryScanItem item(fileName, node);
+	readScanItem(item, ESA_IMPORT);
+	return commitScanItem(item, ESA_IMPORT, rebuild);
 }
 
 void TLibrary::clear() {
@@ -555,7 +896,6 @@ void TLibrary::clear() {
 	clearLibraryMappings();
 	library.tracks.files.clear();
 	util::clearObjectList(library.tracks.songs);
-	util::clearObjectList(library.recent);
 	garbageCollector();
 	updatedCount = 0;
 	rescanCount = 0;
@@ -1035,19 +1375,21 @@ size_t TLibrary::deleteInvalidatedSongs() {
 }
 
 bool TLibrary::hasLibraryMappings() {
-	return library.artists.all.size() > 0 ||
+	return library.artists.table.size() > 0 ||
 			library.albums.size() > 0 ||
 			library.ordered.size() > 0;
 }
 
 void TLibrary::clearLibraryMappings() {
-	clearArtistMap(library.artists.all);
-	clearArtistMap(library.artists.cd);
-	clearArtistMap(library.artists.hdcd);
-	clearArtistMap(library.artists.dsd);
-	clearArtistMap(library.artists.dvd);
-	clearArtistMap(library.artists.bd);
-	clearArtistMap(library.artists.hr);
+	clearArtistMap(library.artists.table);
+
+	library.artists.all.clear();
+	library.artists.cd.clear();
+	library.artists.hdcd.clear();
+	library.artists.dsd.clear();
+	library.artists.dvd.clear();
+	library.artists.bd.clear();
+	library.artists.hr.clear();
 
 	library.letters.all.clear();
 	library.letters.cd.clear();
@@ -1057,8 +1399,11 @@ void TLibrary::clearLibraryMappings() {
 	library.letters.bd.clear();
 	library.letters.hr.clear();
 
-	library.albums.clear();
+	// Views must be cleared before album table
+	searchIndex.clear();
+	library.recent.clear();
 	library.ordered.clear();
+	library.albums.clear();
 }
 
 void TLibrary::saveLibraryMappings() {
@@ -1093,298 +1438,105 @@ void TLibrary::updateLibraryMappings() {
 	dsdCount = 0;
 
 	// Iterate through all songs
+	// --> Album and artist strings are stored once in the album and artist tables
+	// --> All other lists refer to the table entries
 	std::string c_album, c_sort;
-	music::EMediaType media = EMT_UNKNOWN;
-	util::TTimePart inserted = util::epoch();
-	util::TTimePart date = util::epoch();
-	bool compilation = false;
+	PAlbum album = nil;
+	TArtist* artist = nil;
 	PSong o;
 	for (size_t i=0; i<library.tracks.songs.size(); ++i) {
 		o = library.tracks.songs[i];
 		if (util::assigned(o)) {
 			duration += o->getDuration();
 			contentSize += o->getFileSize();
-			const std::string& artist = o->getAlbumArtist();
-			const std::string& displayartist = o->getDisplayAlbumArtist();
-
-			const std::string& originalartist = o->getOriginalAlbumArtist();
-			const std::string& displayoriginalartist = o->getDisplayOriginalAlbumArtist();
-
-			const std::string& album = o->getAlbum();
-			const std::string& displayalbum = o->getDisplayAlbum();
-
-			const std::string& genre = o->getGenre();
-			const std::string& displaygenre = o->getDisplayGenre();
-
 			const std::string& sortartist = o->getAlbumArtist();
-			const std::string& ordered = o->getAlbumSort();
 			const std::string& albumHash = o->getAlbumHash();
-			const std::string& artistHash = o->getAlbumArtistHash();
-			const std::string& url = o->getURL();
 
-			if (debug) std::cout << "TLibrary::updateLibraryMappings() Add album \"" << album << "\"/\"" << displayalbum << "\"" << std::endl;
+			if (debug) std::cout << "TLibrary::updateLibraryMappings() Add album \"" << o->getAlbum() << "\"/\"" << o->getDisplayAlbum() << "\"" << std::endl;
 
-			if (c_sort != sortartist) {
+			if (c_sort != sortartist || !util::assigned(artist)) {
 				c_sort = sortartist;
-				library.artists.all[sortartist].name = artist;
-				library.artists.all[sortartist].originalname = originalartist;
-				library.artists.all[sortartist].displayname = displayartist;
-				library.artists.all[sortartist].displayoriginalname = displayoriginalartist;
-				library.artists.all[sortartist].hash = artistHash;
-				library.artists.all[sortartist].url = url;
-
-				// ATTENTION: Artist change is detected once only:
-				// --> Add artist to all list and do cleanup later
-				// --> remove artists with no albums from maps afterwards
-				library.artists.cd[sortartist].name = artist;
-				library.artists.cd[sortartist].originalname = originalartist;
-				library.artists.cd[sortartist].displayname = displayartist;
-				library.artists.cd[sortartist].displayoriginalname = displayoriginalartist;
-				library.artists.cd[sortartist].hash = artistHash;
-				library.artists.cd[sortartist].url = url;
-
-				library.artists.hdcd[sortartist].name = artist;
-				library.artists.hdcd[sortartist].originalname = originalartist;
-				library.artists.hdcd[sortartist].displayname = displayartist;
-				library.artists.hdcd[sortartist].displayoriginalname = displayoriginalartist;
-				library.artists.hdcd[sortartist].hash = artistHash;
-				library.artists.hdcd[sortartist].url = url;
-
-				library.artists.dsd[sortartist].name = artist;
-				library.artists.dsd[sortartist].originalname = originalartist;
-				library.artists.dsd[sortartist].displayname = displayartist;
-				library.artists.dsd[sortartist].displayoriginalname = displayoriginalartist;
-				library.artists.dsd[sortartist].hash = artistHash;
-				library.artists.dsd[sortartist].url = url;
-
-				library.artists.dvd[sortartist].name = artist;
-				library.artists.dvd[sortartist].originalname = originalartist;
-				library.artists.dvd[sortartist].displayname = displayartist;
-				library.artists.dvd[sortartist].displayoriginalname = displayoriginalartist;
-				library.artists.dvd[sortartist].hash = artistHash;
-				library.artists.dvd[sortartist].url = url;
-
-				library.artists.bd[sortartist].name = artist;
-				library.artists.bd[sortartist].originalname = originalartist;
-				library.artists.bd[sortartist].displayname = displayartist;
-				library.artists.bd[sortartist].displayoriginalname = displayoriginalartist;
-				library.artists.bd[sortartist].hash = artistHash;
-				library.artists.bd[sortartist].url = url;
-
-				library.artists.hr[sortartist].name = artist;
-				library.artists.hr[sortartist].originalname = originalartist;
-				library.artists.hr[sortartist].displayname = displayartist;
-				library.artists.hr[sortartist].displayoriginalname = displayoriginalartist;
-				library.artists.hr[sortartist].hash = artistHash;
-				library.artists.hr[sortartist].url = url;
-			}
-			if (c_album != album) {
-				c_album = album;
-
-				// Compilation flag and media type is fixed for one album!
-				media = o->getMediaType();
-				date = o->getFileTime();
-				inserted = o->getInsertedTime();
-				compilation = o->getCompilation();
-
-				// For one artist the album should be unique!!!
-				// --> use ordered map here...
-				library.artists.all[sortartist].albums[album].name = album;
-				library.artists.all[sortartist].albums[album].artist = artist;
-				library.artists.all[sortartist].albums[album].originalartist = originalartist;
-				library.artists.all[sortartist].albums[album].genre = genre;
-				library.artists.all[sortartist].albums[album].displayname = displayalbum;
-				library.artists.all[sortartist].albums[album].displayartist = displayartist;
-				library.artists.all[sortartist].albums[album].displayoriginalartist = displayoriginalartist;
-				library.artists.all[sortartist].albums[album].displaygenre = displaygenre;
-				library.artists.all[sortartist].albums[album].hash = albumHash;
-				library.artists.all[sortartist].albums[album].url = url;
-				library.artists.all[sortartist].albums[album].compilation = compilation;
-				library.artists.all[sortartist].albums[album].inserted = inserted;
-				library.artists.all[sortartist].albums[album].date = date;
-
-				switch (media) {
-					case EMT_CD:
-						if (debug) std::cout << "TLibrary::updateLibraryMappings() CD: Add album \"" << artist << "\"/\"" << album << "\"" << std::endl;
-						library.artists.cd[sortartist].albums[album].name = album;
-						library.artists.cd[sortartist].albums[album].artist = artist;
-						library.artists.cd[sortartist].albums[album].originalartist = originalartist;
-						library.artists.cd[sortartist].albums[album].genre = genre;
-						library.artists.cd[sortartist].albums[album].displayname = displayalbum;
-						library.artists.cd[sortartist].albums[album].displayartist = displayartist;
-						library.artists.cd[sortartist].albums[album].displayoriginalartist = displayoriginalartist;
-						library.artists.cd[sortartist].albums[album].displaygenre = displaygenre;
-						library.artists.cd[sortartist].albums[album].hash = albumHash;
-						library.artists.cd[sortartist].albums[album].url = url;
-						library.artists.cd[sortartist].albums[album].compilation = compilation;
-						library.artists.cd[sortartist].albums[album].inserted = inserted;
-						library.artists.cd[sortartist].albums[album].date = date;
-						++cdCount;
-						break;
-					case EMT_HDCD:
-						if (debug) std::cout << "TLibrary::updateLibraryMappings() HDCD: Add album \"" << artist << "\"/\"" << album << "\"" << std::endl;
-						library.artists.hdcd[sortartist].albums[album].name = album;
-						library.artists.hdcd[sortartist].albums[album].artist = artist;
-						library.artists.hdcd[sortartist].albums[album].originalartist = originalartist;
-						library.artists.hdcd[sortartist].albums[album].genre = genre;
-						library.artists.hdcd[sortartist].albums[album].displayname = displayalbum;
-						library.artists.hdcd[sortartist].albums[album].displayartist = displayartist;
-						library.artists.hdcd[sortartist].albums[album].displayoriginalartist = displayoriginalartist;
-						library.artists.hdcd[sortartist].albums[album].displaygenre = displaygenre;
-						library.artists.hdcd[sortartist].albums[album].hash = albumHash;
-						library.artists.hdcd[sortartist].albums[album].url = url;
-						library.artists.hdcd[sortartist].albums[album].compilation = compilation;
-						library.artists.hdcd[sortartist].albums[album].inserted = inserted;
-						library.artists.hdcd[sortartist].albums[album].date = date;
-						++hdcdCount;
-						break;
-					case EMT_DSD:
-						if (debug) std::cout << "TLibrary::updateLibraryMappings() DSD: Add album \"" << artist << "\"/\"" << album << "\"" << std::endl;
-						library.artists.dsd[sortartist].albums[album].name = album;
-						library.artists.dsd[sortartist].albums[album].artist = artist;
-						library.artists.dsd[sortartist].albums[album].originalartist = originalartist;
-						library.artists.dsd[sortartist].albums[album].genre = genre;
-						library.artists.dsd[sortartist].albums[album].displayname = displayalbum;
-						library.artists.dsd[sortartist].albums[album].displayartist = displayartist;
-						library.artists.dsd[sortartist].albums[album].displayoriginalartist = displayoriginalartist;
-						library.artists.dsd[sortartist].albums[album].displaygenre = displaygenre;
-						library.artists.dsd[sortartist].albums[album].hash = albumHash;
-						library.artists.dsd[sortartist].albums[album].url = url;
-						library.artists.dsd[sortartist].albums[album].compilation = compilation;
-						library.artists.dsd[sortartist].albums[album].inserted = inserted;
-						library.artists.dsd[sortartist].albums[album].date = date;
-						++dsdCount;
-						break;
-					case EMT_DVD:
-						if (debug) std::cout << "TLibrary::updateLibraryMappings() DVD: Add album \"" << artist << "\"/\"" << album << "\"" << std::endl;
-						library.artists.dvd[sortartist].albums[album].name = album;
-						library.artists.dvd[sortartist].albums[album].artist = artist;
-						library.artists.dvd[sortartist].albums[album].originalartist = originalartist;
-						library.artists.dvd[sortartist].albums[album].genre = genre;
-						library.artists.dvd[sortartist].albums[album].displayname = displayalbum;
-						library.artists.dvd[sortartist].albums[album].displayartist = displayartist;
-						library.artists.dvd[sortartist].albums[album].displayoriginalartist = displayoriginalartist;
-						library.artists.dvd[sortartist].albums[album].displaygenre = displaygenre;
-						library.artists.dvd[sortartist].albums[album].hash = albumHash;
-						library.artists.dvd[sortartist].albums[album].url = url;
-						library.artists.dvd[sortartist].albums[album].compilation = compilation;
-						library.artists.dvd[sortartist].albums[album].inserted = inserted;
-						library.artists.dvd[sortartist].albums[album].date = date;
-						++dvdCount;
-						break;
-					case EMT_BD:
-						if (debug) std::cout << "TLibrary::updateLibraryMappings() BD: Add album \"" << artist << "\"/\"" << album << "\"" << std::endl;
-						library.artists.bd[sortartist].albums[album].name = album;
-						library.artists.bd[sortartist].albums[album].artist = artist;
-						library.artists.bd[sortartist].albums[album].originalartist = originalartist;
-						library.artists.bd[sortartist].albums[album].genre = genre;
-						library.artists.bd[sortartist].albums[album].displayname = displayalbum;
-						library.artists.bd[sortartist].albums[album].displayartist = displayartist;
-						library.artists.bd[sortartist].albums[album].displayoriginalartist = displayoriginalartist;
-						library.artists.bd[sortartist].albums[album].displaygenre = displaygenre;
-						library.artists.bd[sortartist].albums[album].hash = albumHash;
-						library.artists.bd[sortartist].albums[album].url = url;
-						library.artists.bd[sortartist].albums[album].compilation = compilation;
-						library.artists.bd[sortartist].albums[album].inserted = inserted;
-						library.artists.bd[sortartist].albums[album].date = date;
-						++bdCount;
-						break;
-					case EMT_HR:
-						if (debug) std::cout << "TLibrary::updateLibraryMappings() HR: Add album \"" << artist << "\"/\"" << album << "\"" << std::endl;
-						library.artists.hr[sortartist].albums[album].name = album;
-						library.artists.hr[sortartist].albums[album].artist = artist;
-						library.artists.hr[sortartist].albums[album].originalartist = originalartist;
-						library.artists.hr[sortartist].albums[album].genre = genre;
-						library.artists.hr[sortartist].albums[album].displayname = displayalbum;
-						library.artists.hr[sortartist].albums[album].displayartist = displayartist;
-						library.artists.hr[sortartist].albums[album].displayoriginalartist = displayoriginalartist;
-						library.artists.hr[sortartist].albums[album].displaygenre = displaygenre;
-						library.artists.hr[sortartist].albums[album].hash = albumHash;
-						library.artists.hr[sortartist].albums[album].url = url;
-						library.artists.hr[sortartist].albums[album].compilation = compilation;
-						library.artists.hr[sortartist].albums[album].inserted = inserted;
-						library.artists.hr[sortartist].albums[album].date = date;
-						++hrCount;
-						break;
-					default:
-						break;
+				c_album.clear();
+
+				artist = &library.artists.table[sortartist];
+				if (artist->hash.empty()) {
+					artist->name = o->getAlbumArtist();
+					artist->originalname = o->getOriginalAlbumArtist();
+					artist->displayname = o->getDisplayAlbumArtist();
+					artist->displayoriginalname = o->getDisplayOriginalAlbumArtist();
+					artist->hash = o->getAlbumArtistHash();
+					artist->url = o->getURL();
 				}
+			}
 
-				library.albums[albumHash].name = album;
-				library.albums[albumHash].artist = artist;
-				library.albums[albumHash].originalartist = originalartist;
-				library.albums[albumHash].genre = genre;
-				library.albums[albumHash].displayname = displayalbum;
-				library.albums[albumHash].displayartist = displayartist;
-				library.albums[albumHash].displayoriginalartist = displayoriginalartist;
-				library.albums[albumHash].displaygenre = displaygenre;
-				library.albums[albumHash].hash = albumHash;
-				library.albums[albumHash].url = url;
-				library.albums[albumHash].compilation = compilation;
-				library.albums[albumHash].inserted = inserted;
-				library.albums[albumHash].date = date;
-
-				library.ordered[ordered].name = album;
-				library.ordered[ordered].artist = artist;
-				library.ordered[ordered].originalartist = originalartist;
-				library.ordered[ordered].genre = genre;
-				library.ordered[ordered].displayname = displayalbum;
-				library.ordered[ordered].displayartist = displayartist;
-				library.ordered[ordered].displayoriginalartist = displayoriginalartist;
-				library.ordered[ordered].displaygenre = displaygenre;
-				library.ordered[ordered].hash = albumHash;
-				library.ordered[ordered].url = url;
-				library.ordered[ordered].compilation = compilation;
-				library.ordered[ordered].inserted = inserted;
-				library.ordered[ordered].date = date;
-
-			}
-
-			// Build artist/media lists
-			library.artists.all[sortartist].albums[album].songs.push_back(o);
-
-			switch (media) {
-				case EMT_CD:
-					if (debug) std::cout << "TLibrary::updateLibraryMappings() CD: Add song \"" << artist << "\"/\"" << album << "\"/\"" << o->getTitle() << "\"" << std::endl;
-					library.artists.cd[sortartist].albums[album].songs.push_back(o);
-					break;
-				case EMT_HDCD:
-					if (debug) std::cout << "TLibrary::updateLibraryMappings() HDCD: Add song \"" << artist << "\"/\"" << album << "\"/\"" << o->getTitle() << "\"" << std::endl;
-					library.artists.hdcd[sortartist].albums[album].songs.push_back(o);
-					break;
-				case EMT_DSD:
-					if (debug) std::cout << "TLibrary::updateLibraryMappings() DSD: Add song \"" << artist << "\"/\"" << album << "\"/\"" << o->getTitle() << "\"" << std::endl;
-					library.artists.dsd[sortartist].albums[album].songs.push_back(o);
-					break;
-				case EMT_DVD:
-					if (debug) std::cout << "TLibrary::updateLibraryMappings() DVD: Add song \"" << artist << "\"/\"" << album << "\"/\"" << o->getTitle() << "\"" << std::endl;
-					library.artists.dvd[sortartist].albums[album].songs.push_back(o);
-					break;
-				case EMT_BD:
-					if (debug) std::cout << "TLibrary::updateLibraryMappings() BD: Add song \"" << artist << "\"/\"" << album << "\"/\"" << o->getTitle() << "\"" << std::endl;
-					library.artists.bd[sortartist].albums[album].songs.push_back(o);
-					break;
-				case EMT_HR:
-					if (debug) std::cout << "TLibrary::updateLibraryMappings() HR: Add song \"" << artist << "\"/\"" << album << "\"/\"" << o->getTitle() << "\"" << std::endl;
-					library.artists.hr[sortartist].albums[album].songs.push_back(o);
-					break;
-				default:
-					break;
+			if (c_album != albumHash || !util::assigned(album)) {
+				c_album = albumHash;
+
+				// Album entry is unique by album hash
+				album = &library.albums[albumHash];
+				if (album->hash.empty()) {
+
+					// Compilation flag and media type is fixed for one album!
+					album->name = o->getAlbum();
+					album->artist = o->getAlbumArtist();
+					album->originalartist = o->getOriginalAlbumArtist();
+					album->genre = o->getGenre();
+					album->displayname = o->getDisplayAlbum();
+					album->displayartist = o->getDisplayAlbumArtist();
+					album->displayoriginalartist = o->getDisplayOriginalAlbumArtist();
+					album->displaygenre = o->getDisplayGenre();
+					album->hash = albumHash;
+					album->url = o->getURL();
+					album->compilation = o->getCompilation();
+					album->media = o->getMediaType();
+					album->inserted = o->getInsertedTime();
+					album->date = o->getFileTime();
+
+					switch (album->media) {
+						case EMT_CD:
+							++cdCount;
+							break;
+						case EMT_HDCD:
+							++hdcdCount;
+							break;
+						case EMT_DSD:
+							++dsdCount;
+							break;
+						case EMT_DVD:
+							++dvdCount;
+							break;
+						case EMT_BD:
+							++bdCount;
+							break;
+						case EMT_HR:
+							++hrCount;
+							break;
+						default:
+							break;
+					}
+
+					// Add album views to artist and ordered album list
+					// --> For one artist the album should be unique!!!
+					artist->albums.insert(TAlbumItem(album->name, album));
+					artist->media |= (1 << album->media);
+
+					// Albums differing in case only have the same case insensitive sort key
+					// --> Fall back to exact name to keep both albums in ordered list
+					if (!library.ordered.insert(TAlbumItem(o->getAlbumSort(), album)).second)
+						library.ordered.insert(TAlbumItem(o->getAlbumSort() + "\t" + o->getAlbumSortName(), album));
+				}
 			}
 
-			library.albums[albumHash].songs.push_back(o);
-			library.ordered[ordered].songs.push_back(o);
+			if (debug) std::cout << "TLibrary::updateLibraryMappings() " << getMediaName(album->media) << ": Add song \"" << album->artist << "\"/\"" << album->name << "\"/\"" << o->getTitle() << "\"" << std::endl;
+			album->songs.push_back(o);
 		}
 	}
 
 	// Remove artists without album entries
-	cleanArtistMap(library.artists.all);
-	cleanArtistMap(library.artists.cd);
-	cleanArtistMap(library.artists.hdcd);
-	cleanArtistMap(library.artists.dsd);
-	cleanArtistMap(library.artists.dvd);
-	cleanArtistMap(library.artists.bd);
-	cleanArtistMap(library.artists.hr);
+	cleanArtistMap(library.artists.table);
+
+	// Create media type views for artist table
+	createArtistLists();
 
 	// Create letter lookup lists for artists
 	createLetterMap(library.artists.all,  library.letters.all);
@@ -1398,6 +1550,7 @@ void TLibrary::updateLibraryMappings() {
 	// Update tracks count on real album song data
 	updateTracksCount();
 	updateRecentAlbums();
+	updateSearchIndex();
 
 	// Save mappings to file...
 	if (debug) {
@@ -1491,11 +1644,6 @@ void TLibrary::clearArtistMap(TArtistMap& artists) {
 	if (!artists.empty()) {
 		TArtistMap::iterator artist = artists.begin();
 		while (artist != artists.end()) {
-			TAlbumMap::iterator album = artist->second.albums.begin();
-			while (album != artist->second.albums.end()) {
-				album->second.songs.clear();
-				++album;
-			}
 			artist->second.albums.clear();
 			++artist;
 		}
@@ -1516,40 +1664,106 @@ void TLibrary::cleanArtistMap(TArtistMap& artists) {
 	}
 }
 
-void TLibrary::createLetterMap(TArtistMap& artists, TLetterMap& letters) {
+void TLibrary::createArtistLists() {
+	if (!library.artists.table.empty()) {
+		TArtistMap::const_iterator it = library.artists.table.begin();
+		while (it != library.artists.table.end()) {
+			const TArtist& artist = it->second;
+			library.artists.all.push_back(&artist);
+			if (artist.hasMedia(EMT_CD))
+				library.artists.cd.push_back(&artist);
+			if (artist.hasMedia(EMT_HDCD))
+				library.artists.hdcd.push_back(&artist);
+			if (artist.hasMedia(EMT_DSD))
+				library.artists.dsd.push_back(&artist);
+			if (artist.hasMedia(EMT_DVD))
+				library.artists.dvd.push_back(&artist);
+			if (artist.hasMedia(EMT_BD))
+				library.artists.bd.push_back(&artist);
+			if (artist.hasMedia(EMT_HR))
+				library.artists.hr.push_back(&artist);
+			++it;
+		}
+	}
+}
+
+const TConstArtistList& TLibrary::getArtistList(const EMediaType type) const {
+	switch (type) {
+		case EMT_CD:
+			return library.artists.cd;
+		case EMT_HDCD:
+			return library.artists.hdcd;
+		case EMT_DSD:
+			return library.artists.dsd;
+		case EMT_DVD:
+			return library.artists.dvd;
+		case EMT_BD:
+			return library.artists.bd;
+		case EMT_HR:
+			return library.artists.hr;
+		default:
+			break;
+	}
+	return library.artists.all;
+}
+
+size_t TLibrary::getArtistAlbums(const TArtist& artist, const EMediaType type, TConstAlbumList& albums) const {
+	albums.clear();
+	bool all = true;
+	switch (type) {
+		case EMT_CD:
+		case EMT_HDCD:
+		case EMT_DSD:
+		case EMT_DVD:
+		case EMT_BD:
+		case EMT_HR:
+			all = false;
+			break;
+		default:
+			break;
+	}
+	TAlbumMap::const_iterator album = artist.albums.begin();
+	while (album != artist.albums.end()) {
+		const TAlbum* o = album->second;
+		if (util::assigned(o)) {
+			if (all || o->media == type)
+				albums.push_back(o);
+		}
+		++album;
+	}
+	return albums.size();
+}
+
+void TLibrary::createLetterMap(const TConstArtistList& artists, TLetterMap& letters) {
 	if (!artists.empty()) {
 		size_t count = 0;
-		std::string name;
-		TArtistMap::const_iterator artist;
 		for (char c = 'A'; c <= 'Z'; ++c) {
-			artist = artists.begin();
-			while (artist != artists.end()) {
+			for (size_t i=0; i<artists.size(); ++i) {
 				// Do not add compilations to letter list
-				name = artist->second.name;
-				if (filterArtistName(name, c)) {
+				const TArtist* artist = artists[i];
+				if (filterArtistName(artist->name, c)) {
 					letters[c] = ++count;
 				}
-				++artist;
 			}
 		}
 	}
 }
 
-void TLibrary::saveArtistMap(const TArtistMap& artists, const std::string& fileName) {
+void TLibrary::saveArtistMap(const TConstArtistList& artists, const std::string& fileName) {
 	util::deleteFile(fileName);
 	util::TStringList list;
-	TArtistMap::const_iterator artist = artists.begin();
-	while (artist != artists.end()) {
-		list.add("Artist \"" + artist->second.name + "\" [" + artist->second.hash + "]");
-		TAlbumMap::const_iterator album = artist->second.albums.begin();
-		while (album != artist->second.albums.end()) {
-			list.add("  Album \"" + album->second.name + "\" [" + album->second.hash + "]");
-			for (size_t i=0; i<album->second.songs.size(); ++i) {
-				list.add("    Track " + album->second.songs[i]->getTrack() + " \"" + album->second.songs[i]->getTitle() + "\"");
+	for (size_t i=0; i<artists.size(); ++i) {
+		const TArtist* artist = artists[i];
+		list.add("Artist \"" + artist->name + "\" [" + artist->hash + "]");
+		TAlbumMap::const_iterator album = artist->albums.begin();
+		while (album != artist->albums.end()) {
+			const TAlbum* o = album->second;
+			list.add("  Album \"" + o->name + "\" [" + o->hash + "] " + getMediaName(o->media));
+			for (size_t j=0; j<o->songs.size(); ++j) {
+				list.add("    Track " + o->songs[j]->getTrack() + " \"" + o->songs[j]->getTitle() + "\"");
 			}
 			++album;
 		}
-		++artist;
 	}
 	if (!list.empty())
 		list.saveToFile(fileName);
@@ -1578,12 +1792,12 @@ void TLibrary::saveAlbumMap(const TAlbumMap& albums, const std::string& fileName
 	util::TStringList list;
 	TAlbumMap::const_iterator album = albums.begin();
 	while (album != albums.end()) {
-		const std::string& compilation = album->second.compilation ? "yes" : "no";
+		const std::string& compilation = album->second->compilation ? "yes" : "no";
 		list.add("Album \"" + album->first + "\"");
-		list.add("  Hash \"" + album->second.hash + "\"");
-		list.add("  Name \"" + album->second.name + "\"");
-		list.add("  Artist \"" + album->second.artist + "\"");
-		list.add("  Originalartist \"" + album->second.originalartist + "\"");
+		list.add("  Hash \"" + album->second->hash + "\"");
+		list.add("  Name \"" + album->second->name + "\"");
+		list.add("  Artist \"" + album->second->artist + "\"");
+		list.add("  Originalartist \"" + album->second->originalartist + "\"");
 		list.add("  Compilation = " + compilation);
 		++album;
 	}
@@ -1607,15 +1821,13 @@ void TLibrary::updateTracksCount() {
 }
 
 void TLibrary::updateRecentAlbums() {
-	util::clearObjectList(library.recent);
+	library.recent.clear();
 	if (!library.albums.empty()) {
-		THashedMap::const_iterator albums = library.albums.begin();
+		THashedMap::iterator albums = library.albums.begin();
 		while (albums != library.albums.end()) {
-			const TAlbum& album = albums->second;
+			TAlbum& album = albums->second;
 			if (album.inserted > util::epoch()) {
-				TAlbum* o = new TAlbum;
-				*o = album;
-				library.recent.push_back(o);
+				library.recent.push_back(&album);
 			}
 			++albums;
 		}
@@ -1624,6 +1836,18 @@ void TLibrary::updateRecentAlbums() {
 		std::sort(library.recent.begin(), library.recent.end(), dateSorterDesc);
 }
 
+void TLibrary::updateSearchIndex() {
+	searchIndex.clear();
+	if (!library.ordered.empty()) {
+		TAlbumMap::const_iterator album = library.ordered.begin();
+		while (album != library.ordered.end()) {
+			if (util::assigned(album->second))
+				searchIndex.add(*album->second);
+			++album;
+		}
+	}
+}
+
 
 TLibraryResults TLibrary::updateArtistsHTML(const std::string& filter, bool& changed, music::EMediaType type, const music::CConfigValues& config, const EViewType view) {
 
@@ -1775,122 +1999,41 @@ TLibraryResults TLibrary::getArtistsHTML(util::TStringList& html, const std::str
 	} // if (!letters->empty()) {
 
 
-	bool empty = true;
-	switch (type) {
-		case EMT_CD:
-			empty = library.artists.cd.empty();
-			break;
-		case EMT_HDCD:
-			empty = library.artists.hdcd.empty();
-			break;
-		case EMT_DSD:
-			empty = library.artists.dsd.empty();
-			break;
-		case EMT_DVD:
-			empty = library.artists.dvd.empty();
-			break;
-		case EMT_BD:
-			empty = library.artists.bd.empty();
-			break;
-		case EMT_HR:
-			empty = library.artists.hr.empty();
-			break;
-		default:
-			empty = library.artists.all.empty();
-			break;
-	}
+	const TConstArtistList& artistview = getArtistList(type);
+	bool empty = artistview.empty();
 
 	// Generate dynamic HTML
 	if (!empty) {
 		bool ok = true;
-		bool goon = false;
 		bool various = false;
 		bool compilation = false;
 		std::string albumGlyph, albumHint, albumLink, addGlyph, addHint, addLink;
 		std::string urlalbum, artisthash, albumhash, albumname, albumyear, mediatype, tracks, text;
 		std::string displayalbumname;
 		TConstArtistList artists;
+		TConstAlbumList albumlist;
 
-		// Get iterator through artis for given media type
-		TArtistMap::const_iterator artist;
-		switch (type) {
-			case EMT_CD:
-				artist = library.artists.cd.begin();
-				goon = true;
-				break;
-			case EMT_HDCD:
-				artist = library.artists.hdcd.begin();
-				goon = true;
-				break;
-			case EMT_DSD:
-				artist = library.artists.dsd.begin();
-				goon = true;
-				break;
-			case EMT_DVD:
-				artist = library.artists.dvd.begin();
-				goon = true;
-				break;
-			case EMT_BD:
-				artist = library.artists.bd.begin();
-				goon = true;
-				break;
-			case EMT_HR:
-				artist = library.artists.hr.begin();
-				goon = true;
-				break;
-			default:
-				artist = library.artists.all.begin();
-				goon = true;
-				break;
-		}
-
-		while (goon) {
-
-			// Compare current iterator to end of list
-			switch (type) {
-				case EMT_CD:
-					goon = artist != library.artists.cd.end();
-					break;
-				case EMT_HDCD:
-					goon = artist != library.artists.hdcd.end();
-					break;
-				case EMT_DSD:
-					goon = artist != library.artists.dsd.end();
-					break;
-				case EMT_DVD:
-					goon = artist != library.artists.dvd.end();
-					break;
-				case EMT_BD:
-					goon = artist != library.artists.bd.end();
-					break;
-				case EMT_HR:
-					goon = artist != library.artists.hr.end();
-					break;
-				default:
-					goon = artist != library.artists.all.end();
-					break;
-			}
-
-			// End of given artist list?
-			if (!goon) {
-				break;
+		// Iterate through artist view for given media type
+		for (size_t k=0; k<artistview.size(); ++k) {
+			const TArtist* artist = artistview[k];
+			if (!util::assigned(artist)) {
+				continue;
 			}
 
 			// Check for wildcard filter
 			ok = false;
 			various = false;
 			compilation = false;
-			const std::string& artistname = artist->second.name;
-			TAlbumMap::const_iterator album = artist->second.albums.begin();
-			if (album != artist->second.albums.end()) {
-				if (album->second.compilation) {
+			const std::string& artistname = artist->name;
+			if (getArtistAlbums(*artist, type, albumlist) > 0) {
+				if (albumlist[0]->compilation) {
 					compilation = true;
 				}
 			}
 
 			// Check for varios artist category
 			if (compilation) {
-				various = filterVariousArtistName(artist->second.originalname, config.categories);
+				various = filterVariousArtistName(artist->originalname, config.categories);
 			}
 
 			if (!artistname.empty()) {
@@ -1913,11 +2056,9 @@ TLibraryResults TLibrary::getArtistsHTML(util::TStringList& html, const std::str
 
 			if (ok) {
 				// Add filtered artist to list
-				artists.push_back(&artist->second);
+				artists.push_back(artist);
 				++count;
 			};
-
-			++artist;
 		}
 
 		// Add HTML "header" for thumbnail list
@@ -1944,7 +2085,8 @@ TLibraryResults TLibrary::getArtistsHTML(util::TStringList& html, const std::str
 			for (size_t i=0; i<artists.size(); i++) {
 				const TArtist* o = artists[i];
 				if (util::assigned(o)) {
-					const TArtist artist = *o;
+					const TArtist& artist = *o;
+					getArtistAlbums(artist, type, albumlist);
 					ok = false;
 
 					if (!ok && ELV_ARTIST == view) {
@@ -1954,15 +2096,15 @@ TLibraryResults TLibrary::getArtistsHTML(util::TStringList& html, const std::str
 						const std::string& displayartistname = compilation ? artist.displayname : artist.displayoriginalname;
 						const std::string& artisthash = artist.hash;
 						const std::string& search = util::TURL::encode(artist.originalname);
-						size_t albums = artist.albums.size();
+						size_t albums = albumlist.size();
 
 						// Take first album of artist for preview
-						TAlbumMap::const_iterator album = artist.albums.begin();
-						if (album != artist.albums.end()) {
-							albumhash = album->second.hash;
-							albumname = album->second.name;
+						if (!albumlist.empty()) {
+							const TAlbum* album = albumlist[0];
+							albumhash = album->hash;
+							albumname = album->name;
 							urlalbum = util::TURL::encode(albumname);
-							displayalbumname = album->second.displayname;
+							displayalbumname = album->displayname;
 						}
 
 						// Check for multiple albums per artist...
@@ -2030,7 +2172,7 @@ TLibraryResults TLibrary::getArtistsHTML(util::TStringList& html, const std::str
 						const std::string& searchname = artistname;
 						const std::string& displayartistname = compilation ? artist.displayname : artist.displayoriginalname;
 						const std::string& urlname = util::TURL::encode(artistname);
-						size_t albums = artist.albums.size();
+						size_t albums = albumlist.size();
 
 						// Add only artist with albums...
 						if (albums > 0) {
@@ -2038,31 +2180,19 @@ TLibraryResults TLibrary::getArtistsHTML(util::TStringList& html, const std::str
 							if (albums > 1) {
 								albumLink = root + LIBRARY_ROOT_URL + "albums.html?prepare=yes&title=albums&filter=" + urlname;
 							} else {
-								TAlbumMap::const_iterator album = artist.albums.begin();
-								if (album != artist.albums.end()) {
-									albumLink = root + LIBRARY_ROOT_URL + "tracks.html?prepare=yes&title=tracks&filter=" + album->second.hash;
-								} else {
-									albumLink = root + LIBRARY_ROOT_URL + "albums.html?prepare=yes&title=albums&filter=" + urlname;
-								}
+								albumLink = root + LIBRARY_ROOT_URL + "tracks.html?prepare=yes&title=tracks&filter=" + albumlist[0]->hash;
 							}
 
 							html.add("  <h4 style=\"font-weight: bold;\" uri=\"" + albumLink + "\" onclick=\"onListViewHeaderClick(event)\">" + displayartistname + "</h4>");
 							html.add("  <hr style=\"margin-top: 0px; margin-bottom: 7px;\" />");
 
-							// Take first album of artist for preview
-							TAlbumMap::const_iterator album = artist.albums.begin();
-							if (album != artist.albums.end()) {
-								TConstAlbumList list;
+							// Take albums of artist in order of album name
+							if (!albumlist.empty()) {
+								TConstAlbumList list(albumlist);
 
 								html.add("  <table style=\"display: table; width: 100%;\">");
 								html.add("    <tbody>");
 
-								// Add albums from ordered map to vector list
-								do {
-									list.push_back(&album->second);
-									album++;
-								} while (album != artist.albums.end());
-
 								// Sort albums by year?
 								if (config.sortAlbumsByYear) {
 									std::sort(list.begin(), list.end(), yearSorterDesc);
@@ -2371,7 +2501,7 @@ size_t TLibrary::getAlbumsHTML(util::TStringList& html, const std::string& filte
 		music::EMediaType media = music::EMT_UNKNOWN;
 		TAlbumMap::iterator album = library.ordered.begin();
 		while (album != library.ordered.end()) {
-			compilation = album->second.compilation;
+			compilation = album->second->compilation;
 			found = true;
 
 			// Check for media type filter
@@ -2379,8 +2509,8 @@ size_t TLibrary::getAlbumsHTML(util::TStringList& html, const std::string& filte
 			if (found && EMT_ALL != type) {
 				found = false;
 				media = music::EMT_ALL;
-				if (!album->second.songs.empty()) {
-					PSong o = album->second.songs[0];
+				if (!album->second->songs.empty()) {
+					PSong o = album->second->songs[0];
 					if (util::assigned(o)) {
 						media = o->getMediaType();
 						found = true;
@@ -2411,8 +2541,8 @@ size_t TLibrary::getAlbumsHTML(util::TStringList& html, const std::string& filte
 			if (found && !filter.empty()) {
 				switch (domain) {
 					case FD_TITLE:
-						for (size_t i=0; i<album->second.songs.size(); ++i) {
-							PSong o = album->second.songs[i];
+						for (size_t i=0; i<album->second->songs.size(); ++i) {
+							PSong o = album->second->songs[i];
 							if (util::assigned(o)) {
 								found = filterArtistValue(filter, o->getTitle(), partial, search);
 								if (found)
@@ -2421,8 +2551,8 @@ size_t TLibrary::getAlbumsHTML(util::TStringList& html, const std::string& filte
 						}
 						break;
 					case FD_CONDUCTOR:
-						for (size_t i=0; i<album->second.songs.size(); ++i) {
-							PSong o = album->second.songs[i];
+						for (size_t i=0; i<album->second->songs.size(); ++i) {
+							PSong o = album->second->songs[i];
 							if (util::assigned(o)) {
 								found = filterArtistValue(filter, o->getConductor(), partial, search);
 								if (found)
@@ -2431,8 +2561,8 @@ size_t TLibrary::getAlbumsHTML(util::TStringList& html, const std::string& filte
 						}
 						break;
 					case FD_COMPOSER:
-						for (size_t i=0; i<album->second.songs.size(); ++i) {
-							PSong o = album->second.songs[i];
+						for (size_t i=0; i<album->second->songs.size(); ++i) {
+							PSong o = album->second->songs[i];
 							if (util::assigned(o)) {
 								found = filterArtistValue(filter, o->getComposer(), partial, search);
 								if (found)
@@ -2441,8 +2571,8 @@ size_t TLibrary::getAlbumsHTML(util::TStringList& html, const std::string& filte
 						}
 						break;
 					case FD_ARTIST:
-						for (size_t i=0; i<album->second.songs.size(); ++i) {
-							PSong o = album->second.songs[i];
+						for (size_t i=0; i<album->second->songs.size(); ++i) {
+							PSong o = album->second->songs[i];
 							if (util::assigned(o)) {
 								if (compilation) {
 									found = util::strcasestr(o->getOriginalArtist(), filter);
@@ -2456,14 +2586,14 @@ size_t TLibrary::getAlbumsHTML(util::TStringList& html, const std::string& filte
 						break;
 					case FD_ALBUMARTIST:
 					default:
-						found = filterArtistValue(filter, album->second.artist, partial, search);
+						found = filterArtistValue(filter, album->second->artist, partial, search);
 						break;
 				}
 			}
 
 			// Add album to list
 			if (found) {
-				list.push_back(&album->second);
+				list.push_back(album->second);
 				++albums;
 			}
 
@@ -2570,18 +2700,24 @@ size_t TLibrary::getSearchHTML(util::TStringList& html, const std::string& filte
 		html.add("");
 		bool ok = true;
 		TConstAlbumList list;
-		TAlbumMap::const_iterator album = library.ordered.begin();
-		while (album != library.ordered.end()) {
+
+		// Get candidates from search index in order of album map
+		TConstAlbumList candidates;
+		searchIndex.find(searchList, candidates);
+		if (debug) std::cout << "TLibrary::getSearchHTML() Found " << candidates.size() << " candidates in " << searchIndex.size() << " albums for \"" << filter << "\"" << std::endl;
+
+		for (size_t i=0; i<candidates.size(); ++i) {
+			const TAlbum* album = candidates[i];
 
 			// Apply filter word list...
-			ok = filterSearchAlbum(album->second, domain, media, searchList, genre);
+			ok = filterSearchAlbum(*album, domain, media, searchList, genre);
 
 			// Add album to list
 			if (ok) {
-				list.push_back(&album->second);
+				list.push_back(album);
 
 				// Check if genre in result set
-				const std::string& genre = album->second.genre;
+				const std::string& genre = album->genre;
 				if (!genre.empty() && std::string::npos == genres.find(genre, util::EC_COMPARE_FULL)) {
 					genres.add(genre);
 				}
@@ -2589,7 +2725,6 @@ size_t TLibrary::getSearchHTML(util::TStringList& html, const std::string& filte
 				++albums;
 			}
 
-			++album;
 			if (albums >= max) {
 				overflow = true;
 				break;
@@ -3032,6 +3167,15 @@ void TLibrary::saveToFile(const std::string& fileName, const bool addHeader, con
 		if (util::fileExists(fileName)) {
 			cleanup();
 		}
+
+		// Save binary database used for fast library loading
+		// --> CSV file is kept as human readable import and export format
+		if (binaryDatabase) {
+			std::string databaseName = getDatabaseFileName(fileName);
+			if (!saveToDatabase(databaseName)) {
+				util::deleteFile(databaseName);
+			}
+		}
 	} else {
 		// Delete library file on empty song database
 		if (util::fileExists(fileName)) {
@@ -3039,6 +3183,7 @@ void TLibrary::saveToFile(const std::string& fileName, const bool addHeader, con
 			util::moveFile(fileName, util::uniqueFileName(backupName, util::UN_TIME));
 			util::deleteFile(fileName);
 		}
+		util::deleteFile(getDatabaseFileName(fileName));
 		errorList.clear();
 	}
 
@@ -3062,6 +3207,257 @@ void TLibrary::saveErrorsToFile(const std::string& fileName) {
 	}
 }
 
+std::string TLibrary::getDatabaseFileName(const std::string& fileName) const {
+	return util::fileReplaceExt(fileName, LIBRARY_DATABASE_EXT);
+}
+
+void TLibrary::getDatabaseValues(PSong song, std::string* values[]) {
+	values[LDS_ARTIST] = &song->tags.meta.text.artist;
+	values[LDS_ORIGINAL_ARTIST] = &song->tags.meta.text.originalartist;
+	values[LDS_ALBUM_ARTIST] = &song->tags.meta.text.albumartist;
+	values[LDS_ALBUM] = &song->tags.meta.text.album;
+	values[LDS_TITLE] = &song->tags.meta.text.title;
+	values[LDS_GENRE] = &song->tags.meta.text.genre;
+	values[LDS_COMPOSER] = &song->tags.meta.text.composer;
+	values[LDS_CONDUCTOR] = &song->tags.meta.text.conductor;
+	values[LDS_ORIGINAL_ALBUM_ARTIST] = &song->tags.meta.text.originalalbumartist;
+	values[LDS_TITLE_HASH] = &song->tags.meta.hash.title;
+	values[LDS_ALBUM_HASH] = &song->tags.meta.hash.album;
+	values[LDS_YEAR] = &song->tags.meta.text.year;
+	values[LDS_DATE] = &song->tags.meta.text.date;
+	values[LDS_FILE_NAME] = &song->tags.file.filename;
+	values[LDS_FILE_TIME] = &song->tags.file.timestamp;
+	values[LDS_FILE_HASH] = &song->tags.file.hash;
+	values[LDS_INSERT_TIME] = &song->tags.file.insertstamp;
+}
+
+static uLong updateDatabaseChecksum(uLong crc, const void* data, size_t size) {
+	const Bytef* p = (const Bytef*)data;
+	while (size > 0) {
+		uInt chunk = size > (size_t)0x40000000 ? (uInt)0x40000000 : (uInt)size;
+		crc = crc32(crc, p, chunk);
+		p += chunk;
+		size -= chunk;
+	}
+	return crc;
+}
+
+static uint32_t getDatabaseChecksum(const void* records, const size_t recordsSize, const void* strings, const size_t stringsSize) {
+	uLong crc = crc32(0L, Z_NULL, 0);
+	crc = updateDatabaseChecksum(crc, records, recordsSize);
+	crc = updateDatabaseChecksum(crc, strings, stringsSize);
+	return (uint32_t)crc;
+}
+
+static bool addDatabaseString(const std::string& value, TLibraryDatabaseString& result, std::string& table, TLibraryDatabaseStrings& index) {
+	result.offset = 0;
+	result.length = 0;
+	if (!value.empty()) {
+		// Store each distinct string only once
+		TLibraryDatabaseStrings::const_iterator it = index.find(value);
+		if (it != index.end()) {
+			result = it->second;
+			return true;
+		}
+		if (table.size() + value.size() > (size_t)UINT32_MAX)
+			return false;
+		result.offset = (uint32_t)table.size();
+		result.length = (uint32_t)value.size();
+		table.append(value);
+		index.insert(TLibraryDatabaseStrings::value_type(value, result));
+	}
+	return true;
+}
+
+static bool getDatabaseString(const TLibraryDatabaseString& value, const char* table, const uint64_t size, std::string& result) {
+	if ((uint64_t)value.offset + (uint64_t)value.length > size)
+		return false;
+	result.assign(table + value.offset, value.length);
+	return true;
+}
+
+bool TLibrary::saveToDatabase(const std::string& fileName) {
+	TLibraryDatabaseRecords records;
+	TLibraryDatabaseStrings index;
+	std::string strings;
+	std::string* values[LDS_STRING_COUNT];
+
+	// Create fixed width song records and string table
+	records.reserve(size());
+	for (size_t i=0; i<size(); ++i) {
+		PSong o = library.tracks.songs[i];
+		if (util::assigned(o)) {
+			TLibraryDatabaseRecord record;
+			memset(&record, 0, sizeof(record));
+			record.codec = (int32_t)o->type;
+			record.params = (int32_t)o->params;
+			record.tracknumber = (int32_t)o->tags.meta.track.tracknumber;
+			record.trackcount = (int32_t)o->tags.meta.track.trackcount;
+			record.disknumber = (int32_t)o->tags.meta.track.disknumber;
+			record.diskcount = (int32_t)o->tags.meta.track.diskcount;
+			record.sampleRate = (int32_t)o->tags.stream.sampleRate;
+			record.bitsPerSample = (int32_t)o->tags.stream.bitsPerSample;
+			record.bytesPerSample = (int32_t)o->tags.stream.bytesPerSample;
+			record.channels = (int32_t)o->tags.stream.channels;
+			record.sampleCount = (uint64_t)o->tags.stream.sampleCount;
+			record.sampleSize = (uint64_t)o->tags.stream.sampleSize;
+			record.bitRate = (uint64_t)o->tags.stream.bitRate;
+			record.chunkSize = (uint64_t)o->tags.stream.chunkSize;
+			record.duration = (int64_t)o->tags.stream.duration;
+			record.seconds = (int64_t)o->tags.stream.seconds;
+			record.filetime = (int64_t)o->tags.file.time;
+			record.inserted = (int64_t)o->tags.file.inserted;
+			record.filesize = (uint64_t)o->tags.file.size;
+			getDatabaseValues(o, values);
+			for (size_t k=0; k<LDS_STRING_COUNT; ++k) {
+				if (!addDatabaseString(*values[k], record.strings[k], strings, index)) {
+					std::cout << "TLibrary::saveToDatabase() String table exceeds maximum size." << std::endl;
+					return false;
+				}
+			}
+			records.push_back(record);
+		}
+	}
+
+	// Create file header
+	TLibraryDatabaseHeader header;
+	size_t recordsSize = records.size() * sizeof(TLibraryDatabaseRecord);
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, LIBRARY_DATABASE_MAGIC, sizeof(header.magic));
+	header.version = LIBRARY_DATABASE_VERSION;
+	header.order = LIBRARY_DATABASE_BYTE_ORDER;
+	header.header = sizeof(TLibraryDatabaseHeader);
+	header.record = sizeof(TLibraryDatabaseRecord);
+	header.count = records.size();
+	header.records = sizeof(TLibraryDatabaseHeader);
+	header.strings = header.records + recordsSize;
+	header.size = strings.size();
+	header.checksum = getDatabaseChecksum(records.data(), recordsSize, strings.data(), strings.size());
+
+	// Write to temporary file and replace database file
+	std::string tempName = fileName + ".tmp";
+	try {
+		util::TBaseFile file;
+		file.open(tempName, O_WRONLY | O_CREAT | O_TRUNC);
+		file.write(&header, sizeof(header));
+		if (recordsSize > 0)
+			file.write(records.data(), recordsSize);
+		if (!strings.empty())
+			file.write(strings.data(), strings.size());
+		file.close();
+	} catch (const std::exception& e) {
+		std::cout << "TLibrary::saveToDatabase() Writing database <" << fileName << "> failed: " << e.what() << std::endl;
+		util::deleteFile(tempName);
+		return false;
+	}
+	if (!util::moveFile(tempName, fileName)) {
+		util::deleteFile(tempName);
+		return false;
+	}
+
+	if (debug) std::cout << "TLibrary::saveToDatabase() Saved " << header.count << " songs and " << header.size << " bytes of strings to <" << fileName << ">" << std::endl;
+	return true;
+}
+
+bool TLibrary::loadFromDatabase(const std::string& fileName) {
+	util::TMappedFile file;
+	if (!file.map(fileName)) {
+		if (debug) std::cout << "TLibrary::loadFromDatabase() Mapping database <" << fileName << "> failed (" << file.error() << ")" << std::endl;
+		return false;
+	}
+
+	// Check file header
+	const char* data = (const char*)file.data();
+	size_t size = file.getSize();
+	if (size < sizeof(TLibraryDatabaseHeader))
+		return false;
+	const TLibraryDatabaseHeader* header = (const TLibraryDatabaseHeader*)data;
+	if (0 != memcmp(header->magic, LIBRARY_DATABASE_MAGIC, sizeof(header->magic)) ||
+		header->version != LIBRARY_DATABASE_VERSION ||
+		header->order != LIBRARY_DATABASE_BYTE_ORDER ||
+		header->header != sizeof(TLibraryDatabaseHeader) ||
+		header->record != sizeof(TLibraryDatabaseRecord)) {
+		std::cout << "TLibrary::loadFromDatabase() Unsupported database format <" << fileName << ">" << std::endl;
+		return false;
+	}
+
+	// Check table bounds and content
+	if (header->records > size || header->count > (size - header->records) / sizeof(TLibraryDatabaseRecord) ||
+		header->strings > size || header->size > size - header->strings ||
+		header->records % sizeof(uint64_t) != 0) {
+		std::cout << "TLibrary::loadFromDatabase() Invalid database size <" << fileName << ">" << std::endl;
+		return false;
+	}
+	const TLibraryDatabaseRecord* records = (const TLibraryDatabaseRecord*)(data + header->records);
+	const char* strings = data + header->strings;
+	size_t recordsSize = header->count * sizeof(TLibraryDatabaseRecord);
+	if (header->checksum != getDatabaseChecksum(records, recordsSize, strings, header->size)) {
+		std::cout << "TLibrary::loadFromDatabase() Invalid checksum for database <" << fileName << ">" << std::endl;
+		return false;
+	}
+
+	// Create songs directly from records
+	// --> No parsing, URL decoding or codepage conversion needed
+	std::string* values[LDS_STRING_COUNT];
+	library.tracks.songs.reserve(header->count);
+	library.tracks.files.reserve(header->count);
+	for (size_t i=0; i<header->count; ++i) {
+		const TLibraryDatabaseRecord& record = records[i];
+		PSong o = newSong((ECodecType)record.codec);
+		if (!util::assigned(o)) {
+			std::cout << "TLibrary::loadFromDatabase() Unknown song type (" << record.codec << ") for record " << i << std::endl;
+			continue;
+		}
+
+		PSong p = o;
+		util::TObjectGuard<TSong> og(&p);
+		bool ok = true;
+		getDatabaseValues(o, values);
+		for (size_t k=0; k<LDS_STRING_COUNT && ok; ++k) {
+			ok = getDatabaseString(record.strings[k], strings, header->size, *values[k]);
+		}
+		if (!ok)
+			continue;
+
+		o->params = record.params;
+		o->tags.meta.track.tracknumber = record.tracknumber;
+		o->tags.meta.track.trackcount = record.trackcount;
+		o->tags.meta.track.disknumber = record.disknumber;
+		o->tags.meta.track.diskcount = record.diskcount;
+		o->tags.meta.text.track = util::cprintf("%02.2d", o->tags.meta.track.tracknumber);
+		o->tags.meta.text.disk = util::cprintf("%02.2d", o->tags.meta.track.disknumber);
+		o->tags.stream.sampleCount = (size_t)record.sampleCount;
+		o->tags.stream.sampleSize = (size_t)record.sampleSize;
+		o->tags.stream.sampleRate = record.sampleRate;
+		o->tags.stream.bitsPerSample = record.bitsPerSample;
+		o->tags.stream.bytesPerSample = record.bytesPerSample;
+		o->tags.stream.channels = record.channels;
+		o->tags.stream.bitRate = (size_t)record.bitRate;
+		o->tags.stream.chunkSize = (size_t)record.chunkSize;
+		o->tags.stream.duration = (util::TTimePart)record.duration;
+		o->tags.stream.seconds = (util::TTimePart)record.seconds;
+		o->tags.file.basename = util::fileBaseName(o->tags.file.filename);
+		o->tags.file.extension = util::fileExt(o->tags.file.filename);
+		o->tags.file.folder = util::filePath(o->tags.file.filename);
+		o->tags.file.url = util::TURL::encode(o->tags.file.folder);
+		o->tags.file.time = (util::TTimePart)record.filetime;
+		o->tags.file.inserted = (util::TTimePart)record.inserted;
+		o->tags.file.size = (size_t)record.filesize;
+
+		if (o->tags.stream.isValid() && o->tags.meta.isValid() && o->tags.file.isValid()) {
+			o->setSortTags();
+			o->setDisplayTags();
+			addSong(o);
+			p = nil; // Do not delete p via RAII guard!
+		} else {
+			std::cout << "TLibrary::loadFromDatabase() Invalid song <" << o->tags.file.filename << ">" << std::endl;
+		}
+	}
+
+	if (debug) std::cout << "TLibrary::loadFromDatabase() Loaded " << library.tracks.songs.size() << " of " << header->count << " songs from <" << fileName << ">" << std::endl;
+	return true;
+}
+
 std::string TLibrary::escape(const std::string& text) {
 	return util::TJsonValue::escape(html::THTML::encode(text));
 }
@@ -3132,6 +3528,21 @@ void TLibrary::loadFromFile(const std::string& fileName, const bool hasHeader, c
 	if (!empty())
 		clear();
 
+	// Load binary database if not older than CSV library file
+	std::string databaseName = getDatabaseFileName(fileName);
+	if (binaryDatabase && util::fileExists(databaseName) && util::fileAge(databaseName) >= util::fileAge(fileName)) {
+		if (loadFromDatabase(databaseName)) {
+			setDatabase(fileName);
+			cleanup();
+			if (library.tracks.songs.size() > 0) {
+				updateLibraryMappings();
+			}
+			setErrorFileName(fileName);
+			return;
+		}
+		clear();
+	}
+
 	if(!util::fileExists(fileName))
 		return;
 
@@ -3206,6 +3617,14 @@ void TLibrary::loadFromFile(const std::string& fileName, const bool hasHeader, c
 
 	if (library.tracks.songs.size() > 0) {
 		updateLibraryMappings();
+
+		// Create binary database for next start
+		if (binaryDatabase) {
+			std::lock_guard<std::mutex> lock(saveMtx);
+			if (!saveToDatabase(databaseName)) {
+				util::deleteFile(databaseName);
+			}
+		}
 	}
 
 	// Set erroneous file list location for given library file
@@ -3363,12 +3782,12 @@ PSong TLibrary::getAlbumData(const std::string& hash, CTrackData& track, std::st
 
 
 bool TLibrary::getArtistInfo(const std::string& artist, std::string& displayname, std::string& hash) {
-	TArtistMap::const_iterator it = library.artists.all.find(artist);
-	if (it != library.artists.all.end()) {
+	TArtistMap::const_iterator it = library.artists.table.find(artist);
+	if (it != library.artists.table.end()) {
 		bool compilation = false;
 		if (!it->second.albums.empty()) {
 			TAlbumMap::const_iterator album = it->second.albums.begin();
-			if (album->second.compilation)
+			if (album->second->compilation)
 				compilation = true;
 		}
 		displayname = compilation ? it->second.name : it->second.originalname;
@@ -3398,6 +3817,7 @@ TPlaylist::TPlaylist() {
 	permanent = true;
 	thread.setExecHandler(&music::TPlaylist::unlinkThreadMethod, this);
 	thread.setName("Library-Unlink");
+	thread.setPriority(app::ETP_LOW);
 	prepare();
 }
 
@@ -10,6 +10,7 @@
 
 #include <map>
 #include <vector>
+#include <unordered_map>
 #include <fnmatch.h>
 #include <string>
 #include "../inc/gcc.h"
@@ -36,6 +37,9 @@ STATIC_CONST size_t DEFAULT_SEARCH_RESULTS = 8 * DEFAULT_RECENT_RESULTS;
 STATIC_CONST size_t LAZY_LOADER_THRESHOLD_LOW = 18;
 STATIC_CONST size_t LAZY_LOADER_THRESHOLD_HIGH = LAZY_LOADER_THRESHOLD_LOW / 2 * 3;
 
+STATIC_CONST size_t LIBRARY_SCANNER_MAX_THREADS = 16;
+STATIC_CONST size_t LIBRARY_SCANNER_FILES_PER_THREAD = 32;
+
 STATIC_CONST char STATE_PLAYLIST_NAME[] = "state";
 STATIC_CONST char IMAGE_BORDER_RADIUS[] = "0px"; // "5px";
 
@@ -86,6 +90,107 @@ typedef struct CLibraryResults {
 } TLibraryResults;
 
 
+enum EScannerAction { ESA_IMPORT, ESA_UPDATE };
+enum EScannerState { ESS_QUEUED, ESS_READING, ESS_READY };
+
+typedef struct CLibraryScanItem {
+	std::string file;
+	util::TInodeHandle node;
+	EScannerState state;
+	TFileTag tag;
+	PSong song;
+	bool found;
+	bool changed;
+	int result;
+
+	CLibraryScanItem(const std::string& fileName, const util::TInodeHandle inode) {
+		file = fileName;
+		node = inode;
+		state = ESS_QUEUED;
+		song = nil;
+		found = false;
+		changed = false;
+		result = EXIT_SUCCESS;
+	}
+} TLibraryScanItem;
+
+#ifdef STL_HAS_TEMPLATE_ALIAS
+
+using PLibraryScanItem = TLibraryScanItem*;
+using TLibraryScanList = std::vector<TLibraryScanItem>;
+using TScannerThreadList = std::vector<pthread_t>;
+
+#else
+
+typedef TLibraryScanItem* PLibraryScanItem;
+typedef std::vector<TLibraryScanItem> TLibraryScanList;
+typedef std::vector<pthread_t> TScannerThreadList;
+
+#endif
+
+
+typedef struct CLibraryScanner {
+	TLibraryScanList items;
+	EScannerAction action;
+	app::TCondition event;
+	size_t index;
+
+	void clear() {
+		items.clear();
+		action = ESA_UPDATE;
+		index = 0;
+	}
+
+	CLibraryScanner() {
+		clear();
+	}
+} TLibraryScanner;
+
+
+#ifdef STL_HAS_TEMPLATE_ALIAS
+
+using TSearchPostings = std::vector<uint32_t>;
+using TSearchPostingList = std::vector<const TSearchPostings*>;
+using TSearchTrigramMap = std::unordered_map<uint32_t, TSearchPostings>;
+
+#else
+
+typedef std::vector<uint32_t> TSearchPostings;
+typedef std::vector<const TSearchPostings*> TSearchPostingList;
+typedef std::unordered_map<uint32_t, TSearchPostings> TSearchTrigramMap;
+
+#endif
+
+// Trigram index over all searchable album fields
+// --> Albums must be added in order of the ordered album map
+// --> Lookup returns candidates in album order, candidates must be verified by filterSearchAlbum()
+class TLibrarySearchIndex {
+private:
+	TConstAlbumList albums;
+	TSearchTrigramMap trigrams;
+	TSearchPostings keys;
+
+	static inline char fold(const char c) {
+		return (c >= 'A' && c <= 'Z') ? c + 'a' - 'A' : c;
+	}
+	static inline uint32_t trigram(const char* p) {
+		return ((uint32_t)(uint8_t)fold(p[0]) << 16) | ((uint32_t)(uint8_t)fold(p[1]) << 8) | (uint32_t)(uint8_t)fold(p[2]);
+	}
+	void addText(const std::string& text);
+
+public:
+	void clear();
+	void add(const TAlbum& album);
+	size_t find(const util::TStringList& search, TConstAlbumList& result) const;
+
+	size_t size() const { return albums.size(); };
+	bool empty() const { return albums.empty(); };
+
+	TLibrarySearchIndex();
+	virtual ~TLibrarySearchIndex();
+};
+
+
 class TLibrary {
 public:
 	typedef TSongList::const_iterator const_iterator;
@@ -128,6 +233,10 @@ private:
 	bool allowMovePreamble;
 	size_t updatedCount;
 	size_t rescanCount;
+	size_t scannerThreads;
+	bool binaryDatabase;
+	TLibraryScanner scanner;
+	TLibrarySearchIndex searchIndex;
 	std::string database;
 	std::string name;
 	app::TDetachedThread thread;
@@ -145,6 +254,13 @@ private:
 	std::string getMediaName(const music::EMediaType type);
 
 	int readDirektory(const std::string& path, const app::TStringVector& patterns, TLibraryAddFunction addfn, const bool rebuild, const bool recursive = true);
+	size_t scan(const std::string& path, const app::TStringVector& patterns, const EScannerAction action, const bool rebuild, const bool recursive);
+	size_t getScannerThreadCount(const size_t files) const;
+	PLibraryScanItem getNextScanItem();
+	void readScanItem(TLibraryScanItem& item, const EScannerAction action);
+	void waitForScanItem(TLibraryScanItem& item, const EScannerAction action);
+	PSong commitScanItem(TLibraryScanItem& item, const EScannerAction action, const bool rebuild);
+	void terminateScanner(TScannerThreadList& threads);
 	bool hasLibraryMappings();
 	void saveLibraryMappings();
 	void clearLibraryMappings();
@@ -152,10 +268,14 @@ private:
 	void updateVariousArtists();
 	void updateTracksCount();
 	void updateRecentAlbums();
+	void updateSearchIndex();
 	void clearArtistMap(TArtistMap& artists);
 	void cleanArtistMap(TArtistMap& artists);
-	void createLetterMap(TArtistMap& artists, TLetterMap& letters);
-	void saveArtistMap(const TArtistMap& artists, const std::string& fileName);
+	void createArtistLists();
+	void createLetterMap(const TConstArtistList& artists, TLetterMap& letters);
+	const TConstArtistList& getArtistList(const EMediaType type) const;
+	size_t getArtistAlbums(const TArtist& artist, const EMediaType type, TConstAlbumList& albums) const;
+	void saveArtistMap(const TConstArtistList& artists, const std::string& fileName);
 	void saveAlbumMap(const TAlbumMap& albums, const std::string& fileName);
 	void saveHashedMap(const THashedMap& albums, const std::string& fileName);
 	void addArtistQuickLinks(util::TStringList& html, const TLetterMap& letters, const std::string& base, const char active);
@@ -165,6 +285,11 @@ private:
 	bool isValidSpace(const std::string& name, size_t offset);
 	std::string escape(const std::string& text);
 
+	std::string getDatabaseFileName(const std::string& fileName) const;
+	void getDatabaseValues(PSong song, std::string* values[]);
+	bool saveToDatabase(const std::string& fileName);
+	bool loadFromDatabase(const std::string& fileName);
+
 	void validateSongList();
 	void invalidateSongList();
 	void setValidateSongList(const bool value);
@@ -205,6 +330,8 @@ public:
 	PSong updateFile(const std::string& fileName, const util::TInodeHandle node, const bool rebuild);
 	PSong importFile(const std::string& fileName, const util::TInodeHandle node, const bool rebuild);
 	void addError(const std::string& fileName, const int error, const std::string& hint);
+	void queueFile(const std::string& fileName, const util::TInodeHandle node);
+	int scannerThreadHandler();
 
 	size_t size() const { return library.tracks.songs.size(); }
 	bool empty() const { return library.tracks.songs.empty(); }
@@ -215,7 +342,7 @@ public:
 	operator bool() const { return !empty(); };
 	size_t songs() const { return size(); };
 	size_t albums() const { return library.albums.size(); };
-	size_t artists() const { return library.artists.all.size(); };
+	size_t artists() const { return library.artists.table.size(); };
 	size_t erroneous() const { return errorList.size(); };
 
 	PSong findFile(const std::string& fileHash) const;
@@ -237,13 +364,13 @@ public:
 	const TSongMap& getFiles() const { return library.tracks.files; }
 	const THashedMap& getAlbums() const { return library.albums; }
 
-	const TArtistMap& getAllArtists() const { return library.artists.all; }
-	const TArtistMap& getCDArtists() const { return library.artists.cd; }
-	const TArtistMap& getHDCDArtists() const { return library.artists.hdcd; }
-	const TArtistMap& getDVDArtists() const { return library.artists.dvd; }
-	const TArtistMap& getBDArtists() const { return library.artists.bd; }
-	const TArtistMap& getHRArtists() const { return library.artists.hr; }
-	const TArtistMap& getDSDArtists() const { return library.artists.dsd; }
+	const TArtistMap& getAllArtists() const { return library.artists.table; }
+	const TConstArtistList& getCDArtists() const { return library.artists.cd; }
+	const TConstArtistList& getHDCDArtists() const { return library.artists.hdcd; }
+	const TConstArtistList& getDVDArtists() const { return library.artists.dvd; }
+	const TConstArtistList& getBDArtists() const { return library.artists.bd; }
+	const TConstArtistList& getHRArtists() const { return library.artists.hr; }
+	const TConstArtistList& getDSDArtists() const { return library.artists.dsd; }
 
 	size_t getCDCount() const { return cdCount; }
 	size_t getHDCDCount() const { return hdcdCount; }
@@ -261,6 +388,10 @@ public:
 	void setDeepNameInspection(const bool value) { allowDeepNameInspection = value; };
 	void setVariousArtistsRename(const bool value) { allowVariousArtistsRename = value; };
 	void setMovePreamble(const bool value) { allowMovePreamble = value; };
+	void setScannerThreads(const size_t value) { scannerThreads = value; };
+	size_t getScannerThreads() const { return scannerThreads; };
+	void setBinaryDatabase(const bool value) { binaryDatabase = value; };
+	bool getBinaryDatabase() const { return binaryDatabase; };
 	void setSortMode(const ELibrarySortMode value);
 
 	void setName(const std::string& value) { name = value; };
@@ -8,10 +8,100 @@
 #ifndef LIBRARYTYPES_H_
 #define LIBRARYTYPES_H_
 
+#include <map>
+#include <vector>
+#include <string>
+#include <stdint.h>
 #include "../inc/logger.h"
 
 namespace music {
 
+STATIC_CONST char LIBRARY_DATABASE_EXT[] = "db";
+STATIC_CONST char LIBRARY_DATABASE_MAGIC[] = "DBPLYLIB";
+STATIC_CONST uint32_t LIBRARY_DATABASE_VERSION = 1;
+STATIC_CONST uint32_t LIBRARY_DATABASE_BYTE_ORDER = 0x01020304;
+
+// Indices of string values in library database record
+enum ELibraryDatabaseString {
+	LDS_ARTIST,
+	LDS_ORIGINAL_ARTIST,
+	LDS_ALBUM_ARTIST,
+	LDS_ALBUM,
+	LDS_TITLE,
+	LDS_GENRE,
+	LDS_COMPOSER,
+	LDS_CONDUCTOR,
+	LDS_ORIGINAL_ALBUM_ARTIST,
+	LDS_TITLE_HASH,
+	LDS_ALBUM_HASH,
+	LDS_YEAR,
+	LDS_DATE,
+	LDS_FILE_NAME,
+	LDS_FILE_TIME,
+	LDS_FILE_HASH,
+	LDS_INSERT_TIME,
+	LDS_STRING_COUNT
+};
+
+// Binary library database file layout:
+// --> Header, fixed width song records, string table
+// --> Values are stored in host byte order, file is a local cache of the CSV library file
+// --> Strings are stored once in string table and referenced by offset and length
+typedef struct CLibraryDatabaseHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t order;
+	uint32_t header;   // Size of header
+	uint32_t record;   // Size of song record
+	uint64_t count;    // Number of song records
+	uint64_t records;  // Offset of song records
+	uint64_t strings;  // Offset of string table
+	uint64_t size;     // Size of string table
+	uint32_t checksum; // CRC32 of song records and string table
+	uint32_t reserved;
+} TLibraryDatabaseHeader;
+
+typedef struct CLibraryDatabaseString {
+	uint32_t offset;
+	uint32_t length;
+} TLibraryDatabaseString;
+
+typedef struct CLibraryDatabaseRecord {
+	int32_t codec;
+	int32_t params;
+	int32_t tracknumber;
+	int32_t trackcount;
+	int32_t disknumber;
+	int32_t diskcount;
+	int32_t sampleRate;
+	int32_t bitsPerSample;
+	int32_t bytesPerSample;
+	int32_t channels;
+	uint64_t sampleCount;
+	uint64_t sampleSize;
+	uint64_t bitRate;
+	uint64_t chunkSize;
+	int64_t duration;
+	int64_t seconds;
+	int64_t filetime;
+	int64_t inserted;
+	uint64_t filesize;
+	TLibraryDatabaseString strings[LDS_STRING_COUNT];
+} TLibraryDatabaseRecord;
+
+#ifdef STL_HAS_TEMPLATE_ALIAS
+
+using TLibraryDatabaseRecords = std::vector<TLibraryDatabaseRecord>;
+using TLibraryDatabaseStrings = std::map<std::string, TLibraryDatabaseString>;
+
+#else
+
+typedef std::vector<TLibraryDatabaseRecord> TLibraryDatabaseRecords;
+typedef std::map<std::string, TLibraryDatabaseString> TLibraryDatabaseStrings;
+
+#endif
+
+
 typedef struct CLibraryConfig {
 	app::PLogFile logger;
 	bool debug;
@@ -24,6 +114,7 @@ typedef struct CLibraryConfig {
 	bool allowVariousArtistsRename;
 	bool allowMovePreamble;
 	bool sortCaseSensitive;
+	size_t scannerThreads;
 
 	void clear() {
 		logger = nil;
@@ -36,6 +127,7 @@ typedef struct CLibraryConfig {
 		allowVariousArtistsRename = false;
 		allowMovePreamble = false;
 		sortCaseSensitive = true;
+		scannerThreads = 0;
 	}
 
 	CLibraryConfig() {
@@ -40,9 +40,18 @@ void TPlayerConfig::prime() {
 	m_periodtime = 1000;
 	m_skipframe = 8;
 	m_fraction = 50;
+	m_decodeahead = music::DECODE_AHEAD_SECONDS;
+	m_streamprefill = inet::JITTER_DEFAULT_PREFILL_TIME;
+	m_streambuffer = inet::JITTER_DEFAULT_BUFFER_TIME;
+	m_buffermode = music::EBM_DECODED;
+	m_hugepages = true;
+	m_numabinding = true;
 	m_prebuffer = 6;
 	m_alsatimeout = 240;
 	m_ignoremixer = false;
+	m_nativedsd = true;
+	m_resamplerate = 0;
+	m_resamplequality = music::ERQ_MEDIUM;
 	m_updatelibrary = false;
 	m_usemetadata = true;
 	c_damonized = false;
@@ -68,9 +77,14 @@ void TPlayerConfig::prime() {
 	m_displaylimit = 36;
 	m_pagelimit = 10;
 	m_dithered = false;
+	m_ditherspectrum = music::EDS_FLAT;
 	m_path_enabled1 = true;
 	m_path_enabled2 = false;
 	m_path_enabled3 = false;
+	m_scannerthreads = 0;
+	m_thumbnailcache = 32 * 1024 * 1024;
+	m_thumbnailpreload = true;
+	m_thumbnailgenerator = true;
 }
 
 bool TPlayerConfig::doDebug(const int level) const {
@@ -123,6 +137,14 @@ void TPlayerConfig::readConfig() {
 
 	m_skipframe = config.readInteger("FastForwardFrameDuration", m_skipframe);
 	m_dithered = config.readBool("UseDithering", true); // Default ist dithered upscaling output
+	int spectrum = config.readInteger("DitherSpectrum", (int)m_ditherspectrum); // 0 = flat TPDF, 1 = first order, 2 = second order highpass
+	m_ditherspectrum = (spectrum >= music::EDS_FLAT && spectrum <= music::EDS_SECOND) ? (music::EDitherSpectrum)spectrum : music::EDS_FLAT;
+	m_nativedsd = config.readBool("UseNativeDSD", m_nativedsd); // Fallback to DoP if not supported by hardware
+	m_resamplerate = config.readInteger("ResampleRate", m_resamplerate); // 0 = device follows song sample rate, e.g. 48000 = locked output rate for PCM
+	if (m_resamplerate < 0)
+		m_resamplerate = 0;
+	int quality = config.readInteger("ResampleQuality", (int)m_resamplequality); // 0 = low, 1 = medium, 2 = high
+	m_resamplequality = (quality >= music::ERQ_LOW && quality <= music::ERQ_HIGH) ? (music::EResamplerQuality)quality : music::ERQ_MEDIUM;
 
 	// Delete deprecated path entry
 	config.deleteKey("MusicFolder");
@@ -135,6 +157,7 @@ void TPlayerConfig::readConfig() {
 	m_path_enabled2 = config.readBool("MusicFolderEnabled2", m_path_enabled2);
 	m_path3 = config.readString("MusicFolder3", "");
 	m_path_enabled3 = config.readBool("MusicFolderEnabled3", m_path_enabled3);
+	m_scannerthreads = config.readInteger("ScannerThreads", m_scannerthreads); // 0 = one thread per processor core
 
 	// Geuess music path for first entry
 	if (m_path1.empty())
@@ -157,6 +180,18 @@ void TPlayerConfig::readConfig() {
 	m_prebuffer = config.readInteger("PreloadBufferCount", m_prebuffer);
 	if (m_prebuffer < 2)
 		m_prebuffer = 2;
+	m_buffermode = config.readBool("CompressedBuffering", m_buffermode == music::EBM_COMPRESSED) ? music::EBM_COMPRESSED : music::EBM_DECODED;
+	m_decodeahead = config.readInteger("DecodeAheadTime", m_decodeahead);
+	if (m_decodeahead < 5)
+		m_decodeahead = 5;
+	m_streamprefill = config.readInteger("StreamPrefillTime", m_streamprefill);
+	if (m_streamprefill < 100)
+		m_streamprefill = 100;
+	m_streambuffer = config.readInteger("StreamBufferTime", m_streambuffer);
+	if (m_streambuffer < (2 * m_streamprefill))
+		m_streambuffer = 2 * m_streamprefill;
+	m_hugepages = config.readBool("UseHugePages", m_hugepages); // Fallback to default pages if not available
+	m_numabinding = config.readBool("UseNumaBinding", m_numabinding);
 	if (m_alsatimeout != 0 && m_alsatimeout < 10)
 		m_alsatimeout = 10;
 
@@ -212,6 +247,9 @@ void TPlayerConfig::readConfig() {
 
 	config.setSection("Coverart");
 	m_covercache = config.readPath("CacheFolder", c_appdata + "cache/");
+	m_thumbnailcache = config.readSize("MemoryCacheSize", m_thumbnailcache);
+	m_thumbnailpreload = config.readBool("PreloadCurrentAlbum", m_thumbnailpreload);
+	m_thumbnailgenerator = config.readBool("GenerateThumbnails", m_thumbnailgenerator);
 }
 
 void TPlayerConfig::writeConfig() {
@@ -230,6 +268,10 @@ void TPlayerConfig::writeConfig() {
 	config.writeBool("IgnoreMixer", m_ignoremixer, app::INI_BLYES);
 	config.writeInteger("FastForwardFrameDuration", m_skipframe);
 	config.writeBool("UseDithering", m_dithered, app::INI_BLYES);
+	config.writeInteger("DitherSpectrum", (int)m_ditherspectrum);
+	config.writeBool("UseNativeDSD", m_nativedsd, app::INI_BLYES);
+	config.writeInteger("ResampleRate", m_resamplerate);
+	config.writeInteger("ResampleQuality", (int)m_resamplequality);
 
 	config.deleteKey("StateFileName");
 
@@ -241,6 +283,7 @@ void TPlayerConfig::writeConfig() {
 	config.writeBool("MusicFolderEnabled2", m_path_enabled2, app::INI_BLYES);
 	config.writePath("MusicFolder3", m_path3);
 	config.writeBool("MusicFolderEnabled3", m_path_enabled3, app::INI_BLYES);
+	config.writeInteger("ScannerThreads", m_scannerthreads);
 
 	config.setSection("Buffering");
 	config.writeInteger("RelativeMemoryUsage", m_fraction);
@@ -250,6 +293,12 @@ void TPlayerConfig::writeConfig() {
 	config.writeInteger("BufferPlayingThreshold", m_bufferthreshold);
 	config.writeInteger("NextBufferThreshold", m_rebufferthreshold);
 	config.writeInteger("PreloadBufferCount", m_prebuffer);
+	config.writeBool("CompressedBuffering", m_buffermode == music::EBM_COMPRESSED, app::INI_BLYES);
+	config.writeInteger("DecodeAheadTime", m_decodeahead);
+	config.writeInteger("StreamPrefillTime", m_streamprefill);
+	config.writeInteger("StreamBufferTime", m_streambuffer);
+	config.writeBool("UseHugePages", m_hugepages, app::INI_BLYES);
+	config.writeBool("UseNumaBinding", m_numabinding, app::INI_BLYES);
 	config.writeInteger("DeviceShutdownDelay", m_alsatimeout);
 	config.deleteKey("ReplayBuffers");
 	config.deleteKey("MinBufferCount");
@@ -309,6 +358,9 @@ void TPlayerConfig::writeConfig() {
 
 	config.setSection("Coverart");
 	config.writePath("CacheFolder", m_covercache);
+	config.writeSize("MemoryCacheSize", m_thumbnailcache);
+	config.writeBool("PreloadCurrentAlbum", m_thumbnailpreload, app::INI_BLYES);
+	config.writeBool("GenerateThumbnails", m_thumbnailgenerator, app::INI_BLYES);
 
 	config.deleteSection("Network");
 
@@ -581,8 +633,12 @@ void TPlayerConfig::getAlsaConfig(TAlsaConfig& config) {
 	config.skipframe = getSkipFrame();
 	config.verbosity = getVerbosity();
 	config.dithered = getDithered();
+	config.spectrum = getDitherSpectrum();
 	config.debug = getDebug();
 	config.ignoremixer = getIgnoreMixer();
+	config.nativedsd = getNativeDSD();
+	config.resamplerate = getResampleRate();
+	config.resamplequality = getResampleQuality();
 	config.logger = nil;
 }
 
@@ -598,6 +654,7 @@ void TPlayerConfig::getLibraryConfig(TLibraryConfig& config) {
 	config.allowVariousArtistsRename = getVariousArtistsRename();
 	config.allowMovePreamble = getMovePreamble();
 	config.sortCaseSensitive = doSortCaseSensitive();
+	config.scannerThreads = getScannerThreads();
 	config.logger = nil;
 }
 
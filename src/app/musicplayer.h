@@ -14,6 +14,7 @@
 #include "../inc/datetime.h"
 #include "../inc/alsatypes.h"
 #include "../inc/audiotypes.h"
+#include "../inc/jitterbuffer.h"
 #include "../inc/stringutils.h"
 #include "librarytypes.h"
 #include "musictypes.h"
@@ -36,11 +37,18 @@ private:
 	std::string m_database;
 	std::string m_stations;
 	std::string m_covercache;
+	size_t m_thumbnailcache;
+	bool m_thumbnailpreload;
+	bool m_thumbnailgenerator;
 	std::string m_playlist;
 	std::string m_selected;
 	std::string m_ignoredevices;
 	size_t m_playlistsize;
 	bool m_dithered;
+	music::EDitherSpectrum m_ditherspectrum;
+	bool m_nativedsd;
+	int m_resamplerate;
+	music::EResamplerQuality m_resamplequality;
 	bool m_debug;
 	bool m_scandebug;
 	int m_verbosity;
@@ -50,6 +58,7 @@ private:
 	bool m_path_enabled1;
 	bool m_path_enabled2;
 	bool m_path_enabled3;
+	size_t m_scannerthreads;
 	util::TTimePart m_resumedelay;
 	size_t m_maxbuffersize;
 	size_t m_minbuffersize;
@@ -57,6 +66,12 @@ private:
 	size_t m_bufferthreshold;
 	size_t m_rebufferthreshold;
 	size_t m_fraction;
+	util::TTimePart m_decodeahead;
+	util::TTimePart m_streamprefill;
+	util::TTimePart m_streambuffer;
+	music::EBufferMode m_buffermode;
+	bool m_hugepages;
+	bool m_numabinding;
 	size_t m_prebuffer;
 	size_t m_displaylimit;
 	size_t m_pagelimit;
@@ -126,6 +141,9 @@ public:
 	const std::string& getMusicPath2() const { return m_path2; };
 	const std::string& getMusicPath3() const { return m_path3; };
 	const std::string& getCachePath() const { return m_covercache; };
+	size_t getThumbnailCacheSize() const { return m_thumbnailcache; };
+	bool getThumbnailPreload() const { return m_thumbnailpreload; };
+	bool getThumbnailGenerator() const { return m_thumbnailgenerator; };
 	const std::string& getDataRootPath() const { return c_appdata; };
 	const std::string& getDataBasePath() const { return c_database; };
 	const std::string& getDataBaseFile() const { return m_database; };
@@ -144,10 +162,20 @@ public:
 	size_t getMaxBufferCount() const { return m_maxbuffercount; };
 	size_t getMemoryFraction() const { return m_fraction; };
 	size_t getBufferThreshold() const { return m_bufferthreshold; };
+	music::EBufferMode getBufferMode() const { return m_buffermode; };
+	util::TTimePart getDecodeAheadTime() const { return m_decodeahead; };
+	util::TTimePart getStreamPrefillTime() const { return m_streamprefill; };
+	util::TTimePart getStreamBufferTime() const { return m_streambuffer; };
+	bool getHugePages() const { return m_hugepages; };
+	bool getNumaBinding() const { return m_numabinding; };
 	size_t getRebufferThreshold() const { return m_rebufferthreshold; };
 	size_t getPreBufferCount() const { return m_prebuffer; };
 	util::TTimePart getAlsaTimeout() const { return m_alsatimeout; };
 	bool getDithered() const { return m_dithered; };
+	music::EDitherSpectrum getDitherSpectrum() const { return m_ditherspectrum; };
+	bool getNativeDSD() const { return m_nativedsd; };
+	int getResampleRate() const { return m_resamplerate; };
+	music::EResamplerQuality getResampleQuality() const { return m_resamplequality; };
 
 	snd_pcm_uint_t getPeriodTime() const { return m_periodtime; };
 	util::TTimePart getTaskCycleTime() const { return m_taskcycletime; };
@@ -161,6 +189,7 @@ public:
 	size_t getPlaylistSize() const { return m_playlistsize; };
 
 	bool getScannerDebug() const { return m_scandebug; };
+	size_t getScannerThreads() const { return m_scannerthreads; };
 	bool getGroupNameSwap() const { return m_allowGroupNameSwap; };
 	bool getArtistNameRestore() const { return m_allowArtistNameRestore; };
 	bool getFullNameSwap() const { return m_allowFullNameSwap; };
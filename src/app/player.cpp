@@ -13,6 +13,7 @@
 #include <unistd.h>
 #include <stdio.h>
 #include <sys/mount.h>
+#include <sys/resource.h>
 #include "player.h"
 #include "musictypes.h"
 #include "../config.h"
@@ -29,6 +30,7 @@
 #include "../inc/random.h"
 #include "../inc/typeid.h"
 #include "../inc/flac.h"
+#include "../inc/threadpool.h"
 #include "storeconsts.h"
 #include "upnp.h"
 
@@ -48,6 +50,24 @@ static void* streamThreadDispatcher(void *thread) {
 	}
 }
 
+// Internet stream decoder thread dispatcher
+static void* decoderThreadDispatcher(void *thread) {
+	if (util::assigned(thread)) {
+		return (void *)(long)(static_cast<app::TPlayer*>(thread))->decoderThreadHandler();
+	} else {
+		return (void *)(long)(EXIT_FAILURE);
+	}
+}
+
+// Thumbnail generator thread dispatcher
+static void* thumbnailThreadDispatcher(void *thread) {
+	if (util::assigned(thread)) {
+		return (void *)(long)(static_cast<app::TPlayer*>(thread))->thumbnailThreadHandler();
+	} else {
+		return (void *)(long)(EXIT_FAILURE);
+	}
+}
+
 
 /*
  * Main application class
@@ -90,6 +110,12 @@ TPlayer::TPlayer() {
 	libraryThread = nil;
 	libraryThreadRunning = false;
 	libraryThreadActive = false;
+	coverItem = nil;
+	thumbItem = nil;
+	preloadRunning = false;
+	preloadThread.setName("Thumbnail-Preload");
+	preloadThread.setExecHandler(&app::TPlayer::preloadThreadMethod, this);
+	preloadThread.setPriority(app::ETP_LOW);
 #ifdef USE_APPLICATION_AS_OUTPUT
 	app::ansi.disable();
 //	app::red.disable();
@@ -104,7 +130,8 @@ TPlayer::TPlayer() {
 }
 
 TPlayer::~TPlayer() {
-	freeLocalFileCache();
+	fileCache.release(coverItem);
+	fileCache.release(thumbItem);
 }
 
 
@@ -116,6 +143,9 @@ int TPlayer::execute() {
 	wtScannerStatusCaption = nil;
 	wtScannerStatusColor = nil;
 	wtActiveLicenses = nil;
+	wtThumbnailCache = nil;
+	wtAlsaLatency = nil;
+	wtStreamBuffer = nil;
 	wtPlaylistHeader = nil;
 	wtTableRowCount = nil;
 	wtRecentHeader = nil;
@@ -143,6 +173,7 @@ int TPlayer::execute() {
 	// Create cover cache folders
 	coverCache = sound.getCachePath();
 	createCacheFolders(coverCache);
+	fileCache.setLimit(sound.getThumbnailCacheSize());
 
 	// Get and set ALSA player configuration
 	music::TAlsaConfig sndconf;
@@ -293,7 +324,8 @@ int TPlayer::execute() {
 
 	// Create buffer from given memory parameters
 	if (application.arguments().hasKey("P")) {
-		player.createBuffers(sound.getMemoryFraction(), sound.getMaxBufferCount(), sound.getMinBufferSize(), sound.getMaxBufferSize());
+		player.createBuffers(sound.getMemoryFraction(), sound.getMaxBufferCount(), sound.getMinBufferSize(), sound.getMaxBufferSize(),
+				sound.getBufferMode(), sound.getHugePages(), sound.getNumaBinding());
 		application.memoryLog("Player");
 	}
 
@@ -466,6 +498,9 @@ int TPlayer::execute() {
 	toUndoAction = application.addTimeout("ActionHistoryUndoTimeout", 60000);
 	toUndoAction->bindEventHandler(&app::TPlayer::onUndoActionTimeout, this);
 
+	// Create missing thumbnails in background
+	startThumbnailGenerator();
+
 	// Start library update worker thread
 	startLibraryThread();
 
@@ -524,6 +559,9 @@ void TPlayer::cleanup() {
 	// Terminate library update worker thread
 	terminateLibraryThread();
 
+	// Terminate thumbnail generator threads
+	terminateThumbnailGenerator();
+
 	// Save radio stations to file
 	if (stations.isChanged()) {
 		stations.saveToFile();
@@ -533,22 +571,6 @@ void TPlayer::cleanup() {
 	logger("[Loop] Executed last minute cleanups.");
 }
 
-void TPlayer::freeLocalFileCache() {
-	if (!fileCache.empty()) {
-		PFile o;
-		TFileCacheMap::iterator it = fileCache.begin();
-		while (it != fileCache.end()) {
-			o = it->second;
-			if (util::assigned(o)) {
-				o = it->second;
-				o->release();
-				util::freeAndNil(o);
-			}
-			++it;
-		}
-	}
-}
-
 void TPlayer::removeDevelFiles() {
 	// Delete source files on client systems
 	std::string host = application.getHostName();
@@ -702,6 +724,7 @@ void TPlayer::setupWebserverObjects(const size_t songsPerAlbum) {
 		application.addWebLink("erroneous.json",   &app::TPlayer::getErroneous,         this, true);
 		application.addWebLink("current.json",     &app::TPlayer::getPlayerState,       this, true);
 		application.addWebLink("scanner.json",     &app::TPlayer::getScannerState,      this, true);
+		application.addWebLink("latency.json",     &app::TPlayer::getLatencyStatistics, this, true);
 		application.addWebLink("modes.json",       &app::TPlayer::getRepeatModes,       this, true);
 		application.addWebLink("playlists.json",   &app::TPlayer::getCurrentPlaylist,   this, true);
 		application.addWebLink("radiotext.json",   &app::TPlayer::getRadioTextUpdate,   this, true);
@@ -827,6 +850,9 @@ void TPlayer::setupWebserverObjects(const size_t songsPerAlbum) {
 		wtStreamRadioText = application.addWebToken("STREAM_RADIO_TEXT", "No radio text available.");
 
 		wtActiveLicenses = application.addWebToken("ACTIVE_MODULE_LICENSES", "<none>");
+		wtThumbnailCache = application.addWebToken("THUMBNAIL_CACHE_STATUS", "-");
+		wtAlsaLatency    = application.addWebToken("ALSA_LATENCY_STATUS", "-");
+		wtStreamBuffer   = application.addWebToken("STREAM_BUFFER_STATUS", "-");
 
 		// Update player and playlist statistics
 		setErroneousHeader(library.erroneous());
@@ -2181,9 +2207,59 @@ void TPlayer::closeAlsaDevice(TGlobalState& global) {
 bool TPlayer::getBufferSize(const music::PSong song, size_t& free, size_t& size) {
 	free = player.freeBufferSize();
 	size = song->getSampleSize();
+	if (player.isCompressedBuffering()) {
+		// Only decode-ahead window must fit, song is decoded just in time
+		size_t window = getDecodeAheadSize(song);
+		if (window < size)
+			size = window;
+	}
 	return free > size;
 }
 
+size_t TPlayer::getDecodeAheadSize(const music::PSong song) {
+	// PCM bytes for configured decode-ahead time
+	// --> Limited to a quarter of the decode-ahead ring to start next song while current song is playing
+	size_t ring = player.bufferCount() * player.bufferSize() / 4;
+	size_t size = song->getSampleSize();
+	if (song->getDuration() > 0)
+		size = song->getBytesPerSecond() * (size_t)sound.getDecodeAheadTime();
+	return (size < ring) ? size : ring;
+}
+
+void TPlayer::preloadEncodedSongs(TGlobalState& global, const music::PPlaylist playlist) {
+	// Hold encoded files for decoded song and following songs in memory
+	music::PTrack track = global.decoder.track;
+	if (!util::assigned(track) || !util::assigned(playlist))
+		return;
+	music::PSong song = track->getSong();
+	if (!util::assigned(song))
+		return;
+
+	// Use repeat mode to decide how many songs are needed in advance
+	size_t count = global.params.preBufferCount;
+	if (global.shuffle.single) count = 1;
+	if (global.shuffle.random) count = 1;
+
+	music::TSongList songs;
+	{
+		app::TReadWriteGuard<app::TReadWriteLock> lock(libraryLck, RWL_READ);
+		music::PTrack p = playlist->getTrack(song->getFileHash());
+		if (util::assigned(p)) {
+			size_t index = p->getIndex();
+			size_t max = index + count + 1;
+			if (max > playlist->size())
+				max = playlist->size();
+			for (size_t i=index; i<max; ++i) {
+				music::PSong o = playlist->getSong(i);
+				if (util::assigned(o)) {
+					songs.push_back(o);
+				}
+			}
+		}
+	}
+	player.preloadEncodedSongs(songs);
+}
+
 bool TPlayer::executeBufferTask(TGlobalState& global) {
 	bool debugger = debug;
 
@@ -2196,11 +2272,13 @@ bool TPlayer::executeBufferTask(TGlobalState& global) {
 	music::PSong hardware = global.player.hardware.song;
 	music::PSong software = global.player.software.song;
 	music::PAudioBuffer buffer = nil;
+	music::PAudioBuffer next = nil;
 	music::PAudioStream stream = nil;
 	music::PSong current, song = nil;
 	music::PTrack track = nil;
 	util::hash_type hash = 0;
 	size_t thd, read, size, free, freed;
+	size_t position, offset, sample;
 	size_t index = app::nsizet;
 	bool exception = false;
 	bool found = false;
@@ -2250,6 +2328,32 @@ bool TPlayer::executeBufferTask(TGlobalState& global) {
 	// Decoder state machine...
 	switch (state) {
 		case 0:
+			// Seek into part of finished song that was never decoded
+			// --> Decode song again starting at seek position
+			if (player.getRestartRequest(song)) {
+				track = pls->findTrack(song->getFileHash());
+				if (util::assigned(track)) {
+					state = 100;
+					global.decoder.track = track;
+					global.decoder.busy = true;
+					global.decoder.buffered = true;
+					global.player.hardware.timeout = util::now();
+					logger(util::csnprintf("[Buffering] Restart decoder for song $ at seek position", song->getTitle()));
+					break;
+				}
+				player.cancelSeekRequest(song);
+				song = nil;
+			}
+
+			// Played buffers are released in compressed mode
+			// --> Get current song from playback, buffers of previous song may already be gone
+			if (player.isCompressedBuffering()) {
+				music::TCurrentSong playing;
+				player.getCurrentSong(playing);
+				if (util::assigned(playing.song))
+					hardware = playing.song;
+			}
+
 			// 1. Is song requested by command
 			// 2. Current song from hardware
 			current = util::assigned(software) ? software : hardware;
@@ -2347,6 +2451,11 @@ bool TPlayer::executeBufferTask(TGlobalState& global) {
 					break;
 				}
 
+				// Hardware parameters of upcoming song are validated while current song is playing
+				if (song != hardware) {
+					player.prepare(song->getStreamData());
+				}
+
 				// Release all stream buffers
 				size = 0;
 				freed = 0;
@@ -2483,6 +2592,10 @@ bool TPlayer::executeBufferTask(TGlobalState& global) {
 					global.player.hardware.timeout = util::now();
 					logger(util::csnprintf("[Buffering] Decode song $ [% bytes / %] to buffers [free % bytes / %]", \
 							song->getTitle(), size, util::sizeToStr(size, 1, util::VD_BINARY), free, util::sizeToStr(free, 1, util::VD_BINARY)));
+				} else if (player.isCompressedBuffering()) {
+					// Wait for played buffers returned to decode-ahead ring
+					if (debugger) logger(util::csnprintf("[Buffering] Wait for decode-ahead window [% bytes] to decode song $", size, song->getTitle()));
+					ok = true;
 				} else {
 					global.decoder.message = util::csnprintf("Song $ [% bytes / %] does not fit in buffers [free % bytes / %]", \
 							song->getTitle(), size, util::sizeToStr(size, 1, util::VD_BINARY), free, util::sizeToStr(free, 1, util::VD_BINARY));
@@ -2550,6 +2663,7 @@ bool TPlayer::executeBufferTask(TGlobalState& global) {
 			}
 			logger("[Buffering] Use first buffer <" + std::to_string((size_u)global.decoder.buffer->getKey()) + ">");
 			player.operateBuffers(global.decoder.buffer, track, music::EBS_BUFFERING);
+			global.decoder.buffer->setOffset(0);
 			if (global.decoder.buffer->validWriter()) {
 				global.decoder.time.start();
 			} else {
@@ -2584,6 +2698,84 @@ bool TPlayer::executeBufferTask(TGlobalState& global) {
 				break;
 			}
 
+			// Seek requested for position not yet decoded
+			if (player.getSeekRequest(song, position)) {
+				if (stream->canSeek()) {
+
+					// Continue decoding in next empty buffer
+					// --> Empty first buffer of restarted decoder is used directly
+					next = buffer;
+					if (buffer->getWritten() > 0) {
+						player.operateBuffers(buffer, track, music::EBS_LOADED);
+						next = player.getNextEmptyBuffer();
+						if (!util::assigned(next) && player.isCompressedBuffering()) {
+							// Decoded data ahead of playback is invalid after seek
+							// --> Release it to make room in decode-ahead ring
+							size_t n = player.dropBuffers(song);
+							logger(util::csnprintf("[Buffering] Released % decode-ahead buffers for seek", n));
+							next = player.getNextEmptyBuffer();
+						}
+					}
+					ok = util::assigned(next);
+					if (!ok) {
+						player.cancelSeekRequest(song);
+						global.decoder.message = "No empty buffer found to continue decoding at seek position.";
+						break;
+					}
+					if (next != buffer)
+						player.operateBuffers(next, track, music::EBS_CONTINUE);
+
+					// Reposition decoder to sample index of requested position
+					read = 0;
+					offset = 0;
+					sample = position / song->getWordWidth();
+					ok = false;
+					try {
+						ok = stream->seek(sample, next, offset, read);
+					} catch (const std::exception& e)	{
+						string sExcept = e.what();
+						global.decoder.message = util::csnprintf("Exception on stream seek for song $ : $", getGlobalSongTitle(global), sExcept);
+					} catch (...)	{
+						global.decoder.message = util::csnprintf("Unknown exception on stream seek for song $", getGlobalSongTitle(global));
+					}
+					if (!ok) {
+						player.cancelSeekRequest(song);
+						if (global.decoder.message.empty())
+							global.decoder.message = util::csnprintf("Decoder seek for song $ to sample % failed.", getGlobalSongTitle(global), sample);
+						break;
+					}
+
+					// Decoding continues at new position in next buffer
+					next->setOffset(offset);
+					buffer = global.decoder.buffer = next;
+					song->addWritten(read);
+					global.decoder.total += read;
+					global.decoder.seeking = true;
+					global.decoder.waiting = false;
+					global.decoder.busy = true;
+					logger(util::csnprintf("[Buffering] Decoder seek to sample % at offset % [%] in buffer <%>", sample, offset, util::sizeToStr(offset, 1, util::VD_BINARY), buffer->getKey()));
+
+				} else {
+					player.cancelSeekRequest(song);
+					logger(util::csnprintf("[Buffering] Decoder for song $ does not support seeking.", getGlobalSongTitle(global)));
+				}
+			}
+
+			// Wait for played buffer returned to decode-ahead ring
+			if (global.decoder.waiting) {
+				next = player.getNextEmptyBuffer();
+				if (!util::assigned(next)) {
+					preloadEncodedSongs(global, pls);
+					break;
+				}
+				player.operateBuffers(next, track, music::EBS_CONTINUE);
+				next->setOffset(buffer->getOffset() + buffer->getWritten());
+				buffer = global.decoder.buffer = next;
+				global.decoder.waiting = false;
+				global.decoder.busy = true;
+				if (debugger) logger("[Buffering] Continue decoding in released buffer <" + std::to_string((size_u)buffer->getKey()) + ">");
+			}
+
 			// Read next chunk from decoder stream
 			read = 0;
 			ok = false;
@@ -2625,6 +2817,12 @@ bool TPlayer::executeBufferTask(TGlobalState& global) {
 			song->addWritten(read);
 			global.decoder.total += read;
 
+			// Hand over repositioned buffer to playback
+			if (global.decoder.seeking) {
+				global.decoder.seeking = false;
+				player.completeSeekRequest(song, buffer);
+			}
+
 			// All bytes were read...
 			if (stream->isEOF()) {
 				player.operateBuffers(buffer, track, music::EBS_BUFFERED);
@@ -2636,7 +2834,7 @@ bool TPlayer::executeBufferTask(TGlobalState& global) {
 			//if (!global.decoder.buffered && !global.decoder.buffer->isBuffered() && !global.decoder.buffer->isPlaying()) {
 			if (!global.decoder.buffered) {
 				thd = global.decoder.total * 100 / song->getSampleSize();
-				if (thd > sound.getBufferThreshold()) {
+				if (thd > sound.getBufferThreshold() || (player.isCompressedBuffering() && global.decoder.total >= getDecodeAheadSize(song))) {
 					global.decoder.buffered = true;
 					player.operateBuffers(buffer, track, music::EBS_BUFFERED);
 					logger("[Buffering] " + std::to_string((size_u)global.decoder.total) + " Bytes written [" + util::sizeToStr(global.decoder.total, 1, util::VD_BINARY) + "]");
@@ -2658,12 +2856,25 @@ bool TPlayer::executeBufferTask(TGlobalState& global) {
 				player.operateBuffers(buffer, track, music::EBS_LOADED);
 
 				// Switch to next empty buffer
-				buffer = global.decoder.buffer = player.getNextEmptyBuffer();
-				if (util::assigned(buffer)) {
+				next = player.getNextEmptyBuffer();
+				if (util::assigned(next)) {
 					// Continue decoding the same song into next buffer
 					// --> Set written bytes for new buffer to zero!
-					player.operateBuffers(buffer, track, music::EBS_CONTINUE);
+					// --> Song offset of next buffer follows current buffer
+					player.operateBuffers(next, track, music::EBS_CONTINUE);
+					next->setOffset(buffer->getOffset() + buffer->getWritten());
+					buffer = global.decoder.buffer = next;
 					logger("[Buffering] Switched to next buffer <" + std::to_string((size_u)buffer->getKey()) + ">");
+				} else if (player.isCompressedBuffering()) {
+					// Decode-ahead ring is full, continue when playback released a buffer
+					// --> Decoder is not busy meanwhile, so task cycle is not occupied
+					global.decoder.waiting = true;
+					global.decoder.busy = false;
+					if (!global.decoder.buffered) {
+						global.decoder.buffered = true;
+						logger("[Buffering] Decode-ahead buffers filled, playback can be started...");
+					}
+					if (debugger) logger("[Buffering] Wait for empty buffer to continue decoding.");
 				} else {
 					global.decoder.message = "No empty buffer found to continue decoding.";
 					ok = false;
@@ -3041,7 +3252,7 @@ bool TPlayer::play(TGlobalState& global, music::PSong song, const std::string& p
 bool TPlayer::openRemoteDevice(const music::CAudioValues& values, const music::TSong* song, bool& opened, bool& unchanged) {
 	if (util::assigned(song)) {
 		app::TLockGuard<app::TMutex> lock(remoteMtx);
-		music::ESampleRate rate = (music::ESampleRate)song->getSampleRate();
+		music::ESampleRate rate = (music::ESampleRate)player.getOutputStream(song->getStreamData()).sampleRate;
 		return openRemoteDeviceWithNolock(values, rate, opened, unchanged);
 	}
 	return false;
@@ -4282,7 +4493,7 @@ void TPlayer::getCoverArt(TThreadData& sender, const void*& data, size_t& size,
 		fileName = getThumbFile(hash, folder, dimension, coverCache, special);
 	}
 
-	if (getThumbFromCache(fileName, data, size)) {
+	if (getThumbFromCache(fileName, coverItem, data, size)) {
 		// Add caching headers to response
 		if (caching)
 			cached = true;
@@ -4306,51 +4517,249 @@ void TPlayer::getThumbNail(TThreadData& sender, const void*& data, size_t& size,
 	// Get cached cover thumbnail
 	bool special = "00000000000000000000000000000001" == hash;
 	std::string fileName = (dimension > 0) ? getThumbFile(hash, folder, dimension, coverCache, special) : findFileName(folder, "folder.jpg");
-	cached = getThumbFromCache(fileName, data, size);
+	cached = getThumbFromCache(fileName, thumbItem, data, size);
 
 	if (debug) aout << "TPlayer::getThumbNail()     Served file name : " << fileName << endl;
 }
 
 
-bool TPlayer::getThumbFromCache(const std::string& fileName, const void*& data, size_t& size) {
-	bool retVal = false;
-	bool _debug = debug;
-	// _debug = true;
+bool TPlayer::getThumbFromCache(const std::string& fileName, util::PFileCacheItem& item, const void*& data, size_t& size) {
+	// Web link handlers are serialized by the data lock of their link
+	// --> Link data is copied after the handler returned, file is held until next request of the link
+	fileCache.release(item);
 	if (!fileName.empty()) {
-		// Check if file in cached file map
-		bool added = false;
-		app::TReadWriteGuard<app::TReadWriteLock> lock(thumbnailLck, RWL_READ);
-		TFileCacheMap::const_iterator it = fileCache.find(fileName);
-		if (it == fileCache.end()) {
-			// Release read lock and aquire write lock
-			lock.unlock();
-			PFile o = new TFile(fileName);
-			util::TObjectGuard<TFile> guard(&o);
-			if (o->exists()) {
-				o->load();
-				lock.wrLock();
-				fileCache[fileName] = o;
-				o = nil;
-				added = true;
-				it = fileCache.find(fileName);
-				if (_debug) aout << "TPlayer::getThumbFromCache()   Add file " << fileName << " to memory cache." << endl;
-			} else {
-				if (_debug) aout << "TPlayer::getThumbFromCache()   File " << fileName << " does not exists." << endl;
-			}
+		item = fileCache.acquire(fileName);
+		if (util::assigned(item)) {
+			data = item->file->getData();
+			size = item->file->getSize();
+			return true;
 		}
-		if (it != fileCache.end()) {
-			PFile o = it->second;
-			if (util::assigned(o)) {
-				data = o->getData();
-				size = o->getSize();
-				retVal = true;
+	}
+	return false;
+}
+
+void TPlayer::preloadThumbnails(const std::string& fileHash) {
+	// Load thumbnails of current album into memory cache
+	// --> Sizes used by now playing view and album lists
+	const size_t dimensions[] = { 48, 200, 400, 600 };
+	for (size_t i=0; i<util::sizeOfArray(dimensions); ++i) {
+		std::string fileName = getCachedFileName(fileHash, dimensions[i], coverCache);
+		if (util::fileExists(fileName))
+			fileCache.load(fileName);
+	}
+}
+
+void TPlayer::queueThumbnailPreload(const std::string& fileHash) {
+	// Files are loaded by low priority pool worker, not by the calling ALSA event thread
+	// --> Running preload takes the most recent album hash when done
+	bool run = false;
+	{
+		app::TLockGuard<app::TMutex> lock(preloadMtx);
+		preloadHash = fileHash;
+		if (!preloadRunning) {
+			preloadRunning = true;
+			run = true;
+		}
+	}
+	if (run)
+		preloadThread.run();
+}
+
+void TPlayer::preloadThreadMethod(app::TDetachedThread& thread) {
+	std::string hash;
+	while (true) {
+		{
+			app::TLockGuard<app::TMutex> lock(preloadMtx);
+			if (preloadHash.empty() || terminate) {
+				preloadHash.clear();
+				preloadRunning = false;
+				break;
 			}
-			if (!added && retVal && _debug) {
-				aout << "TPlayer::getThumbFromCache()   Using memory cached file " << fileName << endl;
+			hash = preloadHash;
+			preloadHash.clear();
+		}
+		try {
+			preloadThumbnails(hash);
+		} catch (...) {
+			// Allow next preload request to start worker again
+			app::TLockGuard<app::TMutex> lock(preloadMtx);
+			preloadRunning = false;
+			throw;
+		}
+	}
+}
+
+
+void TPlayer::startThumbnailGenerator() {
+	// Called on startup and by library update thread only
+	if (!sound.getThumbnailGenerator())
+		return;
+
+	// Stop generator threads from previous run
+	terminateThumbnailGenerator();
+
+	// Queue all albums, missing thumbnails are detected by generator threads
+	TThumbnailJobList jobs;
+	{
+		app::TReadWriteGuard<app::TReadWriteLock> lock(libraryLck, RWL_READ);
+		const music::THashedMap& albums = library.getAlbums();
+		music::THashedMap::const_iterator it = albums.begin();
+		for (; it != albums.end(); ++it) {
+			const music::TAlbum& album = it->second;
+			if (!album.songs.empty() && util::assigned(album.songs[0])) {
+				TThumbnailJob job;
+				job.hash = it->first;
+				job.folder = album.songs[0]->getFolder();
+				jobs.push_back(job);
 			}
 		}
 	}
-	return retVal;
+	size_t count = jobs.size();
+	if (count <= 0)
+		return;
+
+	// Use half of the processor cores at most
+	size_t workers = sysutil::getProcessorCount();
+	if (std::string::npos == workers)
+		workers = 1;
+	workers /= 2;
+	if (workers < 1)
+		workers = 1;
+	if (workers > THUMBNAIL_GENERATOR_MAX_THREADS)
+		workers = THUMBNAIL_GENERATOR_MAX_THREADS;
+	if (workers > count)
+		workers = count;
+
+	{
+		app::TLockGuard<app::TMutex> lock(thumbnails.mtx);
+		thumbnails.clear();
+		thumbnails.jobs.swap(jobs);
+		thumbnails.active = workers;
+		thumbnails.running = true;
+	}
+
+	for (size_t i=0; i<workers; ++i) {
+		pthread_t thread = 0;
+		if (createJoinableThread(thread, thumbnailThreadDispatcher, this, "Thumbnails")) {
+			thumbnails.threads.push_back(thread);
+		} else {
+			app::TLockGuard<app::TMutex> lock(thumbnails.mtx);
+			if (thumbnails.active > 0)
+				--thumbnails.active;
+			if (thumbnails.active <= 0)
+				thumbnails.running = false;
+		}
+	}
+
+	logger(util::csnprintf("[Thumbnails] Check thumbnails for % albums using % threads.", count, thumbnails.threads.size()));
+	updateScannerStatus();
+}
+
+void TPlayer::terminateThumbnailGenerator() {
+	// Prevent generator threads from taking further albums
+	{
+		app::TLockGuard<app::TMutex> lock(thumbnails.mtx);
+		thumbnails.index = thumbnails.jobs.size();
+	}
+
+	// Wait for current albums to be finished
+	for (size_t i=0; i<thumbnails.threads.size(); ++i) {
+		int r = terminateThread(thumbnails.threads[i]);
+		if (util::checkFailed(r))
+			logger("[Thumbnails] Waiting for generator thread failed.");
+	}
+	thumbnails.threads.clear();
+
+	app::TLockGuard<app::TMutex> lock(thumbnails.mtx);
+	thumbnails.clear();
+}
+
+bool TPlayer::getNextThumbnailJob(TThumbnailJob& job) {
+	app::TLockGuard<app::TMutex> lock(thumbnails.mtx);
+	if (thumbnails.index < thumbnails.jobs.size()) {
+		job = thumbnails.jobs[thumbnails.index++];
+		return true;
+	}
+	return false;
+}
+
+bool TPlayer::getThumbnailProgress(size_t& done, size_t& count) {
+	app::TLockGuard<app::TMutex> lock(thumbnails.mtx);
+	done = thumbnails.done;
+	count = thumbnails.jobs.size();
+	return thumbnails.running;
+}
+
+int TPlayer::thumbnailThreadHandler() {
+	// Generator threads should not compete with playback or web requests
+	if (util::checkFailed(setpriority(PRIO_PROCESS, gettid(), THUMBNAIL_GENERATOR_NICE_LEVEL))) {
+		if (debug) aout << "TPlayer::thumbnailThreadHandler() Set thread priority failed (" << errno << ")" << endl;
+	}
+
+	TThumbnailJob job;
+	while (!isTerminated() && getNextThumbnailJob(job)) {
+		size_t created = createThumbnails(job);
+		bool update = false;
+		{
+			app::TLockGuard<app::TMutex> lock(thumbnails.mtx);
+			++thumbnails.done;
+			thumbnails.created += created;
+			update = (thumbnails.done % THUMBNAIL_GENERATOR_PROGRESS_STEP) == 0;
+		}
+		if (update)
+			updateScannerStatus();
+	}
+
+	// Last thread leaving reports result
+	bool finished = false;
+	size_t done, created;
+	{
+		app::TLockGuard<app::TMutex> lock(thumbnails.mtx);
+		if (thumbnails.active > 0)
+			--thumbnails.active;
+		if (thumbnails.active <= 0) {
+			thumbnails.running = false;
+			finished = true;
+		}
+		done = thumbnails.done;
+		created = thumbnails.created;
+	}
+	if (finished) {
+		logger(util::csnprintf("[Thumbnails] Created % thumbnails for % albums.", created, done));
+		updateScannerStatus();
+	}
+
+	return EXIT_SUCCESS;
+}
+
+size_t TPlayer::createThumbnails(const TThumbnailJob& job) {
+	// Thumbnail sizes ordered from largest to smallest
+	const size_t dimensions[] = { 600, 400, 200, 72, 48, 32 };
+	std::vector<size_t> missing;
+	for (size_t i=0; i<util::sizeOfArray(dimensions); ++i) {
+		if (!util::fileExists(getCachedFileName(job.hash, dimensions[i], coverCache)))
+			missing.push_back(dimensions[i]);
+	}
+	if (missing.empty())
+		return 0;
+
+	// Decode cover art once, prescaled for the largest missing thumbnail
+	// --> Albums without cover art get the default picture on request
+	util::TJpeg cover;
+	if (!loadCoverArt(cover, job.hash, job.folder, missing[0]))
+		return 0;
+
+	// Create all missing thumbnails from decoded bitmap
+	size_t created = 0;
+	for (size_t i=0; i<missing.size() && !isTerminated(); ++i) {
+		util::TJpeg thumbnail;
+		thumbnail.assign(cover);
+		if (createThumbFile(thumbnail, getCachedFileName(job.hash, missing[i], coverCache), missing[i], false))
+			++created;
+	}
+	if (debug) aout << "TPlayer::createThumbnails() Created " << created << " thumbnails for album <" << job.hash << ">" << endl;
+
+	return created;
 }
 
 
@@ -4499,12 +4908,7 @@ void TPlayer::createCacheFolders(const std::string& cachePath) {
 void TPlayer::deleteCachedImages(const std::string& fileName) {
 	app::TReadWriteGuard<app::TReadWriteLock> lock(thumbnailLck, RWL_WRITE);
 	util::deleteFile(fileName);
-	TFileCacheMap::const_iterator it = fileCache.find(fileName);
-	if (it != fileCache.end()) {
-		util::PFile o = it->second;
-		util::freeAndNil(o);
-		fileCache.erase(it);
-	}
+	fileCache.remove(fileName);
 }
 
 void TPlayer::invalidateFileCache() {
@@ -4533,74 +4937,13 @@ std::string TPlayer::getThumbFile(util::TJpeg& thumbnail, const std::string& fil
 			return file;
 		}
 
-		// Find dedicated thumbnail file in folder
-		std::string picture = findFileName(folder, "folder.jpg");
-		if (!picture.empty()) {
-			if (debug) aout << "TPlayer::getThumbFile() Using disk coverart file <" << picture << ">" << endl;
-			try {
-				// File locked by filesystem...
-				app::TReadWriteGuard<app::TReadWriteLock> lock(thumbnailLck, RWL_READ);
-				thumbnail.loadFromFile(picture);
-			} catch (const std::exception& e)	{
-				string sExcept = e.what();
-				logger("TPlayer::getThumbFile() Exception reading coverart as JPEG from file <" + picture + "> \"" + sExcept + "\"");
-			} catch (...)	{
-				logger("TPlayer::getThumbFile() Unknown exception reading coverart as JPEG from file <" + picture + ">");
-			}
-		}
-
-		// No cover art file found in folder, try to load image from embedded metadata
-		if (sound.getUseMetadata() && !thumbnail.hasImage()) {
-			music::PSong o = nil;
-			if (debug) aout << "TPlayer::getThumbFile() Load metadata picture for <" << fileHash << ">" << endl;
-			{ // Protect library access
-				app::TReadWriteGuard<app::TReadWriteLock> lock(libraryLck, RWL_READ);
-				o = library.findAlbum(fileHash);
-			}
-			if (util::assigned(o)) {
-				music::TCoverData cover;
-				std::string song = o->getFileName();
-				try {
-					if (o->readPictureData(song, cover)) {
-						bool ok = false;
-						util::TImage::EImageType type = getImageType(cover.artwork);
-						if (!ok && type == util::TImage::IMG_JPEG) {
-							ok = true;
-							if (debug) aout << "TPlayer::getThumbFile() Using JPEG metadata picture for <" << song << ">" << endl;
-							thumbnail.decode(cover.artwork);
-							if (thumbnail.hasImage()) {
-								logger(util::csnprintf("[Metadata] Decoded JPEG metadata for file $ (%x% to %x% pixel)", song, thumbnail.width(), thumbnail.height(), dimension, dimension));
-							}
-						}
-						if (!ok && type == util::TImage::IMG_PNG) {
-							ok = true;
-							if (debug) aout << "TPlayer::getThumbFile() Using PNG metadata picture for <" << song << ">" << endl;
-							// Convert PNG image data to JPEG
-							util::TPNG png;
-							png.decode(cover.artwork);
-							thumbnail.move(png);
-							if (thumbnail.hasImage()) {
-								logger(util::csnprintf("[Metadata] Decoded PNG metadata for file $ (%x% to %x% pixel)", song, thumbnail.width(), thumbnail.height(), dimension, dimension));
-							}
-						}
-						if (!ok) {
-							if (debug) aout << "TPlayer::getThumbFile() Unknown picture format for <" << song << ">" << endl;
-							logger(util::csnprintf("[Metadata] Unknown picture format for file $", song));
-						}
-					}
-				} catch (const std::exception& e)	{
-					string sExcept = e.what();
-					logger("TPlayer::getThumbFile() Exception when reading metadata from file <" + song + "> \"" + sExcept + "\"");
-				} catch (...)	{
-					logger("TPlayer::getThumbFile() Unknown exception when reading metadata from file <" + song + ">");
-				}
-			}
-		}
+		// Load cover art from folder or from embedded metadata
+		loadCoverArt(thumbnail, fileHash, folder, dimension);
 
 		// Check if default "nocover.jpg" file needed
 		bool nocover = false;
 		if (!thumbnail.hasImage()) {
-			picture = special ? getSpecialFileName(dimension, cache) : getNocoverFileName(dimension, cache);
+			std::string picture = special ? getSpecialFileName(dimension, cache) : getNocoverFileName(dimension, cache);
 			if (!picture.empty()) {
 				if (debug) aout << "TPlayer::getThumbFile() Using default thumbnail file <" << picture << ">" << endl;
 				try {
@@ -4615,59 +4958,140 @@ std::string TPlayer::getThumbFile(util::TJpeg& thumbnail, const std::string& fil
 			}
 		}
 
-		// Load picture from file
+		// Create thumbnail and save JPG in cache folder
 		if (thumbnail.hasImage()) {
-			// Create thumbnail and save JPG in cache folder
+			if (createThumbFile(thumbnail, file, dimension, nocover))
+				return file;
+		}
+
+	} catch (const std::exception& e)	{
+		string sExcept = e.what();
+		logger("TPlayer::getThumbFile() Exception \"" + sExcept + "\"");
+	} catch (...)	{
+		logger("TPlayer::getThumbFile() Unknown exception.");
+	}
+
+	return "";
+}
+
+bool TPlayer::loadCoverArt(util::TJpeg& cover, const std::string& fileHash, const std::string& folder, const size_t dimension) {
+	// Let libjpeg scale down in DCT domain by the largest power of 2
+	// that leaves the picture larger than the requested dimension
+	util::TRGBSize target = (dimension > 0) ? dimension + 1 : 0;
+
+	// Find dedicated thumbnail file in folder
+	std::string picture = findFileName(folder, "folder.jpg");
+	if (!picture.empty()) {
+		if (debug) aout << "TPlayer::loadCoverArt() Using disk coverart file <" << picture << ">" << endl;
+		try {
+			// File locked by filesystem...
+			app::TReadWriteGuard<app::TReadWriteLock> lock(thumbnailLck, RWL_READ);
+			cover.loadPrescaledFromFile(picture, target, target);
+		} catch (const std::exception& e)	{
+			string sExcept = e.what();
+			logger("TPlayer::loadCoverArt() Exception reading coverart as JPEG from file <" + picture + "> \"" + sExcept + "\"");
+		} catch (...)	{
+			logger("TPlayer::loadCoverArt() Unknown exception reading coverart as JPEG from file <" + picture + ">");
+		}
+	}
+
+	// No cover art file found in folder, try to load image from embedded metadata
+	if (sound.getUseMetadata() && !cover.hasImage()) {
+		music::PSong o = nil;
+		if (debug) aout << "TPlayer::loadCoverArt() Load metadata picture for <" << fileHash << ">" << endl;
+		{ // Protect library access
+			app::TReadWriteGuard<app::TReadWriteLock> lock(libraryLck, RWL_READ);
+			o = library.findAlbum(fileHash);
+		}
+		if (util::assigned(o)) {
+			music::TCoverData artwork;
+			std::string song = o->getFileName();
 			try {
-				if (dimension < 100) {
-					thumbnail.setScalingMethod(ESM_SIMPLE);
-					thumbnail.scale(dimension, CL_WHITE);
-				} else {
-					if (dimension < thumbnail.height()) {
-						thumbnail.setScalingMethod(ESM_DITHER);
-						if (thumbnail.scale(dimension, CL_WHITE)) {
-							thumbnail.contrast();
+				if (o->readPictureData(song, artwork)) {
+					bool ok = false;
+					util::TImage::EImageType type = getImageType(artwork.artwork);
+					if (!ok && type == util::TImage::IMG_JPEG) {
+						ok = true;
+						if (debug) aout << "TPlayer::loadCoverArt() Using JPEG metadata picture for <" << song << ">" << endl;
+						cover.decode(artwork.artwork, target, target);
+						if (cover.hasImage()) {
+							logger(util::csnprintf("[Metadata] Decoded JPEG metadata for file $ (%x% to %x% pixel)", song, cover.width(), cover.height(), dimension, dimension));
 						}
-					} else {
-						thumbnail.setScalingMethod(ESM_BILINEAR);
-						if (thumbnail.scale(dimension, CL_WHITE)) {
-							thumbnail.blur(0.80);
-							thumbnail.contrast();
+					}
+					if (!ok && type == util::TImage::IMG_PNG) {
+						ok = true;
+						if (debug) aout << "TPlayer::loadCoverArt() Using PNG metadata picture for <" << song << ">" << endl;
+						// Convert PNG image data to JPEG
+						util::TPNG png;
+						png.decode(artwork.artwork);
+						cover.move(png);
+						if (cover.hasImage()) {
+							logger(util::csnprintf("[Metadata] Decoded PNG metadata for file $ (%x% to %x% pixel)", song, cover.width(), cover.height(), dimension, dimension));
 						}
 					}
-				}
-
-				// Adjust saturation for valid cover arts
-				if (!nocover) {
-					int range = thumbnail.getColorRange();
-					if (range < 50) {
-						thumbnail.saturation(1.3);
-						//logger("TPlayer::getThumbFile() Adjusted color saturation from " + std::to_string((size_u)range) + "% for file <" + picture + ">");
+					if (!ok) {
+						if (debug) aout << "TPlayer::loadCoverArt() Unknown picture format for <" << song << ">" << endl;
+						logger(util::csnprintf("[Metadata] Unknown picture format for file $", song));
 					}
 				}
-
-				// Save preview picture as thumnail
-				app::TReadWriteGuard<app::TReadWriteLock> lock(thumbnailLck, RWL_READ);
-				thumbnail.saveToFile(file);
-
-				return file;
-
 			} catch (const std::exception& e)	{
 				string sExcept = e.what();
-				logger("TPlayer::getThumbFile() Exception on create thumbnail JPEG file <" + file + "> \"" + sExcept + "\"");
+				logger("TPlayer::loadCoverArt() Exception when reading metadata from file <" + song + "> \"" + sExcept + "\"");
 			} catch (...)	{
-				logger("TPlayer::getThumbFile() Unknown exception on create thumbnail JPEG file <" + file + ">");
+				logger("TPlayer::loadCoverArt() Unknown exception when reading metadata from file <" + song + ">");
 			}
 		}
+	}
+
+	return cover.hasImage();
+}
+
+bool TPlayer::createThumbFile(util::TJpeg& thumbnail, const std::string& file, const size_t dimension, const bool nocover) {
+	try {
+		if (dimension < 100) {
+			thumbnail.setScalingMethod(ESM_SIMPLE);
+			thumbnail.scale(dimension, CL_WHITE);
+		} else {
+			if (dimension < thumbnail.height()) {
+				thumbnail.setScalingMethod(ESM_DITHER);
+				if (thumbnail.scale(dimension, CL_WHITE)) {
+					thumbnail.contrast();
+				}
+			} else {
+				thumbnail.setScalingMethod(ESM_BILINEAR);
+				if (thumbnail.scale(dimension, CL_WHITE)) {
+					thumbnail.blur(0.80);
+					thumbnail.contrast();
+				}
+			}
+		}
+
+		// Adjust saturation for valid cover arts
+		if (!nocover) {
+			int range = thumbnail.getColorRange();
+			if (range < 50) {
+				thumbnail.saturation(1.3);
+			}
+		}
+
+		// Save preview picture as thumbnail
+		// --> Write to temporary file and rename it, since the same
+		//     thumbnail may be created by web request and generator thread
+		app::TReadWriteGuard<app::TReadWriteLock> lock(thumbnailLck, RWL_READ);
+		std::string temp = file + "." + std::to_string((size_s)gettid()) + ".tmp";
+		if (thumbnail.saveToFile(temp) > 0) {
+			if (util::moveFile(temp, file))
+				return true;
+		}
+		util::deleteFile(temp);
 
 	} catch (const std::exception& e)	{
 		string sExcept = e.what();
-		logger("TPlayer::getThumbFile() Exception \"" + sExcept + "\"");
+		logger("TPlayer::createThumbFile() Exception on create thumbnail JPEG file <" + file + "> \"" + sExcept + "\"");
 	} catch (...)	{
-		logger("TPlayer::getThumbFile() Unknown exception.");
+		logger("TPlayer::createThumbFile() Unknown exception on create thumbnail JPEG file <" + file + ">");
 	}
-
-	return "";
+	return false;
 }
 
 
@@ -5426,6 +5850,49 @@ void TPlayer::getScannerState(TThreadData& sender, const void*& data, size_t& si
 }
 
 
+static void addHistogramValues(util::TVariantValues& response, const std::string& name, const util::THistogramValues& values) {
+	response.add(name + "Count", values.count);
+	response.add(name + "Min", values.min);
+	response.add(name + "Mean", values.mean);
+	response.add(name + "P50", values.p50);
+	response.add(name + "P90", values.p90);
+	response.add(name + "P99", values.p99);
+	response.add(name + "P999", values.p999);
+	response.add(name + "Max", values.max);
+}
+
+void TPlayer::getLatencyStatistics(TThreadData& sender, const void*& data, size_t& size, const util::TVariantValues& params, const util::TVariantValues& session, util::TVariantValues& headers, bool& zipped, bool& cached, int& error) {
+	// Realtime statistics of ALSA thread, values in microseconds
+	music::TAlsaStatistics stats;
+	player.getStatistics(stats);
+	util::TVariantValues response;
+	addHistogramValues(response, "Wakeup", stats.wakeup);
+	addHistogramValues(response, "Write", stats.write);
+	addHistogramValues(response, "Headroom", stats.headroom);
+	response.add("Underruns", stats.underrun);
+	response.add("Recoveries", stats.recovery);
+	for (size_t i=0; i<music::ALSA_UNDERRUN_LOCATIONS; ++i) {
+		if (stats.recoveries[i] > 0) {
+			response.add("Underruns" + std::to_string((size_u)i), stats.underruns[i]);
+			response.add("Recoveries" + std::to_string((size_u)i), stats.recoveries[i]);
+		}
+	}
+
+	// Start new measurement if requested
+	if (params["reset"].asBoolean(false))
+		player.resetStatistics();
+
+	// Build JSON response
+	jsonLatency = response.asJSON().text();
+	if (!jsonLatency.empty()) {
+		data = jsonLatency.c_str();
+		size = jsonLatency.size();
+	}
+
+	if (debug) aout << app::yellow << "TPlayer::getLatencyStatistics() JSON = " << jsonLatency << app::reset << endl;
+}
+
+
 void TPlayer::getRepeatModes(TThreadData& sender, const void*& data, size_t& size, const util::TVariantValues& params, const util::TVariantValues& session, util::TVariantValues& headers, bool& zipped, bool& cached, int& error) {
 
 	// Get current repeat modes
@@ -5855,7 +6322,7 @@ std::string TPlayer::listAsJSON(const util::TStringList& list, const std::string
 }
 
 
-void TPlayer::setMenuItem(html::PMenuItem item, const music::TArtistMap& artists, const size_t count, const std::string caption) {
+void TPlayer::setMenuItem(html::PMenuItem item, const music::TConstArtistList& artists, const size_t count, const std::string caption) {
 	if (util::assigned(item)) {
 		if (artists.empty()) {
 			item->setCaption(caption);
@@ -8773,7 +9240,10 @@ void TPlayer::updateLibrary(const bool aggressive) {
 
 				// Apply changes to internal database mappings
 				logger("[Scanner] Commit library changes.");
+				size_t before = sysutil::getCurrentMemoryUsage();
 				library.commit();
+				size_t after = sysutil::getCurrentMemoryUsage();
+				logger("[Scanner] Mapped " + std::to_string((size_u)library.albums()) + " albums for " + std::to_string((size_u)library.artists()) + " artists, resident memory " + util::sizeToStr(before) + " before and " + util::sizeToStr(after) + " after commit.");
 
 				// Rebuild or reload all playlists compared to current library content
 				if (aggressive) {
@@ -8831,6 +9301,9 @@ void TPlayer::updateLibrary(const bool aggressive) {
 		setScannerStatusLabel(false, songs, errors);
 		setErroneousHeader(errors);
 		invalidateScannerDislpay();
+
+		// Create thumbnails for new albums
+		startThumbnailGenerator();
 	}
 }
 
@@ -9243,7 +9716,7 @@ std::string TPlayer::addArtist(const std::string& artistName, const std::string&
 				music::EPlayListAction epa = sanitizePlayerAction(action, playlist);
 				music::TAlbumConstIterator at = it->second.albums.begin();
 				while (at != it->second.albums.end()) {
-					std::string albumHash = at->second.hash;
+					std::string albumHash = at->second->hash;
 					pls->removeAlbum(albumHash);
 					c += pls->addAlbum(albumHash, epa, false);
 					++at;
@@ -9474,6 +9947,11 @@ void TPlayer::onPlayerStateChanged(const music::TAlsaPlayer& sender, const music
 		*wtPlaylistCodec     = current->getCodec();
 		*wtPlaylistIcon      = current->getIcon();
 
+		// Warm up memory cache for current album thumbnails
+		if (sound.getThumbnailPreload()) {
+			queueThumbnailPreload(current->getAlbumHash());
+		}
+
 		// Send Telnet client broadcast
 		sendBroadcastMessage("CURRENT|" + getSongsStatusString(current, playlist, "|"));
 
@@ -9659,6 +10137,30 @@ void TPlayer::onFileUploadEvent(const app::TWebServer& sender, const util::TVari
 }
 
 void TPlayer::onWebStatisticsEvent(const app::TWebServer& sender, const app::TWebData&) {
+	// Update thumbnail memory cache statistics
+	if (util::assigned(wtThumbnailCache)) {
+		util::TFileCacheStatistics stats;
+		fileCache.getStatistics(stats);
+		*wtThumbnailCache = util::csnprintf("% files, % of %, % hits, % misses, % evictions", stats.files,
+				util::sizeToStr(stats.size), util::sizeToStr(stats.limit), stats.hits, stats.misses, stats.evictions);
+	}
+
+	// Update ALSA realtime thread statistics
+	if (util::assigned(wtAlsaLatency)) {
+		music::TAlsaStatistics stats;
+		player.getStatistics(stats);
+		*wtAlsaLatency = util::csnprintf("Wakeup p99 % us, write p99 % us, headroom min % us, % underruns, % recoveries",
+				stats.wakeup.p99, stats.write.p99, stats.headroom.min, stats.underrun, stats.recovery);
+	}
+
+	// Update internet stream jitter buffer statistics
+	if (util::assigned(wtStreamBuffer)) {
+		inet::TJitterStatistics stats;
+		radio.jitter.getStatistics(stats);
+		*wtStreamBuffer = util::csnprintf("% of % filled (% to %), prefill %, % stalls, % overruns", util::sizeToStr(stats.level), util::sizeToStr(stats.capacity),
+				util::sizeToStr(stats.minLevel), util::sizeToStr(stats.maxLevel), util::sizeToStr(stats.lowWatermark), stats.stalls, stats.overruns);
+	}
+
 	// Send brockast message to all connected websocket clients
 	broadcastWebSocketEvent("webserver","update");
 }
@@ -10540,11 +11042,17 @@ void TPlayer::setScannerStatusLabel(const bool scanning, const size_t size, cons
 						*wtScannerStatusCaption = util::csnprintf("Library is empty (<u>% files invalid</u>)", erroneous);
 					*wtScannerStatusColor = "label-warning";
 				} else {
-					if (size > 0)
-						*wtScannerStatusCaption = util::csnprintf("% songs in library", size);
-					else
-						*wtScannerStatusCaption = "Library is empty";
-					*wtScannerStatusColor = "label-default";
+					size_t done, count;
+					if (getThumbnailProgress(done, count)) {
+						*wtScannerStatusCaption = util::csnprintf("% songs in library, creating thumbnails for % of % albums...", size, done, count);
+						*wtScannerStatusColor = "label-info";
+					} else {
+						if (size > 0)
+							*wtScannerStatusCaption = util::csnprintf("% songs in library", size);
+						else
+							*wtScannerStatusCaption = "Library is empty";
+						*wtScannerStatusColor = "label-default";
+					}
 				}
 			}
 		}
@@ -10795,6 +11303,7 @@ void TPlayer::createInetStreamer() {
 			radio.stream.setDebug(debug); // !application.isDaemonized());
 			radio.stream.setTimeout(STREAM_TIMEOUT + 1);
 			radio.stream.setChunkSize(STREAM_BUFFER_SIZE);
+			radio.jitter.configure(sound.getStreamPrefillTime(), sound.getStreamBufferTime());
 
 			// Bind stream events
 			radio.stream.bindStreamDataEvent(&app::TPlayer::onInetStreamData, this);
@@ -10989,6 +11498,55 @@ bool TPlayer::prepareInetStream() {
 	return true;
 }
 
+void TPlayer::startInetDecoder() {
+	// Decode received stream data on separate thread
+	// --> Network receiver and decoder are decoupled by jitter buffer
+	radio.jitter.reset();
+	if (!createJoinableThread(radio.decoder, decoderThreadDispatcher, this, "Inet-Decoder")) {
+		throw util::sys_error("TPlayer::startInetDecoder() Create stream decoder thread failed.");
+	}
+}
+
+void TPlayer::stopInetDecoder() {
+	// Remaining data in jitter buffer is discarded
+	if (radio.decoder != 0) {
+		radio.jitter.close();
+		int retVal = terminateThread(radio.decoder);
+		if (util::checkFailed(retVal))
+			logger("[Streamer] Waiting for stream decoder thread failed.");
+		radio.decoder = 0;
+		inet::TJitterStatistics stats;
+		radio.jitter.getStatistics(stats);
+		logger(util::csnprintf("[Streamer] Jitter buffer level % to % of %, prefill %, % stalls, % overruns", util::sizeToStr(stats.minLevel),
+				util::sizeToStr(stats.maxLevel), util::sizeToStr(stats.capacity), util::sizeToStr(stats.lowWatermark), stats.stalls, stats.overruns));
+	}
+}
+
+int TPlayer::decoderThreadHandler() {
+	logger("[Streamer] Stream decoder thread started.");
+	std::vector<music::TSample> chunk(music::MP3_INPUT_CHUNK_SIZE);
+	try {
+		while (true) {
+			size_t size = radio.jitter.read(chunk.data(), chunk.size());
+			if (size <= 0)
+				break;
+			decodeInetStreamData(chunk.data(), size);
+		}
+	} catch (const std::exception& e) {
+		std::string sExcept = e.what();
+		std::string sText = "[Streamer] Exception in TPlayer::decoderThreadHandler() " + sExcept;
+		application.getExceptionLogger().write(sText);
+	} catch (...) {
+		std::string sText = "[Streamer] Unknown exception in TPlayer::decoderThreadHandler()";
+		application.getExceptionLogger().write(sText);
+	}
+
+	// Release receiver waiting on filled jitter buffer
+	radio.jitter.close();
+	logger("[Streamer] Stream decoder thread terminated.");
+	return EXIT_SUCCESS;
+}
+
 bool TPlayer::openInetStream(const music::ECodecType codec) {
 	bool result = false;
 	if (!radio.initialized) {
@@ -11226,6 +11784,7 @@ bool TPlayer::streamThreadMethod() {
 			if (!isTerminated()) {
 				if (EV_SIGNALED == ev) {
 					if (prepareInetStream()) {
+						startInetDecoder();
 						util::TTimePart bailout = STREAM_TIMEOUT + util::now();
 						size_t retry = 0;
 						std::string url;
@@ -11269,6 +11828,9 @@ bool TPlayer::streamThreadMethod() {
 
 							} while (!isTerminated() && !radio.error && !radio.stream.isTerminated() && retry < 5 && getStreamURL(url));
 
+							// Decoder must not start playback again after stop
+							stopInetDecoder();
+
 							// Stop ALSA playback
 							if (radio.playing) {
 								radio.playing = false;
@@ -11288,6 +11850,7 @@ bool TPlayer::streamThreadMethod() {
 						}
 
 						// Reset everything
+						stopInetDecoder();
 						finalizeInetStream(url);
 					}
 				}
@@ -11300,11 +11863,13 @@ bool TPlayer::streamThreadMethod() {
 		std::string sExcept = e.what();
 		std::string sText = "[Streamer] Exception in TPlayer::streamThreadMethod() " + sExcept;
 		application.getExceptionLogger().write(sText);
+		stopInetDecoder();
 		finalizeInetStream("");
 		exit = true;
 	} catch (...) {
 		std::string sText = "[Streamer] Unknown exception in TPlayer::streamThreadMethod()";
 		application.getExceptionLogger().write(sText);
+		stopInetDecoder();
 		finalizeInetStream("");
 		exit = true;
 	}
@@ -11314,6 +11879,19 @@ bool TPlayer::streamThreadMethod() {
 
 void TPlayer::onInetStreamData(const inet::TInetStream& sender, const void *const data, const size_t size) {
 	// logger(util::csnprintf("[Streamer] Received % bytes for URL $", size, sender.getURL()));
+	// Hand over received data to decoder thread, may block when jitter buffer is filled above high watermark
+	if (!radio.terminated) {
+		if (size > 0) {
+			radio.jitter.write(data, size);
+		} else {
+			logger("[Streamer] Error: No stream data received.");
+		}
+	} else {
+		logger("[Streamer] Stream already terminated.");
+	}
+}
+
+void TPlayer::decodeInetStreamData(const void *const data, const size_t size) {
 	bool ok = false;
 	if (!radio.terminated) {
 		if (size > 0) {
@@ -11487,7 +12065,7 @@ void TPlayer::onInetStreamData(const inet::TInetStream& sender, const void *cons
 								} else { // if (decoder->update(buffer, buffered, radio.buffer, read)) ...
 
 									// Input stream/decoder is on error
-									logger(util::csnprintf("[Streamer] Decoder update for stream failed (% bytes decoded)", radio.written));
+									logger(util::csnprintf("[Streamer] Decoder update for stream failed (% bytes decoded)", radio.written.load()));
 									if (util::isClass<music::TFLACDecoder>(decoder)) {
 										music::TFLACDecoder* flac = util::asClass<music::TFLACDecoder>(decoder);
 										if (flac->hasError()) {
@@ -11536,6 +12114,7 @@ void TPlayer::onInetStreamData(const inet::TInetStream& sender, const void *cons
 void TPlayer::onInetStreamInfo(const inet::TInetStream& sender, const inet::TStreamInfo& info) {
 	logger(util::csnprintf("[Streamer] Station $ received for stream $", info.name, info.stream));
 	logger(util::csnprintf("[Streamer] Bitrate % kBit/sec for stream $", info.bitrate, info.stream));
+	radio.jitter.setByteRate(info.bitrate * 1000 / 8);
 	setStreamInfo(info);
 }
 
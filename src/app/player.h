@@ -7,6 +7,7 @@
 #ifndef MAIN_H_
 #define MAIN_H_
 
+#include <atomic>
 #include "../inc/classes.h"
 #include "../inc/webtoken.h"
 #include "../inc/audiofile.h"
@@ -23,6 +24,8 @@
 #include "../inc/udev.h"
 #include "../inc/flac.h"
 #include "../inc/mp3.h"
+#include "../inc/filecache.h"
+#include "../inc/jitterbuffer.h"
 #include "../inc/ipc.h"
 #include "controltypes.h"
 #include "musicplayer.h"
@@ -54,15 +57,16 @@ STATIC_CONST size_t STREAM_TEXT_HISTORY_SIZE = 5;
 STATIC_CONST size_t STREAM_TIMEOUT = 5;
 STATIC_CONST size_t STREAM_BUFFER_SIZE = 1390; // Lower than PPPoE MTU 1492
 
+STATIC_CONST size_t THUMBNAIL_GENERATOR_MAX_THREADS = 4;
+STATIC_CONST size_t THUMBNAIL_GENERATOR_PROGRESS_STEP = 25;
+STATIC_CONST int THUMBNAIL_GENERATOR_NICE_LEVEL = 19;
+
 STATIC_CONST size_t MP3_BUFFERING_THRESHOLD = 44100 * 2 * 2 * 3; // = 44100 Samples/sec * 2 channels * 2 Byte (16 Bit / 8 Bit) * 3 sec
 
 STATIC_CONST ssize_t MAX_COMMAND_SIZE = 64;
 
 #ifdef STL_HAS_TEMPLATE_ALIAS
 
-using TFileCacheMap = std::map<std::string, util::PFile>;
-using TFileCacheItem = std::pair<std::string, util::PFile>;
-using TFileCacheInsert = std::pair<TFileCacheMap::iterator, bool>;
 using TMediaNames = std::map<std::string, music::EMediaType>;
 using TDomainNames = std::map<std::string, music::EFilterDomain>;
 using TCommandBuffer = util::TDataBuffer<TCommandData>;
@@ -73,9 +77,6 @@ using PLibraryThread = TLibraryThread*;
 
 #else
 
-typedef std::map<std::string, util::PFile> TFileCacheMap;
-typedef std::pair<std::string, util::PFile> TFileCacheItem;
-typedef std::pair<TFileCacheMap::iterator, bool> TFileCacheInsert;
 typedef std::map<std::string, music::EMediaType> TMediaNames;
 typedef std::map<std::string, music::EFilterDomain> TDomainNames;
 typedef util::TCommandBuffer<TCommandData> TBuffer;
@@ -96,6 +97,8 @@ typedef struct CDecoderState {
 	size_t softwareIdx;
 	size_t total;
 	bool buffered;
+	bool seeking;
+	bool waiting;
 	bool busy;
 	std::string message;
 	util::TDateTime time;
@@ -114,6 +117,8 @@ typedef struct CDecoderState {
 		buffer = nil;
 		total = 0;
 		busy = false;
+		seeking = false;
+		waiting = false;
 		buffered = false;
 	}
 
@@ -392,25 +397,29 @@ typedef struct CStreamCounters {
 
 typedef struct CRadioStream {
 	bool debug;
-	bool error;
 	bool started;
 	bool running;
 	bool streaming;
-	bool playing;
-	bool buffered;
 	bool terminated;
 	bool initialized;
-	size_t written;
-	size_t consumed;
+
+	// Shared by receiver, decoder and player threads
+	std::atomic<bool> error;
+	std::atomic<bool> playing;
+	std::atomic<bool> buffered;
+	std::atomic<size_t> written;
+	std::atomic<size_t> consumed;
 	size_t threshhold;
 	std::string hash;
 	std::string last;
 	std::string next;
 	pthread_t thread;
+	pthread_t decoder;
 	app::PTimeout limit;
 	app::PTimeout refresh;
 	app::PTimeout timeout;
 	inet::TInetStream stream;
+	inet::TJitterBuffer jitter;
 	music::TTrack* track;
 	music::TMP3Song* mpeg;
 	music::TFLACSong* flac;
@@ -436,6 +445,7 @@ typedef struct CRadioStream {
 		consumed = 0;
 		written = 0;
 		thread = 0;
+		decoder = 0;
 		track = nil;
 		mpeg = nil;
 		flac = nil;
@@ -464,6 +474,48 @@ typedef struct CRadioStream {
 } TRadioStream;
 
 
+typedef struct CThumbnailJob {
+	std::string hash;
+	std::string folder;
+} TThumbnailJob;
+
+#ifdef STL_HAS_TEMPLATE_ALIAS
+
+using TThumbnailJobList = std::vector<TThumbnailJob>;
+using TThumbnailThreadList = std::vector<pthread_t>;
+
+#else
+
+typedef std::vector<TThumbnailJob> TThumbnailJobList;
+typedef std::vector<pthread_t> TThumbnailThreadList;
+
+#endif
+
+typedef struct CThumbnailGenerator {
+	TThumbnailJobList jobs;
+	TThumbnailThreadList threads;
+	app::TMutex mtx;
+	size_t index;
+	size_t done;
+	size_t created;
+	size_t active;
+	bool running;
+
+	void clear() {
+		jobs.clear();
+		index = 0;
+		done = 0;
+		created = 0;
+		active = 0;
+		running = false;
+	}
+
+	CThumbnailGenerator() {
+		clear();
+	};
+} TThumbnailGenerator;
+
+
 typedef TWorkerThread<util::TByteBuffer> TSerialThread;
 
 
@@ -612,6 +664,9 @@ private:
 	PWebToken wtTableRowCount;
 	PWebToken wtStreamRadioText;
 	PWebToken wtActiveLicenses;
+	PWebToken wtThumbnailCache;
+	PWebToken wtAlsaLatency;
+	PWebToken wtStreamBuffer;
 	PWebToken wtWatchLimit;
 
 	html::PMainMenuItem playlistSelectItem;
@@ -654,6 +709,7 @@ private:
 	std::string jsonStations;
 	std::string jsonCurrent;
 	std::string jsonScanner;
+	std::string jsonLatency;
 	std::string jsonModes;
 	std::string jsonMode;
 	std::string jsonConfig;
@@ -682,7 +738,14 @@ private:
 	app::TActionMap actions;
 	app::TControlMap controls;
 	app::TCommandQueue queue;
-	TFileCacheMap fileCache;
+	util::TFileCache fileCache;
+	util::PFileCacheItem coverItem;
+	util::PFileCacheItem thumbItem;
+	app::TDetachedThread preloadThread;
+	app::TMutex preloadMtx;
+	std::string preloadHash;
+	bool preloadRunning;
+	TThumbnailGenerator thumbnails;
 	std::string coverCache;
 
 	PLibraryThread libraryThread;
@@ -752,7 +815,6 @@ private:
 	bool parseRemoteStatusData(util::TByteBuffer& data);
 	void testRemoteParserData();
 	void removeDevelFiles();
-	void freeLocalFileCache();
 	void checkApplicationLicenses();
 	void checkApplicationLicensesWithNolock();
 	bool applyApplicationLicense(const std::string& name, const std::string& value);
@@ -799,7 +861,7 @@ private:
 	void updateComboBoxes(const music::CConfigValues& values, const std::string& limit, const std::string& period, const std::string& rows);
 	void updateSerialDevices(const music::CRemoteValues& values);
 	void updateLibraryMediaItems();
-	void setMenuItem(html::PMenuItem item, const music::TArtistMap& artists, const size_t count, const std::string caption);
+	void setMenuItem(html::PMenuItem item, const music::TConstArtistList& artists, const size_t count, const std::string caption);
 	bool updateScannerStatus();
 	void suspend(TGlobalState& global);
 	void upcall(TGlobalState& global);
@@ -807,6 +869,8 @@ private:
 	void logger(const std::string& text) const;
 
 	bool getBufferSize(const music::PSong song, size_t& free, size_t& size);
+	size_t getDecodeAheadSize(const music::PSong song);
+	void preloadEncodedSongs(TGlobalState& global, const music::PPlaylist playlist);
 	int unlinkSong(const std::string& fileHash, const std::string& albumHash, const std::string& playlist);
 	void saveCurrentSong(const music::TSong* song, const std::string& playlist) const;
 	void loadCurrentSong(music::TSong*& song, std::string& playlist);
@@ -878,6 +942,8 @@ private:
 	void createInetStreamer();
 	void destroyInetStreamer();
 	bool prepareInetStream();
+	void startInetDecoder();
+	void stopInetDecoder();
 	bool openInetStream(const music::ECodecType codec);
 	void resetInetStream();
 	bool delayInetStream();
@@ -904,6 +970,7 @@ private:
 	bool splitRadioText(const std::string& title, const radio::EMetadataOrder order, std::string& artist, std::string& track);
 
 	void onInetStreamData(const inet::TInetStream& sender, const void *const data, const size_t size);
+	void decodeInetStreamData(const void *const data, const size_t size);
 	void onInetStreamInfo(const inet::TInetStream& sender, const inet::TStreamInfo& info);
 	void onInetStreamTitle(const inet::TInetStream& sender, const std::string& title);
 	void onInetStreamError(const inet::TInetStream& sender, const int error, const std::string& text, bool& terminate);
@@ -1080,6 +1147,7 @@ private:
 	void getStations(TThreadData& sender, const void*& data, size_t& size, const util::TVariantValues& params, const util::TVariantValues& session, util::TVariantValues& headers, bool& zipped, bool& cached, int& error);
 	void getPlayerState(TThreadData& sender, const void*& data, size_t& size, const util::TVariantValues& params, const util::TVariantValues& session, util::TVariantValues& headers, bool& zipped, bool& cached, int& error);
 	void getScannerState(TThreadData& sender, const void*& data, size_t& size, const util::TVariantValues& params, const util::TVariantValues& session, util::TVariantValues& headers, bool& zipped, bool& cached, int& error);
+	void getLatencyStatistics(TThreadData& sender, const void*& data, size_t& size, const util::TVariantValues& params, const util::TVariantValues& session, util::TVariantValues& headers, bool& zipped, bool& cached, int& error);
 	void getRepeatModes(TThreadData& sender, const void*& data, size_t& size, const util::TVariantValues& params, const util::TVariantValues& session, util::TVariantValues& headers, bool& zipped, bool& cached, int& error);
 	void getPlayerMode(TThreadData& sender, const void*& data, size_t& size, const util::TVariantValues& params, const util::TVariantValues& session, util::TVariantValues& headers, bool& zipped, bool& cached, int& error);
 	void getPlayerConfig(TThreadData& sender, const void*& data, size_t& size, const util::TVariantValues& params, const util::TVariantValues& session, util::TVariantValues& headers, bool& zipped, bool& cached, int& error);
@@ -1112,9 +1180,19 @@ private:
 	std::string getNocoverFileName(const size_t dimension, const std::string& cache);
 	std::string getSpecialFileName(const size_t dimension, const std::string& cache);
 	std::string getCachedFileName(const std::string& fileHash, const size_t dimension, const std::string& cache);
-	bool getThumbFromCache(const std::string& fileName, const void*& data, size_t& size);
+	bool getThumbFromCache(const std::string& fileName, util::PFileCacheItem& item, const void*& data, size_t& size);
+	void preloadThumbnails(const std::string& fileHash);
+	void queueThumbnailPreload(const std::string& fileHash);
+	void preloadThreadMethod(app::TDetachedThread& thread);
 	std::string getThumbFile(const std::string& fileHash, const std::string& folder, const size_t dimension, const std::string& cache, const bool special);
 	std::string getThumbFile(util::TJpeg& jpg, const std::string& fileHash, const std::string& folder, const size_t dimension, const std::string& cache, const bool special);
+	bool loadCoverArt(util::TJpeg& cover, const std::string& fileHash, const std::string& folder, const size_t dimension);
+	bool createThumbFile(util::TJpeg& thumbnail, const std::string& file, const size_t dimension, const bool nocover);
+	size_t createThumbnails(const TThumbnailJob& job);
+	void startThumbnailGenerator();
+	void terminateThumbnailGenerator();
+	bool getNextThumbnailJob(TThumbnailJob& job);
+	bool getThumbnailProgress(size_t& done, size_t& count);
 	std::string findFileName(const std::string& path, const std::string& file);
 	void createCacheFolders(const std::string& cachePath);
 	void deleteCachedFiles(const std::string& fileHash);
@@ -1143,6 +1221,8 @@ private:
 
 public:
 	int streamThreadHandler();
+	int decoderThreadHandler();
+	int thumbnailThreadHandler();
 
 	int execute();
 	void cleanup();
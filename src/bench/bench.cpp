@@ -0,0 +1,97 @@
+/* ============================================================================ *
+ * Name        : bench.cpp
+ * Author      : Dirk Brinkmeier
+ * Date        : 17.10.2026
+ * Description : Benchmarks for performance critical parts of the music player
+ *               Build with "make build/rmpbench", not installed
+ *               Usage: rmpbench <benchmark> [name=value ...]
+ * ============================================================================ */
+
+/*
+ * Standard header files
+ */
+#include <string.h>
+#include <iostream>
+#include "../inc/application.h"
+#include "../inc/localization.h"
+#include "../inc/translation.h"
+#include "../inc/system.h"
+
+/*
+ * Benchmark header files
+ */
+#include "benchtypes.h"
+#include "benchaudio.h"
+#include "benchfile.h"
+#include "benchlibrary.h"
+#include "benchweb.h"
+
+using namespace app;
+using namespace bench;
+
+/*
+ * Instantiate system data for linked framework modules
+ */
+TSystemData sysdat;
+TApplication application;
+TLocale syslocale(ELT_SYSTEM);
+TTranslator nls;
+
+/*
+ * List of benchmarks
+ */
+static const TBenchmark benchmarks[] = {
+	{ "pack", "Pack planar decoder output into interleaved 16/24/32 bit samples", packBenchmark },
+	{ "dop", "Convert DSD to DoP byte order for DSF and DFF layouts", dopBenchmark },
+	{ "dither", "Upscale 16 bit samples with dither per period (bits=<24|32> period=<ms> rates=<n,...>)", ditherBenchmark },
+	{ "resample", "Polyphase resampler THD+N and realtime factor for 44.1/48 kHz conversions", resampleBenchmark },
+	{ "buffer", "Memory per hour of music and decoder CPU load for buffer modes (path=<dir> files=<n> memory=<MB>)", bufferBenchmark },
+	{ "readahead", "Decoder reads from simulated network storage (latency=<ms> bandwidth=<MB/s> size=<MB> read=<KB>)", readAheadBenchmark },
+	{ "database", "Library startup from CSV file and binary database (songs=<n,...> path=<dir> keep)", databaseBenchmark },
+	{ "search", "Album search by trigram index against linear scan (songs=<n> query=<text>)", searchBenchmark },
+	{ "transfer", "Web server file transfer by sendfile() and buffered callback (path=<dir> size=<MB> clients=<n> requests=<n> threading=<mode> port=<n>)", transferBenchmark },
+	{ "threading", "Web server requests/s and p99 latency per threading mode (modes=<name,...> clients=<n> requests=<n> size=<kB> reuse=<0|1>)", threadingBenchmark },
+};
+
+static const size_t count = sizeof(benchmarks) / sizeof(TBenchmark);
+
+static void usage(const char* name) {
+	std::cout << "Usage: " << name << " <benchmark> [name=value ...]" << std::endl << std::endl;
+	std::cout << "Benchmarks:" << std::endl;
+	std::cout << "  all         Run all benchmarks" << std::endl;
+	for (size_t i=0; i<count; ++i) {
+		std::cout << "  " << benchmarks[i].name << std::string(12 - strlen(benchmarks[i].name), ' ') << benchmarks[i].description << std::endl;
+	}
+	std::cout << std::endl << "Common arguments:" << std::endl;
+	std::cout << "  duration=<ms>  Minimum run time of each measurement (default " << BENCH_DEFAULT_DURATION << " ms)" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+	if (argc < 2) {
+		usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	TBenchmarkArguments args;
+	args.parse(argc - 2, argv + 2);
+
+	int result = EXIT_FAILURE;
+	bool found = false;
+	for (size_t i=0; i<count; ++i) {
+		if (0 == strcmp(argv[1], benchmarks[i].name) || 0 == strcmp(argv[1], "all")) {
+			found = true;
+			try {
+				result = benchmarks[i].method(args);
+			} catch (const std::exception& e) {
+				std::cout << "Benchmark \"" << benchmarks[i].name << "\" failed: " << e.what() << std::endl;
+				result = EXIT_FAILURE;
+			}
+		}
+	}
+
+	if (!found) {
+		usage(argv[0]);
+	}
+
+	return result;
+}
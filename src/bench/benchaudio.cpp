@@ -0,0 +1,607 @@
+/*
+ * benchaudio.cpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: Dirk Brinkmeier
+ */
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string.h>
+#include "benchaudio.h"
+#include "../inc/audiobuffer.h"
+#include "../inc/samples.h"
+#include "../inc/bits.h"
+#include "../inc/stringutils.h"
+#include "../inc/fileutils.h"
+#include "../inc/audioconsts.h"
+#include "../inc/random.h"
+#include "../inc/alsa.h"
+#include "../inc/resampler.h"
+#include "../app/library.h"
+
+namespace bench {
+
+STATIC_CONST size_t PACK_BLOCK_FRAMES = 4096; // Typical FLAC block size
+STATIC_CONST size_t PACK_BLOCK_COUNT = 16;    // Blocks written before the buffer is rewound
+STATIC_CONST size_t PACK_CHANNELS = 2;
+STATIC_CONST size_t DSD_BLOCK_SIZE = 4096;  // DSF block size per channel
+STATIC_CONST size_t DSD_CHUNK_COUNT = 64;   // Chunks converted before the output buffer is rewound
+STATIC_CONST size_t DSD_BASE_RATE = 2822400; // DSD64 bit rate per channel
+STATIC_CONST int64_t DITHER_PERIOD_TIME = 1000; // Default ALSA period time in milliseconds
+STATIC_CONST double RESAMPLE_AMPLITUDE = 0.891250938; // Test tone level of -1 dBFS
+STATIC_CONST size_t DECODE_BUFFER_SIZE = 16 * 1024 * 1024; // Smallest buffer size used by TAudioBufferList
+
+static const music::ESampleKernel sampleKernels[] = { music::ESK_SCALAR, music::ESK_SSE2, music::ESK_AVX2, music::ESK_NEON };
+
+static uint32_t nextRandom(uint32_t& state) {
+	state = state * 1664525 + 1013904223;
+	return state;
+}
+
+static void fillPlanarSamples(std::vector<int32_t>& samples, const size_t bitsPerSample) {
+	uint32_t state = 0x5EED;
+	for (size_t i=0; i<samples.size(); ++i) {
+		// Sign extended random sample of given bit size
+		int32_t value = (int32_t)nextRandom(state);
+		samples[i] = value >> (32 - bitsPerSample);
+	}
+}
+
+static void writeSamples(music::TAudioBuffer& buffer, const int32_t* const planar[], const size_t frames, const size_t bitsPerSample, const util::EEndianType endian) {
+	// Per sample writer as used by decoders before bulk packing
+	for (size_t i=0; i<frames; ++i) {
+		for (size_t c=0; c<PACK_CHANNELS; ++c) {
+			switch (bitsPerSample) {
+				case 16:
+					buffer.write16Bit((int16_t)(planar[c][i] & (uint16_t)-1), endian);
+					break;
+				case 24:
+					buffer.write24Bit(planar[c][i], endian);
+					break;
+				case 32:
+					buffer.write32Bit(planar[c][i], endian);
+					break;
+			}
+		}
+	}
+}
+
+static void printPackResult(const std::string& method, const size_t bitsPerSample, const util::EEndianType endian, const uint64_t bytes, const int64_t duration, const bool valid = true) {
+	std::cout << util::cprintf("%-16s %2d bit %-6s %10.1f MB/s%s", method.c_str(), (int)bitsPerSample,
+			endian == util::EE_BIG_ENDIAN ? "BE" : "LE", getThroughput(bytes, duration), valid ? "" : "  (output differs from sample writer)") << std::endl;
+}
+
+int packBenchmark(const TBenchmarkArguments& args) {
+	const int64_t duration = args.getDuration();
+	const size_t bitDepths[] = { 16, 24, 32 };
+	const util::EEndianType endians[] = { util::EE_LITTLE_ENDIAN, util::EE_BIG_ENDIAN };
+	const music::ESampleKernel detected = music::getSampleKernel();
+
+	printHeader(util::csnprintf("Pack % planar channels of % frames into interleaved samples", PACK_CHANNELS, PACK_BLOCK_FRAMES));
+	std::cout << "Throughput is given for interleaved output bytes." << std::endl;
+	std::cout << "Detected sample kernel is " << music::sampleKernelToStr(detected) << std::endl << std::endl;
+
+	std::vector<int32_t> left(PACK_BLOCK_FRAMES);
+	std::vector<int32_t> right(PACK_BLOCK_FRAMES);
+	const int32_t* const planar[PACK_CHANNELS] = { left.data(), right.data() };
+
+	music::TAudioBuffer buffer;
+	buffer.resize(PACK_BLOCK_COUNT * PACK_BLOCK_FRAMES * PACK_CHANNELS * sizeof(int32_t));
+
+	for (size_t bitsPerSample : bitDepths) {
+		fillPlanarSamples(left, bitsPerSample);
+		fillPlanarSamples(right, bitsPerSample);
+		const size_t blockSize = PACK_BLOCK_FRAMES * PACK_CHANNELS * bitsPerSample / 8;
+
+		for (util::EEndianType endian : endians) {
+			size_t loops = 0;
+			size_t blocks = 0;
+
+			// Per sample writer
+			buffer.reset();
+			int64_t elapsed = measure(duration, loops, [&] () {
+				if (++blocks > PACK_BLOCK_COUNT) {
+					buffer.resetWriter();
+					blocks = 1;
+				}
+				writeSamples(buffer, planar, PACK_BLOCK_FRAMES, bitsPerSample, endian);
+			});
+			printPackResult("Sample writer", bitsPerSample, endian, (uint64_t)loops * blockSize, elapsed);
+			std::vector<music::TSample> reference(buffer.data(), buffer.data() + blockSize);
+
+			// Bulk writer for all available kernels
+			for (music::ESampleKernel kernel : sampleKernels) {
+				music::setSampleKernel(kernel);
+				if (music::getSampleKernel() != kernel)
+					continue;
+				blocks = 0;
+				buffer.reset();
+				elapsed = measure(duration, loops, [&] () {
+					if (++blocks > PACK_BLOCK_COUNT) {
+						buffer.resetWriter();
+						blocks = 1;
+					}
+					buffer.writePlanar(planar, PACK_CHANNELS, PACK_BLOCK_FRAMES, bitsPerSample, endian);
+				});
+				bool valid = 0 == memcmp(buffer.data(), reference.data(), blockSize);
+				printPackResult("Planar " + music::sampleKernelToStr(kernel), bitsPerSample, endian, (uint64_t)loops * blockSize, elapsed, valid);
+			}
+			music::setSampleKernel(detected);
+		}
+		std::cout << std::endl;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+static size_t convertDSDBytes(const music::TSample* dsd, music::TSample* dop, const size_t size, const size_t offset, const bool reverse) {
+	// Byte wise conversion as used by the DSD decoders before block conversion
+	size_t i = 0, idx = 0, written = 0;
+	music::TSample LC1, RC1, LC2, RC2;
+	const music::TSample* p = dsd;
+	while (i < size) {
+		if (offset > 1) {
+			LC1 = reverse ? util::bitReverse(dsd[idx]) : dsd[idx];
+			RC1 = reverse ? util::bitReverse(dsd[idx + offset]) : dsd[idx + offset];
+			++idx;
+			LC2 = reverse ? util::bitReverse(dsd[idx]) : dsd[idx];
+			RC2 = reverse ? util::bitReverse(dsd[idx + offset]) : dsd[idx + offset];
+			++idx;
+		} else {
+			LC1 = reverse ? util::bitReverse(*p++) : *p++;
+			RC1 = reverse ? util::bitReverse(*p++) : *p++;
+			LC2 = reverse ? util::bitReverse(*p++) : *p++;
+			RC2 = reverse ? util::bitReverse(*p++) : *p++;
+		}
+		*dop++ = LC2;
+		*dop++ = LC1;
+		*dop++ = RC2;
+		*dop++ = RC1;
+		i += 4;
+		written += 4;
+	}
+	return written;
+}
+
+static void printDoPResult(const std::string& method, const std::string& layout, const uint64_t bytes, const int64_t duration, const bool valid) {
+	double throughput = getThroughput(bytes, duration);
+	std::string result = util::cprintf("%-16s %-16s %9.1f MB/s", method.c_str(), layout.c_str(), throughput);
+
+	// Realtime factor for stereo DSD64 to DSD512
+	for (size_t multiplier = 1; multiplier <= 8; multiplier *= 2) {
+		double rate = (double)(DSD_BASE_RATE * multiplier) * 2.0 / 8.0 / 1000000.0;
+		result += util::cprintf("  %7.0fx", throughput / rate);
+	}
+	if (!valid)
+		result += "  (output differs from byte loop)";
+	std::cout << result << std::endl;
+}
+
+int dopBenchmark(const TBenchmarkArguments& args) {
+	const int64_t duration = args.getDuration();
+	const size_t chunkSize = 2 * DSD_BLOCK_SIZE;
+	const music::ESampleKernel detected = music::getSampleKernel();
+
+	printHeader(util::csnprintf("Convert stereo DSD chunks of % bytes to DoP byte order", chunkSize));
+	std::cout << "Throughput is given for DSD input bytes, followed by the realtime factor for stereo DSD64 to DSD512." << std::endl;
+	std::cout << "Detected sample kernel is " << music::sampleKernelToStr(detected) << std::endl << std::endl;
+	std::cout << util::cprintf("%-16s %-16s %14s  %8s  %8s  %8s  %8s", "Method", "Layout", "Throughput", "DSD64", "DSD128", "DSD256", "DSD512") << std::endl;
+
+	std::vector<music::TSample> dsd(chunkSize);
+	uint32_t state = 0xD5D;
+	for (size_t i=0; i<dsd.size(); ++i) {
+		dsd[i] = (music::TSample)(nextRandom(state) >> 24);
+	}
+	std::vector<music::TSample> dop(DSD_CHUNK_COUNT * chunkSize);
+	std::vector<music::TSample> reference(chunkSize);
+
+	// Planar LSB first blocks (DSF) and interleaved MSB first bytes (DFF)
+	struct CLayout { const char* name; size_t offset; bool reverse; };
+	const CLayout layouts[] = { { "DSF planar", DSD_BLOCK_SIZE, true }, { "DFF interleaved", 1, false } };
+
+	for (const CLayout& layout : layouts) {
+		size_t loops = 0;
+		size_t chunks = 0;
+
+		// Previous byte wise conversion
+		int64_t elapsed = measure(duration, loops, [&] () {
+			if (chunks >= DSD_CHUNK_COUNT)
+				chunks = 0;
+			convertDSDBytes(dsd.data(), dop.data() + chunks * chunkSize, chunkSize, layout.offset, layout.reverse);
+			++chunks;
+		});
+		printDoPResult("Byte loop", layout.name, (uint64_t)loops * chunkSize, elapsed, true);
+		memcpy(reference.data(), dop.data(), chunkSize);
+
+		// Block conversion for all available kernels
+		for (music::ESampleKernel kernel : sampleKernels) {
+			music::setSampleKernel(kernel);
+			if (music::getSampleKernel() != kernel)
+				continue;
+			chunks = 0;
+			memset(dop.data(), 0, chunkSize);
+			elapsed = measure(duration, loops, [&] () {
+				if (chunks >= DSD_CHUNK_COUNT)
+					chunks = 0;
+				music::convertDSDSamples(dop.data() + chunks * chunkSize, dsd.data(), chunkSize, layout.offset, layout.reverse);
+				++chunks;
+			});
+			bool valid = 0 == memcmp(dop.data(), reference.data(), chunkSize);
+			printDoPResult("Block " + music::sampleKernelToStr(kernel), layout.name, (uint64_t)loops * chunkSize, elapsed, valid);
+		}
+		music::setSampleKernel(detected);
+	}
+
+	return EXIT_SUCCESS;
+}
+
+static bool decodeSong(music::PSong song, music::TAudioBuffer& buffer, size_t& decoded, int64_t& cpu, int64_t& elapsed) {
+	// Decode whole song the same way as the player decoder thread
+	// --> Buffer is rewound when the next chunk would exhaust the buffer
+	decoded = 0;
+	cpu = elapsed = 0;
+	music::PAudioStream stream = song->getStream();
+	if (!util::assigned(stream))
+		return false;
+	int64_t start = getMicroSeconds();
+	int64_t used = getCPUTime();
+	stream->open(song);
+	if (!stream->isOpen())
+		return false;
+	size_t chunk = song->getChunkSize();
+	size_t read;
+	bool ok = true;
+	music::TTrack track;
+	track.setSong(song);
+	buffer.reset();
+	buffer.setTrack(&track);
+	while (ok && !stream->isEOF()) {
+		read = 0;
+		ok = stream->update(&buffer, read) && !stream->hasError();
+		decoded += read;
+		if (read > chunk)
+			chunk = read;
+		if ((buffer.getWritten() + 2 * chunk + 1) >= buffer.size())
+			buffer.resetWriter();
+	}
+	stream->close();
+	buffer.setTrack(nil);
+	cpu = getCPUTime() - used;
+	elapsed = getMicroSeconds() - start;
+	return ok;
+}
+
+static double getHourlySize(const uint64_t bytes, const double seconds) {
+	return seconds > 0.0 ? (double)bytes * 3600.0 / seconds / 1048576.0 : 0.0;
+}
+
+int bufferBenchmark(const TBenchmarkArguments& args) {
+	const std::string path = args.getValue("path", "");
+	const size_t limit = (size_t)args.getInteger("files", 50);
+	const size_t memory = (size_t)args.getInteger("memory", 1024);
+
+	printHeader("Memory per hour of music and decoder CPU load for decoded and compressed buffer mode");
+	if (path.empty() || !util::folderExists(path)) {
+		std::cout << "Music folder \"" << path << "\" not found, use path=<folder> to select FLAC, ALAC, WAV, AIFF or DSD files." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	app::TStringVector files;
+	util::readDirektory(util::validPath(path), files, util::SD_RECURSIVE);
+	std::sort(files.begin(), files.end());
+
+	music::TLibrary library;
+	music::TAudioBuffer buffer;
+	buffer.resize(DECODE_BUFFER_SIZE);
+
+	double seconds = 0.0;
+	uint64_t encoded = 0;
+	uint64_t decoded = 0;
+	int64_t cpu = 0;
+	int64_t elapsed = 0;
+	size_t songs = 0;
+
+	std::cout << util::cprintf("  %-40s %9s %10s %10s %9s %8s", "File", "Duration", "Encoded", "Decoded", "CPU", "Load") << std::endl;
+	for (const std::string& file : files) {
+		if (songs >= limit)
+			break;
+		music::ECodecType type = music::TSong::getFileType(file);
+		if (type == music::EFT_UNKNOWN || type == music::EFT_MP3 || type == music::EFT_AAC)
+			continue;
+		music::PSong song = library.addFile(file);
+		if (!util::assigned(song) || song->getDuration() <= 0)
+			continue;
+
+		size_t bytes;
+		int64_t used, time;
+		if (!decodeSong(song, buffer, bytes, used, time)) {
+			std::cout << "  Decoding " << file << " failed." << std::endl;
+			continue;
+		}
+
+		// Decoded size is taken from the decoder output, DSD files are converted to DoP or native DSD
+		double duration = (double)song->getDuration();
+		std::string name = util::fileBaseName(file);
+		if (name.size() > 40)
+			name = name.substr(0, 37) + "...";
+		std::cout << util::cprintf("  %-40s %7.0f s %7.1f MB %7.1f MB %6.0f ms %7.2f %%", name.c_str(), duration,
+				(double)song->getFileSize() / 1048576.0, (double)bytes / 1048576.0, (double)used / 1000.0, (double)used / duration / 10000.0) << std::endl;
+
+		seconds += duration;
+		encoded += song->getFileSize();
+		decoded += bytes;
+		cpu += used;
+		elapsed += time;
+		++songs;
+	}
+
+	if (songs == 0 || seconds <= 0.0) {
+		std::cout << "No playable files found in " << path << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	// Hours of music held in the given buffer memory
+	// --> Compressed mode keeps the decode-ahead ring in the remaining part of the memory
+	double decodedHourly = getHourlySize(decoded, seconds);
+	double encodedHourly = getHourlySize(encoded, seconds);
+	double decodedHours = decodedHourly > 0.0 ? (double)memory / decodedHourly : 0.0;
+	double encodedHours = encodedHourly > 0.0 ? (double)memory * (double)music::ENCODED_BUFFER_PERCENT / 100.0 / encodedHourly : 0.0;
+
+	std::cout << std::endl << util::csnprintf("% files with % of music:", songs, util::cprintf("%.1f min", seconds / 60.0)) << std::endl;
+	std::cout << util::cprintf("  %-40s %9.1f MB", "Decoded buffer mode per hour", decodedHourly) << std::endl;
+	std::cout << util::cprintf("  %-40s %9.1f MB", "Compressed buffer mode per hour", encodedHourly) << std::endl;
+	std::cout << util::cprintf("  %-40s %9.2f h decoded, %.2f h compressed (%zu%% for encoded files)", util::csnprintf("Music held in % MB", memory).c_str(),
+			decodedHours, encodedHours, music::ENCODED_BUFFER_PERCENT) << std::endl;
+	std::cout << util::cprintf("  %-40s %9.1f s per hour of music, %.2f %% of one core", "Decoder CPU time",
+			(double)cpu / seconds * 3600.0 / 1000000.0, (double)cpu / seconds / 10000.0) << std::endl;
+	std::cout << util::cprintf("  %-40s %9.1fx realtime", "Decoder speed", (double)seconds * 1000000.0 / (double)elapsed) << std::endl;
+	std::cout << "Both modes decode the same amount of audio, compressed mode decodes it just in time during playback." << std::endl;
+
+	return EXIT_SUCCESS;
+}
+
+class TDitherConverter : public music::TPCMConverter {
+public:
+	void setSpectrum(const music::EDitherSpectrum value) { generator.setSpectrum(value); };
+};
+
+static void writeRandomized(const music::TSample* src, music::TSample* dst, const size_t frames, const size_t bitsPerSample) {
+	// Random low byte for each sample as written before the block dither generator
+	const size_t fill = bitsPerSample / 8 - 2;
+	for (size_t i=0; i<frames * 2; ++i) {
+		for (size_t j=0; j<fill; ++j) {
+			*(dst++) = (music::TSample)util::randomize(0, 255);
+		}
+		*(dst++) = *(src++);
+		*(dst++) = *(src++);
+	}
+}
+
+static void printDitherResult(const std::string& method, const size_t rate, const size_t frames, const int64_t elapsed, const size_t loops, const int64_t period) {
+	double time = (double)elapsed / (double)loops;
+	std::cout << util::cprintf("  %6.1f kHz %8zu frames  %-20s %10.1f us %8.2f ns/frame %8.3f %% of period", (double)rate / 1000.0, frames,
+			method.c_str(), time, time * 1000.0 / (double)frames, time * 100.0 / (double)period) << std::endl;
+}
+
+int ditherBenchmark(const TBenchmarkArguments& args) {
+	const int64_t duration = args.getDuration();
+	const int64_t period = args.getInteger("period", DITHER_PERIOD_TIME) * 1000;
+	const size_t bitsPerSample = 32 == args.getInteger("bits", 24) ? 32 : 24;
+	const TBenchmarkIntegers rates = args.getIntegers("rates", { 44100, 48000, 88200, 96000, 176400, 192000, 352800, 384000 });
+
+	struct CSpectrum { const char* name; music::EDitherSpectrum spectrum; };
+	const CSpectrum spectrums[] = { { "Flat TPDF", music::EDS_FLAT }, { "First order TPDF", music::EDS_FIRST }, { "Second order TPDF", music::EDS_SECOND } };
+
+	printHeader(util::csnprintf("Upscale stereo 16 bit samples to % bit with dither for one period of % ms", bitsPerSample, period / 1000));
+	std::cout << "Previous random byte dither against the block TPDF dither generator, plain conversion without dither as reference." << std::endl;
+
+	TDitherConverter converter;
+	for (int64_t value : rates) {
+		if (value <= 0)
+			continue;
+		const size_t rate = (size_t)value;
+		const size_t frames = (size_t)((int64_t)rate * period / 1000000);
+		if (frames == 0)
+			continue;
+
+		std::vector<music::TSample> source(frames * 2 * 2);
+		uint32_t state = (uint32_t)rate;
+		for (size_t i=0; i<source.size(); ++i) {
+			source[i] = (music::TSample)(nextRandom(state) >> 24);
+		}
+		std::vector<music::TSample> output(frames * 2 * bitsPerSample / 8);
+
+		std::cout << std::endl;
+		size_t loops = 0;
+		size_t read = 0;
+		int64_t elapsed = measure(duration, loops, [&] () {
+			music::TSample* dst = output.data();
+			if (bitsPerSample == 24)
+				converter.write16to24Bit(source.data(), dst, read, frames, util::EE_LITTLE_ENDIAN, false);
+			else
+				converter.write16to32Bit(source.data(), dst, read, frames, util::EE_LITTLE_ENDIAN, false);
+		});
+		printDitherResult("No dither", rate, frames, elapsed, loops, period);
+
+		elapsed = measure(duration, loops, [&] () {
+			writeRandomized(source.data(), output.data(), frames, bitsPerSample);
+		});
+		printDitherResult("Random byte", rate, frames, elapsed, loops, period);
+
+		for (const CSpectrum& spectrum : spectrums) {
+			converter.setSpectrum(spectrum.spectrum);
+			elapsed = measure(duration, loops, [&] () {
+				music::TSample* dst = output.data();
+				if (bitsPerSample == 24)
+					converter.write16to24Bit(source.data(), dst, read, frames, util::EE_LITTLE_ENDIAN, true);
+				else
+					converter.write16to32Bit(source.data(), dst, read, frames, util::EE_LITTLE_ENDIAN, true);
+			});
+			printDitherResult(spectrum.name, rate, frames, elapsed, loops, period);
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
+
+static void fillSine(std::vector<music::TSample>& data, const size_t frames, const int rate, const double frequency) {
+	// Stereo 24 bit little endian sine with same phase on both channels
+	data.resize(frames * 2 * 3);
+	music::TSample* p = data.data();
+	for (size_t i=0; i<frames; ++i) {
+		int32_t value = (int32_t)lround(RESAMPLE_AMPLITUDE * 8388607.0 * sin(2.0 * M_PI * frequency * (double)i / (double)rate));
+		for (size_t c=0; c<2; ++c) {
+			*(p++) = (music::TSample)(value & 0xFF);
+			*(p++) = (music::TSample)((value >> 8) & 0xFF);
+			*(p++) = (music::TSample)((value >> 16) & 0xFF);
+		}
+	}
+}
+
+static bool getSineFit(const std::vector<music::TSample>& data, const int rate, const double frequency, double& noise, double& gain) {
+	// Least squares fit of sine, cosine and offset at the known frequency to the left channel
+	// --> Residual of the fit is distortion and noise (THD+N), 10% at both ends are skipped for filter settling
+	const size_t frames = data.size() / 6;
+	const size_t first = frames / 10;
+	const size_t last = frames - first;
+	if (last <= first)
+		return false;
+	std::vector<double> samples(last - first);
+	for (size_t i=first; i<last; ++i) {
+		const music::TSample* p = data.data() + i * 6;
+		int32_t value = p[0] | (p[1] << 8) | (p[2] << 16);
+		if (value & 0x800000)
+			value -= 0x1000000;
+		samples[i - first] = (double)value / 8388608.0;
+	}
+
+	double m[3][3] = { { 0.0 } };
+	double v[3] = { 0.0 };
+	const double w = 2.0 * M_PI * frequency / (double)rate;
+	for (size_t i=0; i<samples.size(); ++i) {
+		double b[3] = { sin(w * (double)(i + first)), cos(w * (double)(i + first)), 1.0 };
+		for (size_t j=0; j<3; ++j) {
+			for (size_t k=0; k<3; ++k)
+				m[j][k] += b[j] * b[k];
+			v[j] += b[j] * samples[i];
+		}
+	}
+
+	// Solve 3x3 system by Cramer's rule
+	double det = m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) - m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) + m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+	if (std::abs(det) < 1e-12)
+		return false;
+	double x[3];
+	for (size_t j=0; j<3; ++j) {
+		double a[3][3];
+		memcpy(a, m, sizeof(a));
+		for (size_t k=0; k<3; ++k)
+			a[k][j] = v[k];
+		x[j] = (a[0][0] * (a[1][1] * a[2][2] - a[1][2] * a[2][1]) - a[0][1] * (a[1][0] * a[2][2] - a[1][2] * a[2][0]) + a[0][2] * (a[1][0] * a[2][1] - a[1][1] * a[2][0])) / det;
+	}
+
+	double signal = 0.0, residual = 0.0;
+	for (size_t i=0; i<samples.size(); ++i) {
+		double fit = x[0] * sin(w * (double)(i + first)) + x[1] * cos(w * (double)(i + first)) + x[2];
+		signal += fit * fit;
+		residual += (samples[i] - fit) * (samples[i] - fit);
+	}
+	if (signal <= 0.0)
+		return false;
+	noise = residual > 0.0 ? 10.0 * log10(residual / signal) : -200.0;
+	gain = 20.0 * log10(sqrt(x[0] * x[0] + x[1] * x[1]) / RESAMPLE_AMPLITUDE);
+	return true;
+}
+
+static size_t resampleBuffer(music::TResampler& resampler, const std::vector<music::TSample>& input, std::vector<music::TSample>* output) {
+	// Feed whole input in blocks like the decoder stage does
+	const music::TSample* src = input.data();
+	size_t size = input.size();
+	size_t frames = 0;
+	size_t consumed;
+	while (true) {
+		size_t produced = resampler.process(src, size, music::RESAMPLER_BLOCK_FRAMES, consumed);
+		if (util::assigned(output))
+			output->insert(output->end(), resampler.data(), resampler.data() + produced * 2 * 3);
+		frames += produced;
+		src += consumed;
+		size -= consumed;
+		if (produced < music::RESAMPLER_BLOCK_FRAMES)
+			break;
+	}
+	return frames;
+}
+
+int resampleBenchmark(const TBenchmarkArguments& args) {
+	const int64_t duration = args.getDuration();
+	const double frequencies[] = { 997.0, 15000.0 };
+	const music::EResamplerQuality qualities[] = { music::ERQ_LOW, music::ERQ_MEDIUM, music::ERQ_HIGH };
+	const music::ESampleKernel detected = music::getSampleKernel();
+
+	struct CRates { int input; int output; };
+	const CRates conversions[] = { { 44100, 48000 }, { 48000, 44100 }, { 44100, 192000 }, { 96000, 44100 } };
+
+	printHeader("Polyphase resampler quality and throughput for stereo 24 bit samples");
+	std::cout << util::cprintf("THD+N is the residual of a sine fit to a %.1f dBFS test tone, gain is the level change of the tone.", 20.0 * log10(RESAMPLE_AMPLITUDE)) << std::endl;
+	std::cout << "Throughput is given as realtime factor for each available kernel." << std::endl;
+	std::cout << "Detected sample kernel is " << music::sampleKernelToStr(detected) << std::endl;
+
+	int result = EXIT_SUCCESS;
+	for (const CRates& rates : conversions) {
+		std::cout << std::endl << util::cprintf("%.1f kHz to %.1f kHz:", (double)rates.input / 1000.0, (double)rates.output / 1000.0) << std::endl;
+		std::vector<music::TSample> input;
+
+		for (music::EResamplerQuality quality : qualities) {
+			std::string line;
+
+			// Filter bank design time and quality for detected kernel
+			music::TResampler resampler;
+			int64_t start = getMicroSeconds();
+			if (!resampler.setup(rates.input, rates.output, 2, 24, quality)) {
+				std::cout << "  Setup for quality " << music::resamplerQualityToStr(quality) << " failed." << std::endl;
+				result = EXIT_FAILURE;
+				continue;
+			}
+			int64_t design = getMicroSeconds() - start;
+			line = util::cprintf("  %-7s %5zu taps %5zu phases %7.1f ms design", music::resamplerQualityToStr(quality).c_str(),
+					resampler.getTaps(), resampler.getPhases(), (double)design / 1000.0);
+
+			for (double frequency : frequencies) {
+				std::vector<music::TSample> output;
+				fillSine(input, (size_t)rates.input, rates.input, frequency);
+				resampler.reset();
+				resampleBuffer(resampler, input, &output);
+				double noise, gain;
+				if (getSineFit(output, rates.output, frequency, noise, gain)) {
+					line += util::cprintf("  %5.0f Hz %6.1f dB %+6.2f dB", frequency, noise, gain);
+				} else {
+					line += util::cprintf("  %5.0f Hz fit failed", frequency);
+					result = EXIT_FAILURE;
+				}
+			}
+
+			// Realtime factor for one second of input for all available kernels
+			for (music::ESampleKernel kernel : sampleKernels) {
+				music::setSampleKernel(kernel);
+				if (music::getSampleKernel() != kernel)
+					continue;
+				music::TResampler converter;
+				converter.setup(rates.input, rates.output, 2, 24, quality);
+				size_t loops = 0;
+				int64_t elapsed = measure(duration, loops, [&] () {
+					resampleBuffer(converter, input, nil);
+				});
+				line += util::cprintf("  %s %6.0fx", music::sampleKernelToStr(kernel).c_str(), (double)loops * 1000000.0 / (double)elapsed);
+			}
+			music::setSampleKernel(detected);
+			std::cout << line << std::endl;
+		}
+	}
+
+	return result;
+}
+
+} /* namespace bench */
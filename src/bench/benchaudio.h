@@ -0,0 +1,32 @@
+/*
+ * benchaudio.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: Dirk Brinkmeier
+ */
+
+#ifndef BENCHAUDIO_H_
+#define BENCHAUDIO_H_
+
+#include "benchtypes.h"
+
+namespace bench {
+
+// Pack planar decoder output into interleaved samples, per sample writer against bulk kernels
+int packBenchmark(const TBenchmarkArguments& args);
+
+// Convert DSD to DoP byte order, byte wise conversion against block kernels
+int dopBenchmark(const TBenchmarkArguments& args);
+
+// Upscale 16 bit samples with dither for one ALSA period, random byte dither against block TPDF generator
+int ditherBenchmark(const TBenchmarkArguments& args);
+
+// Polyphase resampler THD+N by sine fit and realtime factor for all sample kernels
+int resampleBenchmark(const TBenchmarkArguments& args);
+
+// Memory per hour of music and decoder CPU load for decoded and compressed buffer mode
+int bufferBenchmark(const TBenchmarkArguments& args);
+
+} /* namespace bench */
+
+#endif /* BENCHAUDIO_H_ */
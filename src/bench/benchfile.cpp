@@ -0,0 +1,168 @@
+/*
+ * benchfile.cpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: Dirk Brinkmeier
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include "benchfile.h"
+#include "../inc/readahead.h"
+#include "../inc/semaphores.h"
+#include "../inc/fileutils.h"
+#include "../inc/stringutils.h"
+
+namespace bench {
+
+STATIC_CONST size_t READ_AHEAD_STEREO_DSD512 = 22579200 * 2 / 8; // Bytes per second for stereo DSD512
+STATIC_CONST size_t READ_AHEAD_STEREO_HIRES = 192000 * 2 * 3;     // Bytes per second for stereo 24/192 PCM
+
+// Storage link shared by all requests of one reader
+// --> Round trip latency of parallel requests overlaps, but payload transfers are serialized at the link bandwidth
+// --> Request completes after its latency and after all earlier transfers have left the link
+class TStorageLink {
+private:
+	app::TMutex mtx;
+	int64_t latency;
+	double bandwidth;
+	int64_t idle;
+
+public:
+	int64_t transfer(const size_t size) {
+		int64_t now = getMicroSeconds();
+		int64_t done;
+		{
+			app::TLockGuard<app::TMutex> lock(mtx);
+			int64_t start = std::max(now + latency, idle);
+			done = start + (bandwidth > 0.0 ? (int64_t)((double)size / bandwidth) : 0);
+			idle = done;
+		}
+		return done - now;
+	}
+
+	TStorageLink(const int64_t latency, const double bandwidth) : latency(latency), bandwidth(bandwidth), idle(0) {}
+};
+
+// Read-ahead reader on storage with simulated network latency
+// --> Every load from file waits until the shared link has delivered the requested size
+class TDelayedReadAhead : public util::TReadAhead {
+private:
+	TStorageLink link;
+
+protected:
+	ssize_t load(void *const data, const size_t size, const size_t offset) {
+		int64_t delay = link.transfer(size);
+		if (delay > 0)
+			::usleep((useconds_t)delay);
+		return util::TReadAhead::load(data, size, offset);
+	}
+
+public:
+	TDelayedReadAhead(const int64_t latency, const double bandwidth) : link(latency, bandwidth) {}
+	virtual ~TDelayedReadAhead() { close(); }
+};
+
+static bool createReadAheadFile(const std::string& fileName, const size_t size) {
+	std::ofstream file(fileName.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+	if (!file.is_open())
+		return false;
+	std::vector<char> block(1024 * 1024);
+	uint32_t state = 0xF11E;
+	for (size_t written = 0; written < size; written += block.size()) {
+		for (size_t i=0; i<block.size(); ++i) {
+			state = state * 1664525 + 1013904223;
+			block[i] = (char)(state >> 24);
+		}
+		file.write(block.data(), std::min(block.size(), size - written));
+	}
+	file.close();
+	return !file.fail();
+}
+
+static bool readFile(util::TFile& file, const size_t readSize, const size_t depth, const size_t workers,
+		const int64_t latency, const double bandwidth, uint64_t& checksum, int64_t& elapsed) {
+	TDelayedReadAhead reader(latency, bandwidth);
+	reader.configure(util::READ_AHEAD_CHUNK_SIZE, depth, workers);
+	std::vector<char> data(readSize);
+	checksum = 0;
+
+	// Read whole file sequentially like a decoder does
+	int64_t start = getMicroSeconds();
+	if (!reader.open(file, 0))
+		return false;
+	while (!reader.isEOF()) {
+		ssize_t r = reader.read(data.data(), data.size());
+		if (r <= 0)
+			break;
+		for (ssize_t i=0; i<r; i+=64) {
+			checksum = checksum * 31 + (uint8_t)data[i];
+		}
+	}
+	bool complete = reader.getPosition() >= reader.getSize();
+	reader.close();
+	elapsed = getMicroSeconds() - start;
+	return complete;
+}
+
+int readAheadBenchmark(const TBenchmarkArguments& args) {
+	const std::string path = args.getValue("path", "/tmp");
+	const size_t size = (size_t)args.getInteger("size", 32) * 1024 * 1024;
+	const size_t readSize = (size_t)args.getInteger("read", 64) * 1024;
+	const int64_t latency = args.getInteger("latency", 5) * 1000;
+	const double bandwidth = (double)args.getInteger("bandwidth", 100); // MB/s is equal to bytes per microsecond
+
+	// Synchronous reads (no worker) as used by the decoders before the read-ahead reader
+	struct CReadAheadConfig { const char* name; size_t depth; size_t workers; };
+	const CReadAheadConfig configs[] = {
+		{ "Synchronous pread", 2, 0 },
+		{ "Depth 4, 2 workers", util::READ_AHEAD_DEFAULT_DEPTH, util::READ_AHEAD_DEFAULT_WORKERS },
+		{ "Depth 8, 4 workers", 8, 4 },
+		{ "Depth 16, 4 workers", 16, 4 },
+		{ "Depth 32, 4 workers", util::READ_AHEAD_MAX_DEPTH, util::READ_AHEAD_MAX_WORKERS }
+	};
+
+	printHeader("Sequential decoder reads from storage with simulated network latency");
+	std::cout << util::csnprintf("Each storage request waits % ms round trip, all transfers share one % MB/s link, decoder reads % KB per call.",
+			latency / 1000, args.getInteger("bandwidth", 100), readSize / 1024) << std::endl;
+	std::cout << "Realtime factors are given for stereo 24/192 PCM and stereo DSD512." << std::endl << std::endl;
+
+	std::string fileName = util::validPath(path) + "rmpbench-readahead.bin";
+	if (!createReadAheadFile(fileName, size)) {
+		std::cout << "Creating file " << fileName << " failed." << std::endl;
+		return EXIT_FAILURE;
+	}
+	util::TFile file(fileName);
+	file.open(O_RDONLY);
+	if (!file.isOpen()) {
+		std::cout << "Opening file " << fileName << " failed." << std::endl;
+		util::deleteFile(fileName);
+		return EXIT_FAILURE;
+	}
+
+	int result = EXIT_SUCCESS;
+	uint64_t reference = 0;
+	for (const CReadAheadConfig& config : configs) {
+		uint64_t checksum;
+		int64_t elapsed;
+		bool complete = readFile(file, readSize, config.depth, config.workers, latency, bandwidth, checksum, elapsed);
+		if (config.workers == 0)
+			reference = checksum;
+		bool valid = complete && checksum == reference;
+		double throughput = getThroughput(size, elapsed);
+		std::cout << util::cprintf("  %-22s %9.1f ms %9.1f MB/s %8.1fx 24/192 %8.1fx DSD512%s", config.name, (double)elapsed / 1000.0, throughput,
+				throughput * 1000000.0 / (double)READ_AHEAD_STEREO_HIRES, throughput * 1000000.0 / (double)READ_AHEAD_STEREO_DSD512,
+				valid ? "" : "  (data differs from synchronous read)") << std::endl;
+		if (!valid)
+			result = EXIT_FAILURE;
+	}
+
+	file.close();
+	util::deleteFile(fileName);
+	return result;
+}
+
+} /* namespace bench */
@@ -0,0 +1,20 @@
+/*
+ * benchfile.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: Dirk Brinkmeier
+ */
+
+#ifndef BENCHFILE_H_
+#define BENCHFILE_H_
+
+#include "benchtypes.h"
+
+namespace bench {
+
+// Sequential decoder reads from simulated high latency storage, synchronous reads against read-ahead reader
+int readAheadBenchmark(const TBenchmarkArguments& args);
+
+} /* namespace bench */
+
+#endif /* BENCHFILE_H_ */
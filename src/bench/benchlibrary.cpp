@@ -0,0 +1,262 @@
+/*
+ * benchlibrary.cpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: Dirk Brinkmeier
+ */
+
+#include <malloc.h>
+#include <fstream>
+#include <iostream>
+#include "benchlibrary.h"
+#include "../inc/encoding.h"
+#include "../inc/fileutils.h"
+#include "../inc/datetime.h"
+#include "../inc/sysutils.h"
+#include "../inc/stringutils.h"
+#include "../app/library.h"
+
+namespace bench {
+
+STATIC_CONST size_t LIBRARY_TRACKS_PER_ALBUM = 10;
+STATIC_CONST size_t LIBRARY_ALBUMS_PER_ARTIST = 5;
+
+static const char* libraryGenres[] = { "Classical", "Jazz", "Rock", "Pop", "Soundtrack", "Blues", "Electronic", "Folk" };
+static const char* librarySyllables[] = { "ka", "lo", "mi", "ne", "ru", "sa", "to", "vi", "be", "da", "fe", "go", "hu", "ja", "pe", "zo" };
+
+static std::string getLibraryWord(const size_t index) {
+	// One of 4096 words made of three syllables, e.g. "Kalomi"
+	std::string word;
+	size_t value = index;
+	for (size_t i=0; i<3; ++i) {
+		word += librarySyllables[value % 16];
+		value /= 16;
+	}
+	word[0] = toupper(word[0]);
+	return word;
+}
+
+static std::string getLibraryArtist(const size_t artist) {
+	return getLibraryWord(artist) + " " + getLibraryWord(artist * 7 + 1000);
+}
+
+static std::string getLibraryAlbum(const size_t album) {
+	return getLibraryWord(album * 13 + 7) + " " + getLibraryWord(album);
+}
+
+static std::string getLibraryFileName(const std::string& path, const size_t songs) {
+	return util::validPath(path) + util::csnprintf("rmpbench-%.csv", songs);
+}
+
+static std::string getLibraryHash(const char prefix, const size_t index) {
+	// Unique 32 digit hex value like MD5 hashes used by the library
+	return util::cprintf("%c%031zx", prefix, index);
+}
+
+static bool createLibraryFile(const std::string& fileName, const size_t songs) {
+	// Synthetic library with 10 tracks per album and 5 albums per artist
+	// --> Same CSV row layout as written by TSong::text()
+	std::ofstream file(fileName.c_str(), std::ios::out | std::ios::trunc);
+	if (!file.is_open())
+		return false;
+	const std::string timestamp = util::dateTimeToStr(util::now());
+	const size_t genres = sizeof(libraryGenres) / sizeof(libraryGenres[0]);
+	file << "Codec;Artist;OriginalArtist;AlbumArtist;Album;Title;Genre;Composer;Conductor;OriginalAlbumArtist;TitleHash;AlbumHash;Track;Disk;Year;Date;"
+			"SampleCount;SampleSize;SampleRate;BitsPerSample;BytesPerSample;Channels;BitRate;ChunkSize;Duration;Seconds;Time;FileName;TimeStamp;FileSize;FileHash;Params;InsertStamp" << std::endl;
+	for (size_t i=0; i<songs; ++i) {
+		size_t track = i % LIBRARY_TRACKS_PER_ALBUM + 1;
+		size_t album = i / LIBRARY_TRACKS_PER_ALBUM;
+		size_t artist = album / LIBRARY_ALBUMS_PER_ARTIST;
+		std::string artistName = getLibraryArtist(artist);
+		std::string albumName = getLibraryAlbum(album);
+		std::string titleName = getLibraryWord(i * 31 + 5) + " " + getLibraryWord(i);
+		std::string genre = libraryGenres[artist % genres];
+		std::string fileName = util::csnprintf("/music/%/% %/% - %.flac", artistName, albumName, album, util::cprintf("%02d", (int)track), titleName);
+		size_t seconds = 180 + i % 240;
+		size_t samples = seconds * 44100;
+		file << (int)music::EFT_FLAC << ';'
+			<< util::quote(artistName) << ';'
+			<< util::quote(artistName) << ';'
+			<< util::quote(artistName) << ';'
+			<< util::quote(albumName) << ';'
+			<< util::quote(titleName) << ';'
+			<< util::quote(genre) << ';'
+			<< util::quote("Composer " + std::to_string(artist % 100)) << ';'
+			<< util::quote("") << ';'
+			<< util::quote(artistName) << ';'
+			<< util::quote(getLibraryHash('t', i)) << ';'
+			<< util::quote(getLibraryHash('a', album)) << ';'
+			<< util::cprintf("%02d/%02d", (int)track, (int)LIBRARY_TRACKS_PER_ALBUM) << ';'
+			<< "1/01" << ';'
+			<< 1960 + album % 60 << ';'
+			<< 1960 + album % 60 << ';'
+			<< samples << ';'
+			<< samples * 4 << ';'
+			<< 44100 << ';'
+			<< 16 << ';'
+			<< 2 << ';'
+			<< 2 << ';'
+			<< 1411 << ';'
+			<< 4096 << ';'
+			<< seconds * 1000 << ';'
+			<< seconds << ';'
+			<< util::cprintf("%02d:%02d", (int)(seconds / 60), (int)(seconds % 60)) << ';'
+			<< util::TURL::encode(fileName) << ';'
+			<< timestamp << ';'
+			<< samples * 2 << ';'
+			<< getLibraryHash('f', i) << ';'
+			<< "0000000000000000" << ';'
+			<< timestamp << std::endl;
+	}
+	file.close();
+	return !file.fail();
+}
+
+static void loadLibraryFile(const std::string& title, const std::string& fileName, const bool binary) {
+	malloc_trim(0);
+	size_t resident = sysutil::getCurrentMemoryUsage();
+	bool peak = resetPeakMemory();
+
+	music::TLibrary library;
+	library.setBinaryDatabase(binary);
+
+	int64_t start = getMicroSeconds();
+	library.loadFromFile(fileName);
+	int64_t elapsed = getMicroSeconds() - start;
+
+	size_t current = sysutil::getCurrentMemoryUsage();
+	size_t used = current > resident ? current - resident : 0;
+	std::string maximum = "n/a";
+	if (peak) {
+		size_t value = sysutil::getPeakMemoryUsage();
+		maximum = util::cprintf("%.1f MB", value > resident ? (double)(value - resident) / 1048576.0 : 0.0);
+	}
+	std::cout << util::cprintf("  %-34s %9.1f ms  %8zu songs  %8.1f MB resident  %10s peak", title.c_str(),
+			(double)elapsed / 1000.0, library.songs(), (double)used / 1048576.0, maximum.c_str()) << std::endl;
+}
+
+int databaseBenchmark(const TBenchmarkArguments& args) {
+	const TBenchmarkIntegers counts = args.getIntegers("songs", { 10000, 100000, 500000 });
+	const std::string path = args.getValue("path", "/tmp");
+	const bool keep = args.hasValue("keep");
+
+	printHeader("Library startup from CSV file and from binary database");
+	std::cout << "Synthetic libraries with " << LIBRARY_TRACKS_PER_ALBUM << " tracks per album and "
+			<< LIBRARY_ALBUMS_PER_ARTIST << " albums per artist are created in " << path << std::endl;
+	std::cout << "Times include building the artist and album mappings. Memory is counted above the state before loading." << std::endl;
+
+	for (int64_t count : counts) {
+		if (count <= 0)
+			continue;
+		size_t songs = (size_t)count;
+		std::string fileName = getLibraryFileName(path, songs);
+		std::string databaseName = util::fileReplaceExt(fileName, music::LIBRARY_DATABASE_EXT);
+		util::deleteFile(databaseName);
+
+		std::cout << std::endl << util::csnprintf("% songs:", songs) << std::endl;
+		if (!createLibraryFile(fileName, songs)) {
+			std::cout << "  Creating library file " << fileName << " failed." << std::endl;
+			return EXIT_FAILURE;
+		}
+		std::cout << util::cprintf("  %-34s %9.1f MB", "CSV file size", (double)util::fileSize(fileName) / 1048576.0) << std::endl;
+
+		// Previous startup path, CSV file only
+		loadLibraryFile("Load CSV file", fileName, false);
+
+		// First start after CSV import creates the binary database
+		loadLibraryFile("Load CSV file, write database", fileName, true);
+		if (util::fileExists(databaseName)) {
+			std::cout << util::cprintf("  %-34s %9.1f MB", "Database file size", (double)util::fileSize(databaseName) / 1048576.0) << std::endl;
+
+			// Following starts load the memory mapped database
+			loadLibraryFile("Load binary database", fileName, true);
+		} else {
+			std::cout << "  Binary database was not created." << std::endl;
+		}
+
+		if (!keep) {
+			util::deleteFile(fileName);
+			util::deleteFile(databaseName);
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
+
+
+static size_t searchLinear(music::TLibrary& library, const std::string& filter, util::TStringList& html) {
+	// Linear scan over all albums as used before the search index
+	util::TStringList search;
+	search.assign(filter, ' ');
+	html.clear();
+	music::TConstAlbumList list;
+	const music::THashedMap& albums = library.getAlbums();
+	for (music::THashedMap::const_iterator it = albums.begin(); it != albums.end(); ++it) {
+		if (library.filterSearchAlbum(it->second, music::FD_ALL, music::EMT_ALL, search, "")) {
+			list.push_back(&it->second);
+		}
+	}
+	return library.addSortedAlbums(html, list, false);
+}
+
+int searchBenchmark(const TBenchmarkArguments& args) {
+	const int64_t duration = args.getDuration();
+	const size_t songs = (size_t)args.getInteger("songs", 150000);
+	const std::string path = args.getValue("path", "/tmp");
+	const size_t albums = songs / LIBRARY_TRACKS_PER_ALBUM;
+
+	// Default queries for a full artist name, a word of album names, a song title,
+	// a common prefix and a word that is not part of the library
+	std::vector<std::string> queries;
+	if (args.hasValue("query")) {
+		queries.push_back(args.getValue("query"));
+	} else {
+		queries.push_back(getLibraryArtist(albums / LIBRARY_ALBUMS_PER_ARTIST / 2));
+		queries.push_back(getLibraryWord(albums / 3));
+		queries.push_back(getLibraryWord(songs / 2 * 31 + 5) + " " + getLibraryWord(songs / 2));
+		queries.push_back("Kal");
+		queries.push_back("Quixotic");
+	}
+
+	printHeader("Album search with trigram index against linear scan");
+	std::string fileName = getLibraryFileName(path, songs);
+	if (!createLibraryFile(fileName, songs)) {
+		std::cout << "Creating library file " << fileName << " failed." << std::endl;
+		return EXIT_FAILURE;
+	}
+	music::TLibrary library;
+	library.setBinaryDatabase(false);
+	library.loadFromFile(fileName);
+	util::deleteFile(fileName);
+	std::cout << util::csnprintf("Library with % songs in % albums", library.songs(), library.albums()) << std::endl;
+	std::cout << "Both methods include verifying the filter and creating the HTML result list." << std::endl << std::endl;
+
+	int result = EXIT_SUCCESS;
+	for (const std::string& query : queries) {
+		util::TStringList html;
+		util::TStringList genres;
+		size_t found = 0;
+		size_t loops = 0;
+
+		int64_t elapsed = measure(duration, loops, [&] () {
+			genres.clear();
+			found = library.getSearchHTML(html, query, "", music::FD_ALL, music::EMT_ALL, albums, false, genres);
+		});
+		double indexed = (double)elapsed / (double)loops;
+
+		size_t scanned = 0;
+		elapsed = measure(duration, loops, [&] () {
+			scanned = searchLinear(library, query, html);
+		});
+		double linear = (double)elapsed / (double)loops;
+
+		std::cout << util::cprintf("  %-24s %6zu albums  index %10.1f us  linear %10.1f us  %7.1fx%s", ("\"" + query + "\"").c_str(), found,
+				indexed, linear, indexed > 0.0 ? linear / indexed : 0.0, found == scanned ? "" : "  (result count differs from linear scan)") << std::endl;
+		if (found != scanned)
+			result = EXIT_FAILURE;
+	}
+
+	return result;
+}
+
+} /* namespace bench */
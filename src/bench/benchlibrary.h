@@ -0,0 +1,23 @@
+/*
+ * benchlibrary.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: Dirk Brinkmeier
+ */
+
+#ifndef BENCHLIBRARY_H_
+#define BENCHLIBRARY_H_
+
+#include "benchtypes.h"
+
+namespace bench {
+
+// Library startup from CSV file against binary database for synthetic libraries
+int databaseBenchmark(const TBenchmarkArguments& args);
+
+// Album search by trigram index against linear scan of all albums
+int searchBenchmark(const TBenchmarkArguments& args);
+
+} /* namespace bench */
+
+#endif /* BENCHLIBRARY_H_ */
@@ -0,0 +1,106 @@
+/*
+ * benchtypes.cpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: Dirk Brinkmeier
+ */
+
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include "benchtypes.h"
+#include "../inc/nullptr.h"
+
+namespace bench {
+
+void TBenchmarkArguments::parse(int argc, char *argv[]) {
+	values.clear();
+	for (int i=0; i<argc; ++i) {
+		std::string arg(argv[i]);
+		size_t pos = arg.find('=');
+		if (pos != std::string::npos && pos > 0) {
+			values[arg.substr(0, pos)] = arg.substr(pos + 1);
+		} else {
+			values[arg] = "";
+		}
+	}
+}
+
+bool TBenchmarkArguments::hasValue(const std::string& name) const {
+	return values.find(name) != values.end();
+}
+
+std::string TBenchmarkArguments::getValue(const std::string& name, const std::string& defValue) const {
+	TBenchmarkValues::const_iterator it = values.find(name);
+	if (it != values.end())
+		return it->second;
+	return defValue;
+}
+
+int64_t TBenchmarkArguments::getInteger(const std::string& name, const int64_t defValue) const {
+	TBenchmarkValues::const_iterator it = values.find(name);
+	if (it != values.end() && !it->second.empty()) {
+		char* end = nil;
+		long long value = strtoll(it->second.c_str(), &end, 10);
+		if (end != it->second.c_str() && *end == '\0')
+			return (int64_t)value;
+	}
+	return defValue;
+}
+
+TBenchmarkIntegers TBenchmarkArguments::getIntegers(const std::string& name, const TBenchmarkIntegers& defValues) const {
+	// Comma separated list of integer values, e.g. "songs=10000,100000"
+	TBenchmarkValues::const_iterator it = values.find(name);
+	if (it != values.end() && !it->second.empty()) {
+		TBenchmarkIntegers result;
+		const char* p = it->second.c_str();
+		while (*p != '\0') {
+			char* end = nil;
+			long long value = strtoll(p, &end, 10);
+			if (end == p)
+				return defValues;
+			result.push_back((int64_t)value);
+			p = (*end == ',') ? end + 1 : end;
+		}
+		if (!result.empty())
+			return result;
+	}
+	return defValues;
+}
+
+
+int64_t getMicroSeconds() {
+	struct timespec ts;
+	if (EXIT_SUCCESS == clock_gettime(CLOCK_MONOTONIC, &ts))
+		return (int64_t)ts.tv_sec * 1000000 + (int64_t)ts.tv_nsec / 1000;
+	return 0;
+}
+
+int64_t getCPUTime() {
+	struct timespec ts;
+	if (EXIT_SUCCESS == clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts))
+		return (int64_t)ts.tv_sec * 1000000 + (int64_t)ts.tv_nsec / 1000;
+	return 0;
+}
+
+bool resetPeakMemory() {
+	FILE* file = fopen("/proc/self/clear_refs", "w");
+	if (nil == file)
+		return false;
+	bool ok = fputs("5", file) >= 0;
+	return (EXIT_SUCCESS == fclose(file)) && ok;
+}
+
+double getThroughput(const uint64_t bytes, const int64_t duration) {
+	if (duration > 0)
+		return (double)bytes / (double)duration;
+	return 0.0;
+}
+
+void printHeader(const std::string& title) {
+	std::cout << std::endl << title << std::endl;
+	std::cout << std::string(title.size(), '=') << std::endl;
+}
+
+} /* namespace bench */
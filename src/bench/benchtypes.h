@@ -0,0 +1,90 @@
+/*
+ * benchtypes.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: Dirk Brinkmeier
+ */
+
+#ifndef BENCHTYPES_H_
+#define BENCHTYPES_H_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "../inc/gcc.h"
+
+namespace bench {
+
+STATIC_CONST int64_t BENCH_DEFAULT_DURATION = 500; // Minimum run time of each measurement in milliseconds
+
+#ifdef STL_HAS_TEMPLATE_ALIAS
+
+using TBenchmarkValues = std::map<std::string, std::string>;
+using TBenchmarkIntegers = std::vector<int64_t>;
+
+#else
+
+typedef std::map<std::string, std::string> TBenchmarkValues;
+typedef std::vector<int64_t> TBenchmarkIntegers;
+
+#endif
+
+
+// Command line arguments given as "name=value" after the benchmark name
+class TBenchmarkArguments {
+private:
+	TBenchmarkValues values;
+
+public:
+	void parse(int argc, char *argv[]);
+	bool hasValue(const std::string& name) const;
+	std::string getValue(const std::string& name, const std::string& defValue = "") const;
+	int64_t getInteger(const std::string& name, const int64_t defValue) const;
+	TBenchmarkIntegers getIntegers(const std::string& name, const TBenchmarkIntegers& defValues) const;
+
+	// Minimum run time of each measurement in microseconds
+	int64_t getDuration() const { return getInteger("duration", BENCH_DEFAULT_DURATION) * 1000; };
+};
+
+typedef int (*TBenchmarkMethod)(const TBenchmarkArguments& args);
+
+typedef struct CBenchmark {
+	const char* name;
+	const char* description;
+	TBenchmarkMethod method;
+} TBenchmark;
+
+
+// Monotonic time in microseconds
+int64_t getMicroSeconds();
+
+// Process CPU time (user + system) in microseconds
+int64_t getCPUTime();
+
+// Reset peak resident memory of process (VmHWM), returns false if not supported by kernel
+bool resetPeakMemory();
+
+// Throughput in MB/s for given bytes per microseconds
+double getThroughput(const uint64_t bytes, const int64_t duration);
+
+void printHeader(const std::string& title);
+
+// Call method repeatedly for at least the given duration in microseconds
+// --> Returns elapsed time in microseconds, "loops" is the number of calls
+template<typename method_t>
+int64_t measure(const int64_t duration, size_t& loops, method_t&& method) {
+	int64_t start = getMicroSeconds();
+	int64_t elapsed = 0;
+	loops = 0;
+	do {
+		method();
+		++loops;
+		elapsed = getMicroSeconds() - start;
+	} while (elapsed < duration);
+	return elapsed;
+}
+
+} /* namespace bench */
+
+#endif /* BENCHTYPES_H_ */
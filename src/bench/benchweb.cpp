@@ -0,0 +1,342 @@
+/*
+ * benchweb.cpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: Dirk Brinkmeier
+ */
+
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <iostream>
+#include "benchweb.h"
+#include "../inc/webserver.h"
+#include "../inc/webclient.h"
+#include "../inc/translation.h"
+#include "../inc/inifile.h"
+#include "../inc/logger.h"
+#include "../inc/timer.h"
+#include "../inc/threads.h"
+#include "../inc/histogram.h"
+#include "../inc/fileutils.h"
+#include "../inc/stringutils.h"
+#include "../inc/sysutils.h"
+
+namespace bench {
+
+STATIC_CONST size_t HTTP_MAX_CLIENTS = 256;
+STATIC_CONST int64_t HTTP_DEFAULT_PORT = 8099;
+STATIC_CONST char HTTP_SERVER_NAME[] = "Bench";
+
+static int64_t getThreadTime() {
+	struct timespec ts;
+	if (EXIT_SUCCESS == clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts))
+		return (int64_t)ts.tv_sec * 1000000 + (int64_t)ts.tv_nsec / 1000;
+	return 0;
+}
+
+
+// Web server instance in benchmark process with own config, logs, timers and threads in a temporary folder
+// --> Server CPU time is the process time minus the CPU time of the client threads
+class TBenchWebServer {
+private:
+	std::string folder;
+	app::TIniFile* config;
+	app::TLogController* logger;
+	app::TTimerController* timers;
+	app::TThreadController* threads;
+	app::TTranslator translator;
+	app::TWebServer* server;
+
+public:
+	bool start(const std::string& threading, const bool sendfile, const int port) {
+		stop();
+		util::createDirektory(folder + "www");
+		config = new app::TIniFile(folder + "webserver.conf");
+		config->setSection(HTTP_SERVER_NAME);
+		config->writeInteger("Port", port);
+		config->writeBool("UseHttps", false, app::INI_BLYES);
+		config->writeBool("UseSendFile", sendfile, app::INI_BLYES);
+		config->writeBool("Authentication", false, app::INI_BLYES);
+		config->writeString("ThreadingMode", threading);
+		config->writeString("DocumentRoot", folder + "www/");
+		config->writeString("UploadFolder", folder + "upload/");
+		config->writeString("SessionStore", folder + "sessions/");
+		config->writeInteger("VerbosityLevel", 0);
+		logger = new app::TLogController("rmpbench", folder, folder, false);
+		app::PLogFile info = logger->addLogFile("webserver.log");
+		app::PLogFile exception = logger->addLogFile("bench-exception.log");
+		timers = new app::TTimerController(folder, *info, *exception);
+		threads = new app::TThreadController(*info, *exception);
+		server = new app::TWebServer(HTTP_SERVER_NAME, folder + "www/", config, threads, timers, &translator, info, exception);
+		try {
+			return server->start();
+		} catch (const std::exception& e) {
+			std::cout << "Starting web server failed: " << e.what() << std::endl;
+		}
+		return false;
+	}
+
+	void stop() {
+		if (util::assigned(server)) {
+			server->terminate();
+			server->waitFor();
+		}
+		util::freeAndNil(server);
+		util::freeAndNil(threads);
+		util::freeAndNil(timers);
+		util::freeAndNil(logger);
+		util::freeAndNil(config);
+	}
+
+	std::string getURL(const std::string& path) const {
+		return util::csnprintf("http://127.0.0.1:%", util::assigned(server) ? server->getPort() : 0) + path;
+	}
+
+	const std::string& getFolder() const { return folder; };
+
+	TBenchWebServer(const std::string& path) : config(nil), logger(nil), timers(nil), threads(nil), server(nil) {
+		folder = util::validPath(path) + util::csnprintf("rmpbench-web-%/", getpid());
+		util::createDirektory(folder);
+	}
+
+	~TBenchWebServer() {
+		stop();
+		util::deleteFolder(folder);
+	}
+};
+
+
+class THttpLoadClient {
+private:
+	app::TURLClient curl;
+	util::THistogram& latency;
+	std::string url;
+	size_t requests;
+	bool reuse;
+	size_t completed;
+	size_t errors;
+	uint64_t received;
+	int64_t cpu;
+
+	static size_t writeHandler(void *buffer, size_t size, size_t count, void *ctx) {
+		// Received data is counted and discarded
+		size_t bytes = size * count;
+		static_cast<THttpLoadClient*>(ctx)->received += bytes;
+		return bytes;
+	}
+
+public:
+	int execute() {
+		// Handle is reused for all requests, so the connection is kept alive unless reuse is disabled
+		curl_easy_setopt(curl(), CURLOPT_URL, url.c_str());
+		curl_easy_setopt(curl(), CURLOPT_WRITEFUNCTION, writeHandler);
+		curl_easy_setopt(curl(), CURLOPT_WRITEDATA, this);
+		curl_easy_setopt(curl(), CURLOPT_NOSIGNAL, 1L);
+		curl_easy_setopt(curl(), CURLOPT_FORBID_REUSE, reuse ? 0L : 1L);
+
+		// Session cookie is kept like in a browser, otherwise every request creates a new web session
+		curl_easy_setopt(curl(), CURLOPT_COOKIEFILE, "");
+		for (size_t i=0; i<requests; ++i) {
+			long status = 0;
+
+			// Close connection after last request, waiting clients are accepted only below MaxConnectionsPerCPU
+			if (i + 1 == requests)
+				curl_easy_setopt(curl(), CURLOPT_FORBID_REUSE, 1L);
+
+			int64_t start = getMicroSeconds();
+			CURLcode r = curl_easy_perform(curl());
+			latency.add((uint64_t)(getMicroSeconds() - start));
+			if (CURLE_OK == r)
+				curl_easy_getinfo(curl(), CURLINFO_RESPONSE_CODE, &status);
+			if (CURLE_OK == r && (200 == status || 206 == status)) {
+				++completed;
+			} else {
+				++errors;
+			}
+		}
+		cpu = getThreadTime();
+		return EXIT_SUCCESS;
+	}
+
+	size_t getCompleted() const { return completed; };
+	size_t getErrors() const { return errors; };
+	uint64_t getReceived() const { return received; };
+	int64_t getCPUTime() const { return cpu; };
+
+	THttpLoadClient(util::THistogram& latency, const std::string& url, const size_t requests, const bool reuse)
+		: latency(latency), url(url), requests(requests), reuse(reuse), completed(0), errors(0), received(0), cpu(0) {}
+};
+
+static void* httpLoadThreadDispatcher(void *client) {
+	if (util::assigned(client)) {
+		return (void *)(long)(static_cast<THttpLoadClient*>(client))->execute();
+	}
+	return (void *)(long)(EXIT_FAILURE);
+}
+
+
+typedef struct CHttpLoadResult {
+	size_t completed;
+	size_t errors;
+	uint64_t received;
+	int64_t elapsed;
+	int64_t client;
+	int64_t server;
+	util::THistogramValues latency;
+} THttpLoadResult;
+
+static bool httpLoad(const std::string& url, const size_t clients, const size_t requests, const bool reuse, THttpLoadResult& result) {
+	util::THistogram latency;
+	std::vector<THttpLoadClient*> list;
+	std::vector<pthread_t> threads;
+	for (size_t i=0; i<clients; ++i) {
+		list.push_back(new THttpLoadClient(latency, url, requests, reuse));
+	}
+
+	int64_t cpu = getCPUTime();
+	int64_t start = getMicroSeconds();
+	for (THttpLoadClient* client : list) {
+		pthread_t thread = 0;
+		if (app::TThreadUtil::createJoinableThread(thread, httpLoadThreadDispatcher, client, "HTTP-Load"))
+			threads.push_back(thread);
+	}
+	for (pthread_t& thread : threads) {
+		app::TThreadUtil::terminateThread(thread);
+	}
+	result.elapsed = getMicroSeconds() - start;
+	cpu = getCPUTime() - cpu;
+
+	result.completed = 0;
+	result.errors = 0;
+	result.received = 0;
+	result.client = 0;
+	for (THttpLoadClient* client : list) {
+		result.completed += client->getCompleted();
+		result.errors += client->getErrors();
+		result.received += client->getReceived();
+		result.client += client->getCPUTime();
+		delete client;
+	}
+	result.server = std::max(cpu - result.client, (int64_t)0);
+	latency.getValues(result.latency);
+
+	return result.errors == 0 && threads.size() == clients;
+}
+
+static double getRequestRate(const THttpLoadResult& result) {
+	return result.elapsed > 0 ? (double)result.completed * 1000000.0 / (double)result.elapsed : 0.0;
+}
+
+static bool createDataFile(const std::string& fileName, const uint64_t size) {
+	// File is filled with DSD silence pattern and stays in page cache after writing
+	// --> Both response paths read the same cached pages unless file is larger than memory
+	int fd = ::open(fileName.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+	if (fd < 0)
+		return false;
+	std::vector<uint8_t> buffer(1048576, 0x69);
+	uint64_t written = 0;
+	while (written < size) {
+		size_t chunk = (size_t)std::min((uint64_t)buffer.size(), size - written);
+		ssize_t r = ::write(fd, buffer.data(), chunk);
+		if (r <= 0)
+			break;
+		written += (uint64_t)r;
+	}
+	::close(fd);
+	return written == size;
+}
+
+
+int transferBenchmark(const TBenchmarkArguments& args) {
+	const std::string path = args.getValue("path", "/tmp");
+	const uint64_t size = (uint64_t)std::max(args.getInteger("size", 4096), (int64_t)1) * 1048576;
+	const size_t clients = std::min((size_t)std::max(args.getInteger("clients", 1), (int64_t)1), HTTP_MAX_CLIENTS);
+	const size_t requests = (size_t)std::max(args.getInteger("requests", 2), (int64_t)1);
+	const int port = (int)args.getInteger("port", HTTP_DEFAULT_PORT);
+	const std::string threading = args.getValue("threading", "SINGLE");
+
+	printHeader("File transfer by web server, sendfile() against buffered callback");
+	TBenchWebServer web(path);
+	std::string fileName = web.getFolder() + "rmpbench.dsf";
+	if (!createDataFile(fileName, size)) {
+		std::cout << "Creating file " << fileName << " failed." << std::endl;
+		return EXIT_FAILURE;
+	}
+	std::cout << util::csnprintf("% clients with % requests each for % MB DSD file, plain HTTP on port %, threading mode %", clients, requests, size / 1048576, port, threading) << std::endl << std::endl;
+	std::cout << util::cprintf("  %-24s %10s %12s %14s %10s", "Response", "MB/s", "Server CPU", "Server ms/GB", "Client CPU") << std::endl;
+
+	int retVal = EXIT_SUCCESS;
+	for (int i=0; i<2; ++i) {
+		bool sendfile = i == 0;
+		if (!web.start(threading, sendfile, port)) {
+			retVal = EXIT_FAILURE;
+			break;
+		}
+		THttpLoadResult result;
+		if (!httpLoad(web.getURL("/fs0" + fileName), clients, requests, true, result))
+			retVal = EXIT_FAILURE;
+		web.stop();
+
+		// CPU time is given per GB transferred to compare file response paths
+		double gigabytes = (double)result.received / 1073741824.0;
+		std::cout << util::cprintf("  %-24s %10.1f %10.1f s %14.1f %8.1f s", sendfile ? "File descriptor" : "Buffered callback",
+				getThroughput(result.received, result.elapsed), (double)result.server / 1000000.0,
+				gigabytes > 0.0 ? (double)result.server / 1000.0 / gigabytes : 0.0, (double)result.client / 1000000.0) << std::endl;
+		if (result.errors > 0)
+			std::cout << util::cprintf("  %-24s %10zu failed", "", result.errors) << std::endl;
+	}
+
+	util::deleteFile(fileName);
+	return retVal;
+}
+
+
+int threadingBenchmark(const TBenchmarkArguments& args) {
+	const std::string path = args.getValue("path", "/tmp");
+	const uint64_t size = (uint64_t)std::max(args.getInteger("size", 20), (int64_t)1) * 1024;
+	const size_t clients = std::min((size_t)std::max(args.getInteger("clients", 16), (int64_t)1), HTTP_MAX_CLIENTS);
+	const size_t requests = (size_t)std::max(args.getInteger("requests", 2000), (int64_t)1);
+	const bool reuse = args.getInteger("reuse", 1) != 0;
+	const int port = (int)args.getInteger("port", HTTP_DEFAULT_PORT);
+	const util::TStringList modes(args.getValue("modes", "SINGLE,POOL,CONNECTION"), ',');
+
+	printHeader("Web server threading modes under concurrent load");
+	TBenchWebServer web(path);
+	std::string fileName = web.getFolder() + "rmpbench.bin";
+	if (!createDataFile(fileName, size)) {
+		std::cout << "Creating file " << fileName << " failed." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	// Pool workers are kept off the core reserved for the ALSA thread on multi core hosts only
+	size_t cores = sysutil::getProcessorCount();
+	std::cout << util::csnprintf("% clients with % requests each for % kB file, %", clients, requests, size / 1024,
+			reuse ? "connections kept alive" : "new connection per request") << std::endl;
+	std::cout << util::csnprintf("% processor cores, reserved ALSA core %", cores, cores > 1 ? "excluded from pool workers" : "not excluded (single core)") << std::endl << std::endl;
+	std::cout << util::cprintf("  %-24s %10s %10s %10s %12s", "Threading mode", "Requests/s", "p50 ms", "p99 ms", "Server CPU") << std::endl;
+
+	int retVal = EXIT_SUCCESS;
+	for (size_t i=0; i<modes.size(); ++i) {
+		const std::string& mode = modes[i];
+		if (!web.start(mode, false, port)) {
+			retVal = EXIT_FAILURE;
+			break;
+		}
+		THttpLoadResult result;
+		if (!httpLoad(web.getURL("/fs0" + fileName), clients, requests, reuse, result))
+			retVal = EXIT_FAILURE;
+		web.stop();
+
+		std::cout << util::cprintf("  %-24s %10.1f %10.2f %10.2f %10.2f s", mode.c_str(), getRequestRate(result),
+				(double)result.latency.p50 / 1000.0, (double)result.latency.p99 / 1000.0, (double)result.server / 1000000.0) << std::endl;
+		if (result.errors > 0)
+			std::cout << util::cprintf("  %-24s %10zu failed", "", result.errors) << std::endl;
+	}
+
+	util::deleteFile(fileName);
+	return retVal;
+}
+
+} /* namespace bench */
@@ -0,0 +1,23 @@
+/*
+ * benchweb.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: Dirk Brinkmeier
+ */
+
+#ifndef BENCHWEB_H_
+#define BENCHWEB_H_
+
+#include "benchtypes.h"
+
+namespace bench {
+
+// Transfer of a large DSD file by the web server, sendfile() against buffered callback response
+int transferBenchmark(const TBenchmarkArguments& args);
+
+// Requests/s and latency percentiles of the web server for each threading mode with concurrent keep-alive clients
+int threadingBenchmark(const TBenchmarkArguments& args);
+
+} /* namespace bench */
+
+#endif /* BENCHWEB_H_ */
@@ -64,6 +64,7 @@ void TAIFFStream::setSoundChunkEndian(CAIFFSoundChunk& sound) const {
 
 TAIFFDecoder::TAIFFDecoder() {
 	debug = false;
+	dataOffset = 0;
 }
 
 TAIFFDecoder::~TAIFFDecoder() {
@@ -117,6 +118,7 @@ bool TAIFFDecoder::open(const std::string& fileName, const CStreamData& properti
 					size_t r = file.seek(offset);
 					if (r != offset)
 						error = true;
+					dataOffset = offset;
 				}
 
 				// Close file on error!
@@ -124,6 +126,10 @@ bool TAIFFDecoder::open(const std::string& fileName, const CStreamData& properti
 					opened = false;
 					file.close();
 				}
+
+				// Prefetch sample data ahead of decoder
+				if (opened)
+					reader.open(file, dataOffset);
 			}
 			if (opened)
 				setStream(properties);
@@ -138,6 +144,27 @@ bool TAIFFDecoder::open(const std::string& fileName, const CStreamData& properti
 }
 
 
+bool TAIFFDecoder::seek(const size_t sample, PAudioBuffer buffer, size_t& position, size_t& read) {
+	position = 0;
+	read = 0;
+
+	// Sound data chunk contains fixed size big endian frames
+	if (canSeek() && !error) {
+		size_t offset = sample * getFrameSize();
+		if (offset < stream.sampleSize) {
+			size_t r = reader.seek(dataOffset + offset);
+			if (r == (dataOffset + offset)) {
+				if (debug) std::cout << "TAIFFDecoder::seek() Seek to sample " << sample << " at offset " << offset << std::endl;
+				setRead(offset);
+				position = offset;
+				eof = false;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
 bool TAIFFDecoder::update(PAudioBuffer buffer, size_t& read) {
 	read = 0;
 	bool warning = false;
@@ -147,7 +174,6 @@ bool TAIFFDecoder::update(PAudioBuffer buffer, size_t& read) {
 		PSong song = buffer->getSong();
 		if (util::assigned(song)) {
 			ssize_t r = 0;
-			PSample samples = buffer->writer();
 
 			// Resize sample buffer if needed
 			if (chunk.size() != song->getChunkSize()) {
@@ -157,7 +183,7 @@ bool TAIFFDecoder::update(PAudioBuffer buffer, size_t& read) {
 
 			// File reader may throw exception...
 			try {
-				r = file.read(chunk.data(), song->getChunkSize());
+				r = reader.read(chunk.data(), song->getChunkSize());
 				if (r > 0) {
 
 					// Check if all audio data is read
@@ -183,9 +209,11 @@ bool TAIFFDecoder::update(PAudioBuffer buffer, size_t& read) {
 
 					// Convert big endian chunk to little endian PCM data
 					// Remember that ALSA is set to use little endian PCM by application parameters!
-					// --> Set write buffer pointer to current position after successful conversion
-					size_t written = convertToLittleEndian(chunk.data(), samples, read, song->getBitsPerSample());
-					buffer->write(written);
+					// --> Write buffer pointer is set to current position after successful conversion
+					size_t written = 0;
+					PSample samples = buffer->writeSwapped(chunk.data(), read, song->getBitsPerSample());
+					if (util::assigned(samples))
+						written = buffer->writer() - samples;
 
 					// Check for successful endian conversion
 					if (read != written) {
@@ -210,8 +238,10 @@ bool TAIFFDecoder::update(PAudioBuffer buffer, size_t& read) {
 				eof = true;
 
 			// Close open file as early as possible...
-			if (eof && file.isOpen())
+			if (eof && file.isOpen()) {
+				reader.close();
 				file.close();
+			}
 
 			if (debug && eof) {
 				 std::cout << "TAIFFDecoder::update() EOF detected." << std::endl;
@@ -226,79 +256,14 @@ bool TAIFFDecoder::update(PAudioBuffer buffer, size_t& read) {
 	// Create internal error
 	error = true;
 	setBuffer(nil);
+	reader.close();
 	file.close();
 	return false;
 }
 
-size_t TAIFFDecoder::convertToLittleEndian(const TSample* aiff, TSample* pcm, size_t size, int bitsPerSample) {
-	size_t i = 0, written = 0;
-	TSample L1, L2, L3, R1, R2, R3;
-	while (i < size) {
-
-		// Read big endian aligned bytes from AIFF buffer
-		switch (bitsPerSample) {
-			case 8:
-				// Read/write 1 byte
-				*pcm++ = *aiff++;
-
-				// Increment read/write counter
-				++i;
-				++written;
-
-				break;
-
-			case 16:
-				// Read 2 bytes for each stereo (!) channel
-				L1 = *aiff++;
-				L2 = *aiff++;
-				R1 = *aiff++;
-				R2 = *aiff++;
-
-				// Reverse byte order in PCM stream
-				*pcm++ = L2;
-				*pcm++ = L1;
-				*pcm++ = R2;
-				*pcm++ = R1;
-
-				// Increment read/write counter
-				i += 2;
-				written += 2;
-
-				break;
-
-			case 24:
-				// Read 3 bytes for each stereo (!) channel
-				L1 = *aiff++;
-				L2 = *aiff++;
-				L3 = *aiff++;
-				R1 = *aiff++;
-				R2 = *aiff++;
-				R3 = *aiff++;
-
-				// Reverse byte order in PCM stream
-				*pcm++ = L3;
-				*pcm++ = L2;
-				*pcm++ = L1;
-				*pcm++ = R3;
-				*pcm++ = R2;
-				*pcm++ = R1;
-
-				// Increment read/write counter
-				i += 3;
-				written += 3;
-
-				break;
-
-			default:
-				break;
-		}
-
-	}
-	return written;
-}
-
 void TAIFFDecoder::close() {
 	clear();
+	reader.close();
 	file.close();
 	if (debug)
 		 std::cout << "TAIFFDecoder::close()" << std::endl;
@@ -30,17 +30,19 @@ class TAIFFDecoder : private TAIFFStream, public TAudioStream {
 private:
 	TSampleBuffer chunk;
 	util::TFile file;
+	size_t dataOffset;
 	bool debug;
 
-	size_t convertToLittleEndian(const TSample* aiff, TSample* pcm, size_t size, int bitsPerSample);
-
 public:
 	bool open(const std::string& fileName, const CStreamData& properties);
 	bool open(const TSong& song);
 	bool open(const PSong song);
 	bool open(const TDecoderParams& params);
 
+	bool canSeek() const { return opened && file.isOpen(); };
+
 	bool update(PAudioBuffer buffer, size_t& read);
+	bool seek(const size_t sample, PAudioBuffer buffer, size_t& position, size_t& read);
 
 	void close();
 
@@ -5,6 +5,8 @@
  *      Author: Dirk Brinkmeier
  */
 
+#include <cstring>
+#include <algorithm>
 #include "gcc.h"
 #include "endian.h"
 #include "bitmap.h"
@@ -1036,6 +1038,10 @@ bool TAACDecoder::open(const std::string& fileName, const CStreamData& propertie
 					opened = false;
 					file.close();
 				}
+
+				// Prefetch sample data ahead of decoder
+				if (opened)
+					reader.open(file, fileOffset);
 			}
 			if (!opened) {
 				freeDecoder();
@@ -1132,12 +1138,12 @@ bool TAACDecoder::update(PAudioBuffer buffer, size_t& read) {
 
 					// Go to next file position
 					if (debug) util::hexout("TAACDecoder::update() File offset = ", fileOffset);
-					r = file.seek(fileOffset);
+					r = reader.seek(fileOffset);
 					if (r != (ssize_t)fileOffset)
 						throw util::app_error_fmt("TAACDecoder::update() Seek to next chunk data failed (@/@)", r, fileOffset);
 
 					// Read input buffer size from file
-					bytesRead = this->read(file, inputBuffer, readBufferSize);
+					bytesRead = reader.read((char*)inputBuffer.data(), readBufferSize);
 					if (debug) std::cout << "TAACDecoder::update() Read from file = " << bytesRead << std::endl;
 					if (bytesRead <= 0) {
 						if (buffer->getWritten() <= 0)
@@ -1153,8 +1159,10 @@ bool TAACDecoder::update(PAudioBuffer buffer, size_t& read) {
 			}
 
 			// Close open file as early as possible...
-			if (eof && file.isOpen())
+			if (eof && file.isOpen()) {
+				reader.close();
 				file.close();
+			}
 
 			if (debug && eof) {
 				std::cout << "TAACDecoder::update() EOF detected." << std::endl;
@@ -1195,6 +1203,7 @@ ssize_t TAACDecoder::read(const util::TFile& file, TDecoderBuffer& buffer, const
 void TAACDecoder::close() {
 	bool r = error;
 	clear();
+	reader.close();
 	file.close();
 	freeDecoder();
 	if (debug)
@@ -1304,6 +1313,7 @@ bool TALACDecoder::createDecoder() {
 void TALACDecoder::freeDecoder() {
 	util::freeAndNil(decoder);
 	inputBuffer.clear();
+	packets.clear();
 	fileOffset = 0;
 	lastOffset = 0;
 	decodedSize = 0;
@@ -1345,6 +1355,12 @@ bool TALACDecoder::open(const std::string& fileName, const CStreamData& properti
 					parser.setDebug(debug);
 					ssize_t r = parser.scan(file, ETL_METADATA);
 					if (r > 0) {
+						// Build packet index from sample tables for seeking
+						// --> Missing or invalid tables disable seeking only
+						if (!createPacketIndex(file, parser)) {
+							if (debug) std::cout << "TAlacDecoder::open() No packet index for file \"" << fileName << "\"" << std::endl;
+						}
+
 						// Set offset to first data byte after data chunk file header
 						TALACAtom atom = parser["mdat"];
 						if (atom.data != std::string::npos) {
@@ -1387,6 +1403,10 @@ bool TALACDecoder::open(const std::string& fileName, const CStreamData& properti
 					opened = false;
 					file.close();
 				}
+
+				// Prefetch sample data ahead of decoder
+				if (opened)
+					reader.open(file, fileOffset);
 			}
 			if (!opened) {
 				freeDecoder();
@@ -1425,13 +1445,13 @@ bool TALACDecoder::update(PAudioBuffer buffer, size_t& read) {
 
 				// Go to file position
 				if (debug) util::hexout("TAlacDecoder::update() File offset = ", fileOffset);
-				r = file.seek(fileOffset);
+				r = reader.seek(fileOffset);
 				if (r != (ssize_t)fileOffset)
 					throw util::app_error_fmt("TAlacDecoder::update() Seek to next header position failed (@/@)", r, fileOffset);
 
 				// Read input buffer size from file
 				// inputBuffer.fillchar(0);
-				bytesRead = this->read(file, inputBuffer, readBufferSize);
+				bytesRead = reader.read((char*)inputBuffer.data(), readBufferSize);
 				if (debug) std::cout << "TAlacDecoder::update() Read from file = " << bytesRead << std::endl;
 				if (bytesRead > 0) {
 
@@ -1539,8 +1559,10 @@ bool TALACDecoder::update(PAudioBuffer buffer, size_t& read) {
 			//}
 
 			// Close open file as early as possible...
-			if (eof && file.isOpen())
+			if (eof && file.isOpen()) {
+				reader.close();
 				file.close();
+			}
 
 			if (debug && eof) {
 				std::cout << "TAlacDecoder::update() EOF detected." << std::endl;
@@ -1566,6 +1588,154 @@ bool TALACDecoder::update(PAudioBuffer buffer, size_t& read) {
 }
 
 
+bool TALACDecoder::seek(const size_t sample, PAudioBuffer buffer, size_t& position, size_t& read) {
+	position = 0;
+	read = 0;
+
+	// Find last packet starting at or before given sample
+	if (canSeek() && !error) {
+		TALACPacket packet;
+		packet.offset = 0;
+		packet.frame = sample;
+		TPacketIndex::const_iterator it = std::upper_bound(packets.begin(), packets.end(), packet,
+				[] (const TALACPacket& value, const TALACPacket& item) -> bool { return value.frame < item.frame; });
+		if (it != packets.begin()) {
+			--it;
+			size_t offset = it->frame * getFrameSize();
+			if (offset < stream.sampleSize && it->offset < file.getSize()) {
+				if (debug) std::cout << "TAlacDecoder::seek() Seek to sample " << sample << " in packet at frame " << it->frame << ", file offset " << it->offset << std::endl;
+				fileOffset = lastOffset = it->offset;
+				decodedSize = offset;
+				position = offset;
+				setRead(offset);
+				BitBufferReset(&readBuffer);
+				eof = false;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+bool TALACDecoder::readAtom(const util::TFile& file, const TALACAtom& atom, util::TBuffer& buffer) {
+	if (atom.offset != std::string::npos && atom.size > (atom.data - atom.offset)) {
+		size_t size = atom.size - (atom.data - atom.offset);
+		buffer.resize(size, false);
+		return ((ssize_t)size == file.read(buffer.data(), size, atom.data, util::SO_FROM_START));
+	}
+	return false;
+}
+
+size_t TALACDecoder::getTableValue(const util::TBuffer& buffer, const size_t offset, const bool large) const {
+	if (large) {
+		if ((offset + sizeof(uint64_t)) <= buffer.size()) {
+			uint64_t value;
+			memcpy(&value, buffer.data() + offset, sizeof(uint64_t));
+			return (size_t)convertFromBigEndian64(value);
+		}
+	} else {
+		if ((offset + sizeof(uint32_t)) <= buffer.size()) {
+			uint32_t value;
+			memcpy(&value, buffer.data() + offset, sizeof(uint32_t));
+			return (size_t)convertFromBigEndian32(value);
+		}
+	}
+	return std::string::npos;
+}
+
+bool TALACDecoder::createPacketIndex(const util::TFile& file, const TALACAtomScanner& parser) {
+	packets.clear();
+
+	// Sample tables from 'stbl' atom:
+	//   stsz : Size of each packet
+	//   stsc : Packets per chunk
+	//   stco : 32 bit chunk offsets (or co64 for 64 bit offsets)
+	//   stts : Frames per packet
+	// All tables start with DWORD for version flags
+	const TALACAtom& stsz = parser["stsz"];
+	const TALACAtom& stsc = parser["stsc"];
+	const TALACAtom& stts = parser["stts"];
+	const TALACAtom& co64 = parser["co64"];
+	bool large = co64.offset != std::string::npos;
+	const TALACAtom& stco = large ? co64 : parser["stco"];
+
+	util::TBuffer sizes, map, times, chunks;
+	if (!readAtom(file, stsz, sizes) || !readAtom(file, stsc, map) || !readAtom(file, stts, times) || !readAtom(file, stco, chunks))
+		return false;
+
+	// Read table sizes
+	size_t fixed = getTableValue(sizes, 4);
+	size_t count = getTableValue(sizes, 8);
+	size_t mapCount = getTableValue(map, 4);
+	size_t timeCount = getTableValue(times, 4);
+	size_t chunkCount = getTableValue(chunks, 4);
+	if (fixed == std::string::npos || count == std::string::npos || mapCount == std::string::npos || timeCount == std::string::npos || chunkCount == std::string::npos)
+		return false;
+	if (count <= 0 || mapCount <= 0 || timeCount <= 0 || chunkCount <= 0)
+		return false;
+
+	// Iterate through chunks and add offsets of all packets in chunk
+	size_t width = large ? sizeof(uint64_t) : sizeof(uint32_t);
+	size_t packet = 0, frame = 0;
+	size_t entry = 0, perChunk = 0;
+	size_t time = 0, remaining = 0, delta = 0;
+	TALACPacket item;
+	packets.reserve(count);
+	for (size_t chunk=0; chunk<chunkCount && packet<count; ++chunk) {
+
+		// Get packets per chunk for current chunk index (first chunk index is 1 based)
+		while (entry < mapCount) {
+			size_t first = getTableValue(map, 8 + entry * 12);
+			if (first == std::string::npos || first > (chunk + 1))
+				break;
+			perChunk = getTableValue(map, 8 + entry * 12 + 4);
+			++entry;
+		}
+		if (perChunk == std::string::npos || perChunk <= 0)
+			break;
+
+		size_t offset = getTableValue(chunks, 8 + chunk * width, large);
+		if (offset == std::string::npos)
+			break;
+
+		for (size_t i=0; i<perChunk && packet<count; ++i) {
+
+			// Get frames per packet from time to sample table
+			if (remaining <= 0) {
+				if (time >= timeCount)
+					break;
+				remaining = getTableValue(times, 8 + time * 8);
+				delta = getTableValue(times, 8 + time * 8 + 4);
+				if (remaining == std::string::npos || delta == std::string::npos)
+					break;
+				++time;
+			}
+
+			item.offset = offset;
+			item.frame = frame;
+			packets.push_back(item);
+
+			size_t size = fixed > 0 ? fixed : getTableValue(sizes, 12 + packet * 4);
+			if (size == std::string::npos)
+				break;
+			offset += size;
+			frame += delta;
+			if (remaining > 0)
+				--remaining;
+			++packet;
+		}
+	}
+
+	// Index must cover all packets
+	if (packets.size() != count) {
+		packets.clear();
+		return false;
+	}
+
+	if (debug) std::cout << "TAlacDecoder::createPacketIndex() " << packets.size() << " packets for " << frame << " frames indexed." << std::endl;
+	return true;
+}
+
 bool TALACDecoder::getBlockHeader(const void *const buffer, const size_t size, TAlacBlockHeader& header) const {
 	size_t hsize = sizeof(TAlacBlockHeader);
 	/* std::cout << util::csnprintf("TAlacDecoder::getBlockHeader() Header size (%/%)", size, hsize) << std::endl; */
@@ -1663,6 +1833,7 @@ size_t TALACDecoder::getBlockLength(const TDecoderBuffer& buffer, size_t& length
 
 void TALACDecoder::close() {
 	clear();
+	reader.close();
 	file.close();
 	freeDecoder();
 	if (debug)
@@ -9,6 +9,7 @@
 #define ALAC_H_
 
 #include <map>
+#include <vector>
 #include "gcc.h"
 
 #include "id3.h"
@@ -33,6 +34,11 @@ typedef struct CAlacAtom {
 	DWORD hash;
 } TALACAtom;
 
+typedef struct CAlacPacket {
+	size_t offset;
+	size_t frame;
+} TALACPacket;
+
 
 #ifdef STL_HAS_TEMPLATE_ALIAS
 
@@ -41,6 +47,7 @@ using TAtomMapItem = std::pair<std::string, TALACAtom>;
 using TTagMap = std::map<DWORD, std::string>;
 using TTagMapItem = std::pair<DWORD, std::string>;
 using TDecoderBuffer = util::TDataBuffer<uint8_t>;
+using TPacketIndex = std::vector<TALACPacket>;
 
 #else
 
@@ -49,6 +56,7 @@ typedef std::pair<std::string, TALACAtom> TAtomMapItem;
 typedef std::map<DWORD, std::string> TTagMap;
 typedef std::pair<DWORD, std::string> TTagMapItem;
 typedef util::TDataBuffer<uint8_t> TDecoderBuffer;
+typedef std::vector<TALACPacket> TPacketIndex;
 
 #endif
 
@@ -198,6 +206,7 @@ private:
     size_t decodedSize;
 
     TAlacBlockHeader blockHeader;
+    TPacketIndex packets;
 	util::TFile file;
 	bool debug;
 
@@ -206,6 +215,10 @@ private:
 	bool createDecoder();
 	void freeDecoder();
 
+	bool createPacketIndex(const util::TFile& file, const TALACAtomScanner& parser);
+	bool readAtom(const util::TFile& file, const TALACAtom& atom, util::TBuffer& buffer);
+	size_t getTableValue(const util::TBuffer& buffer, const size_t offset, const bool large = false) const;
+
 	size_t getBlockLength(const TDecoderBuffer& buffer, size_t& length);
 	bool getBlockHeader(const void *const buffer, const size_t size, TAlacBlockHeader& header) const;
 	bool isBlockHeader(const TAlacBlockHeader& header) const;
@@ -222,7 +235,10 @@ public:
 	bool open(const PSong song);
 	bool open(const TDecoderParams& params);
 
+	bool canSeek() const { return opened && file.isOpen() && !packets.empty(); };
+
 	bool update(PAudioBuffer buffer, size_t& read);
+	bool seek(const size_t sample, PAudioBuffer buffer, size_t& position, size_t& read);
 
 	void close();
 
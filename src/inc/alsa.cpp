@@ -6,6 +6,8 @@
  */
 
 #include <iostream>
+#include <algorithm>
+#include <cstring>
 #include <string>
 #include "alsa.h"
 #include "bits.h"
@@ -17,6 +19,7 @@
 #include "datetime.h"
 #include "templates.h"
 #include "semaphores.h"
+#include "sysutils.h"
 #include "endianutils.h"
 #include "audioconsts.h"
 #include "audiofile.h"
@@ -34,6 +37,14 @@ static void* alsaThreadDispatcher(void *thread) {
 	return (void *)(long)(EXIT_FAILURE);
 }
 
+// Monotonic time in microseconds for latency statistics
+static int64_t getMicroSeconds() {
+	struct timespec ts;
+	if (EXIT_SUCCESS == clock_gettime(CLOCK_MONOTONIC, &ts))
+		return (int64_t)ts.tv_sec * 1000000 + (int64_t)ts.tv_nsec / 1000;
+	return 0;
+}
+
 
 namespace music {
 
@@ -158,14 +169,61 @@ void TByteConverter::write24to32Bit(const TSample *& src, int32_t *& dst, size_t
 
 
 
-TPCMConverter::TPCMConverter() {
+// Helper for dithered upscaling of PCM samples
+// --> Source samples are little endian, dither is added as 8 bit fraction of the source sample
+static inline int32_t readSample16(const TSample *& src) {
+	int16_t sample = (int16_t)(src[0] | (src[1] << 8));
+	src += 2;
+	return sample;
 }
 
-TPCMConverter::~TPCMConverter() {
+static inline int32_t readSample24(const TSample *& src) {
+	int32_t sample = src[0] | (src[1] << 8) | (src[2] << 16);
+	if (sample & 0x800000)
+		sample -= 0x1000000;
+	src += 3;
+	return sample;
 }
 
-TSample TPCMConverter::getRandomDither() {
-	return (TSample)util::randomize(0, 255);
+static inline int32_t addDither24(const int32_t sample, const int32_t dither) {
+	int32_t value = sample * 256 + dither;
+	if (value > 8388607)
+		return 8388607;
+	if (value < -8388608)
+		return -8388608;
+	return value;
+}
+
+static inline int32_t addDither32(const int32_t sample, const int32_t dither) {
+	int64_t value = (int64_t)sample * 256 + dither;
+	if (value > util::TLimits::LIMIT_INT32_MAX)
+		return util::TLimits::LIMIT_INT32_MAX;
+	if (value < util::TLimits::LIMIT_INT32_MIN)
+		return util::TLimits::LIMIT_INT32_MIN;
+	return (int32_t)value;
+}
+
+static inline void writeSample(TSample * dst, const int32_t value, const size_t bytes, const bool isLittleEndian) {
+	uint32_t v = (uint32_t)value;
+	if (isLittleEndian) {
+		for (size_t i=0; i<bytes; ++i) {
+			*(dst++) = (TSample)(v & 0xFF);
+			v >>= 8;
+		}
+	} else {
+		dst += bytes;
+		for (size_t i=0; i<bytes; ++i) {
+			*(--dst) = (TSample)(v & 0xFF);
+			v >>= 8;
+		}
+	}
+}
+
+
+TPCMConverter::TPCMConverter() {
+}
+
+TPCMConverter::~TPCMConverter() {
 }
 
 
@@ -179,31 +237,33 @@ void TPCMConverter::write16to16Bit(const TSample *src, TSample *& dst, size_t& r
 
 void TPCMConverter::write16to24Bit(const TSample *src, TSample *& dst, size_t& read, snd_pcm_uframes_t frames, const util::EEndianType endian, const bool dithered) {
 	bool isLittleEndian = endian == util::EE_LITTLE_ENDIAN;
-	TSample dither = 0;
-	for (snd_pcm_uframes_t i=0; i<frames; ++i) {
-		if (dithered) {
-			dither = getRandomDither();
+	if (dithered) {
+		const int32_t* dither = generator.generate(frames, 2);
+		for (snd_pcm_uframes_t i=0; i<frames; ++i) {
+			write16to24Bit(src, dst, read, isLittleEndian, *(dither++)); // Left channel
+			write16to24Bit(src, dst, read, isLittleEndian, *(dither++)); // Right channel
 		}
-		write16to24Bit(src, dst, read, isLittleEndian, dither); // Left channel
-		if (dithered) {
-			dither = getRandomDither();
+	} else {
+		for (snd_pcm_uframes_t i=0; i<frames; ++i) {
+			write16to24Bit(src, dst, read, isLittleEndian); // Left channel
+			write16to24Bit(src, dst, read, isLittleEndian); // Right channel
 		}
-		write16to24Bit(src, dst, read, isLittleEndian, dither); // Right channel
 	}
 }
 
 void TPCMConverter::write16to32Bit(const TSample *src, TSample *& dst, size_t& read, snd_pcm_uframes_t frames, const util::EEndianType endian, const bool dithered) {
 	bool isLittleEndian = endian == util::EE_LITTLE_ENDIAN;
-	TSample dither = 0;
-	for (snd_pcm_uframes_t i=0; i<frames; ++i) {
-		if (dithered) {
-			dither = getRandomDither();
+	if (dithered) {
+		const int32_t* dither = generator.generate(frames, 2);
+		for (snd_pcm_uframes_t i=0; i<frames; ++i) {
+			write16to32Bit(src, dst, read, isLittleEndian, *(dither++)); // Left channel
+			write16to32Bit(src, dst, read, isLittleEndian, *(dither++)); // Right channel
 		}
-		write16to32Bit(src, dst, read, isLittleEndian, dither); // Left channel
-		if (dithered) {
-			dither = getRandomDither();
+	} else {
+		for (snd_pcm_uframes_t i=0; i<frames; ++i) {
+			write16to32Bit(src, dst, read, isLittleEndian); // Left channel
+			write16to32Bit(src, dst, read, isLittleEndian); // Right channel
 		}
-		write16to32Bit(src, dst, read, isLittleEndian, dither); // Right channel
 	}
 }
 
@@ -218,16 +278,17 @@ void TPCMConverter::write24to24Bit(const TSample *src, TSample *& dst, size_t& r
 
 void TPCMConverter::write24to32Bit(const TSample *src, TSample *& dst, size_t& read, snd_pcm_uframes_t frames, const util::EEndianType endian, const bool dithered) {
 	bool isLittleEndian = endian == util::EE_LITTLE_ENDIAN;
-	TSample dither = 0;
-	for (size_t i=0; i<frames; ++i) {
-		if (dithered) {
-			dither = getRandomDither();
+	if (dithered) {
+		const int32_t* dither = generator.generate(frames, 2);
+		for (snd_pcm_uframes_t i=0; i<frames; ++i) {
+			write24to32Bit(src, dst, read, isLittleEndian, *(dither++)); // Left channel
+			write24to32Bit(src, dst, read, isLittleEndian, *(dither++)); // Right channel
 		}
-		write24to32Bit(src, dst, read, isLittleEndian, dither); // Left channel
-		if (dithered) {
-			dither = getRandomDither();
+	} else {
+		for (snd_pcm_uframes_t i=0; i<frames; ++i) {
+			write24to32Bit(src, dst, read, isLittleEndian); // Left channel
+			write24to32Bit(src, dst, read, isLittleEndian); // Right channel
 		}
-		write24to32Bit(src, dst, read, isLittleEndian, dither); // Right channel
 	}
 }
 
@@ -244,31 +305,37 @@ void TPCMConverter::write16to16Bit(const TSample *& src, TSample *& dst, size_t&
 	read += 2;
 }
 
-void TPCMConverter::write16to24Bit(const TSample *& src, TSample *& dst, size_t& read, const bool isLittleEndian, const TSample dither) {
-	if (isLittleEndian) {
-		*(dst++) = dither;
+void TPCMConverter::write16to24Bit(const TSample *& src, TSample *& dst, size_t& read, const bool isLittleEndian, const int32_t dither) {
+	if (dither != 0) {
+		writeSample(dst, addDither24(readSample16(src), dither), 3, isLittleEndian);
+		dst += 3;
+	} else if (isLittleEndian) {
+		*(dst++) = 0;
 		*(dst++) = *(src++);
 		*(dst++) = *(src++);
 	} else {
 		TSample b = *(src++);
 		*(dst++) = *(src++);
 		*(dst++) = b;
-		*(dst++) = dither;
+		*(dst++) = 0;
 	}
 	read += 2;
 }
 
-void TPCMConverter::write16to32Bit(const TSample *& src, TSample *& dst, size_t& read, const bool isLittleEndian, const TSample dither) {
-	if (isLittleEndian) {
+void TPCMConverter::write16to32Bit(const TSample *& src, TSample *& dst, size_t& read, const bool isLittleEndian, const int32_t dither) {
+	if (dither != 0) {
+		writeSample(dst, addDither24(readSample16(src), dither) * 256, 4, isLittleEndian);
+		dst += 4;
+	} else if (isLittleEndian) {
+		*(dst++) = 0;
 		*(dst++) = 0;
-		*(dst++) = dither;
 		*(dst++) = *(src++);
 		*(dst++) = *(src++);
 	} else {
 		TSample b = *(src++);
 		*(dst++) = *(src++);
 		*(dst++) = b;
-		*(dst++) = dither;
+		*(dst++) = 0;
 		*(dst++) = 0;
 	}
 	read += 2;
@@ -289,9 +356,12 @@ void TPCMConverter::write24to24Bit(const TSample *& src, TSample *& dst, size_t&
 	read += 3;
 }
 
-void TPCMConverter::write24to32Bit(const TSample *& src, TSample *& dst, size_t& read, const bool isLittleEndian, const TSample dither) {
-	if (isLittleEndian) {
-		*(dst++) = dither;
+void TPCMConverter::write24to32Bit(const TSample *& src, TSample *& dst, size_t& read, const bool isLittleEndian, const int32_t dither) {
+	if (dither != 0) {
+		writeSample(dst, addDither32(readSample24(src), dither), 4, isLittleEndian);
+		dst += 4;
+	} else if (isLittleEndian) {
+		*(dst++) = 0;
 		*(dst++) = *(src++);
 		*(dst++) = *(src++);
 		*(dst++) = *(src++);
@@ -301,7 +371,7 @@ void TPCMConverter::write24to32Bit(const TSample *& src, TSample *& dst, size_t&
 		*(dst++) = *(src++);;
 		*(dst++) = b2;
 		*(dst++) = b1;
-		*(dst++) = dither;
+		*(dst++) = 0;
 	}
 	read += 3;
 }
@@ -322,34 +392,38 @@ void TPCMConverter::write16to16Bit(const TSample *& src, TSample *& dst, size_t&
 	dst += step;
 }
 
-void TPCMConverter::write16to24Bit(const TSample *& src, TSample *& dst, size_t& read, const snd_pcm_int_t step, const bool isLittleEndian, const TSample dither) {
+void TPCMConverter::write16to24Bit(const TSample *& src, TSample *& dst, size_t& read, const snd_pcm_int_t step, const bool isLittleEndian, const int32_t dither) {
 	TSample *p = dst;
-	if (isLittleEndian) {
-		*(p++) = dither;
+	if (dither != 0) {
+		writeSample(p, addDither24(readSample16(src), dither), 3, isLittleEndian);
+	} else if (isLittleEndian) {
+		*(p++) = 0;
 		*(p++) = *(src++);
 		*p = *(src++);
 	} else {
 		TSample b = *(src++);
 		*(p++) = *(src++);
 		*(p++) = b;
-		*p = dither;
+		*p = 0;
 	}
 	read += 2;
 	dst += step;
 }
 
-void TPCMConverter::write16to32Bit(const TSample *& src, TSample *& dst, size_t& read, const snd_pcm_int_t step, const bool isLittleEndian, const TSample dither) {
+void TPCMConverter::write16to32Bit(const TSample *& src, TSample *& dst, size_t& read, const snd_pcm_int_t step, const bool isLittleEndian, const int32_t dither) {
 	TSample *p = dst;
-	if (isLittleEndian) {
+	if (dither != 0) {
+		writeSample(p, addDither24(readSample16(src), dither) * 256, 4, isLittleEndian);
+	} else if (isLittleEndian) {
+		*(p++) = 0;
 		*(p++) = 0;
-		*(p++) = dither;
 		*(p++) = *(src++);
 		*p = *(src++);
 	} else {
 		TSample b = *(src++);
 		*(p++) = *(src++);
 		*(p++) = b;
-		*(p++) = dither;
+		*(p++) = 0;
 		*p = 0;
 	}
 	read += 2;
@@ -373,10 +447,12 @@ void TPCMConverter::write24to24Bit(const TSample *& src, TSample *& dst, size_t&
 	dst += step;
 }
 
-void TPCMConverter::write24to32Bit(const TSample *& src, TSample *& dst, size_t& read, const snd_pcm_int_t step, const bool isLittleEndian, const TSample dither) {
+void TPCMConverter::write24to32Bit(const TSample *& src, TSample *& dst, size_t& read, const snd_pcm_int_t step, const bool isLittleEndian, const int32_t dither) {
 	TSample *p = dst;
-	if (isLittleEndian) {
-		*(p++) = dither;
+	if (dither != 0) {
+		writeSample(p, addDither32(readSample24(src), dither), 4, isLittleEndian);
+	} else if (isLittleEndian) {
+		*(p++) = 0;
 		*(p++) = *(src++);
 		*(p++) = *(src++);
 		*p = *(src++);
@@ -386,7 +462,7 @@ void TPCMConverter::write24to32Bit(const TSample *& src, TSample *& dst, size_t&
 		*(p++) = *(src++);
 		*(p++) = b2;
 		*(p++) = b1;
-		*p = dither;
+		*p = 0;
 	}
 	read += 3;
 	dst += step;
@@ -466,17 +542,27 @@ void TAlsaPlayer::prime() {
 	m_periodtime = 1000000; // 1 second
 	m_skipframe = 10; // 10 seconds
 	m_buffertime = 0;
-	handler = nil;
 	logfile = nil;
 	verbosity = 0;
 	debug = false;
 	enabled = false;
 	dithered = false;
+	m_nativedsd = true;
+	m_resamplerate = 0;
+	m_resamplequality = ERQ_MEDIUM;
+	resampling = false;
+	reopenTime = 0;
+	drainTime = 0;
+	wakeupTime = 0;
+	commitTime = 0;
+	resetStatistics();
 	alsaMtx.open();
 	clear();
 }
 
 void TAlsaPlayer::clear() {
+	// Asynchronous handler is freed by snd_pcm_close()
+	handler = nil;
 	snd_handle = nil;
 	hw_params = nil;
 	sw_params = nil;
@@ -491,6 +577,7 @@ void TAlsaPlayer::clear() {
 	snd_activeperiodtime = 0;
 	snd_format = SND_PCM_FORMAT_UNKNOWN;
 	snd_physicalwidth = 0;
+	native = false;
 	periodEvent = false;
 	ignoreMixer = false;
 	forceReopen = false;
@@ -508,6 +595,7 @@ void TAlsaPlayer::reset(const EPlayerState state) {
 	m_endian = util::EE_LITTLE_ENDIAN;
 	m_state = p_state /*= e_state*/ = state;
 	currentSong.clear();
+	seekRequest.clear();
 	dop = false;
 	lastSongProgress = 0;
 	lastSongStreamed = 0;
@@ -541,7 +629,11 @@ void TAlsaPlayer::configure(const TAlsaConfig& config) {
 	setVerbosity(config.verbosity);
 	setDebug(config.debug);
 	setDithered(config.dithered);
+	setDitherSpectrum(config.spectrum);
 	setIgnoreMixer(config.ignoremixer);
+	setNativeDSD(config.nativedsd);
+	setResampleRate(config.resamplerate);
+	setResampleQuality(config.resamplequality);
 	setLogFile(config.logger);
 }
 
@@ -664,8 +756,11 @@ snd_pcm_format_t TAlsaPlayer::getHardwareFormat() {
 	if (success() && val != SND_PCM_FORMAT_UNKNOWN) {
 		logger("[Hardware] Format reported from hardware is " + formatToStr(val) + " (" + std::to_string((size_s)val) + ")");
 		util::EEndianType endian = getEndianFromFormat(val);
-		if (endian != util::EE_UNKNOWN_ENDIAN)
-			return val;
+		if (endian != util::EE_UNKNOWN_ENDIAN) {
+			// Native DSD formats are only valid for native DSD transfer and vice versa
+			if (isDSDFormat(val) == native)
+				return val;
+		}
 	}
 
 	// No valid hardware format found
@@ -708,6 +803,191 @@ bool TAlsaPlayer::setHardwareFormat(const snd_pcm_format_t format) {
 	return ok;
 }
 
+bool TAlsaPlayer::isDSDFormat(const snd_pcm_format_t format) const {
+	return util::isMemberOf(format, SND_PCM_FORMAT_DSD_U8,SND_PCM_FORMAT_DSD_U16_LE,SND_PCM_FORMAT_DSD_U16_BE,SND_PCM_FORMAT_DSD_U32_LE,SND_PCM_FORMAT_DSD_U32_BE);
+}
+
+bool TAlsaPlayer::isDSDStream(const CStreamData& stream) const {
+	return util::isMemberOf(stream.bitsPerSample, (int)ES_DSD_NE,(int)ES_DSD_OE);
+}
+
+bool TAlsaPlayer::isResampled(const CStreamData& stream) const {
+	// Only PCM streams are converted to the locked device rate, DSD is always played bit perfect
+	return m_resamplerate > 0 && stream.sampleRate != m_resamplerate &&
+			TResampler::isSupported(stream.sampleRate, m_resamplerate, stream.channels, stream.bitsPerSample);
+}
+
+CStreamData TAlsaPlayer::getOutputStream(const CStreamData& stream) const {
+	// Stream parameters as seen by the sound device
+	CStreamData output = stream;
+	if (isResampled(stream))
+		output.sampleRate = m_resamplerate;
+	return output;
+}
+
+bool TAlsaPlayer::updateResampler(const CStreamData& stream) {
+	// Filter history is continued for songs with identical stream parameters
+	if (!isResampled(stream) || native) {
+		if (resampling) {
+			resampler.reset();
+			resampling = false;
+		}
+		return false;
+	}
+	if (!resampler.isConfigured(stream.sampleRate, m_resamplerate, stream.channels, stream.bitsPerSample)) {
+		if (prepared.isConfigured(stream.sampleRate, m_resamplerate, stream.channels, stream.bitsPerSample)) {
+			// Filter bank was designed by play() or prepare() before
+			resampler.swap(prepared);
+			resampler.reset();
+		} else {
+			// Should never happen, filter design is expensive on playback thread
+			logger(util::csnprintf("[Resampler] Filter bank for % Hz to % Hz was not prepared", stream.sampleRate, m_resamplerate));
+			if (!resampler.setup(stream.sampleRate, m_resamplerate, stream.channels, stream.bitsPerSample, m_resamplequality)) {
+				resampling = false;
+				return false;
+			}
+		}
+		logger(util::csnprintf("[Resampler] Convert % Hz to % Hz, % phases with % taps (%)", stream.sampleRate, m_resamplerate,
+				resampler.getPhases(), resampler.getTaps(), resamplerQualityToStr(m_resamplequality)));
+	}
+	resampling = true;
+	return true;
+}
+
+void TAlsaPlayer::prepareResampler(const CStreamData& stream) {
+	// Design filter bank for given stream on calling thread without holding the ALSA lock
+	// --> Prepared resampler is activated by the ALSA thread when the stream is played
+	int rate;
+	EResamplerQuality quality;
+	{
+		app::TLockGuard<app::TMutex> lock(alsaMtx);
+		rate = m_resamplerate;
+		quality = m_resamplequality;
+		if (rate <= 0 || stream.sampleRate == rate || isDSDStream(stream))
+			return;
+		if (!TResampler::isSupported(stream.sampleRate, rate, stream.channels, stream.bitsPerSample)) {
+			logger(util::csnprintf("[Resampler] Unsupported conversion from % Hz to % Hz, stream is played at native rate", stream.sampleRate, rate));
+			return;
+		}
+		if (resampler.isConfigured(stream.sampleRate, rate, stream.channels, stream.bitsPerSample) ||
+			prepared.isConfigured(stream.sampleRate, rate, stream.channels, stream.bitsPerSample))
+			return;
+	}
+	TResampler filter;
+	if (filter.setup(stream.sampleRate, rate, stream.channels, stream.bitsPerSample, quality)) {
+		app::TLockGuard<app::TMutex> lock(alsaMtx);
+		prepared.swap(filter);
+	}
+}
+
+snd_pcm_format_t TAlsaPlayer::getNativeDSDFormat(const CStreamData& stream, snd_pcm_uint_t& rate) {
+	// Native DSD formats in order of preference
+	static const snd_pcm_format_t formats[] = {
+		SND_PCM_FORMAT_DSD_U32_BE,
+		SND_PCM_FORMAT_DSD_U32_LE,
+		SND_PCM_FORMAT_DSD_U16_BE,
+		SND_PCM_FORMAT_DSD_U16_LE,
+		SND_PCM_FORMAT_DSD_U8
+	};
+	static const size_t count = sizeof(formats) / sizeof(formats[0]);
+	rate = 0;
+
+	snd_pcm_hw_params_t* any;
+	snd_pcm_hw_params_t* params;
+	snd_pcm_hw_params_alloca(&any);
+	snd_pcm_hw_params_alloca(&params);
+	if (!util::assigned(any) || !util::assigned(params))
+		return SND_PCM_FORMAT_UNKNOWN;
+	if (snd_pcm_hw_params_any(snd_handle, any) < 0)
+		return SND_PCM_FORMAT_UNKNOWN;
+
+	// Stream sample rate is given for DoP transfer with 16 DSD bits per channel
+	// --> Frame rate for native transfer depends on format width
+	for (size_t i=0; i<count; ++i) {
+		snd_pcm_format_t format = formats[i];
+		snd_pcm_hw_params_copy(params, any);
+		if (snd_pcm_hw_params_set_format(snd_handle, params, format) == 0) {
+			int width = snd_pcm_format_physical_width(format);
+			if (width > 0) {
+				snd_pcm_uint_t r = stream.sampleRate * 16 / width;
+				if (snd_pcm_hw_params_test_channels(snd_handle, params, stream.channels) == 0 &&
+					snd_pcm_hw_params_test_rate(snd_handle, params, r, 0) == 0) {
+					logger(util::csnprintf("[Native] Hardware supports format $ at % Hz", formatToStr(format), r));
+					rate = r;
+					return format;
+				}
+			}
+		}
+	}
+
+	return SND_PCM_FORMAT_UNKNOWN;
+}
+
+bool TAlsaPlayer::openNativeDevice(const std::string& device, const CStreamData& stream) {
+	errval = EXIT_SUCCESS;
+	bool retVal = false;
+	native = false;
+
+	// Use DoP stream parameters as base for native transfer
+	logger("[Open] [NATIVE_DSD]");
+	if (setAlsaParams(stream, util::EE_LITTLE_ENDIAN)) {
+
+		// Retrieve PCM sound handle
+		errval = snd_pcm_open(&snd_handle, device.c_str(), SND_PCM_STREAM_PLAYBACK, 0);
+		if (success() && util::assigned(snd_handle)) {
+
+			// Get best native DSD format supported by hardware
+			snd_pcm_uint_t rate;
+			snd_pcm_format_t format = getNativeDSDFormat(stream, rate);
+			if (format != SND_PCM_FORMAT_UNKNOWN && setHardwareFormat(format)) {
+
+				// Sample buffer data is transferred without DoP marker
+				// --> One hardware frame consumes the same amount of bytes from sample buffer
+				native = true;
+				snd_samplerate = rate;
+				snd_dataframesize = snd_framesize;
+
+				// Initialize hardware and software parameter
+				if (setHardwareParams(SND_PCM_ACCESS_MMAP_INTERLEAVED)) {
+					if (setSoftwareParams()) {
+
+						// Open device was successful
+						this->device = device;
+						card = getHardwareCard();
+
+						// Set master volumes to 100%
+						bool r = setMasterVolume(100);
+						retVal = ignoreMixer ? true : r;
+
+					}
+				}
+
+			} else {
+				errmsg = "TAlsaPlayer::openNativeDevice() No native DSD format supported.";
+				errval = -EINVAL;
+			}
+
+		} else {
+			errmsg = util::csnprintf("TAlsaPlayer::openNativeDevice() Device $ open failed.", device);
+		}
+
+	} else {
+		errmsg = "TAlsaPlayer::openNativeDevice() Invalid stream parameter (NATIVE_DSD)";
+		errval = -EINVAL;
+	}
+
+	if (retVal) {
+		logger("[Open] Open <" + device + "> succeeded [" + card + "]");
+		logger("[Open] Format " + formatToStr(snd_format));
+		logger("[Open] Samplerate " + std::to_string((size_s)snd_samplerate) + " Frames/sec");
+	} else {
+		logger("[Open] [NATIVE_DSD] failed \"" + errmsg + "\", fallback to DoP");
+		native = false;
+	}
+
+	return retVal;
+}
+
 bool TAlsaPlayer::open(const CStreamData& stream) {
 	return open(device, stream);
 }
@@ -724,6 +1004,16 @@ bool TAlsaPlayer::open(const std::string& device, const CStreamData& stream) {
 
 
 bool TAlsaPlayer::openDevice(const std::string& device, const CStreamData& stream) {
+	// Prefer native DSD transfer if supported by hardware, DoP is used as fallback
+	if (m_nativedsd && isDSDStream(stream) && !getOpen() && !device.empty()) {
+		if (openNativeDevice(device, stream))
+			return true;
+		closeDevice();
+	}
+
+	// Device is opened with locked sample rate for resampled PCM streams
+	const CStreamData output = getOutputStream(stream);
+
 	errval = EXIT_SUCCESS;
 	bool retVal = false;
 	if (!getOpen()) {
@@ -732,7 +1022,7 @@ bool TAlsaPlayer::openDevice(const std::string& device, const CStreamData& strea
 
 			// Try to use little endian data transfer to sound card
     		logger("[Open] [LITTLE_ENDIAN]");
-			if (setAlsaParams(stream, util::EE_LITTLE_ENDIAN)) {
+			if (setAlsaParams(output, util::EE_LITTLE_ENDIAN)) {
 
 				// Retrieve PCM sound handle
 				errval = snd_pcm_open(&snd_handle, device.c_str(), SND_PCM_STREAM_PLAYBACK, 0);
@@ -775,7 +1065,7 @@ bool TAlsaPlayer::openDevice(const std::string& device, const CStreamData& strea
 
 				// Falback to big endian data transfer to sound card
 	    		logger("[Open] [BIG_ENDIAN]");
-				if (setAlsaParams(stream, util::EE_BIG_ENDIAN)) {
+				if (setAlsaParams(output, util::EE_BIG_ENDIAN)) {
 
 					// Retrieve PCM sound handle
 					errval = snd_pcm_open(&snd_handle, device.c_str(), SND_PCM_STREAM_PLAYBACK, 0);
@@ -822,9 +1112,13 @@ bool TAlsaPlayer::openDevice(const std::string& device, const CStreamData& strea
 	}
 
 	if (retVal) {
+		resampler.reset();
+		resampling = false;
 		logger("[Open] Open <" + device + "> succeeded [" + card + "]");
 		logger("[Open] Format " + formatToStr(snd_format));
-		logger("[Open] Samplerate " + std::to_string((size_s)stream.sampleRate) + " Samples/sec");
+		logger("[Open] Samplerate " + std::to_string((size_s)output.sampleRate) + " Samples/sec");
+		if (isResampled(stream))
+			logger("[Open] Resampled from " + std::to_string((size_s)stream.sampleRate) + " Samples/sec");
 	} else {
 		logger("[Open] Open <" + device + "> failed \"" + errmsg + "\" (" + std::to_string((size_s)errval) + ")");
 		closeDevice();
@@ -879,6 +1173,17 @@ bool TAlsaPlayer::dropDevice() {
 bool TAlsaPlayer::play(PSong song, const std::string& playlist, const std::string& device, bool& isOpen) {
 	bool retVal = false;
 	TPlayerState player;
+
+	// Wait for previous song to be played out before switching format in place
+	// --> ALSA thread keeps writing periods meanwhile
+	int64_t delay = getDrainDelay(song);
+	if (delay > 0)
+		util::wait(delay / 1000 + 1);
+
+	// Design resampler filter bank outside of ALSA lock
+	if (util::assigned(song))
+		prepareResampler(song->getStreamData());
+
 	{
 		app::TLockGuard<app::TMutex> lock(alsaMtx);
 		errval = EXIT_SUCCESS;
@@ -915,9 +1220,12 @@ bool TAlsaPlayer::play(PSong song, const std::string& playlist, const std::strin
 		}
 
 		// Check for identical stream parameter of given song compared to current song
-		// --> Close player and reopen on next call
+		// --> Reconfigure open device for changed stream format
+		// --> Close player and reopen on next call if reconfiguration is not possible
+		bool reconfigured = false;
 		if (getOpen()) {
 			bool reopen = false;
+			bool different = false;
 			if (forceReopen) {
 				// Reopen was requested by playlist queue
 				forceReopen = false;
@@ -926,8 +1234,9 @@ bool TAlsaPlayer::play(PSong song, const std::string& playlist, const std::strin
 				// Compare hardware format to previous song
 				if (util::assigned(lastSong.song)) {
 					if (song->getStreamData().isValid()) {
-						if (song->isChanged(true) || song->getStreamData() != lastSong.song->getStreamData()) {
+						if (song->isChanged(true) || getOutputStream(song->getStreamData()) != getOutputStream(lastSong.song->getStreamData())) {
 							reopen = true;
+							different = true;
 						}
 					}
 				} else {
@@ -936,6 +1245,21 @@ bool TAlsaPlayer::play(PSong song, const std::string& playlist, const std::strin
 					reopen = true;
 				}
 			}
+			if (different) {
+				int64_t begin = getMicroSeconds();
+				if (reconfigureDevice(song->getStreamData())) {
+					int64_t end = getMicroSeconds();
+					if (reopenTime > 0)
+						logger(util::csnprintf("[Switch] Format changed for song $ in % ms, % ms after request", song->getTitle(), (end - begin) / 1000, (end - reopenTime) / 1000));
+					else
+						logger(util::csnprintf("[Switch] Format changed for song $ in % ms", song->getTitle(), (end - begin) / 1000));
+					reopenTime = 0;
+					reconfigured = true;
+					reopen = false;
+				} else {
+					logger(util::csnprintf("[Switch] Reconfiguration failed for song $, reopen device \"%\"", song->getTitle(), errmsg));
+				}
+			}
 			if (reopen) {
 				// Close device and set current song buffers as played
 				if (util::assigned(lastSong.song))
@@ -950,8 +1274,10 @@ bool TAlsaPlayer::play(PSong song, const std::string& playlist, const std::strin
 		}
 
 		// Open device if needed
-		bool opened = false;
+		// --> Reconfigured device is prepared and must be started like a newly opened device
+		bool opened = reconfigured;
 		if (!getOpen()) {
+			int64_t begin = getMicroSeconds();
 			if (!openDevice(device, song->getStreamData())) {
 				//setPlayerStateWithNolock(EPS_ERROR);
 				//executeStatusChangeWithNolock(EPS_ERROR, currentSong);
@@ -959,6 +1285,11 @@ bool TAlsaPlayer::play(PSong song, const std::string& playlist, const std::strin
 				isOpen = false;
 				return false;
 			}
+			if (reopenTime > 0) {
+				int64_t end = getMicroSeconds();
+				logger(util::csnprintf("[Switch] Device reopened for song $ in % ms, % ms after request", song->getTitle(), (end - begin) / 1000, (end - reopenTime) / 1000));
+				reopenTime = 0;
+			}
 			// Initial open on ALSA device successful
 			opened = true;
 		}
@@ -978,6 +1309,7 @@ bool TAlsaPlayer::play(PSong song, const std::string& playlist, const std::strin
 			lastSong.playlist = playlist;
 			currentSong.song = song;
 			currentSong.playlist = playlist;
+			resampler.reset();
 
 			if (debug && verbosity >= 3)
 				parameterOutput("TAlsaPlayer::play() ");
@@ -1027,6 +1359,7 @@ bool TAlsaPlayer::stop() {
 	TPlayerState player;
 	{
 		app::TLockGuard<app::TMutex> lock(alsaMtx);
+		reopenTime = 0;
 		if (m_state == EPS_STOP) {
 			closeDevice();
 			if (m_state == EPS_CLOSED)
@@ -1454,6 +1787,11 @@ bool TAlsaPlayer::isDoP() const {
 	return getDoP();
 };
 
+bool TAlsaPlayer::isNativeDSD() const {
+	app::TLockGuard<app::TMutex> lock(alsaMtx);
+	return getNativeDSD();
+};
+
 bool TAlsaPlayer::isDithered() const {
 	app::TLockGuard<app::TMutex> lock(alsaMtx);
 	return dithered && (snd_physicalwidth > snd_datawidth);
@@ -1469,6 +1807,30 @@ void TAlsaPlayer::getBitDepth(std::string& bits) const {
 	}
 };
 
+void TAlsaPlayer::getStatistics(TAlsaStatistics& statistics) {
+	// Lock free access, do not block ALSA thread
+	statistics.clear();
+	wakeupLatency.getValues(statistics.wakeup);
+	writeDuration.getValues(statistics.write);
+	bufferHeadroom.getValues(statistics.headroom);
+	for (size_t i=0; i<ALSA_UNDERRUN_LOCATIONS; ++i) {
+		statistics.underruns[i] = util::atomicGet(underruns[i]);
+		statistics.recoveries[i] = util::atomicGet(recoveries[i]);
+		statistics.underrun += statistics.underruns[i];
+		statistics.recovery += statistics.recoveries[i];
+	}
+}
+
+void TAlsaPlayer::resetStatistics() {
+	wakeupLatency.reset();
+	writeDuration.reset();
+	bufferHeadroom.reset();
+	for (size_t i=0; i<ALSA_UNDERRUN_LOCATIONS; ++i) {
+		__sync_lock_test_and_set(&underruns[i], 0);
+		__sync_lock_test_and_set(&recoveries[i], 0);
+	}
+}
+
 EPlayerState TAlsaPlayer::getCurrentState() const {
 	app::TLockGuard<app::TMutex> lock(alsaMtx);
 	return m_state;
@@ -1800,6 +2162,9 @@ util::EEndianType TAlsaPlayer::getEndianFromFormat(const snd_pcm_format_t format
 		case SND_PCM_FORMAT_U24_LE:
 		case SND_PCM_FORMAT_U32_LE:
 		case SND_PCM_FORMAT_U24_3LE:
+		case SND_PCM_FORMAT_DSD_U8:
+		case SND_PCM_FORMAT_DSD_U16_LE:
+		case SND_PCM_FORMAT_DSD_U32_LE:
 			return util::EE_LITTLE_ENDIAN;
 			break;
 		case SND_PCM_FORMAT_S16_BE:
@@ -1810,6 +2175,8 @@ util::EEndianType TAlsaPlayer::getEndianFromFormat(const snd_pcm_format_t format
 		case SND_PCM_FORMAT_U24_BE:
 		case SND_PCM_FORMAT_U32_BE:
 		case SND_PCM_FORMAT_U24_3BE:
+		case SND_PCM_FORMAT_DSD_U16_BE:
+		case SND_PCM_FORMAT_DSD_U32_BE:
 			return util::EE_BIG_ENDIAN;
 			break;
 		default:
@@ -1978,10 +2345,28 @@ bool TAlsaPlayer::setHardwareParams(snd_pcm_access_t access) {
 	/* set the period time */
 	dir = 0;
 	snd_pcm_uframes_t snd_size = 0;
-	errval = snd_pcm_hw_params_set_period_time_near(snd_handle, hw_params, &snd_periodtime, &dir);
-	if (!success()) {
-		errmsg = util::csnprintf("TAlsaPlayer::setHardwareParams() Unable to set period time % for playback.", snd_periodtime);
-		return false;
+	snd_pcm_uframes_t group = getNativeFrameGroup();
+	if (group > 1) {
+		// Native DSD periods must hold whole byte blocks
+		// --> Set period size rounded to block size instead of period time
+		snd_size = (snd_pcm_uframes_t)snd_periodtime * snd_samplerate / 1000000;
+		snd_size = (snd_size + group - 1) / group * group;
+		errval = snd_pcm_hw_params_set_period_size_near(snd_handle, hw_params, &snd_size, &dir);
+		if (!success()) {
+			errmsg = util::csnprintf("TAlsaPlayer::setHardwareParams() Unable to set period size % for native DSD playback.", snd_size);
+			return false;
+		}
+		errval = snd_pcm_hw_params_set_periods_integer(snd_handle, hw_params);
+		if (!success()) {
+			errmsg = "TAlsaPlayer::setHardwareParams() Unable to set integer periods for native DSD playback.";
+			return false;
+		}
+	} else {
+		errval = snd_pcm_hw_params_set_period_time_near(snd_handle, hw_params, &snd_periodtime, &dir);
+		if (!success()) {
+			errmsg = util::csnprintf("TAlsaPlayer::setHardwareParams() Unable to set period time % for playback.", snd_periodtime);
+			return false;
+		}
 	}
 	snd_size = 0;
 	errval = snd_pcm_hw_params_get_period_size(hw_params, &snd_size, &dir);
@@ -1989,6 +2374,9 @@ bool TAlsaPlayer::setHardwareParams(snd_pcm_access_t access) {
 		errmsg = "TAlsaPlayer::setHardwareParams() Unable to get period size for playback.";
 		return false;
 	}
+	if (group > 1 && (snd_size % group) != 0) {
+		logger(util::csnprintf("[Params] Native DSD period size % is not a multiple of % frames, writes are truncated to whole blocks.", snd_size, group));
+	}
 	snd_periodsize = snd_size;
 
 	/* set the buffer time */
@@ -2080,17 +2468,162 @@ bool TAlsaPlayer::setSoftwareParams() {
 	}
 
 	// Asynchronous PCM callback handler
-    errval = snd_async_add_pcm_handler(&handler, snd_handle, alsaAsyncCallback, (void*)this);
-	if (!success()) {
-		errmsg = "TAlsaPlayer::setSoftwareParams() Unable to register asynchronous callback handler.";
-		return false;
-    }
+	// --> Handler is kept when hardware parameters are changed on open device
+	if (!util::assigned(handler)) {
+		errval = snd_async_add_pcm_handler(&handler, snd_handle, alsaAsyncCallback, (void*)this);
+		if (!success()) {
+			errmsg = "TAlsaPlayer::setSoftwareParams() Unable to register asynchronous callback handler.";
+			return false;
+		}
+	}
 
     // Software parameters were successfully set!
 	errval = EXIT_SUCCESS;
 	return true;
 }
 
+std::string TAlsaPlayer::getParamKey(const CStreamData& stream) const {
+	return util::csnprintf("%:%:%:%", device, stream.sampleRate, stream.bitsPerSample, stream.channels);
+}
+
+bool TAlsaPlayer::negotiateParams(const CStreamData& stream, TAlsaParamSet& params) {
+	params.clear();
+	if (!getOpen() || !stream.isValid())
+		return false;
+
+	// Refine a private parameter space of the open device
+	// --> Current hardware configuration is not changed, nothing is written to the device
+	snd_pcm_hw_params_t* hw;
+	snd_pcm_hw_params_alloca(&hw);
+	if (!util::assigned(hw))
+		return false;
+
+	// Same formats as tried by setAlsaParams() and setHardwareParams(), DoP needs 24 Bit physical width
+	int width = isDSDStream(stream) ? 24 : stream.bitsPerSample;
+	const int widths[] = { width, 32 };
+	const util::EEndianType endians[] = { util::EE_LITTLE_ENDIAN, util::EE_BIG_ENDIAN };
+	for (size_t e=0; e<2; ++e) {
+		for (size_t w=0; w<2; ++w) {
+			if (w > 0 && widths[w] == width)
+				continue;
+			snd_pcm_format_t format = snd_pcm_build_linear_format(widths[w], widths[w], 0, endians[e] == util::EE_LITTLE_ENDIAN ? 0 : 1);
+			if (format == SND_PCM_FORMAT_UNKNOWN)
+				continue;
+			if (snd_pcm_hw_params_any(snd_handle, hw) < 0)
+				return false;
+			if (snd_pcm_hw_params_set_rate_resample(snd_handle, hw, 0) < 0)
+				continue;
+			if (snd_pcm_hw_params_set_access(snd_handle, hw, SND_PCM_ACCESS_MMAP_INTERLEAVED) < 0)
+				continue;
+			if (snd_pcm_hw_params_set_channels(snd_handle, hw, stream.channels) < 0)
+				continue;
+			if (snd_pcm_hw_params_set_rate(snd_handle, hw, stream.sampleRate, 0) < 0)
+				continue;
+			if (snd_pcm_hw_params_set_format(snd_handle, hw, format) < 0)
+				continue;
+			params.format = format;
+			params.endian = endians[e];
+			params.valid = true;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool TAlsaPlayer::findParams(const CStreamData& stream, TAlsaParamSet& params) {
+	// Negotiated parameters are cached per device and stream format, failed negotiations as well
+	std::string key = getParamKey(stream);
+	TAlsaParamCache::const_iterator it = paramCache.find(key);
+	if (it != paramCache.end()) {
+		params = it->second;
+		return params.valid;
+	}
+	int64_t begin = getMicroSeconds();
+	bool ok = negotiateParams(stream, params);
+	int64_t end = getMicroSeconds();
+	paramCache[key] = params;
+	if (ok)
+		logger(util::csnprintf("[Switch] Negotiated format % for <%> in % us", formatToStr(params.format), key, end - begin));
+	else
+		logger(util::csnprintf("[Switch] No hardware format available for <%>", key));
+	return ok;
+}
+
+void TAlsaPlayer::prepare(const CStreamData& stream) {
+	// Stream of song to be played next, parameters are negotiated by the calling buffer thread
+	// --> Refining a private parameter space takes microseconds, ALSA thread is not involved
+	// --> Native DSD is opened by a different access mode and is never switched in place
+	if (stream.isValid()) {
+		prepareResampler(stream);
+		app::TLockGuard<app::TMutex> lock(alsaMtx);
+		CStreamData output = getOutputStream(stream);
+		if (getOpen() && !native && !(m_nativedsd && isDSDStream(output)) && output != this->stream) {
+			TAlsaParamSet params;
+			findParams(output, params);
+		}
+	}
+}
+
+int64_t TAlsaPlayer::getDrainDelay(PSong song) {
+	// Time left until last frames of previous song are played before format is switched in place
+	app::TLockGuard<app::TMutex> lock(alsaMtx);
+	if (drainTime > 0 && getOpen() && !forceReopen && util::assigned(song) && util::assigned(lastSong.song)) {
+		if (song->getStreamData().isValid() && getOutputStream(song->getStreamData()) != getOutputStream(lastSong.song->getStreamData())) {
+			int64_t now = getMicroSeconds();
+			if (drainTime > now)
+				return drainTime - now;
+		}
+	}
+	return 0;
+}
+
+bool TAlsaPlayer::reconfigureDevice(const CStreamData& stream) {
+	// Change stream format of open device without closing it
+	// --> Only pre-negotiated PCM and DoP formats are switched in place
+	if (!getOpen() || native || (m_nativedsd && isDSDStream(stream)))
+		return false;
+	const CStreamData output = getOutputStream(stream);
+	TAlsaParamSet params;
+	if (!findParams(output, params))
+		return false;
+
+	// Remaining frames of previous song were played out by play() without lock
+	// --> Silence written afterwards is dropped
+	drainTime = 0;
+	errval = snd_pcm_drop(snd_handle);
+	if (!success()) {
+		errmsg = "TAlsaPlayer::reconfigureDevice() Drop device buffers failed.";
+		return false;
+	}
+	errval = snd_pcm_hw_free(snd_handle);
+	if (!success()) {
+		errmsg = "TAlsaPlayer::reconfigureDevice() Release hardware parameters failed.";
+		return false;
+	}
+
+	// Apply validated format, no further probing or endian fallback needed
+	if (!setAlsaParams(output, params.endian)) {
+		errmsg = "TAlsaPlayer::reconfigureDevice() Invalid stream parameter";
+		errval = -EINVAL;
+		return false;
+	}
+	if (!setHardwareFormat(params.format)) {
+		errmsg = util::csnprintf("TAlsaPlayer::reconfigureDevice() Unsupported hardware format %", formatToStr(params.format));
+		errval = -EINVAL;
+		return false;
+	}
+	if (!setHardwareParams(SND_PCM_ACCESS_MMAP_INTERLEAVED))
+		return false;
+	if (!setSoftwareParams())
+		return false;
+
+	resampler.reset();
+	resampling = false;
+	dop = false;
+	logger("[Switch] Reconfigured <" + device + "> for format " + formatToStr(snd_format) + " with " + std::to_string((size_s)output.sampleRate) + " Samples/sec");
+	return true;
+}
+
 bool TAlsaPlayer::setMasterVolume(long volume) {
 	// Check prerequisites
 	if (card.empty()) {
@@ -2234,6 +2767,12 @@ int TAlsaPlayer::recoverUnderrun(int error, int location) {
 	logger(util::csnprintf("[Underrun] Underrun at % reason (%)", location, error));
 	errval = error;
 
+	// Count calls by location for statistics
+	size_t index = (location > 0 && location < (int)ALSA_UNDERRUN_LOCATIONS) ? location : 0;
+	util::atomicInc(recoveries[index]);
+	if (errval == -EPIPE)
+		util::atomicInc(underruns[index]);
+
 	// Underrun occurred
 	if (errval == -EPIPE) {
 		logger("[Underrun] Recovering from EPIPE");
@@ -2272,8 +2811,9 @@ int TAlsaPlayer::writeFrameData(const TSample * src, TSample *dst[], size_t& rea
 	errval = EXIT_SUCCESS;
 	snd_pcm_uframes_t frame;
 	snd_pcm_uint_t channel;
-	TSample dither = 0;
 	bool isLittleEndian = isLE();
+	bool useDither = dithered && (snd_physicalwidth > snd_datawidth);
+	const int32_t* dither = useDither ? generator.generate(frames, snd_channels) : nil;
 
 	if (verbosity >= 3)
 		logger(util::csnprintf("[Frame]  Frames to read         : % Frames", frames));
@@ -2295,12 +2835,10 @@ int TAlsaPlayer::writeFrameData(const TSample * src, TSample *dst[], size_t& rea
 							write16to16Bit(src, dst[channel], read, steps[channel], isLittleEndian);
 							break;
 						case 24:
-							if (dithered) dither = getRandomDither();
-							write16to24Bit(src, dst[channel], read, steps[channel], isLittleEndian, dither);
+							write16to24Bit(src, dst[channel], read, steps[channel], isLittleEndian, useDither ? *(dither++) : 0);
 							break;
 						case 32:
-							if (dithered) dither = getRandomDither();
-							write16to32Bit(src, dst[channel], read, steps[channel], isLittleEndian, dither);
+							write16to32Bit(src, dst[channel], read, steps[channel], isLittleEndian, useDither ? *(dither++) : 0);
 							break;
 						default:
 							// Set frames to current value
@@ -2319,8 +2857,7 @@ int TAlsaPlayer::writeFrameData(const TSample * src, TSample *dst[], size_t& rea
 							write24to24Bit(src, dst[channel], read, steps[channel], isLittleEndian);
 							break;
 						case 32:
-							if (dithered) dither = getRandomDither();
-							write24to32Bit(src, dst[channel], read, steps[channel], isLittleEndian, dither);
+							write24to32Bit(src, dst[channel], read, steps[channel], isLittleEndian, useDither ? *(dither++) : 0);
 							break;
 						default:
 							// Set frames to current value
@@ -2363,7 +2900,7 @@ int TAlsaPlayer::writeFrameData(const TSample * src, TSample *dst[], size_t& rea
 
 
 
-int TAlsaPlayer::writeStereoData(const TSample * src, TSample *dst[], size_t& read, snd_pcm_uframes_t& frames) {
+int TAlsaPlayer::writeStereoData(const TSample * src, TSample *dst[], size_t& read, snd_pcm_uframes_t& frames, const size_t size) {
 	errmsg.clear();
 	errval = EXIT_SUCCESS;
 
@@ -2376,6 +2913,11 @@ int TAlsaPlayer::writeStereoData(const TSample * src, TSample *dst[], size_t& re
 		// DSD 1 Bit stream encapsulated as 24 Bit DoP data
 		case 1: // Newest endian
 		case 2: // Oldest endian
+			// Native DSD transfer without DoP marker
+			if (native) {
+				writeNativeDSDData(src, dst[0], read, frames, size);
+				break;
+			}
 			// Switch destination data width
 			switch (snd_physicalwidth) {
 				case 24:
@@ -2542,6 +3084,70 @@ void TAlsaPlayer::write32BitDSDData(const TSample *src, TSample *& dst, size_t&
 }
 
 
+void TAlsaPlayer::writeNativeDSDData(const TSample *src, TSample *& dst, size_t& read, snd_pcm_uframes_t frames, const size_t size) {
+	// Sample buffer holds 2 DSD bytes per channel, newest byte first: L2 L1 R2 R1
+	// --> Byte order for native formats is given for blocks of 8 bytes (2 frames of sample buffer)
+	static const size_t orderU8[8]    = { 1,3,0,2, 5,7,4,6 };
+	static const size_t orderU16LE[8] = { 0,1,2,3, 4,5,6,7 };
+	static const size_t orderU16BE[8] = { 1,0,3,2, 5,4,7,6 };
+	static const size_t orderU32LE[8] = { 4,5,0,1, 6,7,2,3 };
+	static const size_t orderU32BE[8] = { 1,0,5,4, 3,2,7,6 };
+	const size_t* order;
+	switch (snd_format) {
+		case SND_PCM_FORMAT_DSD_U8:
+			order = orderU8;
+			break;
+		case SND_PCM_FORMAT_DSD_U16_BE:
+			order = orderU16BE;
+			break;
+		case SND_PCM_FORMAT_DSD_U32_LE:
+			order = orderU32LE;
+			break;
+		case SND_PCM_FORMAT_DSD_U32_BE:
+			order = orderU32BE;
+			break;
+		default:
+			order = orderU16LE;
+			break;
+	}
+
+	// Fill missing bytes of incomplete frame at end of buffer with DSD silence
+	size_t bytes = frames * snd_framesize;
+	size_t available = std::min(bytes, size);
+	size_t i = 0, k;
+	for (; (i + 8) <= available; i += 8, src += 8) {
+		for (k=0; k<8; ++k)
+			*(dst++) = src[order[k]];
+	}
+	if (i < bytes) {
+		TSample block[8];
+		for (; i < bytes; i += 8, src += 8) {
+			for (k=0; k<8; ++k)
+				block[k] = (i + k) < available ? src[k] : 0x69;
+			for (k=0; k<8 && (i + k) < bytes; ++k)
+				*(dst++) = block[order[k]];
+		}
+	}
+
+	// Set read sample bytes
+	read += available;
+}
+
+snd_pcm_uframes_t TAlsaPlayer::getNativeFrameGroup() const {
+	// Native DSD bytes are reordered in blocks of 8 bytes (2 frames of sample buffer)
+	// --> Periods must hold whole blocks, otherwise L/R byte groups are split across periods
+	if (native && snd_framesize > 0 && snd_framesize < 8)
+		return 8 / snd_framesize;
+	return 1;
+}
+
+void TAlsaPlayer::writeNativeDSDSilence(TSample *& dst, snd_pcm_uframes_t& frames) {
+	// One of the possible DSD silence pattern 0x69 = 0110 1001
+	size_t bytes = frames * snd_framesize;
+	memset(dst, 0x69, bytes);
+	dst += bytes;
+}
+
 
 int TAlsaPlayer::writeDSDSilence(TSample *dst[], snd_pcm_uframes_t& frames) {
 	errmsg.clear();
@@ -2556,6 +3162,11 @@ int TAlsaPlayer::writeDSDSilence(TSample *dst[], snd_pcm_uframes_t& frames) {
 		// DSD 1 Bit stream encapsulated as 24 Bit DoP data
 		case 1: // Newest endian
 		case 2: // Oldest endian
+			// Native DSD transfer without DoP marker
+			if (native) {
+				writeNativeDSDSilence(dst[0], frames);
+				break;
+			}
 			// Switch destination data width
 			switch (snd_physicalwidth) {
 				case 24:
@@ -2696,7 +3307,8 @@ bool TAlsaPlayer::doSeek(TAudioBuffer*& buffer, PSong song, double position) {
 								o->resetReader();
 
 								// Mark previous buffers as played
-								if (o->getKey() < key) {
+								// --> Compare song position of buffers, key order is not song order after decoder seek
+								if (o->getKey() != key && o->getOffset() < next->getOffset()) {
 									buffers.operate(o, EBS_PLAYED, true);
 								}
 
@@ -2707,7 +3319,7 @@ bool TAlsaPlayer::doSeek(TAudioBuffer*& buffer, PSong song, double position) {
 								}
 
 								// Mark following buffers as playable
-								if (o->getKey() > key) {
+								if (o->getKey() != key && o->getOffset() > next->getOffset()) {
 									buffers.operate(o, EBS_LOADED, true);
 								}
 							}
@@ -2736,6 +3348,59 @@ bool TAlsaPlayer::doSeek(TAudioBuffer*& buffer, PSong song, double position) {
 	return false;
 }
 
+bool TAlsaPlayer::doDecoderSeek(PSong song, double position) {
+	if (util::assigned(song) && position > 0.0) {
+		size_t size = song->getSampleSize();
+		size_t bytes = (size_t)(position * (double)size / 100.0);
+		size_t align = song->getWordWidth();
+		size_t aligned = util::align(bytes, align);
+
+		// Seek position is available in buffers
+		size_t offset;
+		PAudioBuffer next = buffers.getSeekBuffer(song, aligned, offset);
+		if (util::assigned(next))
+			return false;
+
+		// Request decoder to continue at seek position
+		// --> Finished decoder is restarted to decode song again from seek position
+		seekRequest.clear();
+		seekRequest.song = song;
+		seekRequest.position = aligned;
+		seekRequest.timestamp = util::now();
+		seekRequest.restart = buffers.isDecoded(song);
+		seekRequest.pending = true;
+		logger(util::csnprintf("[Seek] Request decoder % to position [%/% bytes] aligned by % bytes [% of %]", seekRequest.restart ? "restart" : "seek",
+				bytes, aligned, align, util::sizeToStr(bytes, 1, util::VD_BINARY), util::sizeToStr(size, 1, util::VD_BINARY)));
+		return true;
+	}
+	return false;
+}
+
+bool TAlsaPlayer::isSeekPending() {
+	if (seekRequest.pending) {
+		bool cancel = false;
+		PSong song = currentSong.song;
+
+		// Song changed or buffers released while decoder seek is pending
+		if (!util::assigned(song) || !seekRequest.song->compareByTitleHash(song) || !buffers.hasSong(song))
+			cancel = true;
+
+		// Decoder finished or did not take over seek request in time
+		if (!cancel && !seekRequest.accepted) {
+			if ((!seekRequest.restart && buffers.isDecoded(song)) || (util::now() - seekRequest.timestamp) > (util::TTimePart)5)
+				cancel = true;
+		}
+
+		if (cancel) {
+			logger("[Seek] Pending decoder seek dropped.");
+			seekRequest.clear();
+			return false;
+		}
+		return true;
+	}
+	return false;
+}
+
 bool TAlsaPlayer::doFastForward(TAudioBuffer*& buffer, PSong song) {
 	if (util::assigned(song) && util::assigned(buffer)) {
 		util::TTimePart frame = getSkipFrame(song);
@@ -2950,6 +3615,11 @@ bool TAlsaPlayer::writePeriodData() {
 		return false;
 	}
 
+	// Play silence until decoder reached seek position for current song
+	if (isSeekPending()) {
+		return writeSilence();
+	}
+
 	// Initialize locals with hardware parameters
 	const snd_pcm_channel_area_t *areas;
 	snd_pcm_uframes_t offset, frames, commit;
@@ -2994,6 +3664,12 @@ bool TAlsaPlayer::writePeriodData() {
 			break;
 	}
 
+	// Frames still queued for playback give headroom until next underrun
+	if (available >= 0 && snd_samplerate > 0) {
+		snd_pcm_uframes_t queued = snd_buffersize > (snd_pcm_uframes_t)available ? snd_buffersize - available : 0;
+		bufferHeadroom.add((uint64_t)queued * 1000000 / snd_samplerate);
+	}
+
 	// Check available space
 	if (available < 0) {
 		errmsg = util::csnprintf("TAlsaPlayer::writePeriodData() No available space in memory mapped buffer (%)", available);
@@ -3006,6 +3682,12 @@ bool TAlsaPlayer::writePeriodData() {
 		size = available;
 	}
 
+	// Native DSD is written in whole byte blocks
+	snd_pcm_sframes_t group = (snd_pcm_sframes_t)getNativeFrameGroup();
+	if (group > 1) {
+		size -= size % group;
+	}
+
 	if (verbosity >= 3) {
 		logger(util::csnprintf("[Period] ALSA period time       : % (%) milliseconds", getActivePeriodTime(), getPeriodTime()));
 		logger(util::csnprintf("[Period] Max. frames to be read : % Frames", size));
@@ -3065,6 +3747,19 @@ bool TAlsaPlayer::writePeriodData() {
 			}
 		}
 
+		// Filter history of resampler is invalid after repositioning
+		if (forward || rewind || seek) {
+			resampler.reset();
+		}
+
+		// Seek position not yet decoded, play silence until decoder is repositioned
+		if (seek && !currentSong.song->isStreamed()) {
+			if (doDecoderSeek(currentSong.song, position)) {
+				queue.clear();
+				return writeSilence();
+			}
+		}
+
 		// Signal progress to main process by calling progress handler
 		// 2020/06/26 This is done by checking the played seconds below!!!
 //		if (!progressed && currentSong.song->getPercent() != lastSongProgress) {
@@ -3164,6 +3859,18 @@ bool TAlsaPlayer::writePeriodData() {
 		size_t bytes = frames * snd_dataframesize;
 		size_t rest = buffer->getWritten() - buffer->getRead();
 
+		// Convert sample rate of current song to locked device rate
+		// --> Input bytes consumed from buffer differ from output bytes written to device
+		const TSample* source = buffer->reader();
+		size_t available = rest;
+		size_t consumed = 0;
+		bool resampled = updateResampler(currentSong.song->getStreamData());
+		if (resampled && rest > 0) {
+			size_t produced = resampler.process(source, rest, frames, consumed);
+			source = resampler.data();
+			available = produced * snd_dataframesize;
+		}
+
 		// Debug output
 		if (verbosity >= 3) {
 			logger(util::csnprintf("[Period] Physical frame size    : % Byte [% Bit, % Bit per channel]", snd_framesize, snd_framesize * 8, snd_framesize * 8 / snd_channels));
@@ -3189,13 +3896,16 @@ bool TAlsaPlayer::writePeriodData() {
 		if (rest > 0) {
 
 			// Check frame size in bytes against available space in bytes in read buffer
-			if (rest <= bytes) {
+			if (resampled ? consumed >= rest : rest <= bytes) {
 				// Last frames for current buffer are streamed
 				// --> set status to draining
 				buffers.operate(buffer, EBS_DRAINING);
 
 				// Commit all frames until end of current read buffer
-				commit = rest / snd_dataframesize;
+				// --> Incomplete native DSD frame is filled with silence
+				commit = available / snd_dataframesize;
+				if (native && (available % snd_dataframesize) > 0)
+					++commit;
 
 				if (verbosity >= 3) {
 					logger(util::csnprintf("[Period] Planned frames         : % Frames", frames));
@@ -3211,15 +3921,17 @@ bool TAlsaPlayer::writePeriodData() {
 			size_t read = 0;
 			switch (snd_channels) {
 				case 2:
-					errval = writeStereoData(buffer->reader(), samples, read, commit);
+					errval = writeStereoData(source, samples, read, commit, available);
 					break;
 				default:
-					errval = writeFrameData(buffer->reader(), samples, read, areas, steps, commit);
+					errval = writeFrameData(source, samples, read, areas, steps, commit);
 					break;
 			}
 
 			if (success()) {
 				// Set read bytes from buffer
+				if (resampled)
+					read = consumed;
 				buffer->read(read);
 				currentSong.song->addRead(read);
 				currentSong.song->updateStatsistics();
@@ -3248,6 +3960,7 @@ bool TAlsaPlayer::writePeriodData() {
 
 		// Commit written frames
 		committed = snd_pcm_mmap_commit(snd_handle, offset, commit);
+		commitTime = getMicroSeconds();
 		if (committed < 0 || (snd_pcm_uframes_t)committed != commit) {
 			errval = recoverUnderrun(-EPIPE, 3);
 			if (!success()) {
@@ -3318,11 +4031,19 @@ bool TAlsaPlayer::writePeriodData() {
 						if (*prevSong != *nextSong || forceReopen) {
 
 							// Test for different stream parameters
-							if (prevSong->getStreamData() != nextSong->getStreamData() || forceReopen) {
+							// --> Songs with different sample rate are played gapless when resampled to locked device rate
+							if (getOutputStream(prevSong->getStreamData()) != getOutputStream(nextSong->getStreamData()) || forceReopen) {
 								// New stream parameters detected
 								// --> Device must be reopened for new song after draining buffer
 								logger("[Period] Wait to reopen device with different stream properties.");
 								setPlayerStateWithNolock(EPS_REOPEN);
+
+								// Remember when last frames of previous song are played to reconfigure device in place
+								snd_pcm_sframes_t delay = 0;
+								reopenTime = getMicroSeconds();
+								drainTime = 0;
+								if (snd_samplerate > 0 && EXIT_SUCCESS == snd_pcm_delay(snd_handle, &delay) && delay > 0)
+									drainTime = reopenTime + (int64_t)delay * 1000000 / snd_samplerate;
 								reopen = true;
 								exit = true;
 							}
@@ -3331,10 +4052,13 @@ bool TAlsaPlayer::writePeriodData() {
 
 						// A) Reset buffers and song properties for current song to played (again?)
 						// B) Release last buffer for streamed playback
+						// C) Release all buffers of played song in compressed mode, song is decoded again if needed
 						if (streamable) {
 							logger(util::csnprintf("[Period] Reset stream buffer <%> for song $", buffer->getKey(), currentSong.song->getTitle()));
 							buffers.reset(buffer);
 						} else {
+							if (buffers.isCompressed())
+								buffers.reset(prevSong);
 							buffers.cleanup(currentSong.song);
 						}
 
@@ -3370,6 +4094,10 @@ bool TAlsaPlayer::writePeriodData() {
 						if (streamable) {
 							logger(util::csnprintf("[Period] Reset stream buffer <%> for song $", buffer->getKey(), currentSong.song->getTitle()));
 							buffers.reset(buffer);
+						} else if (buffers.isCompressed()) {
+							// Return played buffer to decode-ahead ring
+							if (verbosity >= 2) logger(util::csnprintf("[Period] Release played buffer <%> for song $", buffer->getKey(), currentSong.song->getTitle()));
+							buffers.reset(buffer);
 						}
 					}
 				}
@@ -3464,6 +4192,12 @@ bool TAlsaPlayer::writeSilence() {
 		size = available;
 	}
 
+	// Native DSD is written in whole byte blocks
+	snd_pcm_sframes_t group = (snd_pcm_sframes_t)getNativeFrameGroup();
+	if (group > 1) {
+		size -= size % group;
+	}
+
 	if (verbosity >= 3) {
 		logger(util::csnprintf("[Silence] ALSA period time          : % (%) milliseconds", getActivePeriodTime(), getPeriodTime()));
 		logger(util::csnprintf("[Silence] Max. frames to be read    : % Frames", size));
@@ -3613,6 +4347,7 @@ int TAlsaPlayer::alsaThreadHandler() {
 
 	// Loop on semaphore...
 	while (sema.wait()) {
+		wakeupTime = getMicroSeconds();
 		if (terminate)
 			break;
 		alsaThreadMethod();
@@ -3673,7 +4408,14 @@ void TAlsaPlayer::alsaThreadMethod() {
 
 		// Copy data to ALSA buffer when playing and not stopped
 		if (!stop && !getPaused() && !getStopped() && !getHalted()) {
-			if (!writePeriodData()) {
+			commitTime = 0;
+			int64_t begin = getMicroSeconds();
+			bool written = writePeriodData();
+			int64_t end = getMicroSeconds();
+			writeDuration.add(end > begin ? end - begin : 0);
+			if (commitTime >= wakeupTime && wakeupTime > 0)
+				wakeupLatency.add(commitTime - wakeupTime);
+			if (!written) {
 				logger("[Thread] Writing samples to ALSA buffer failed:");
 				logger(util::csnprintf("[Tread] Message : $", strerr()));
 				logger(util::csnprintf("[Tread] Error   : $", syserr()));
@@ -3827,11 +4569,44 @@ void TAlsaPlayer::onPlaylistRequest(const TCurrentSong& current, TSong*& next, s
 
 
 void TAlsaPlayer::createBuffers(const size_t fraction, const size_t maxBufferCount,
-		const size_t minBufferSize, const size_t maxBufferSize) {
+		const size_t minBufferSize, const size_t maxBufferSize, const EBufferMode mode, const bool hugepages, const bool numa) {
 	app::TLockGuard<app::TMutex> lock(alsaMtx);
+
+	// Buffers are read by ALSA thread
+	// --> Bind buffer memory to NUMA node of the default core used for thread affinity
+	util::TMappedOptions options;
+	options.populate = true;
+	options.hugepages = hugepages;
+	if (hugepages)
+		options.hugePageSize = sysutil::getHugePageSize();
+	if (numa && sysutil::getNodeCount() > 1)
+		options.node = sysutil::getProcessorNode(getDefaultCore() - 1);
+
 	buffers.setDebug(debug);
+	buffers.setMode(mode);
+	buffers.setMemoryOptions(options);
 	buffers.create(fraction, maxBufferCount, minBufferSize, maxBufferSize);
 	logger(util::csnprintf("Prepared % buffers with % each.", buffers.count(), util::sizeToStr(buffers.buffer(), 1, util::VD_BINARY)));
+	logger(util::csnprintf("Buffer memory uses % pages with % page faults on NUMA node %.", util::sizeToStr(buffers.getPageSize(), 1, util::VD_BINARY), buffers.getPageFaults(), options.node));
+	if (buffers.isCompressed())
+		logger(util::csnprintf("Compressed buffer mode, % reserved for encoded files.", util::sizeToStr(buffers.encodedLimit(), 1, util::VD_BINARY)));
+}
+
+PSong TAlsaPlayer::preloadEncodedSongs(const TSongList& songs) {
+	// Encoded file list is protected by its own lock
+	// --> Do not hold player lock while file is read into memory
+	PSong song = buffers.preload(songs);
+	if (util::assigned(song)) {
+		logger(util::csnprintf("[Buffering] Preloaded encoded file $ [%], % of % used.", song->getTitle(), util::sizeToStr(song->getFileSize(), 1, util::VD_BINARY),
+				util::sizeToStr(buffers.encodedSize(), 1, util::VD_BINARY), util::sizeToStr(buffers.encodedLimit(), 1, util::VD_BINARY)));
+	}
+	std::string file;
+	int error;
+	if (buffers.getPinError(file, error)) {
+		logger(util::csnprintf("[Buffering] Locking encoded file $ failed: $, encoded memory limited to %.", file,
+				sysutil::getSysErrorMessage(error), util::sizeToStr(buffers.encodedLimit(), 1, util::VD_BINARY)));
+	}
+	return song;
 }
 
 size_t TAlsaPlayer::bufferCount() const {
@@ -3839,6 +4614,11 @@ size_t TAlsaPlayer::bufferCount() const {
 	return buffers.count();
 };
 
+size_t TAlsaPlayer::bufferSize() const {
+	app::TLockGuard<app::TMutex> lock(alsaMtx);
+	return buffers.buffer();
+};
+
 size_t TAlsaPlayer::freeBufferSize() const {
 	app::TLockGuard<app::TMutex> lock(alsaMtx);
 	return buffers.free();
@@ -3894,6 +4674,15 @@ void TAlsaPlayer::resetBuffer(PAudioBuffer buffer) {
 	buffers.reset(buffer);
 }
 
+size_t TAlsaPlayer::dropBuffers(const TSong* song) {
+	app::TLockGuard<app::TMutex> lock(alsaMtx);
+	size_t r = buffers.drop(song);
+	if (r > 0) {
+		buffers.sort();
+	}
+	return r;
+}
+
 size_t TAlsaPlayer::bufferGarbageCollector(const music::TCurrentSongs& songs) {
 	app::TLockGuard<app::TMutex> lock(alsaMtx);
 	return buffers.garbageCollector(songs);
@@ -3943,4 +4732,63 @@ void TAlsaPlayer::setBufferLevel(PAudioBuffer buffer, const EBufferLevel level)
 	buffers.setLevel(buffer, level);
 }
 
+
+bool TAlsaPlayer::getSeekRequest(const TSong* song, size_t& position) {
+	app::TLockGuard<app::TMutex> lock(alsaMtx);
+	position = 0;
+	if (seekRequest.pending && !seekRequest.accepted && util::assigned(song)) {
+		if (seekRequest.song->compareByTitleHash(song)) {
+			// Decoder takes over seek request
+			// --> Request is no longer subject to timeout
+			seekRequest.accepted = true;
+			position = seekRequest.position;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool TAlsaPlayer::getRestartRequest(PSong& song) {
+	app::TLockGuard<app::TMutex> lock(alsaMtx);
+	song = nil;
+	if (seekRequest.pending && seekRequest.restart && !seekRequest.accepted && util::assigned(seekRequest.song)) {
+		// Seek position of finished song was never decoded
+		// --> Idle decoder opens song again, seek request is taken over by getSeekRequest()
+		song = seekRequest.song;
+		return true;
+	}
+	return false;
+}
+
+void TAlsaPlayer::completeSeekRequest(const TSong* song, PAudioBuffer buffer) {
+	app::TLockGuard<app::TMutex> lock(alsaMtx);
+	if (seekRequest.pending && util::assigned(song) && util::assigned(buffer)) {
+		if (seekRequest.song->compareByTitleHash(song)) {
+
+			// Mark previous buffers as played and drop buffers behind new position
+			size_t n = buffers.reposition(song, buffer);
+			if (n > 0) {
+				buffers.sort();
+			}
+
+			// Playback continues from first buffer at decoder position
+			buffers.operate(buffer, EBS_BUFFERED);
+			seekRequest.song->setRead(buffer->getOffset());
+			seekRequest.song->updateStatsistics();
+			logger(util::csnprintf("[Seek] Decoder repositioned to % bytes [%] in buffer <%>, % buffers dropped", buffer->getOffset(), util::sizeToStr(buffer->getOffset(), 1, util::VD_BINARY), buffer->getKey(), n));
+		}
+	}
+	seekRequest.clear();
+}
+
+void TAlsaPlayer::cancelSeekRequest(const TSong* song) {
+	app::TLockGuard<app::TMutex> lock(alsaMtx);
+	if (seekRequest.pending && util::assigned(song)) {
+		if (seekRequest.song->compareByTitleHash(song)) {
+			logger(util::csnprintf("[Seek] Decoder seek for song $ canceled", song->getTitle()));
+			seekRequest.clear();
+		}
+	}
+}
+
 } /* namespace music */
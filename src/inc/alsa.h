@@ -8,11 +8,14 @@
 #ifndef ALSA_H_
 #define ALSA_H_
 
+#include <map>
 #include <alsa/asoundlib.h>
 #include "alsatypes.h"
 #include "audiotypes.h"
 #include "audiobuffer.h"
 #include "audiofile.h"
+#include "dither.h"
+#include "resampler.h"
 #include "tagtypes.h"
 #include "semaphores.h"
 #include "threadqueue.h"
@@ -137,6 +140,56 @@ struct TPlayerCommand {
 };
 
 
+struct TSeekRequest {
+	PSong song;
+	size_t position;
+	util::TTimePart timestamp;
+	bool pending;
+	bool accepted;
+	bool restart;
+
+	void clear() {
+		song = nil;
+		position = 0;
+		timestamp = 0;
+		pending = false;
+		accepted = false;
+		restart = false;
+	}
+
+	TSeekRequest() {
+		clear();
+	}
+};
+
+
+typedef struct CAlsaParamSet {
+	snd_pcm_format_t format;   // Hardware format validated for stream
+	util::EEndianType endian;
+	bool valid;
+
+	void clear() {
+		format = SND_PCM_FORMAT_UNKNOWN;
+		endian = util::EE_UNKNOWN_ENDIAN;
+		valid = false;
+	}
+
+	CAlsaParamSet() {
+		clear();
+	}
+} TAlsaParamSet;
+
+#ifdef STL_HAS_TEMPLATE_ALIAS
+
+using TAlsaParamCache = std::map<std::string, TAlsaParamSet>;
+
+#else
+
+typedef std::map<std::string, TAlsaParamSet> TAlsaParamCache;
+
+#endif
+
+
 class TByteConverter {
 public:
 	// Converter for different word sizes (NO endianess!)
@@ -175,16 +228,16 @@ public:
 
 class TPCMConverter {
 protected:
-	TSample getRandomDither();
+	TDither generator;
 
 public:
 	// Writer from PCM sample buffer to byte aligned destination buffer
 	void write16to16Bit(const TSample *& src, TSample *& dst, size_t& read, const bool isLittleEndian);
-	void write16to24Bit(const TSample *& src, TSample *& dst, size_t& read, const bool isLittleEndian, const TSample dither = 0);
-	void write16to32Bit(const TSample *& src, TSample *& dst, size_t& read, const bool isLittleEndian, const TSample dither = 0);
+	void write16to24Bit(const TSample *& src, TSample *& dst, size_t& read, const bool isLittleEndian, const int32_t dither = 0);
+	void write16to32Bit(const TSample *& src, TSample *& dst, size_t& read, const bool isLittleEndian, const int32_t dither = 0);
 
 	void write24to24Bit(const TSample *& src, TSample *& dst, size_t& read, const bool isLittleEndian);
-	void write24to32Bit(const TSample *& src, TSample *& dst, size_t& read, const bool isLittleEndian, const TSample dither = 0);
+	void write24to32Bit(const TSample *& src, TSample *& dst, size_t& read, const bool isLittleEndian, const int32_t dither = 0);
 
 	// Writer from PCM sample buffer to byte aligned destination buffer for count of frames
 	void write16to16Bit(const TSample *src, TSample *& dst, size_t& read, snd_pcm_uframes_t frames, const util::EEndianType endian);
@@ -196,11 +249,11 @@ public:
 
 	// Writer from PCM sample buffer to byte aligned destination buffer an increment destination by step width in bytes
 	void write16to16Bit(const TSample *& src, TSample *& dst, size_t& read, const snd_pcm_int_t step, const bool isLittleEndian);
-	void write16to24Bit(const TSample *& src, TSample *& dst, size_t& read, const snd_pcm_int_t step, const bool isLittleEndian, const TSample dither = 0);
-	void write16to32Bit(const TSample *& src, TSample *& dst, size_t& read, const snd_pcm_int_t step, const bool isLittleEndian, const TSample dither = 0);
+	void write16to24Bit(const TSample *& src, TSample *& dst, size_t& read, const snd_pcm_int_t step, const bool isLittleEndian, const int32_t dither = 0);
+	void write16to32Bit(const TSample *& src, TSample *& dst, size_t& read, const snd_pcm_int_t step, const bool isLittleEndian, const int32_t dither = 0);
 
 	void write24to24Bit(const TSample *& src, TSample *& dst, size_t& read, const snd_pcm_int_t step, const bool isLittleEndian);
-	void write24to32Bit(const TSample *& src, TSample *& dst, size_t& read, const snd_pcm_int_t step, const bool isLittleEndian, const TSample dither = 0);
+	void write24to32Bit(const TSample *& src, TSample *& dst, size_t& read, const snd_pcm_int_t step, const bool isLittleEndian, const int32_t dither = 0);
 
 	TPCMConverter();
 	virtual ~TPCMConverter();
@@ -297,6 +350,7 @@ private:
 	util::TStringList cards;
 
 	app::TThreadQueue<TPlayerCommand> queue;
+	TSeekRequest seekRequest;
 
 	snd_pcm_t* snd_handle;
 	snd_pcm_hw_params_t* hw_params;
@@ -327,6 +381,17 @@ private:
 	bool ignoreMixer;
 	bool forceReopen;
 	bool dop;
+	bool native;
+	bool m_nativedsd;
+	bool resampling;
+	int m_resamplerate;
+	EResamplerQuality m_resamplequality;
+	TResampler resampler;
+	TResampler prepared;
+
+	TAlsaParamCache paramCache;
+	int64_t reopenTime;
+	int64_t drainTime;
 
 	snd_pcm_format_t snd_format;
 	snd_pcm_uint_t snd_channels;
@@ -347,6 +412,14 @@ private:
 	util::TTimePart m_skipframe;
 	util::EEndianType m_endian;
 
+	util::THistogram wakeupLatency;
+	util::THistogram writeDuration;
+	util::THistogram bufferHeadroom;
+	atomic_uint64 underruns[ALSA_UNDERRUN_LOCATIONS];
+	atomic_uint64 recoveries[ALSA_UNDERRUN_LOCATIONS];
+	int64_t wakeupTime;
+	int64_t commitTime;
+
 	TPlayerStateCallback onOutputStateChanged;
 	TPlayerStateCallback onPlaybackStateChanged;
 	TPlayerProgressCallback onPlaybackProgressChanged;
@@ -366,12 +439,22 @@ private:
 	void alsaThreadMethod();
 
 	bool setAlsaParams(const CStreamData& stream, const util::EEndianType endian);
+	bool negotiateParams(const CStreamData& stream, TAlsaParamSet& params);
+	bool findParams(const CStreamData& stream, TAlsaParamSet& params);
+	int64_t getDrainDelay(PSong song);
+	std::string getParamKey(const CStreamData& stream) const;
 	bool setHardwareParams(snd_pcm_access_t access);
 	bool setSoftwareParams();
 	bool validStreamParams();
 
 	snd_pcm_format_t getHardwareFormat();
 	bool setHardwareFormat(const snd_pcm_format_t format);
+	snd_pcm_format_t getNativeDSDFormat(const CStreamData& stream, snd_pcm_uint_t& rate);
+	bool isDSDFormat(const snd_pcm_format_t format) const;
+	bool isDSDStream(const CStreamData& stream) const;
+	bool isResampled(const CStreamData& stream) const;
+	bool updateResampler(const CStreamData& stream);
+	void prepareResampler(const CStreamData& stream);
 	util::EEndianType getEndianFromFormat(const snd_pcm_format_t format);
 	std::string formatToStr(const snd_pcm_format_t format) const;
 	std::string getHardwareCard() const ;
@@ -381,6 +464,8 @@ private:
 	int writeDSDSilence(TSample *dst[], snd_pcm_uframes_t& frames);
 	void write24BitDSDSilence(TSample *& dst, snd_pcm_uframes_t& frames);
 	void write32BitDSDSilence(TSample *& dst, snd_pcm_uframes_t& frames);
+	void writeNativeDSDSilence(TSample *& dst, snd_pcm_uframes_t& frames);
+	snd_pcm_uframes_t getNativeFrameGroup() const;
 
 	bool isLE() const { return m_endian == util::EE_LITTLE_ENDIAN; };
 	bool isBE() const { return m_endian == util::EE_BIG_ENDIAN; };
@@ -388,11 +473,14 @@ private:
 	bool writePeriodData();
 	int writeFrameData(const TSample * src, TSample *dst[], size_t& read,
 			const snd_pcm_channel_area_t *areas, const snd_pcm_int_t steps[], snd_pcm_uframes_t& frames);
-	int writeStereoData(const TSample * src, TSample *dst[], size_t& read, snd_pcm_uframes_t& frames);
+	int writeStereoData(const TSample * src, TSample *dst[], size_t& read, snd_pcm_uframes_t& frames, const size_t size);
 	void write24BitDSDData(const TSample *src, TSample *& dst, size_t& read, snd_pcm_uframes_t frames);
 	void write32BitDSDData(const TSample *src, TSample *& dst, size_t& read, snd_pcm_uframes_t frames);
+	void writeNativeDSDData(const TSample *src, TSample *& dst, size_t& read, snd_pcm_uframes_t frames, const size_t size);
 
 	bool doSeek(TAudioBuffer*& buffer, PSong song, double position);
+	bool doDecoderSeek(PSong song, double position);
+	bool isSeekPending();
 	bool doFastForward(TAudioBuffer*& buffer, PSong song);
 	bool doFastRewind(TAudioBuffer*& buffer, PSong song);
 	util::TTimePart getSkipFrame(const TSong* song);
@@ -406,10 +494,13 @@ private:
 	bool getStopped() const { return m_state == EPS_STOP; };
 	bool getHalted() const { return m_state == EPS_HALT; };
 	bool getDoP() const { return dop; };
+	bool getNativeDSD() const { return native; };
 	EPlayerState getState() const { return m_state; };
 	const std::string& getDevice() const { return device; };
 
 	bool openDevice(const std::string& device, const CStreamData& stream);
+	bool openNativeDevice(const std::string& device, const CStreamData& stream);
+	bool reconfigureDevice(const CStreamData& stream);
 	void closeDevice();
 	bool dropDevice();
 	bool stopDevice();
@@ -454,9 +545,13 @@ public:
 	bool isHalted() const;
 	bool isStopped() const;
 	bool isDoP() const;
+	bool isNativeDSD() const;
 	bool isDithered() const;
 
 	void getBitDepth(std::string& bits) const;
+	CStreamData getOutputStream(const CStreamData& stream) const;
+	void getStatistics(TAlsaStatistics& statistics);
+	void resetStatistics();
 	EPlayerState getCurrentState() const;
 	const std::string& getCurrentDevice() const;
 	const std::string& getCurrentPlaylist() const;
@@ -477,9 +572,13 @@ public:
 	void close();
 
 	void setDithered(const bool value) { dithered = value; };
+	void setDitherSpectrum(const EDitherSpectrum value) { generator.setSpectrum(value); };
 	void setVerbosity(const int value) { verbosity = value; };
 	void setDebug(const bool value) { debug = value; };
 	void setIgnoreMixer(const bool value) { ignoreMixer = value; };
+	void setNativeDSD(const bool value) { m_nativedsd = value; };
+	void setResampleRate(const int value) { m_resamplerate = value; };
+	void setResampleQuality(const EResamplerQuality value) { m_resamplequality = value; };
 	void setLogFile(const app::PLogFile logger) { logfile = logger; };
 
 	static std::string statusToStr(const EPlayerState value);
@@ -488,6 +587,7 @@ public:
 	static std::string commandToStr(const EPlayerCommand value);
 
 	bool play(PSong song, const std::string& playlist, const std::string& device, bool& isOpen);
+	void prepare(const CStreamData& stream);
 	bool stop();
 	bool pause();
 	bool resume();
@@ -529,9 +629,13 @@ public:
 	static int getAlsaHardwareDevices(util::TStringList& devices, util::TStringList& ignore);
 
 	void createBuffers(const size_t fraction, const size_t maxBufferCount = MAX_BUFFER_COUNT,
-			const size_t minBufferSize = MIN_BUFFER_SIZE, const size_t maxBufferSize = MAX_BUFFER_SIZE);
+			const size_t minBufferSize = MIN_BUFFER_SIZE, const size_t maxBufferSize = MAX_BUFFER_SIZE,
+			const EBufferMode mode = EBM_DECODED, const bool hugepages = false, const bool numa = false);
 	size_t bufferCount() const;
+	size_t bufferSize() const;
 	size_t freeBufferSize() const;
+	bool isCompressedBuffering() const { return buffers.isCompressed(); };
+	PSong preloadEncodedSongs(const TSongList& songs);
 
 	size_t resetStreamBuffers();
 	size_t bufferGarbageCollector(const music::TCurrentSongs& songs);
@@ -546,6 +650,7 @@ public:
 	void resetBuffers(PTrack track);
 	void resetBuffers();
 	void resetBuffer(PAudioBuffer buffer);
+	size_t dropBuffers(const TSong* song);
 
 	void operateBuffers(PAudioBuffer buffer, const PTrack track, const EBufferState state, const EBufferLevel level);
 	void operateBuffers(PAudioBuffer buffer, const PTrack track, const EBufferState state);
@@ -556,6 +661,11 @@ public:
 	PAudioBuffer getNextEmptyBuffer(const TSong* song);
 	PAudioBuffer getNextEmptyBuffer();
 
+	bool getSeekRequest(const TSong* song, size_t& position);
+	bool getRestartRequest(PSong& song);
+	void completeSeekRequest(const TSong* song, PAudioBuffer buffer);
+	void cancelSeekRequest(const TSong* song);
+
 	template<typename reader_t, typename class_t>
 		inline void bindStateChangedEvent(reader_t &&onPlaybackState, class_t &&owner) {
 			onPlaybackStateChanged = std::bind(onPlaybackState, owner, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4);
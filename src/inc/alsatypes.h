@@ -11,9 +11,12 @@
 #include "audiotypes.h"
 #include "datetime.h"
 #include "logger.h"
+#include "histogram.h"
 
 namespace music {
 
+STATIC_CONST size_t ALSA_UNDERRUN_LOCATIONS = 16; // Location given by caller of TAlsaPlayer::recoverUnderrun()
+
 typedef struct CAlsaConfig {
 	app::PLogFile logger;
 	snd_pcm_uint_t periodtime;
@@ -21,7 +24,11 @@ typedef struct CAlsaConfig {
 	int verbosity;
 	bool debug;
 	bool dithered;
+	EDitherSpectrum spectrum;
 	bool ignoremixer;
+	bool nativedsd;
+	int resamplerate;
+	EResamplerQuality resamplequality;
 
 	void clear() {
 		logger = nil;
@@ -30,7 +37,11 @@ typedef struct CAlsaConfig {
 		verbosity = 0;
 		debug = false;
 		dithered = false;
+		spectrum = EDS_FLAT;
 		ignoremixer = false;
+		nativedsd = true;
+		resamplerate = 0; // Device follows sample rate of song
+		resamplequality = ERQ_MEDIUM;
 	}
 
 	CAlsaConfig() {
@@ -38,6 +49,32 @@ typedef struct CAlsaConfig {
 	}
 } TAlsaConfig;
 
+typedef struct CAlsaStatistics {
+	util::THistogramValues wakeup;   // Microseconds from semaphore wake up to last commit of period
+	util::THistogramValues write;    // Microseconds spent in writePeriodData()
+	util::THistogramValues headroom; // Microseconds of queued frames reported by snd_pcm_avail_update()
+	size_t underruns[ALSA_UNDERRUN_LOCATIONS];
+	size_t recoveries[ALSA_UNDERRUN_LOCATIONS];
+	size_t underrun;
+	size_t recovery;
+
+	void clear() {
+		wakeup.clear();
+		write.clear();
+		headroom.clear();
+		for (size_t i=0; i<ALSA_UNDERRUN_LOCATIONS; ++i) {
+			underruns[i] = 0;
+			recoveries[i] = 0;
+		}
+		underrun = 0;
+		recovery = 0;
+	}
+
+	CAlsaStatistics() {
+		clear();
+	}
+} TAlsaStatistics;
+
 } /* namespace music */
 
 #endif /* ALSATYPES_H_ */
@@ -37,6 +37,7 @@
 #include "typeid.h"
 #include "system.h"
 #include "memory.h"
+#include "threadpool.h"
 #include "sockets.h"
 #include "ASCII.h"
 #include "gzip.h"
@@ -1469,6 +1470,15 @@ void TApplication::initialize(int argc, char *argv[], TTranslator& nls) {
 		sysdat.obj.tasks = new app::TTaskController(TA_TIME_RESOLUTION_MS, sysdat.app.configFolder, *sysdat.obj.tasksLog,  *sysdat.obj.exceptionLog);
 		sysdat.obj.threads = new app::TThreadController(*sysdat.obj.threadLog, *sysdat.obj.exceptionLog);
 
+		// Shared thread pool for short living tasks (0 = one worker per processor core)
+		// --> Pin workers to processor cores only when application is not pinned to fixed core
+		config->setSection(APP_CONFIG);
+		sysdat.app.poolSize = config->readInteger("ThreadPoolSize", sysdat.app.poolSize);
+		sysdat.app.poolAffinity = config->readBool("ThreadPoolAffinity", sysdat.app.poolAffinity);
+		config->writeInteger("ThreadPoolSize", sysdat.app.poolSize);
+		config->writeBool("ThreadPoolAffinity", sysdat.app.poolAffinity, INI_BLYES);
+		sysdat.obj.threads->getThreadPool().configure(sysdat.app.poolSize > 0 ? (size_t)sysdat.app.poolSize : 0, sysdat.app.poolAffinity && sysdat.app.affinity < 0);
+
 		// Cyclic log flushing
 		config->setSection(APP_CONFIG);
 		sysdat.log.cyclicLogFlush = config->readInteger("CyclicFlushDelay", sysdat.log.cyclicLogFlush);
@@ -14,6 +14,7 @@
 #include "convert.h"
 #include "ASCII.h"
 #include "pcm.h"
+#include "samples.h"
 
 namespace music {
 
@@ -60,6 +61,7 @@ void TAudioBuffer::resetWriter() {
 }
 
 void TAudioBuffer::init() {
+	m_offset = 0;
 	m_level = EBL_EMPTY;
 	m_status = EBS_EMPTY;
 	m_track = nil;
@@ -119,6 +121,28 @@ void TAudioBuffer::resize(const size_t size) {
 	}
 }
 
+void TAudioBuffer::configure(const util::TMappedOptions& options) {
+#ifdef USE_MEMORY_MAPPED_SAMPLE_BUFFER
+	buffer.configure(options);
+#endif
+}
+
+size_t TAudioBuffer::getPageSize() const {
+#ifdef USE_MEMORY_MAPPED_SAMPLE_BUFFER
+	return buffer.memory().getPageSize();
+#else
+	return 0;
+#endif
+}
+
+size_t TAudioBuffer::getPageFaults() const {
+#ifdef USE_MEMORY_MAPPED_SAMPLE_BUFFER
+	return buffer.memory().getFaults();
+#else
+	return 0;
+#endif
+}
+
 PSong TAudioBuffer::getSong() const {
 	if (util::assigned(m_track))
 		return m_track->getSong();
@@ -214,6 +238,30 @@ PSample TAudioBuffer::write32Bit(uint32_t value, const util::EEndianType endian)
 	return nil;
 }
 
+PSample TAudioBuffer::writePlanar(const int32_t* const samples[], const size_t channels, const size_t frames,
+		const size_t bitsPerSample, const util::EEndianType endian) {
+	if (validBuffer() && validWriter()) {
+		size_t bytes = frames * channels * bitsPerSample / 8;
+		if (w_ptr + bytes <= w_max) {
+			size_t written = packPlanarSamples(w_ptr, samples, channels, frames, bitsPerSample, endian);
+			if (written > 0)
+				return write(written);
+		}
+	}
+	return nil;
+}
+
+PSample TAudioBuffer::writeSwapped(const TSample* samples, const size_t size, const size_t bitsPerSample) {
+	if (validBuffer() && validWriter()) {
+		if (w_ptr + size <= w_max) {
+			size_t written = swapSampleOrder(w_ptr, samples, size, bitsPerSample);
+			if (written > 0)
+				return write(written);
+		}
+	}
+	return nil;
+}
+
 
 bool TAudioBuffer::validReader() const {
 	if (util::assigned(r_ptr))
@@ -308,6 +356,11 @@ void TAudioBuffer::debugOutput(const std::string& preamble) const {
 	std::cout << preamble << "Unique ID      : " << m_key << std::endl;
 	std::cout << preamble << "Status         : " << bufferStatusToStr(m_status) << std::endl;
 	std::cout << preamble << "Buffer size    : " << buffer.size() << " Bytes [" << util::sizeToStr(buffer.size(), 1, util::VD_BINARY) << "]" << std::endl;
+#ifdef USE_MEMORY_MAPPED_SAMPLE_BUFFER
+	std::cout << preamble << "Page size      : " << util::sizeToStr(getPageSize(), 1, util::VD_BINARY) << (buffer.memory().getPages() == util::EMP_HUGETLB ? " (reserved)" : (buffer.memory().getPages() == util::EMP_TRANSPARENT ? " (transparent)" : "")) << std::endl;
+	std::cout << preamble << "Page faults    : " << getPageFaults() << std::endl;
+	std::cout << preamble << "NUMA node      : " << buffer.memory().getNode() << std::endl;
+#endif
 	std::cout << preamble << "Bytes read     : " << m_read << " Bytes [" << util::sizeToStr(m_read, 1, util::VD_BINARY) << "]" << std::endl;
 	std::cout << preamble << "Bytes written  : " << m_written << " Bytes [" << util::sizeToStr(m_written, 1, util::VD_BINARY) << "]" << std::endl;
 	std::cout << preamble << "Is allocated   : " << isAllocated() << std::endl;
@@ -347,16 +400,34 @@ bool TAudioBuffer::saveToFile(const std::string fileName, const TAudioBufferList
 
 
 
+// Background thread to lock encoded files into memory
+static void* pinnerThreadDispatcher(void *thread) {
+	if (util::assigned(thread)) {
+		return (void *)(long)(static_cast<PAudioBufferList>(thread))->pinnerThreadHandler();
+	} else {
+		return (void *)(long)(EXIT_FAILURE);
+	}
+}
+
+
 TAudioBufferList::TAudioBufferList() {
+	pinning = nil;
+	pinner = 0;
+	terminated = false;
+	pinError = EXIT_SUCCESS;
 	m_key = 0;
 	m_size = 0;
 	m_free = 0;
 	m_allocated = 0;
 	m_empty = 0;
+	m_encoded = 0;
+	m_limit = 0;
+	m_mode = EBM_DECODED;
 	debug = true;
 }
 
 TAudioBufferList::~TAudioBufferList() {
+	terminatePinner();
 	clear();
 }
 
@@ -383,6 +454,7 @@ void TAudioBufferList::clear() {
 	}
 
 	util::clearObjectList(list);
+	unload();
 
 	if (debug && count() > 0) {
 		sysutil::getSystemMemory(mem);
@@ -403,9 +475,20 @@ void TAudioBufferList::create(const size_t fraction, const size_t maxBufferCount
 		factor /= 10;
 		size_t free = mem.memFree * factor / 10;
 
+		// Use most of the memory for encoded files in compressed mode
+		// --> Remaining memory holds at least 2 PCM buffers for the decode-ahead ring
+		m_limit = 0;
+		if (isCompressed()) {
+			m_limit = free * ENCODED_BUFFER_PERCENT / 100;
+			if ((free - m_limit) < (2 * minBufferSize))
+				m_limit = (free > (2 * minBufferSize)) ? free - 2 * minBufferSize : 0;
+			free -= m_limit;
+		}
+
 		if (debug) {
 			std::cout << "TAudioBufferList::create() Percent usage = " << fraction << std::endl;
 			std::cout << "TAudioBufferList::create() Usable memory = " << util::sizeToStr(free) << std::endl;
+			std::cout << "TAudioBufferList::create() Encoded memory = " << util::sizeToStr(m_limit) << std::endl;
 			std::cout << "TAudioBufferList::create() Max. buffer count = " << maxBufferCount << std::endl;
 			std::cout << "TAudioBufferList::create() Min. buffer size  = " << util::sizeToStr(minBufferSize) << std::endl;
 			std::cout << "TAudioBufferList::create() Max. buffer size  = " << util::sizeToStr(maxBufferSize) << std::endl;
@@ -456,12 +539,14 @@ void TAudioBufferList::create(const size_t fraction, const size_t maxBufferCount
 		if (b_count >= 2) {
 			for (size_t i=0; i<b_count; ++i) {
 				PAudioBuffer o = new TAudioBuffer;
+				o->configure(m_options);
 				o->resize(m_size);
 				list.push_back(o);
 				m_free += m_size;
 				++m_empty;
 				if (debug) {
-					std::cout << "  TAudioBufferList::create() Buffer[" << util::succ(i) << "] created, size = " << util::sizeToStr(o->size()) << std::endl;
+					std::cout << "  TAudioBufferList::create() Buffer[" << util::succ(i) << "] created, size = " << util::sizeToStr(o->size()) \
+							<< ", page size = " << util::sizeToStr(o->getPageSize()) << ", page faults = " << o->getPageFaults() << std::endl;
 				}
 			}
 		} else {
@@ -483,6 +568,23 @@ void TAudioBufferList::create(const size_t fraction, const size_t maxBufferCount
 	}
 }
 
+size_t TAudioBufferList::getPageSize() const {
+	// All buffers are created with the same memory options
+	if (!list.empty())
+		return list[0]->getPageSize();
+	return 0;
+}
+
+size_t TAudioBufferList::getPageFaults() const {
+	size_t r = 0;
+	for (size_t i=0; i<count(); ++i) {
+		PAudioBuffer o = list[i];
+		if (util::assigned(o))
+			r += o->getPageFaults();
+	}
+	return r;
+}
+
 bool TAudioBufferList::isSufficient(const size_t needed) const {
 	return (m_size - m_free) > needed;
 }
@@ -632,6 +734,29 @@ size_t TAudioBufferList::resetStreamBuffers() {
 	return r;
 }
 
+size_t TAudioBufferList::drop(const TSong* song) {
+	// Release all buffers for given song that are not playing
+	// --> Make room in decode-ahead ring for decoder seek
+	size_t r = 0;
+	if (util::assigned(song)) {
+		PSong s;
+		PAudioBuffer o;
+		for (size_t i=0; i<count(); ++i) {
+			o = list[i];
+			if (util::assigned(o)) {
+				s = o->getSong();
+				if (util::assigned(s) && !o->isPlaying()) {
+					if (s->compareByTitleHash(song)) {
+						release(o);
+						++r;
+					}
+				}
+			}
+		}
+	}
+	return r;
+}
+
 size_t TAudioBufferList::reset(const util::hash_type hash, const TSong* current, const size_t index, const ECompareType type, size_t range) {
 	PSong song;
 	PTrack track;
@@ -885,6 +1010,194 @@ void TAudioBufferList::release(PAudioBuffer buffer) {
 }
 
 
+bool TAudioBufferList::hasEncoded(const std::string& fileHash) const {
+	for (size_t i=0; i<encoded.size(); ++i) {
+		if (encoded[i].hash == fileHash)
+			return true;
+	}
+	return false;
+}
+
+TEncodedFileList::iterator TAudioBufferList::unload(TEncodedFileList::iterator it) {
+	if (m_encoded > it->size)
+		m_encoded -= it->size;
+	else
+		m_encoded = 0;
+	unpin(it->file);
+	return encoded.erase(it);
+}
+
+void TAudioBufferList::pin(util::TMappedFile* file) {
+	// Called with encoded file lock held
+	app::TLockGuard<app::TCondition> lock(pinEvent);
+	if (pinner == 0 && !terminated) {
+		if (!createJoinableThread(pinner, pinnerThreadDispatcher, this, "Buffer-Pinner"))
+			return;
+	}
+	pinQueue.push_back(file);
+	pinEvent.broadcast();
+}
+
+void TAudioBufferList::unpin(util::TMappedFile*& file) {
+	// Called with encoded file lock held
+	// --> File currently locked by pinner thread is freed by the thread afterwards
+	app::TLockGuard<app::TCondition> lock(pinEvent);
+	pinQueue.erase(std::remove(pinQueue.begin(), pinQueue.end(), file), pinQueue.end());
+	if (util::assigned(file) && file == pinning) {
+		retired.push_back(file);
+		file = nil;
+	} else {
+		util::freeAndNil(file);
+	}
+}
+
+int TAudioBufferList::pinnerThreadHandler() {
+	util::TMappedFile* file;
+	while (true) {
+		{
+			app::TLockGuard<app::TCondition> lock(pinEvent);
+			while (!terminated && pinQueue.empty()) {
+				pinEvent.wait();
+			}
+			if (terminated)
+				break;
+			file = pinning = pinQueue.front();
+			pinQueue.erase(pinQueue.begin());
+		}
+
+		// Page in and lock whole file without holding any lock
+		// --> Encoded file lock is taken before pin lock, same order as in preload()
+		if (!file->lock()) {
+			app::TLockGuard<app::TMutex> lock(encodedMtx);
+			unlocked(file);
+		}
+
+		app::TLockGuard<app::TCondition> lock(pinEvent);
+		pinning = nil;
+		util::clearObjectList(retired);
+	}
+	return EXIT_SUCCESS;
+}
+
+void TAudioBufferList::unlocked(util::TMappedFile* file) {
+	// Called with encoded file lock held
+	// --> File stays mapped and is read from page cache, but is not accounted as pinned memory
+	// --> Limit encoded memory to the amount that could be locked, e.g. by RLIMIT_MEMLOCK
+	TEncodedFileList::iterator it = encoded.begin();
+	for (; it != encoded.end(); ++it) {
+		if (it->file == file) {
+			if (m_encoded > it->size)
+				m_encoded -= it->size;
+			else
+				m_encoded = 0;
+			if (m_limit > m_encoded)
+				m_limit = m_encoded;
+			it->size = 0;
+			pinFile = it->name;
+			pinError = file->error();
+			break;
+		}
+	}
+}
+
+bool TAudioBufferList::getPinError(std::string& file, int& error) {
+	app::TLockGuard<app::TMutex> lock(encodedMtx);
+	if (pinError != EXIT_SUCCESS) {
+		file = pinFile;
+		error = pinError;
+		pinFile.clear();
+		pinError = EXIT_SUCCESS;
+		return true;
+	}
+	return false;
+}
+
+void TAudioBufferList::terminatePinner() {
+	if (pinner != 0) {
+		{
+			app::TLockGuard<app::TCondition> lock(pinEvent);
+			terminated = true;
+			pinEvent.broadcast();
+		}
+		terminateThread(pinner);
+		pinner = 0;
+	}
+	util::clearObjectList(retired);
+}
+
+void TAudioBufferList::unload() {
+	app::TLockGuard<app::TMutex> lock(encodedMtx);
+	TEncodedFileList::iterator it = encoded.begin();
+	while (it != encoded.end()) {
+		it = unload(it);
+	}
+	m_encoded = 0;
+}
+
+size_t TAudioBufferList::encodedSize() {
+	app::TLockGuard<app::TMutex> lock(encodedMtx);
+	return m_encoded;
+}
+
+PSong TAudioBufferList::preload(const TSongList& songs) {
+	if (!isCompressed())
+		return nil;
+
+	// Encoded files have their own lock, PCM buffers are not touched here
+	// --> Reading a file into memory must not block the playback thread
+	app::TLockGuard<app::TMutex> lock(encodedMtx);
+
+	// Release encoded files not needed for given upcoming songs
+	TEncodedFileList::iterator it = encoded.begin();
+	while (it != encoded.end()) {
+		bool found = false;
+		for (size_t i=0; i<songs.size(); ++i) {
+			PSong song = songs[i];
+			if (util::assigned(song)) {
+				if (song->getFileHash() == it->hash) {
+					found = true;
+					break;
+				}
+			}
+		}
+		if (found)
+			++it;
+		else
+			it = unload(it);
+	}
+
+	// Map next missing file in playlist order
+	// --> Mapping starts asynchronous read ahead by MADV_WILLNEED
+	// --> File is locked into memory by background thread, decoders read from resident page cache
+	for (size_t i=0; i<songs.size(); ++i) {
+		PSong song = songs[i];
+		if (!util::assigned(song))
+			continue;
+		if (hasEncoded(song->getFileHash()))
+			continue;
+		if ((m_encoded + song->getFileSize()) > m_limit)
+			break;
+		util::TMappedFile* file = new util::TMappedFile;
+		if (file->map(song->getFileName())) {
+			pin(file);
+			TEncodedFile o;
+			o.hash = song->getFileHash();
+			o.name = song->getFileName();
+			o.file = file;
+			o.size = file->getSize();
+			encoded.push_back(o);
+			m_encoded += o.size;
+			if (debug) {
+				std::cout << "TAudioBufferList::preload() Encoded file <" << song->getFileName() << "> loaded, size = " << util::sizeToStr(o.size) << std::endl;
+			}
+			return song;
+		}
+		util::freeAndNil(file);
+	}
+	return nil;
+}
+
+
 PAudioBuffer TAudioBufferList::getNextSongBuffer(const TTrack* track, const bool debug) {
 	if (util::assigned(track))
 		return getNextSongBuffer(track->getSong(), debug);
@@ -1045,8 +1358,6 @@ PAudioBuffer TAudioBufferList::getSeekBuffer(const TSong* song, const size_t pos
 	offset = 0;
 	if (util::assigned(song)) {
 		if (position < song->getSampleSize()) {
-			size_t size = 0;
-			size_t last = 0;
 			PAudioBuffer o;
 			for (size_t i=0; i<count(); ++i) {
 				o = list[i];
@@ -1054,12 +1365,12 @@ PAudioBuffer TAudioBufferList::getSeekBuffer(const TSong* song, const size_t pos
 					PSong s = o->getSong();
 					if (util::assigned(s)) {
 						if (s->compareByTitleHash(song)) {
-							size += o->getWritten();
-							if (size > position) {
-								offset = position - last;
+							// Buffer offset is the position of the first byte in the decoded song
+							// --> Song may be decoded in non contiguous parts after decoder seek
+							if (position >= o->getOffset() && position < (o->getOffset() + o->getWritten())) {
+								offset = position - o->getOffset();
 								return o;
 							}
-							last = size;
 						}
 					}
 				}
@@ -1069,6 +1380,36 @@ PAudioBuffer TAudioBufferList::getSeekBuffer(const TSong* song, const size_t pos
 	return nil;
 }
 
+size_t TAudioBufferList::reposition(const TSong* song, const PAudioBuffer buffer) {
+	size_t r = 0;
+	if (util::assigned(song) && util::assigned(buffer)) {
+		PSong s;
+		PAudioBuffer o;
+		size_t position = buffer->getOffset();
+		for (size_t i=0; i<count(); ++i) {
+			o = list[i];
+			if (util::assigned(o) && o != buffer) {
+				s = o->getSong();
+				if (util::assigned(s)) {
+					if (s->compareByTitleHash(song)) {
+						if (o->getOffset() >= position || isCompressed()) {
+							// Drop buffers behind new decoder position
+							// --> Previous buffers would block the decode-ahead ring in compressed mode
+							release(o);
+							++r;
+						} else {
+							// Keep previous buffers for seeking, but do not play them again
+							o->resetReader();
+							o->forceStatus(EBS_PLAYED);
+						}
+					}
+				}
+			}
+		}
+	}
+	return r;
+}
+
 
 bool TAudioBufferList::hasSong(const TSong* song) const {
 	if (util::assigned(song)) {
@@ -1090,6 +1431,25 @@ bool TAudioBufferList::hasSong(const TSong* song) const {
 }
 
 
+bool TAudioBufferList::isDecoded(const TSong* song) const {
+	if (util::assigned(song)) {
+		PSong s;
+		PAudioBuffer o;
+		for (size_t i=0; i<count(); ++i) {
+			o = list[i];
+			if (util::assigned(o)) {
+				s = o->getSong();
+				if (util::assigned(s)) {
+					// Last buffer for song is marked when decoder has finished
+					if (o->isLast() && s->compareByTitleHash(song))
+						return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
 bool TAudioBufferList::hasFile(const std::string& fileHash) const {
 	PSong s;
 	PAudioBuffer o;
@@ -14,6 +14,9 @@
 #include "endianutils.h"
 #include "stringtypes.h"
 #include "semaphore.h"
+#include "semaphores.h"
+#include "fileutils.h"
+#include "threads.h"
 #include "nullptr.h"
 #include "memory.h"
 #include "tags.h"
@@ -23,6 +26,13 @@ namespace music {
 class TAudioBuffer;
 class TAudioBufferList;
 
+typedef struct CEncodedFile {
+	std::string hash;
+	std::string name;
+	util::TMappedFile* file;
+	size_t size;
+} TEncodedFile;
+
 #ifdef STL_HAS_TEMPLATE_ALIAS
 
 using TKeyValue = size_t;
@@ -30,6 +40,7 @@ using PAudioBuffer = TAudioBuffer*;
 using PAudioBufferList = TAudioBufferList*;
 using TBufferList = std::vector<PAudioBuffer>;
 using TBufferSorter = std::function<bool(const TAudioBuffer *, const TAudioBuffer *)>;
+using TEncodedFileList = std::vector<TEncodedFile>;
 
 #else
 
@@ -38,6 +49,7 @@ typedef TAudioBuffer* PAudioBuffer;
 typedef TAudioBufferList* PAudioBufferList;
 typedef std::vector<PAudioBuffer> TBufferList;
 typedef std::function<bool(const TAudioBuffer *, const TAudioBuffer *)> TBufferSorter;
+typedef std::vector<TEncodedFile> TEncodedFileList;
 
 #endif
 
@@ -120,6 +132,7 @@ private:
 	PSample w_max;
 	size_t m_written;
 	size_t m_read;
+	size_t m_offset;
 	TKeyValue m_key;
 	PTrack m_track;
 	bool m_last;
@@ -140,11 +153,16 @@ public:
 	void resetWriter();
 	void resize(const size_t size);
 	void cleanup();
+	void configure(const util::TMappedOptions& options);
+	size_t getPageSize() const;
+	size_t getPageFaults() const;
 
 	size_t size() const { return buffer.size(); };
 	PSample data() const { return buffer.data(); };
 	size_t getWritten() const { return m_written; };
 	size_t getRead() const { return m_read; };
+	size_t getOffset() const { return m_offset; };
+	void setOffset(const size_t value) { m_offset = value; };
 
 	const std::string& getFile() const;
 	const std::string& getHash() const;
@@ -189,6 +207,10 @@ public:
 	PSample write24Bit(uint32_t value, const util::EEndianType endian = util::EE_LITTLE_ENDIAN);
 	PSample write32Bit(uint32_t value, const util::EEndianType endian = util::EE_LITTLE_ENDIAN);
 
+	PSample writePlanar(const int32_t* const samples[], const size_t channels, const size_t frames,
+			const size_t bitsPerSample, const util::EEndianType endian = util::EE_LITTLE_ENDIAN);
+	PSample writeSwapped(const TSample* samples, const size_t size, const size_t bitsPerSample);
+
 	PSample rewind(const size_t size);
 	PSample read(const size_t size);
 	PSample write(const size_t size);
@@ -215,7 +237,11 @@ public:
 };
 
 
-class TAudioBufferList {
+// List of preallocated PCM sample buffers
+// --> EBM_DECODED: Songs are completely decoded into buffers ahead of playback
+// --> EBM_COMPRESSED: Encoded files of upcoming songs are held in locked memory,
+//     the PCM buffers are used as a decode-ahead ring and released after playback
+class TAudioBufferList : private app::TThreadUtil {
 private:
 	TBufferList list;
 	size_t m_size;
@@ -224,6 +250,27 @@ private:
 	size_t m_free;
 	bool debug;
 	TKeyValue m_key;
+	EBufferMode m_mode;
+	util::TMappedOptions m_options;
+	app::TMutex encodedMtx;
+	TEncodedFileList encoded;
+	size_t m_encoded;
+	size_t m_limit;
+
+	// Encoded files are locked into memory by background thread
+	app::TCondition pinEvent;
+	std::vector<util::TMappedFile*> pinQueue;
+	std::vector<util::TMappedFile*> retired;
+	util::TMappedFile* pinning;
+	pthread_t pinner;
+	bool terminated;
+	std::string pinFile;
+	int pinError;
+
+	void pin(util::TMappedFile* file);
+	void unpin(util::TMappedFile*& file);
+	void unlocked(util::TMappedFile* file);
+	void terminatePinner();
 
 	bool validIndex(const size_t index) const;
 	void sort(const util::ESortOrder order, const TBufferSorter asc, const TBufferSorter desc);
@@ -232,6 +279,9 @@ private:
 	void allocate(PAudioBuffer buffer);
 	void release(PAudioBuffer buffer);
 
+	bool hasEncoded(const std::string& fileHash) const;
+	TEncodedFileList::iterator unload(TEncodedFileList::iterator it);
+
 	TKeyValue getNextKey() { return ++m_key; };
 	PAudioBuffer getNextBuffer(const TSong* song, const bool debug = false);
 	PAudioBuffer getCurrentBuffer(const TSong* song, const bool debug = false);
@@ -262,6 +312,20 @@ public:
 
 	void setDebug(const bool value) { debug = value; };
 	bool getDebug() const { return debug; };
+	void setMode(const EBufferMode value) { m_mode = value; };
+	EBufferMode getMode() const { return m_mode; };
+	bool isCompressed() const { return m_mode == EBM_COMPRESSED; };
+	void setMemoryOptions(const util::TMappedOptions& options) { m_options = options; };
+	size_t getPageSize() const;
+	size_t getPageFaults() const;
+
+	PSong preload(const TSongList& songs);
+	int pinnerThreadHandler();
+	void unload();
+	size_t drop(const TSong* song);
+	size_t encodedSize();
+	size_t encodedLimit() const { return m_limit; };
+	bool getPinError(std::string& file, int& error);
 
 	size_t count() const { return list.size(); };
 	size_t free() const { return m_free; };
@@ -270,6 +334,7 @@ public:
 	size_t buffer() const { return m_size; };
 	bool isSufficient(const size_t needed) const;
 	bool hasSong(const TSong* song) const;
+	bool isDecoded(const TSong* song) const;
 	bool hasFile(const std::string& fileHash) const;
 	bool hasAlbum(const std::string& albumHash) const;
 
@@ -283,6 +348,7 @@ public:
 	PAudioBuffer getRewindBuffer(const PAudioBuffer buffer, const TSong* song);
 	PAudioBuffer getForwardBuffer(const PAudioBuffer buffer, const TSong* song);
 	PAudioBuffer getSeekBuffer(const TSong* song, const size_t position, size_t& offset);
+	size_t reposition(const TSong* song, const PAudioBuffer buffer);
 
 	PAudioBuffer at(const std::size_t index) const;
 	PAudioBuffer operator[] (const std::size_t index) const;
@@ -23,6 +23,9 @@ STATIC_CONST size_t MAX_BUFFER_COUNT = 32;
 STATIC_CONST size_t MIN_BUFFER_SIZE = 1024 * 1024 * 16; // 16 MByte
 STATIC_CONST size_t MAX_BUFFER_SIZE = 1024 * 1024 * 128; // 128 MByte
 
+STATIC_CONST size_t ENCODED_BUFFER_PERCENT = 75; // Part of buffer memory used for encoded files in compressed buffer mode
+STATIC_CONST size_t DECODE_AHEAD_SECONDS = 30;
+
 STATIC_CONST size_t AUDIO_CHUNK_SIZE = 1024 * 16; // 16 kByte
 
 STATIC_CONST size_t ALAC_FRAMES_PER_PACKET = 1024 * 4; // 4 kByte
@@ -33,6 +36,8 @@ STATIC_CONST size_t DSF_CHUNK_SIZE = 1024 * 4; // 4 kByte for left channel and t
 
 STATIC_CONST size_t MP3_INPUT_CHUNK_SIZE = 1024 * 8; // 8 kByte compressed data
 STATIC_CONST size_t MP3_OUTPUT_CHUNK_SIZE = 2 * MP3_INPUT_CHUNK_SIZE; // 16 kByte uncompressed data
+STATIC_CONST size_t MP3_FRAME_SCAN_SIZE = 1024 * 64; // 64 kByte read ahead for frame header scanning
+STATIC_CONST size_t MP3_SEEK_TABLE_STEP = 32; // Frames per seek table entry for scanned files
 
 
 // BASE64 encoded JPG 32x32 pixel: nocover.jpg
@@ -37,6 +37,22 @@ bool TAudioStream::update(const TSample *const data, const size_t size, PAudioBu
 	return false;
 }
 
+size_t TAudioStream::getFrameSize() const {
+	// DSD samples are decoded as 16 bit DoP words per channel
+	size_t bytes = (stream.bitsPerSample > ES_DSD_OE) ? stream.bitsPerSample / 8 : 2;
+	return stream.channels * bytes;
+}
+
+bool TAudioStream::seek(const size_t sample, PAudioBuffer buffer, size_t& position, size_t& read) {
+	// Default decoder can not be positioned
+	// --> Sample is the frame index in the decoded output stream
+	// --> Position returns the decoded output byte offset the next update() continues from
+	// --> Read returns the bytes written to the given buffer while positioning
+	position = 0;
+	read = 0;
+	return false;
+}
+
 bool TAudioStream::getConfiguredValues(TDecoderParams& params) {
 	params.clear();
 	return false;
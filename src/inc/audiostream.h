@@ -11,6 +11,7 @@
 #include "audiotypes.h"
 #include "audiobuffer.h"
 #include "tagtypes.h"
+#include "readahead.h"
 #include "gcc.h"
 
 namespace music {
@@ -59,6 +60,7 @@ class TAudioStream {
 protected:
 	PAudioBuffer buffer;
 	CStreamData stream;
+	util::TReadAhead reader;
 	size_t consumed;
 	size_t read;
 	bool error;
@@ -79,6 +81,8 @@ protected:
 	void addConsumed(size_t value) { consumed += value; };
 	size_t getConsumed() const { return consumed; };
 
+	size_t getFrameSize() const;
+
 	void prime();
 	void clear();
 
@@ -88,12 +92,14 @@ public:
 	bool hasError() const { return error; };
 
 	virtual size_t getBlockSize() const { return (size_t)0; };
+	virtual bool canSeek() const { return false; };
 
 	virtual bool getConfiguredValues(TDecoderParams& params);
 	virtual bool getRunningValues(TDecoderParams& params);
 
 	virtual bool update(PAudioBuffer buffer, size_t& read) = 0;
 	virtual bool update(const TSample *const data, const size_t size, PAudioBuffer buffer, size_t& written, size_t& consumed);
+	virtual bool seek(const size_t sample, PAudioBuffer buffer, size_t& position, size_t& read);
 
 	virtual bool open(const std::string& fileName, const CStreamData& properties) = 0;
 	virtual bool open(const TSong& song) = 0;
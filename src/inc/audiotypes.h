@@ -165,6 +165,17 @@ typedef struct CTracks {
 	TSongMap files;
 } TTracks;
 
+enum EMediaType {
+	EMT_UNKNOWN,
+	EMT_CD,
+	EMT_HDCD,
+	EMT_DSD,
+	EMT_DVD,
+	EMT_BD,
+	EMT_HR,
+	EMT_ALL
+};
+
 typedef struct CAlbum {
 	std::string name;
 	std::string artist;
@@ -180,6 +191,7 @@ typedef struct CAlbum {
 	std::string url;
 
 	bool compilation;
+	EMediaType media;
 	util::TTimePart inserted;
 	util::TTimePart date;
 	TSongList songs;
@@ -197,6 +209,7 @@ typedef struct CAlbum {
 		hash = value.hash;
 		url = value.url;
 		compilation = value.compilation;
+		media = value.media;
 		inserted = value.inserted;
 		date = value.date;
 		for (size_t i=0; i<value.songs.size(); ++i)
@@ -206,6 +219,7 @@ typedef struct CAlbum {
 
 	CAlbum() {
 		compilation = false;
+		media = EMT_UNKNOWN;
 		inserted = util::epoch();
 		date = util::epoch();
 	}
@@ -217,8 +231,8 @@ using PAlbum = TAlbum*;
 using TAlbumList = std::vector<PAlbum>;
 using TConstAlbumList = std::vector<const TAlbum*>;
 
-using TAlbumMap = std::map<std::string, TAlbum>;
-using TAlbumItem = std::pair<std::string, TAlbum>;
+using TAlbumMap = std::map<std::string, PAlbum>;
+using TAlbumItem = std::pair<std::string, PAlbum>;
 using TAlbumIterator = TAlbumMap::iterator;
 using TAlbumConstIterator = TAlbumMap::const_iterator;
 
@@ -233,8 +247,8 @@ typedef TAlbum* PAlbum;
 typedef std::vector<PAlbum> TAlbumList;
 typedef std::vector<const TAlbum*> TConstAlbumList;
 
-typedef std::map<std::string, TAlbum> TAlbumMap;
-typedef std::pair<std::string, TAlbum> TAlbumItem;
+typedef std::map<std::string, PAlbum> TAlbumMap;
+typedef std::pair<std::string, PAlbum> TAlbumItem;
 typedef TAlbumMap::iterator TAlbumIterator;
 typedef TAlbumMap::const_iterator TAlbumConstIterator;
 
@@ -252,7 +266,16 @@ typedef struct CArtist {
 	std::string displayoriginalname;
 	std::string hash;
 	std::string url;
+	unsigned int media;
 	TAlbumMap albums;
+
+	bool hasMedia(const EMediaType type) const {
+		return (media & (1 << type)) != 0;
+	}
+
+	CArtist() {
+		media = 0;
+	}
 } TArtist;
 
 
@@ -282,19 +305,22 @@ typedef std::pair<char, int> TLetterItem;
 typedef TLetterMap::iterator TLetterIterator;
 typedef TLetterMap::const_iterator TLetterConstIterator;
 
-using std::vector<const music::TArtist*> TConstArtistList;
+typedef std::vector<const music::TArtist*> TConstArtistList;
 
 #endif
 
 
+// Artist table holds each artist once, albums of an artist point to the hashed album table
+// --> Media type lists are views into the artist table
 typedef struct CArtists {
-	TArtistMap all;
-	TArtistMap cd;
-	TArtistMap hdcd;
-	TArtistMap dsd;
-	TArtistMap dvd;
-	TArtistMap bd;
-	TArtistMap hr;
+	TArtistMap table;
+	TConstArtistList all;
+	TConstArtistList cd;
+	TConstArtistList hdcd;
+	TConstArtistList dsd;
+	TConstArtistList dvd;
+	TConstArtistList bd;
+	TConstArtistList hr;
 } TArtists;
 
 typedef struct CAplhabet {
@@ -311,9 +337,9 @@ typedef struct CSongs {
 	TTracks tracks;
 	TArtists artists;
 	TAplhabet letters;
-	THashedMap albums;
-	TAlbumMap ordered;
-	TAlbumList recent;
+	THashedMap albums;   // Album table, owns album entries by album hash
+	TAlbumMap ordered;   // View into album table by album sort name
+	TAlbumList recent;   // View into album table by inserted date
 } TSongs;
 
 
@@ -330,22 +356,28 @@ enum ECodecType {
 	EFT_MP3 = 99
 };
 
-enum EMediaType {
-	EMT_UNKNOWN,
-	EMT_CD,
-	EMT_HDCD,
-	EMT_DSD,
-	EMT_DVD,
-	EMT_BD,
-	EMT_HR,
-	EMT_ALL
-};
-
 enum EPcmType {
 	EP_PCM_RAW,
 	EP_PCM_WAVE
 };
 
+enum EBufferMode {
+	EBM_DECODED,    // Songs are decoded completely into PCM buffers
+	EBM_COMPRESSED  // Encoded files are held in memory, PCM buffers are used as decode-ahead ring
+};
+
+enum EDitherSpectrum {
+	EDS_FLAT,   // White TPDF dither
+	EDS_FIRST,  // First order highpass shaped TPDF dither
+	EDS_SECOND  // Second order highpass shaped TPDF dither
+};
+
+enum EResamplerQuality {
+	ERQ_LOW,    // Short filter, passband up to 0.40 of lower sample rate
+	ERQ_MEDIUM, // Passband up to 0.43 of lower sample rate
+	ERQ_HIGH    // Long filter, passband up to 0.45 of lower sample rate
+};
+
 enum ESampleSize {
 	ES_DSD_NE = 1, // Newest endian
 	ES_DSD_OE = 2, // Oldest endian
@@ -2911,6 +2911,13 @@ size_t TJpeg::decode(const TBuffer& buffer) {
 	return (size_t)0;
 }
 
+size_t TJpeg::decode(const TBuffer& buffer, const TRGBSize targetWidth, const TRGBSize targetHeight) {
+	if (!buffer.empty()) {
+		return decode(buffer.data(), buffer.size(), image, imageWidth, imageHeight, targetWidth, targetHeight);
+	}
+	return (size_t)0;
+}
+
 size_t TJpeg::decode(const char* buffer, const size_t size) {
 	return decode(buffer, size, image, imageWidth, imageHeight, 0, 0);
 }
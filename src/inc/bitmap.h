@@ -484,6 +484,7 @@ public:
 	size_t decode(const char* buffer, const size_t size, TRGBData& data, TRGBSize& width, TRGBSize& height, const TRGBSize targetWidth, const TRGBSize targetHeight);
 	size_t decode(const char* buffer, const size_t size);
 	size_t decode(const TBuffer& buffer);
+	size_t decode(const TBuffer& buffer, const TRGBSize targetWidth, const TRGBSize targetHeight);
 	size_t decode(const TFile& file);
 
 	size_t encode(const std::string& fileName, const TRGBData& data, const TRGBSize width, const TRGBSize height);
@@ -9,11 +9,13 @@
 #include "logger.h"
 #include "functors.h"
 #include "threads.h"
+#include "threadpool.h"
 
 namespace app {
 
 static std::mutex detachedTreadMtx;
 static size_t detachedTreadCount = 0;
+static PThreadPool detachedThreadPool = nil;
 
 /*
  * TIntermittentThread
@@ -32,9 +34,28 @@ TIntermittentThread::~TIntermittentThread() {
 
 void TIntermittentThread::init() {
 	logger = nil;
+	priority = ETP_NORMAL;
+}
+
+void TIntermittentThread::setThreadPool(TThreadPool* pool) {
+	std::lock_guard<std::mutex> lock(detachedTreadMtx);
+	detachedThreadPool = pool;
 }
 
 void TIntermittentThread::createDetachedThread(TThreadHandler method) {
+	// Use pool worker if available
+	// --> Create detached thread as before if pool is terminated or has no idle worker for high priority task
+	PThreadPool pool;
+	{
+		std::lock_guard<std::mutex> lock(detachedTreadMtx);
+		pool = detachedThreadPool;
+	}
+	if (util::assigned(pool)) {
+		void* object = this;
+		if (pool->enqueue([method, object] () { method(object); }, (ETaskPriority)priority))
+			return;
+	}
+
 	pthread_t thd = 0;
 	const char* desc = !name.empty() ? name.c_str() : nil;
 	TThreadUtil::createThread(thd, method, THD_CREATE_DETACHED, this, desc);
@@ -25,6 +25,7 @@
 namespace app {
 
 class TDetachedThread;
+class TThreadPool;
 
 #ifdef STL_HAS_TEMPLATE_ALIAS
 
@@ -41,6 +42,7 @@ typedef std::function<void(TDetachedThread&)> TThreadDetachedMethod;
 
 class TIntermittentThread : public TObject {
 private:
+	int priority;
 	void init();
 
 protected:
@@ -54,6 +56,12 @@ public:
 	static bool hasThreads() { return getThreadCount() > 0; };
 	static void waitFor();
 
+	// Thread methods are executed by pool workers when a pool is set
+	// --> Priority is a value of ETaskPriority
+	static void setThreadPool(TThreadPool* pool);
+	void setPriority(const int value) { priority = value; };
+	int getPriority() const { return priority; };
+
 	void writeException(const std::exception& e, const std::string& info);
 	void writeException(const std::string& info);
 
@@ -0,0 +1,108 @@
+/*
+ * dither.cpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: Dirk Brinkmeier
+ */
+
+#include <string.h>
+#include "dither.h"
+#include "random.h"
+#include "numlimits.h"
+
+namespace music {
+
+TDither::TDither() {
+	spectrum = EDS_FLAT;
+	state = 1;
+	reset();
+	seed(((uint64_t)util::randomize(1, util::TLimits::LIMIT_INT32_MAX) << 32) ^ (uint64_t)util::randomize(1, util::TLimits::LIMIT_INT32_MAX));
+}
+
+TDither::~TDither() {
+}
+
+void TDither::seed(const uint64_t value) {
+	// Scramble seed by splitmix64, engine state must not be zero
+	uint64_t z = value + 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	z = z ^ (z >> 31);
+	state = (z != 0) ? z : 1;
+	bits = 0;
+	count = 0;
+}
+
+void TDither::reset() {
+	bits = 0;
+	count = 0;
+	memset(history, 0, sizeof(history));
+}
+
+void TDither::setSpectrum(const EDitherSpectrum value) {
+	if (value != spectrum) {
+		spectrum = value;
+		reset();
+	}
+}
+
+void TDither::generateFlat(int32_t* dither, const size_t frames, const size_t channels) {
+	// Difference of two independent rectangular values gives zero mean triangular PDF
+	size_t samples = frames * channels;
+	for (size_t i=0; i<samples; ++i) {
+		*(dither++) = rectangular() - rectangular();
+	}
+}
+
+void TDither::generateFirstOrder(int32_t* dither, const size_t frames, const size_t channels) {
+	// Difference of successive rectangular values: triangular PDF with highpass spectrum
+	for (size_t i=0; i<frames; ++i) {
+		for (size_t c=0; c<channels; ++c) {
+			int32_t* h = history[c];
+			int32_t r = rectangular();
+			*(dither++) = r - h[0];
+			h[0] = r;
+		}
+	}
+}
+
+void TDither::generateSecondOrder(int32_t* dither, const size_t frames, const size_t channels) {
+	// Second order difference of rectangular values, halved to keep peak amplitude at 1 LSB
+	for (size_t i=0; i<frames; ++i) {
+		for (size_t c=0; c<channels; ++c) {
+			int32_t* h = history[c];
+			int32_t r = rectangular();
+			*(dither++) = (r - 2 * h[0] + h[1]) / 2;
+			h[1] = h[0];
+			h[0] = r;
+		}
+	}
+}
+
+const int32_t* TDither::generate(const size_t frames, const size_t channels) {
+	// Buffer grows to largest period size and is reused afterwards
+	size_t n = channels < DITHER_MAX_CHANNELS ? channels : DITHER_MAX_CHANNELS;
+	size_t samples = frames * channels;
+	if (buffer.size() < samples)
+		buffer.resize(samples);
+	int32_t* dither = buffer.data();
+	if (n == channels) {
+		switch (spectrum) {
+			case EDS_FIRST:
+				generateFirstOrder(dither, frames, channels);
+				break;
+			case EDS_SECOND:
+				generateSecondOrder(dither, frames, channels);
+				break;
+			default:
+				generateFlat(dither, frames, channels);
+				break;
+		}
+	} else {
+		// Filter history not available for all channels
+		generateFlat(dither, frames, channels);
+	}
+	return dither;
+}
+
+} /* namespace music */
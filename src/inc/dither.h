@@ -0,0 +1,87 @@
+/*
+ * dither.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: Dirk Brinkmeier
+ */
+
+#ifndef DITHER_H_
+#define DITHER_H_
+
+#include <vector>
+#include <stdint.h>
+#include "gcc.h"
+#include "audiotypes.h"
+
+namespace music {
+
+STATIC_CONST size_t DITHER_MAX_CHANNELS = 8;
+
+#ifdef STL_HAS_TEMPLATE_ALIAS
+
+using TDitherBuffer = std::vector<int32_t>;
+
+#else
+
+typedef std::vector<int32_t> TDitherBuffer;
+
+#endif
+
+
+// Triangular PDF dither generator for upscaling PCM samples
+// --> Dither values are scaled to the additional 8 bits of the upscaled sample,
+//     one LSB of the source sample is 256, the peak amplitude is +/- 1 LSB
+// --> Whole blocks are generated at once from a private xorshift engine,
+//     every instance is meant to be used by one thread only and needs no locking
+// --> Highpass spectrum moves the dither energy to higher frequencies by differencing the
+//     rectangular values, the history is kept for each channel across blocks
+// --> This is not error feedback noise shaping, upscaling does not requantize the source sample
+class TDither {
+private:
+	uint64_t state;
+	uint64_t bits;
+	size_t count;
+	EDitherSpectrum spectrum;
+	int32_t history[DITHER_MAX_CHANNELS][2];
+	TDitherBuffer buffer;
+
+	inline uint64_t random() {
+		// xorshift64* engine
+		state ^= state >> 12;
+		state ^= state << 25;
+		state ^= state >> 27;
+		return state * 0x2545F4914F6CDD1DULL;
+	}
+
+	inline int32_t rectangular() {
+		// Rectangular PDF in range -128..127 taken bytewise from random value
+		if (count <= 0) {
+			bits = random();
+			count = sizeof(bits);
+		}
+		int32_t r = (int8_t)(bits & 0xFF);
+		bits >>= 8;
+		--count;
+		return r;
+	}
+
+	void generateFlat(int32_t* dither, const size_t frames, const size_t channels);
+	void generateFirstOrder(int32_t* dither, const size_t frames, const size_t channels);
+	void generateSecondOrder(int32_t* dither, const size_t frames, const size_t channels);
+
+public:
+	void seed(const uint64_t value);
+	void reset();
+
+	const int32_t* generate(const size_t frames, const size_t channels);
+
+	void setSpectrum(const EDitherSpectrum value);
+	EDitherSpectrum getSpectrum() const { return spectrum; };
+
+	TDither();
+	virtual ~TDither();
+};
+
+} /* namespace music */
+
+#endif /* DITHER_H_ */
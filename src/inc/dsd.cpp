@@ -13,7 +13,7 @@
 #include "audioconsts.h"
 #include "audiotypes.h"
 #include "audiofile.h"
-#include "bits.h"
+#include "samples.h"
 #include "gcc.h"
 #include "dsd.h"
 
@@ -27,51 +27,10 @@ TDSDStream::TDSDStream() {
 TDSDStream::~TDSDStream() {
 }
 
-TSample TDSDStream::reverse(TSample sample, int bitsPerSample) {
-	if (bitsPerSample > ES_DSD_NE)
-		return sample;
-	return util::bitReverse(sample);
-}
-
 size_t TDSDStream::convertDSDtoDoP(const TSample* dsd, TSample* dop, size_t size, size_t offset, int bitsPerSample) {
-	size_t i = 0, idx = 0, written = 0;
-	TSample LC1, RC1, LC2, RC2;
-	const TSample* p = dsd;
-	while (i < size) {
-
-		// Read first L/R channel frame from DSD data
-		if (offset > 1) {
-			LC1 = reverse(dsd[idx], bitsPerSample);
-			RC1 = reverse(dsd[idx + offset], bitsPerSample);
-			++idx;
-		} else {
-			LC1 = reverse(*p++, bitsPerSample);
-			RC1 = reverse(*p++, bitsPerSample);
-		}
-
-		// Read second L/R channel frame from DSD data
-		if (offset > 1) {
-			LC2 = reverse(dsd[idx], bitsPerSample);
-			RC2 = reverse(dsd[idx + offset], bitsPerSample);
-			++idx;
-		} else {
-			LC2 = reverse(*p++, bitsPerSample);
-			RC2 = reverse(*p++, bitsPerSample);
-		}
-
-		// Write 2 frames for left channel
-		*dop++ = LC2;
-		*dop++ = LC1;
-
-		// Write 2 frames for right channel
-		*dop++ = RC2;
-		*dop++ = RC1;
-
-		// 4 samples were read and 4 bytes written
-		i += 4; // * AUDIO_SAMPLE_SIZE;
-		written += 4;
-	}
-	return written;
+	// Convert 2 frames of L/R channel DSD data per DoP block
+	// --> DSF data is stored LSB first and must be bit reversed
+	return convertDSDSamples(dop, dsd, size, offset, bitsPerSample <= ES_DSD_NE);
 }
 
 
@@ -140,6 +99,7 @@ void TDSFStream::setDSFDataEndian(TDSFData& data) const {
 
 TDSFDecoder::TDSFDecoder() {
 	debug = false;
+	dataOffset = 0;
 }
 
 TDSFDecoder::~TDSFDecoder() {
@@ -178,6 +138,7 @@ bool TDSFDecoder::open(const std::string& fileName, const CStreamData& propertie
 					size_t r = file.seek(hsize);
 					if (r != hsize)
 						error = true;
+					dataOffset = hsize;
 				}
 
 				// Close file on error!
@@ -185,6 +146,10 @@ bool TDSFDecoder::open(const std::string& fileName, const CStreamData& propertie
 					opened = false;
 					file.close();
 				}
+
+				// Prefetch sample data ahead of decoder
+				if (opened)
+					reader.open(file, dataOffset);
 			}
 			if (opened)
 				setStream(properties);
@@ -199,6 +164,35 @@ bool TDSFDecoder::open(const std::string& fileName, const CStreamData& propertie
 }
 
 
+bool TDSFDecoder::seek(const size_t sample, PAudioBuffer buffer, size_t& position, size_t& read) {
+	position = 0;
+	read = 0;
+
+	// DSF data is stored in blocks of left and right channel samples
+	// --> Seek to start of block that contains the given sample
+	if (canSeek() && !error && util::assigned(buffer)) {
+		PSong song = buffer->getSong();
+		if (util::assigned(song)) {
+			size_t size = song->getChunkSize();
+			if (size > 0) {
+				size_t offset = sample * getFrameSize();
+				offset = (offset / size) * size;
+				if (offset < stream.sampleSize) {
+					size_t r = reader.seek(dataOffset + offset);
+					if (r == (dataOffset + offset)) {
+						if (debug) std::cout << "TDSFDecoder::seek() Seek to sample " << sample << " at block offset " << offset << std::endl;
+						setRead(offset);
+						position = offset;
+						eof = false;
+						return true;
+					}
+				}
+			}
+		}
+	}
+	return false;
+}
+
 bool TDSFDecoder::update(PAudioBuffer buffer, size_t& read) {
 	read = 0;
 
@@ -217,7 +211,7 @@ bool TDSFDecoder::update(PAudioBuffer buffer, size_t& read) {
 			// File reader may throw exception...
 			try {
 
-				r = file.read((char*)chunk.data(), song->getChunkSize());
+				r = reader.read((char*)chunk.data(), song->getChunkSize());
 				if (r > 0) {
 
 					// Check if all audio data is read
@@ -267,8 +261,10 @@ bool TDSFDecoder::update(PAudioBuffer buffer, size_t& read) {
 				eof = true;
 
 			// Close open file as early as possible...
-			if (eof && file.isOpen())
+			if (eof && file.isOpen()) {
+				reader.close();
 				file.close();
+			}
 
 			if (debug && eof) {
 				 std::cout << "TDSFDecoder::update() EOF detected." << std::endl;
@@ -283,12 +279,14 @@ bool TDSFDecoder::update(PAudioBuffer buffer, size_t& read) {
 	// Create internal error
 	error = true;
 	setBuffer(nil);
+	reader.close();
 	file.close();
 	return false;
 }
 
 void TDSFDecoder::close() {
 	clear();
+	reader.close();
 	file.close();
 	if (debug) std::cout << "TDSFDecoder::close()" << std::endl;
 }
@@ -591,6 +589,7 @@ void TDFFStream::setDFFSoundDataEndian(TDFFSoundDataChunk& data) const {
 
 TDFFDecoder::TDFFDecoder() {
 	debug = true;
+	dataOffset = 0;
 }
 
 TDFFDecoder::~TDFFDecoder() {
@@ -647,11 +646,20 @@ bool TDFFDecoder::open(const std::string& fileName, const CStreamData& propertie
 					error = true;
 				}
 
+				// Position to first byte after sound data chunk header
+				// --> Sample data must start on channel interleaved frame boundary
+				if (!error) {
+					offset += sizeof(TDFFSoundDataChunk);
+					if (offset > file.getSize())
+						error = true;
+				}
+
 				// Seek to position and check resulting position
 				if (!error) {
 					r = file.seek(offset);
 					if (r != (ssize_t)offset)
 						error = true;
+					dataOffset = offset;
 				}
 
 				// Close file on error!
@@ -659,6 +667,10 @@ bool TDFFDecoder::open(const std::string& fileName, const CStreamData& propertie
 					opened = false;
 					file.close();
 				}
+
+				// Prefetch sample data ahead of decoder
+				if (opened)
+					reader.open(file, dataOffset);
 			}
 			if (opened)
 				setStream(properties);
@@ -673,6 +685,27 @@ bool TDFFDecoder::open(const std::string& fileName, const CStreamData& propertie
 }
 
 
+bool TDFFDecoder::seek(const size_t sample, PAudioBuffer buffer, size_t& position, size_t& read) {
+	position = 0;
+	read = 0;
+
+	// DFF data is stored as channel interleaved DSD bytes
+	if (canSeek() && !error) {
+		size_t offset = sample * getFrameSize();
+		if (offset < stream.sampleSize) {
+			ssize_t r = reader.seek(dataOffset + offset);
+			if (r == (ssize_t)(dataOffset + offset)) {
+				if (debug) std::cout << "TDFFDecoder::seek() Seek to sample " << sample << " at offset " << offset << std::endl;
+				setRead(offset);
+				position = offset;
+				eof = false;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
 bool TDFFDecoder::update(PAudioBuffer buffer, size_t& read) {
 	read = 0;
 
@@ -691,7 +724,7 @@ bool TDFFDecoder::update(PAudioBuffer buffer, size_t& read) {
 			// File reader may throw exception...
 			try {
 
-				r = file.read((char*)chunk.data(), song->getChunkSize());
+				r = reader.read((char*)chunk.data(), song->getChunkSize());
 				if (r > 0) {
 
 					// Check if all audio data is read
@@ -737,8 +770,10 @@ bool TDFFDecoder::update(PAudioBuffer buffer, size_t& read) {
 				eof = true;
 
 			// Close open file as early as possible...
-			if (eof && file.isOpen())
+			if (eof && file.isOpen()) {
+				reader.close();
 				file.close();
+			}
 
 			if (debug && eof) {
 				 std::cout << "TDFFDecoder::update() EOF detected." << std::endl;
@@ -753,12 +788,14 @@ bool TDFFDecoder::update(PAudioBuffer buffer, size_t& read) {
 	// Create internal error
 	error = true;
 	setBuffer(nil);
+	reader.close();
 	file.close();
 	return false;
 }
 
 void TDFFDecoder::close() {
 	clear();
+	reader.close();
 	file.close();
 	if (debug) std::cout << "TDFFDecoder::close()" << std::endl;
 }
@@ -20,7 +20,6 @@ namespace music {
 
 class TDSDStream {
 protected:
-	TSample reverse(TSample sample, int bitsPerSample);
 	size_t convertDSDtoDoP(const TSample* dsd, TSample* dop, size_t size, size_t offset, int bitsPerSample);
 
 public:
@@ -46,6 +45,7 @@ class TDSFDecoder : private TDSFStream, private TDSDStream, public TAudioStream
 private:
 	TSampleBuffer chunk;
 	util::TFile file;
+	size_t dataOffset;
 	bool debug;
 
 public:
@@ -54,7 +54,10 @@ public:
 	bool open(const PSong song);
 	bool open(const TDecoderParams& params);
 
+	bool canSeek() const { return opened && file.isOpen(); };
+
 	bool update(PAudioBuffer buffer, size_t& read);
+	bool seek(const size_t sample, PAudioBuffer buffer, size_t& position, size_t& read);
 
 	void close();
 
@@ -103,6 +106,7 @@ class TDFFDecoder : private TDFFStream, private TDSDStream, public TAudioStream
 private:
 	TSampleBuffer chunk;
 	util::TFile file;
+	size_t dataOffset;
 	bool debug;
 
 public:
@@ -111,7 +115,10 @@ public:
 	bool open(const PSong song);
 	bool open(const TDecoderParams& params);
 
+	bool canSeek() const { return opened && file.isOpen(); };
+
 	bool update(PAudioBuffer buffer, size_t& read);
+	bool seek(const size_t sample, PAudioBuffer buffer, size_t& position, size_t& read);
 
 	void close();
 
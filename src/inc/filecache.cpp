@@ -0,0 +1,200 @@
+/*
+ * filecache.cpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: Dirk Brinkmeier
+ */
+
+#include <iostream>
+#include "filecache.h"
+#include "templates.h"
+#include "hash.h"
+
+namespace util {
+
+TFileCache::TFileCache() {
+	limit = FILE_CACHE_DEFAULT_LIMIT;
+	debug = false;
+}
+
+TFileCache::~TFileCache() {
+	// Files still held by readers are freed by their last release
+	for (size_t i=0; i<FILE_CACHE_SHARD_COUNT; ++i) {
+		TFileCacheShard& shard = shards[i];
+		app::TLockGuard<app::TMutex> lock(shard.mtx);
+		while (!shard.files.empty()) {
+			remove(shard, shard.files.begin());
+		}
+	}
+}
+
+TFileCacheShard& TFileCache::getShard(const std::string& fileName) {
+	return shards[util::calcHash(fileName, false) % FILE_CACHE_SHARD_COUNT];
+}
+
+void TFileCache::destroy(PFileCacheItem item) {
+	PFile o = item->file;
+	if (util::assigned(o)) {
+		o->release();
+		util::freeAndNil(o);
+	}
+	delete item;
+}
+
+void TFileCache::remove(TFileCacheShard& shard, TFileCacheList::iterator it) {
+	// Remove entry from LRU list
+	PFileCacheItem item = *it;
+	if (shard.stats.size >= item->size)
+		shard.stats.size -= item->size;
+	else
+		shard.stats.size = 0;
+	if (shard.stats.files > 0)
+		--shard.stats.files;
+	shard.index.erase(item->name);
+	shard.files.erase(it);
+
+	// Free file object now or by last reader
+	item->evicted = true;
+	if (item->references <= 0)
+		destroy(item);
+}
+
+void TFileCache::evict(TFileCacheShard& shard, const size_t size) {
+	// Remove least recently used files until file of given size fits into shard
+	size_t budget = limit / FILE_CACHE_SHARD_COUNT;
+	while (!shard.files.empty() && (shard.stats.size + size) > budget) {
+		TFileCacheList::iterator it = util::pred(shard.files.end());
+		if (debug) std::cout << "TFileCache::evict() Evict file <" << (*it)->name << "> from memory cache." << std::endl;
+		remove(shard, it);
+		++shard.stats.evictions;
+	}
+}
+
+PFileCacheItem TFileCache::acquire(const std::string& fileName) {
+	// Returned file data stays valid until item is released by caller
+	if (fileName.empty())
+		return nil;
+
+	// Check if file in cached file map
+	TFileCacheShard& shard = getShard(fileName);
+	{
+		app::TLockGuard<app::TMutex> lock(shard.mtx);
+		TFileCacheIndex::const_iterator it = shard.index.find(fileName);
+		if (it != shard.index.end()) {
+			// Move file to front of LRU list
+			TFileCacheList::iterator entry = it->second;
+			shard.files.splice(shard.files.begin(), shard.files, entry);
+			PFileCacheItem item = *entry;
+			++item->references;
+			++shard.stats.hits;
+			if (debug) std::cout << "TFileCache::acquire() Using memory cached file <" << fileName << ">" << std::endl;
+			return item;
+		}
+		++shard.stats.misses;
+	}
+
+	// Load file without holding shard lock
+	PFile o = new TFile(fileName);
+	util::TObjectGuard<TFile> guard(&o);
+	if (!o->exists()) {
+		if (debug) std::cout << "TFileCache::acquire() File <" << fileName << "> does not exists." << std::endl;
+		return nil;
+	}
+	o->load();
+
+	// File may be added by other thread meanwhile
+	app::TLockGuard<app::TMutex> lock(shard.mtx);
+	PFileCacheItem item;
+	TFileCacheIndex::const_iterator it = shard.index.find(fileName);
+	if (it != shard.index.end()) {
+		item = *it->second;
+	} else {
+		item = new TFileCacheItem;
+		item->name = fileName;
+		item->file = o;
+		item->size = o->getSize();
+		item->references = 0;
+		item->evicted = false;
+		evict(shard, item->size);
+		shard.files.push_front(item);
+		shard.index[fileName] = shard.files.begin();
+		shard.stats.size += item->size;
+		++shard.stats.files;
+		o = nil;
+		if (debug) std::cout << "TFileCache::acquire() Add file <" << fileName << "> to memory cache." << std::endl;
+	}
+	++item->references;
+	return item;
+}
+
+void TFileCache::release(PFileCacheItem& item) {
+	if (util::assigned(item)) {
+		TFileCacheShard& shard = getShard(item->name);
+		app::TLockGuard<app::TMutex> lock(shard.mtx);
+		if (item->references > 0)
+			--item->references;
+		if (item->evicted && item->references <= 0)
+			destroy(item);
+		item = nil;
+	}
+}
+
+bool TFileCache::load(const std::string& fileName) {
+	if (!contains(fileName)) {
+		PFileCacheItem item = acquire(fileName);
+		if (!util::assigned(item))
+			return false;
+		release(item);
+	}
+	return true;
+}
+
+bool TFileCache::contains(const std::string& fileName) {
+	TFileCacheShard& shard = getShard(fileName);
+	app::TLockGuard<app::TMutex> lock(shard.mtx);
+	return shard.index.find(fileName) != shard.index.end();
+}
+
+void TFileCache::remove(const std::string& fileName) {
+	TFileCacheShard& shard = getShard(fileName);
+	app::TLockGuard<app::TMutex> lock(shard.mtx);
+	TFileCacheIndex::const_iterator it = shard.index.find(fileName);
+	if (it != shard.index.end()) {
+		remove(shard, it->second);
+	}
+}
+
+void TFileCache::clear() {
+	for (size_t i=0; i<FILE_CACHE_SHARD_COUNT; ++i) {
+		TFileCacheShard& shard = shards[i];
+		app::TLockGuard<app::TMutex> lock(shard.mtx);
+		while (!shard.files.empty()) {
+			remove(shard, shard.files.begin());
+		}
+	}
+}
+
+void TFileCache::setLimit(const size_t value) {
+	limit = value > 0 ? value : FILE_CACHE_DEFAULT_LIMIT;
+	for (size_t i=0; i<FILE_CACHE_SHARD_COUNT; ++i) {
+		TFileCacheShard& shard = shards[i];
+		app::TLockGuard<app::TMutex> lock(shard.mtx);
+		evict(shard, 0);
+	}
+}
+
+void TFileCache::getStatistics(TFileCacheStatistics& statistics) {
+	statistics.clear();
+	statistics.limit = limit;
+	for (size_t i=0; i<FILE_CACHE_SHARD_COUNT; ++i) {
+		TFileCacheShard& shard = shards[i];
+		app::TLockGuard<app::TMutex> lock(shard.mtx);
+		statistics.files += shard.stats.files;
+		statistics.size += shard.stats.size;
+		statistics.hits += shard.stats.hits;
+		statistics.misses += shard.stats.misses;
+		statistics.evictions += shard.stats.evictions;
+	}
+}
+
+} /* namespace util */
@@ -0,0 +1,116 @@
+/*
+ * filecache.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: Dirk Brinkmeier
+ */
+
+#ifndef FILECACHE_H_
+#define FILECACHE_H_
+
+#include <list>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "gcc.h"
+#include "classes.h"
+#include "nullptr.h"
+#include "semaphores.h"
+#include "fileutils.h"
+
+namespace util {
+
+STATIC_CONST size_t FILE_CACHE_SHARD_COUNT = 8;
+STATIC_CONST size_t FILE_CACHE_DEFAULT_LIMIT = 32 * 1024 * 1024;
+
+class TFileCache;
+
+typedef struct CFileCacheItem {
+	std::string name;
+	PFile file;
+	size_t size;
+	size_t references; // Readers holding the file data, guarded by shard lock
+	bool evicted;      // Removed from cache, freed by the last reader
+} TFileCacheItem;
+
+typedef struct CFileCacheStatistics {
+	size_t files;
+	size_t size;
+	size_t limit;
+	size_t hits;
+	size_t misses;
+	size_t evictions;
+
+	void clear() {
+		files = 0;
+		size = 0;
+		limit = 0;
+		hits = 0;
+		misses = 0;
+		evictions = 0;
+	}
+
+	CFileCacheStatistics() {
+		clear();
+	}
+} TFileCacheStatistics;
+
+#ifdef STL_HAS_TEMPLATE_ALIAS
+
+using PFileCache = TFileCache*;
+using PFileCacheItem = TFileCacheItem*;
+using TFileCacheList = std::list<PFileCacheItem>;
+using TFileCacheIndex = std::unordered_map<std::string, TFileCacheList::iterator>;
+
+#else
+
+typedef TFileCache* PFileCache;
+typedef TFileCacheItem* PFileCacheItem;
+typedef std::list<PFileCacheItem> TFileCacheList;
+typedef std::unordered_map<std::string, TFileCacheList::iterator> TFileCacheIndex;
+
+#endif
+
+typedef struct CFileCacheShard {
+	app::TMutex mtx;
+	TFileCacheList files;
+	TFileCacheIndex index;
+	TFileCacheStatistics stats;
+} TFileCacheShard;
+
+
+// Least recently used cache for small files (e.g. thumbnails)
+// --> Cache size is limited by the byte size of all cached files
+// --> File names are distributed over shards, each shard has its own lock
+// --> File data is reference counted, an evicted file is freed when the last reader releases it
+class TFileCache : public app::TObject {
+private:
+	TFileCacheShard shards[FILE_CACHE_SHARD_COUNT];
+	size_t limit;
+	bool debug;
+
+	TFileCacheShard& getShard(const std::string& fileName);
+	void evict(TFileCacheShard& shard, const size_t size);
+	void remove(TFileCacheShard& shard, TFileCacheList::iterator it);
+	void destroy(PFileCacheItem item);
+
+public:
+	void clear();
+	PFileCacheItem acquire(const std::string& fileName);
+	void release(PFileCacheItem& item);
+	bool load(const std::string& fileName);
+	void remove(const std::string& fileName);
+	bool contains(const std::string& fileName);
+
+	void setLimit(const size_t value);
+	size_t getLimit() const { return limit; };
+	void setDebug(const bool value) { debug = value; };
+	void getStatistics(TFileCacheStatistics& statistics);
+
+	TFileCache();
+	virtual ~TFileCache();
+};
+
+} /* namespace util */
+
+#endif /* FILECACHE_H_ */
@@ -497,6 +497,83 @@ bool TFileHandle::chown(uid_t owner, gid_t group) const {
 
 
 
+TMappedFile::TMappedFile() : TFileHandle() {
+	prime();
+}
+
+TMappedFile::~TMappedFile() {
+	unmap();
+}
+
+void TMappedFile::prime() {
+	mmem = nil;
+	size = 0;
+	locked = false;
+}
+
+bool TMappedFile::map(const std::string& fileName) {
+	unmap();
+
+	// Open file read only
+	if (0 > open(fileName, O_RDONLY | O_CLOEXEC))
+		return false;
+
+	// Get file size, empty files can't be mapped
+	struct stat status;
+	if (EXIT_SUCCESS != fstat(handle(), &status)) {
+		errval = errno;
+		unmap();
+		return false;
+	}
+	if (status.st_size <= 0) {
+		errval = ENODATA;
+		unmap();
+		return false;
+	}
+
+	// Map whole file as private read only memory region
+	void* p = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, handle(), 0);
+	if (MAP_FAILED == p) {
+		errval = errno;
+		unmap();
+		return false;
+	}
+
+	// File is read sequentially, start read ahead for whole file
+	madvise(p, (size_t)status.st_size, MADV_SEQUENTIAL);
+	madvise(p, (size_t)status.st_size, MADV_WILLNEED);
+	size = (size_t)status.st_size;
+	mmem = p;
+	return true;
+}
+
+bool TMappedFile::lock() {
+	// Keep mapped file pages resident in page cache
+	// --> Fails if RLIMIT_MEMLOCK is exceeded
+	if (locked)
+		return true;
+	if (util::assigned(mmem)) {
+		if (EXIT_SUCCESS == mlock(mmem, size)) {
+			locked = true;
+			return true;
+		}
+		errval = errno;
+	}
+	return false;
+}
+
+void TMappedFile::unmap() {
+	if (util::assigned(mmem)) {
+		if (locked)
+			munlock(mmem, size);
+		munmap(mmem, size);
+	}
+	prime();
+	close();
+}
+
+
+
 TBaseFile::TBaseFile() : TFileHandle() {
 	prime();
 	finalize();
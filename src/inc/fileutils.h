@@ -242,6 +242,28 @@ public:
 
 
 
+class TMappedFile : public TFileHandle {
+private:
+	void* mmem;
+	size_t size;
+	bool locked;
+	void prime();
+
+public:
+	bool empty() const { return !util::assigned(mmem); };
+	const void* data() const { return mmem; };
+	size_t getSize() const { return size; };
+	bool isLocked() const { return locked; };
+
+	bool map(const std::string& fileName);
+	bool lock();
+	void unmap();
+
+	TMappedFile();
+	virtual ~TMappedFile();
+};
+
+
 class TBaseFile : public TFileHandle {
 friend class TFile;
 
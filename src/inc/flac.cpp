@@ -41,6 +41,36 @@ FLAC__StreamDecoderReadStatus flacReaderCallback(const FLAC__StreamDecoder *deco
 	return FLAC__STREAM_DECODER_READ_STATUS_ABORT;
 }
 
+FLAC__StreamDecoderReadStatus flacFileReaderCallback(const FLAC__StreamDecoder *decoder, FLAC__byte buffer[], size_t *bytes, void *ctx) {
+	if (util::assigned(ctx))
+		return (static_cast<music::PFLACStream>(ctx))->fileReaderCallback(buffer, bytes);
+	return FLAC__STREAM_DECODER_READ_STATUS_ABORT;
+}
+
+FLAC__StreamDecoderSeekStatus flacFileSeekCallback(const FLAC__StreamDecoder *decoder, FLAC__uint64 offset, void *ctx) {
+	if (util::assigned(ctx))
+		return (static_cast<music::PFLACStream>(ctx))->fileSeekCallback(offset);
+	return FLAC__STREAM_DECODER_SEEK_STATUS_ERROR;
+}
+
+FLAC__StreamDecoderTellStatus flacFileTellCallback(const FLAC__StreamDecoder *decoder, FLAC__uint64 *offset, void *ctx) {
+	if (util::assigned(ctx))
+		return (static_cast<music::PFLACStream>(ctx))->fileTellCallback(offset);
+	return FLAC__STREAM_DECODER_TELL_STATUS_ERROR;
+}
+
+FLAC__StreamDecoderLengthStatus flacFileLengthCallback(const FLAC__StreamDecoder *decoder, FLAC__uint64 *length, void *ctx) {
+	if (util::assigned(ctx))
+		return (static_cast<music::PFLACStream>(ctx))->fileLengthCallback(length);
+	return FLAC__STREAM_DECODER_LENGTH_STATUS_ERROR;
+}
+
+FLAC__bool flacFileEofCallback(const FLAC__StreamDecoder *decoder, void *ctx) {
+	if (util::assigned(ctx))
+		return (static_cast<music::PFLACStream>(ctx))->fileEofCallback();
+	return true;
+}
+
 void flacMetadataCallback(const FLAC__StreamDecoder *decoder, const FLAC__StreamMetadata *metadata, void *ctx) {
 	if (util::assigned(ctx))
 		(static_cast<music::PFLACStream>(ctx))->metadataCallback(metadata);
@@ -221,28 +251,11 @@ FLAC__StreamDecoderWriteStatus TFLACDecoder::decoderCallback(const FLAC__Frame *
 		size_t bytes = stream.bytesPerSample * frame->header.blocksize * stream.channels;
 		addRead(bytes);
 
-		// Write decoded 32 Bit PCM samples in destination word size
+		// Write decoded planar 32 Bit PCM samples as interleaved samples in destination word size
+		// --> Abort on unsupported bit size or buffer overflow
 		music::TAudioBuffer& data = *getBuffer();
-		for(size_t i = 0; i < frame->header.blocksize; i++) {
-			switch (stream.bitsPerSample) {
-				case 16:
-					data.write16Bit((FLAC__int16)(buffer[0][i] & (uint16_t)-1)); // Left channel
-					data.write16Bit((FLAC__int16)(buffer[1][i] & (uint16_t)-1)); // Right channel
-					break;
-				case 24:
-					data.write24Bit(buffer[0][i]); // Left channel
-					data.write24Bit(buffer[1][i]); // Right channel
-					break;
-				case 32:
-					data.write32Bit(buffer[0][i]); // Left channel
-					data.write32Bit(buffer[1][i]); // Right channel
-					break;
-				default:
-					// Unsupported bit size
-					return FLAC__STREAM_DECODER_WRITE_STATUS_ABORT;
-					break;
-			}
-		}
+		if (!util::assigned(data.writePlanar(buffer, frame->header.channels, frame->header.blocksize, stream.bitsPerSample)))
+			return FLAC__STREAM_DECODER_WRITE_STATUS_ABORT;
 
 		return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
 	}
@@ -275,26 +288,10 @@ FLAC__StreamDecoderWriteStatus TFLACDecoder::writerCallback(const FLAC__Frame *f
 		// Write decoded 32 Bit PCM samples in destination word size
 		if (debug) std::cout << "TFLACDecoder::writerCallback() bytes = " << bytes << std::endl;
 		music::TAudioBuffer& data = *getBuffer();
-		for(size_t i = 0; i < frame->header.blocksize; i++) {
-			switch (frame->header.bits_per_sample) {
-				case 16:
-					data.write16Bit((FLAC__int16)(buffer[0][i] & (uint16_t)-1)); // Left channel
-					data.write16Bit((FLAC__int16)(buffer[1][i] & (uint16_t)-1)); // Right channel
-					break;
-				case 24:
-					data.write24Bit(buffer[0][i]); // Left channel
-					data.write24Bit(buffer[1][i]); // Right channel
-					break;
-				case 32:
-					data.write32Bit(buffer[0][i]); // Left channel
-					data.write32Bit(buffer[1][i]); // Right channel
-					break;
-				default:
-					// Unsupported bit size
-					if (debug) std::cout << "TFLACDecoder::writerCallback() Abort (1)" << std::endl;
-					return FLAC__STREAM_DECODER_WRITE_STATUS_ABORT;
-					break;
-			}
+		if (!util::assigned(data.writePlanar(buffer, frame->header.channels, frame->header.blocksize, frame->header.bits_per_sample))) {
+			// Unsupported bit size or buffer overflow
+			if (debug) std::cout << "TFLACDecoder::writerCallback() Abort (1)" << std::endl;
+			return FLAC__STREAM_DECODER_WRITE_STATUS_ABORT;
 		}
 
 		return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
@@ -333,6 +330,53 @@ FLAC__StreamDecoderReadStatus TFLACDecoder::readerCallback(FLAC__byte buffer[],
 	return FLAC__STREAM_DECODER_READ_STATUS_END_OF_STREAM;
 }
 
+FLAC__StreamDecoderReadStatus TFLACDecoder::fileReaderCallback(FLAC__byte buffer[], size_t *bytes) {
+	// Read file data from prefetching reader
+	if (*bytes > 0 && util::assigned(buffer)) {
+		try {
+			ssize_t r = reader.read(buffer, *bytes * sizeof(FLAC__byte));
+			if (r > 0) {
+				*bytes = r / sizeof(FLAC__byte);
+				return FLAC__STREAM_DECODER_READ_STATUS_CONTINUE;
+			}
+			*bytes = 0;
+			return FLAC__STREAM_DECODER_READ_STATUS_END_OF_STREAM;
+		} catch (const std::exception& e) {
+			if (debug) std::cout << "TFLACDecoder::fileReaderCallback() Exception: \"" << e.what() << "\"" << std::endl;
+		}
+	}
+	*bytes = 0;
+	return FLAC__STREAM_DECODER_READ_STATUS_ABORT;
+}
+
+FLAC__StreamDecoderSeekStatus TFLACDecoder::fileSeekCallback(FLAC__uint64 offset) {
+	if (reader.isOpen() && offset <= (FLAC__uint64)reader.getSize()) {
+		if (reader.seek((size_t)offset) == (ssize_t)offset)
+			return FLAC__STREAM_DECODER_SEEK_STATUS_OK;
+	}
+	return FLAC__STREAM_DECODER_SEEK_STATUS_ERROR;
+}
+
+FLAC__StreamDecoderTellStatus TFLACDecoder::fileTellCallback(FLAC__uint64 *offset) {
+	if (reader.isOpen()) {
+		*offset = (FLAC__uint64)reader.getPosition();
+		return FLAC__STREAM_DECODER_TELL_STATUS_OK;
+	}
+	return FLAC__STREAM_DECODER_TELL_STATUS_ERROR;
+}
+
+FLAC__StreamDecoderLengthStatus TFLACDecoder::fileLengthCallback(FLAC__uint64 *length) {
+	if (reader.isOpen()) {
+		*length = (FLAC__uint64)reader.getSize();
+		return FLAC__STREAM_DECODER_LENGTH_STATUS_OK;
+	}
+	return FLAC__STREAM_DECODER_LENGTH_STATUS_ERROR;
+}
+
+FLAC__bool TFLACDecoder::fileEofCallback() {
+	return !reader.isOpen() || reader.isEOF();
+}
+
 void TFLACDecoder::metadataCallback(const FLAC__StreamMetadata *block) {
 	
 	// Valid metadata block?
@@ -530,10 +574,32 @@ bool TFLACDecoder::open(const std::string& fileName, const CStreamData& properti
 		if (properties.isValid()) {
 			decoderNeeded();
 			if (debug) std::cout << "TFlacDecoder::open() File \"" << fileName << "\"" << std::endl;
-			initval = FLAC__stream_decoder_init_file(decoder, fileName.c_str(), flacDecoderCallback, NULL, flacErrorCallback, (void*)this);
+
+			// Decoder reads file by prefetching reader
+			// --> Seek, tell, length and EOF callbacks are needed for seeking in file
+			file.assign(fileName);
+			file.open(O_RDONLY);
+			if (file.isOpen() && reader.open(file, 0)) {
+				initval = FLAC__stream_decoder_init_stream( decoder,                // FLAC__StreamDecoder *decoder
+															flacFileReaderCallback, // FLAC__StreamDecoderReadCallback read_callback
+															flacFileSeekCallback,   // FLAC__StreamDecoderSeekCallback seek_callback
+															flacFileTellCallback,   // FLAC__StreamDecoderTellCallback tell_callback
+															flacFileLengthCallback, // FLAC__StreamDecoderLengthCallback length_callback
+															flacFileEofCallback,    // FLAC__StreamDecoderEofCallback eof_callback
+															flacDecoderCallback,    // FLAC__StreamDecoderWriteCallback write_callback
+															NULL,                   // FLAC__StreamDecoderMetadataCallback metadata_callback
+															flacErrorCallback,      // FLAC__StreamDecoderErrorCallback error_callback
+															(void*)this );          // void *client_data
+			} else {
+				initval = FLAC__STREAM_DECODER_INIT_STATUS_ERROR_OPENING_FILE;
+			}
 			opened = initval == FLAC__STREAM_DECODER_INIT_STATUS_OK;
-			if (opened)
+			if (opened) {
 				setStream(properties);
+			} else {
+				reader.close();
+				file.close();
+			}
 			if (debug) {
 				stream.debugOutput();
 				std::cout << "TFlacDecoder::open() Decoder opened : " << opened << std::endl;
@@ -570,6 +636,31 @@ bool TFLACDecoder::update(PAudioBuffer buffer, size_t& read) {
 	return false;
 }
 
+bool TFLACDecoder::seek(const size_t sample, PAudioBuffer buffer, size_t& position, size_t& read) {
+	position = 0;
+	read = 0;
+
+	// Seek in file decoder only, stream decoder has no seek callbacks
+	// --> Decoder writes the frame containing the sample to the given buffer, starting at the sample
+	if (canSeek() && !error && util::assigned(buffer) && sample < stream.sampleCount) {
+		setRead(0);
+		setBuffer(buffer);
+		FLAC__bool r = FLAC__stream_decoder_seek_absolute(decoder, sample);
+		if (r > 0) {
+			updated = true;
+			eof = FLAC__STREAM_DECODER_END_OF_STREAM == statuscode();
+			read = getRead();
+			position = sample * getFrameSize();
+			if (debug) std::cout << "TFlacDecoder::seek() Seek to sample " << sample << " at offset " << position << " (" << read << " bytes decoded)" << std::endl;
+			return true;
+		}
+		errval = FLAC__STREAM_DECODER_ERROR_STATUS_LOST_SYNC;
+		error = true;
+		setBuffer(nil);
+	}
+	return false;
+}
+
 bool TFLACDecoder::update(const TSample * const data, const size_t size, PAudioBuffer buffer, size_t& written, size_t& consumed) {
 	written = 0;
 	consumed = 0;
@@ -629,6 +720,8 @@ void TFLACDecoder::close() {
 		TFLACStream::close();
 		FLAC__stream_decoder_finish(decoder);
 	}
+	reader.close();
+	file.close();
 	clear();
 	if (debug) std::cout << "TFlacDecoder::close()" << std::endl;
 }
@@ -98,6 +98,11 @@ public:
 	virtual FLAC__StreamDecoderWriteStatus decoderCallback(const FLAC__Frame * frame, const FLAC__int32 * const buffer[]) = 0;
 	virtual FLAC__StreamDecoderWriteStatus writerCallback(const FLAC__Frame *frame, const FLAC__int32 * const buffer[]) = 0;
 	virtual FLAC__StreamDecoderReadStatus readerCallback(FLAC__byte buffer[], size_t *bytes) = 0;
+	virtual FLAC__StreamDecoderReadStatus fileReaderCallback(FLAC__byte buffer[], size_t *bytes) = 0;
+	virtual FLAC__StreamDecoderSeekStatus fileSeekCallback(FLAC__uint64 offset) = 0;
+	virtual FLAC__StreamDecoderTellStatus fileTellCallback(FLAC__uint64 *offset) = 0;
+	virtual FLAC__StreamDecoderLengthStatus fileLengthCallback(FLAC__uint64 *length) = 0;
+	virtual FLAC__bool fileEofCallback() = 0;
 	virtual void metadataCallback(const FLAC__StreamMetadata *block) = 0;
 	virtual void errorCallback(FLAC__StreamDecoderErrorStatus status) = 0;
 
@@ -126,6 +131,7 @@ private:
 	mutable FLAC__StreamDecoderState stateval;
 	TSample const * inbuf;
 	size_t insize;
+	util::TFile file;
 	bool updated;
 	bool debug;
 
@@ -134,6 +140,11 @@ private:
 	FLAC__StreamDecoderWriteStatus decoderCallback(const FLAC__Frame *frame, const FLAC__int32 * const buffer[]);
 	FLAC__StreamDecoderWriteStatus writerCallback(const FLAC__Frame *frame, const FLAC__int32 * const buffer[]);
 	FLAC__StreamDecoderReadStatus readerCallback(FLAC__byte buffer[], size_t *bytes);
+	FLAC__StreamDecoderReadStatus fileReaderCallback(FLAC__byte buffer[], size_t *bytes);
+	FLAC__StreamDecoderSeekStatus fileSeekCallback(FLAC__uint64 offset);
+	FLAC__StreamDecoderTellStatus fileTellCallback(FLAC__uint64 *offset);
+	FLAC__StreamDecoderLengthStatus fileLengthCallback(FLAC__uint64 *length);
+	FLAC__bool fileEofCallback();
 	void metadataCallback(const FLAC__StreamMetadata *metadata);
 	void errorCallback(FLAC__StreamDecoderErrorStatus status);
 	void decoderNeeded();
@@ -158,8 +169,11 @@ public:
 	bool open(const TDecoderParams& params);
 	void close();
 
+	bool canSeek() const { return opened && !isStreaming(); };
+
 	bool update(PAudioBuffer buffer, size_t& read);
 	bool update(const TSample * const data, const size_t size, PAudioBuffer buffer, size_t& written, size_t& consumed);
+	bool seek(const size_t sample, PAudioBuffer buffer, size_t& position, size_t& read);
 
 	bool getConfiguredValues(TDecoderParams& params);
 	bool getRunningValues(TDecoderParams& params);
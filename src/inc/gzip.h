@@ -64,6 +64,9 @@ public:
 		return action(EZ_DECOMPRESS, src, dst, size);
 	}
 
+	void setLevel(const int level) { this->level = level; };
+	int getLevel() const { return level; };
+
 	TZLib(int level = Z_BEST_COMPRESSION);
 	virtual ~TZLib();
 };
@@ -0,0 +1,113 @@
+/*
+ * histogram.cpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: Dirk Brinkmeier
+ */
+
+#include "histogram.h"
+#include "stringtemplates.h"
+
+namespace util {
+
+THistogram::THistogram() {
+	reset();
+}
+
+THistogram::~THistogram() {
+}
+
+size_t THistogram::getIndex(const uint64_t value) {
+	if (value < HISTOGRAM_SUB_BUCKETS)
+		return (size_t)value;
+	size_t msb = 63 - __builtin_clzll(value);
+	if (msb >= HISTOGRAM_VALUE_BITS)
+		return HISTOGRAM_BUCKETS - 1;
+	size_t shift = msb - HISTOGRAM_SUB_BUCKET_BITS;
+	size_t sub = (size_t)(value >> shift) & (HISTOGRAM_SUB_BUCKETS - 1);
+	return (shift + 1) * HISTOGRAM_SUB_BUCKETS + sub;
+}
+
+uint64_t THistogram::getValue(const size_t index) {
+	// Highest value counted in bucket
+	if (index < HISTOGRAM_SUB_BUCKETS)
+		return index;
+	size_t shift = index / HISTOGRAM_SUB_BUCKETS - 1;
+	uint64_t sub = index % HISTOGRAM_SUB_BUCKETS;
+	return ((HISTOGRAM_SUB_BUCKETS + sub + 1) << shift) - 1;
+}
+
+void THistogram::add(const uint64_t value) {
+	__sync_fetch_and_add(&buckets[getIndex(value)], 1);
+	__sync_fetch_and_add(&count, 1);
+	__sync_fetch_and_add(&sum, value);
+
+	// Compare and swap loop for concurrent writers
+	uint64_t current = min;
+	while (value < current) {
+		uint64_t previous = __sync_val_compare_and_swap(&min, current, value);
+		if (previous == current)
+			break;
+		current = previous;
+	}
+	current = max;
+	while (value > current) {
+		uint64_t previous = __sync_val_compare_and_swap(&max, current, value);
+		if (previous == current)
+			break;
+		current = previous;
+	}
+}
+
+void THistogram::reset() {
+	for (size_t i=0; i<HISTOGRAM_BUCKETS; ++i)
+		__sync_lock_test_and_set(&buckets[i], 0);
+	__sync_lock_test_and_set(&count, 0);
+	__sync_lock_test_and_set(&sum, 0);
+	__sync_lock_test_and_set(&min, (uint64_t)-1);
+	__sync_lock_test_and_set(&max, 0);
+}
+
+void THistogram::getValues(THistogramValues& values) {
+	values.clear();
+
+	// Take snapshot of counters, may be updated meanwhile
+	uint64_t snapshot[HISTOGRAM_BUCKETS];
+	uint64_t total = 0;
+	for (size_t i=0; i<HISTOGRAM_BUCKETS; ++i) {
+		snapshot[i] = util::atomicGet(buckets[i]);
+		total += snapshot[i];
+	}
+	if (total <= 0)
+		return;
+
+	values.count = total;
+	values.min = util::atomicGet(min);
+	values.max = util::atomicGet(max);
+	values.mean = util::atomicGet(sum) / total;
+
+	// Find percentiles by ranks
+	uint64_t* results[] = { &values.p50, &values.p90, &values.p99, &values.p999 };
+	uint64_t ranks[] = { (total * 500 + 999) / 1000, (total * 900 + 999) / 1000, (total * 990 + 999) / 1000, (total * 999 + 999) / 1000 };
+	size_t k = 0;
+	uint64_t n = 0;
+	for (size_t i=0; i<HISTOGRAM_BUCKETS && k<4; ++i) {
+		n += snapshot[i];
+		while (k < 4 && n >= ranks[k]) {
+			uint64_t value = getValue(i);
+			*results[k++] = value < values.max ? value : values.max;
+		}
+	}
+}
+
+std::string THistogram::asString(const std::string& unit) {
+	THistogramValues values;
+	getValues(values);
+	if (values.count <= 0)
+		return "-";
+	std::string u = unit.empty() ? "" : " " + unit;
+	return util::csnprintf("p50 %, p99 %, p99.9 %, max % (% samples)",
+			std::to_string(values.p50) + u, std::to_string(values.p99) + u, std::to_string(values.p999) + u, std::to_string(values.max) + u, values.count);
+}
+
+} /* namespace util */
@@ -0,0 +1,76 @@
+/*
+ * histogram.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: Dirk Brinkmeier
+ */
+
+#ifndef HISTOGRAM_H_
+#define HISTOGRAM_H_
+
+#include <string>
+#include "gcc.h"
+#include "atomic.h"
+
+namespace util {
+
+STATIC_CONST size_t HISTOGRAM_SUB_BUCKET_BITS = 3; // 8 sub buckets per power of two, 12.5% resolution
+STATIC_CONST size_t HISTOGRAM_SUB_BUCKETS = 1 << HISTOGRAM_SUB_BUCKET_BITS;
+STATIC_CONST size_t HISTOGRAM_VALUE_BITS = 32; // Larger values are counted in last bucket
+STATIC_CONST size_t HISTOGRAM_BUCKETS = (HISTOGRAM_VALUE_BITS - HISTOGRAM_SUB_BUCKET_BITS + 1) * HISTOGRAM_SUB_BUCKETS;
+
+typedef struct CHistogramValues {
+	uint64_t count;
+	uint64_t min;
+	uint64_t max;
+	uint64_t mean;
+	uint64_t p50;
+	uint64_t p90;
+	uint64_t p99;
+	uint64_t p999;
+
+	void clear() {
+		count = 0;
+		min = 0;
+		max = 0;
+		mean = 0;
+		p50 = 0;
+		p90 = 0;
+		p99 = 0;
+		p999 = 0;
+	}
+
+	CHistogramValues() {
+		clear();
+	}
+} THistogramValues;
+
+
+// Log-linear histogram in the manner of HdrHistogram
+// --> Values below 8 are counted exactly, larger values in 8 buckets per power of two
+// --> Adding values is lock free and does not allocate memory, e.g. for realtime threads
+// --> Percentiles are calculated by the reader from a snapshot of the bucket counters
+class THistogram {
+private:
+	atomic_uint64 buckets[HISTOGRAM_BUCKETS];
+	atomic_uint64 count;
+	atomic_uint64 sum;
+	atomic_uint64 min;
+	atomic_uint64 max;
+
+	static size_t getIndex(const uint64_t value);
+	static uint64_t getValue(const size_t index);
+
+public:
+	void add(const uint64_t value);
+	void reset();
+	void getValues(THistogramValues& values);
+	std::string asString(const std::string& unit = "");
+
+	THistogram();
+	virtual ~THistogram();
+};
+
+} /* namespace util */
+
+#endif /* HISTOGRAM_H_ */
@@ -0,0 +1,238 @@
+/*
+ * jitterbuffer.cpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: Dirk Brinkmeier
+ */
+
+#include <time.h>
+#include <string.h>
+#include "jitterbuffer.h"
+
+namespace inet {
+
+// Monotonic time in milliseconds for stall detection
+static util::TTimePart getMilliSeconds() {
+	struct timespec ts;
+	if (EXIT_SUCCESS == clock_gettime(CLOCK_MONOTONIC, &ts))
+		return (util::TTimePart)ts.tv_sec * 1000 + (util::TTimePart)ts.tv_nsec / 1000000;
+	return 0;
+}
+
+
+TJitterBuffer::TJitterBuffer() {
+	ring.resize(JITTER_BUFFER_SIZE);
+	mask = JITTER_BUFFER_SIZE - 1;
+	byteRate = JITTER_DEFAULT_BYTE_RATE;
+	prefillTime = JITTER_DEFAULT_PREFILL_TIME;
+	bufferTime = JITTER_DEFAULT_BUFFER_TIME;
+	low = 0;
+	high = 0;
+	reset();
+}
+
+TJitterBuffer::~TJitterBuffer() {
+}
+
+void TJitterBuffer::configure(const util::TTimePart prefillTime, const util::TTimePart bufferTime) {
+	this->prefillTime = prefillTime > 0 ? prefillTime : JITTER_DEFAULT_PREFILL_TIME;
+	this->bufferTime = bufferTime > this->prefillTime ? bufferTime : 2 * this->prefillTime;
+	updateWatermarks(getPrefillSize());
+}
+
+void TJitterBuffer::setByteRate(const size_t value) {
+	// Watermarks are given as time, convert to bytes by stream bitrate
+	if (value > 0 && value != byteRate) {
+		byteRate = value;
+		updateWatermarks(getPrefillSize());
+	}
+}
+
+size_t TJitterBuffer::getPrefillSize() const {
+	size_t size = byteRate * prefillTime / 1000;
+	if (size < JITTER_MIN_PREFILL)
+		size = JITTER_MIN_PREFILL;
+	if (size > ring.size() / 2)
+		size = ring.size() / 2;
+	return size;
+}
+
+void TJitterBuffer::updateWatermarks(const size_t prefill) {
+	size_t limit = byteRate * bufferTime / 1000;
+	if (limit < 2 * prefill)
+		limit = 2 * prefill;
+	if (limit > ring.size())
+		limit = ring.size();
+	__sync_lock_test_and_set(&low, prefill);
+	__sync_lock_test_and_set(&high, limit);
+}
+
+void TJitterBuffer::reset() {
+	// Producer and consumer must not access ring while reset
+	__sync_lock_test_and_set(&head, 0);
+	__sync_lock_test_and_set(&tail, 0);
+	__sync_lock_test_and_set(&stalls, 0);
+	__sync_lock_test_and_set(&overruns, 0);
+	__sync_lock_test_and_set(&minLevel, (uint64_t)-1);
+	__sync_lock_test_and_set(&maxLevel, 0);
+	util::atomicReset(closed);
+	util::atomicReset(waiting);
+	prefilling = true;
+	stable = getMilliSeconds();
+	empty = 0;
+	updateWatermarks(getPrefillSize());
+}
+
+void TJitterBuffer::close() {
+	util::atomicSet(closed);
+	notify();
+}
+
+bool TJitterBuffer::isClosed() {
+	return util::atomicGet(closed);
+}
+
+size_t TJitterBuffer::getLevel() {
+	return (size_t)(util::atomicGet(head) - util::atomicGet(tail));
+}
+
+void TJitterBuffer::notify() {
+	app::TLockGuard<app::TCondition> lock(event);
+	event.broadcast();
+}
+
+bool TJitterBuffer::sleep() {
+	// Wait is limited, a missed notification only delays the caller
+	app::TLockGuard<app::TCondition> lock(event);
+	util::atomicSet(waiting);
+	if (!util::atomicGet(closed))
+		event.timedWait(JITTER_WAIT_DELAY);
+	util::atomicReset(waiting);
+	return !util::atomicGet(closed);
+}
+
+size_t TJitterBuffer::write(const void *const data, const size_t size) {
+	const uint8_t* p = (const uint8_t*)data;
+	size_t capacity = ring.size();
+	size_t written = 0;
+	bool throttled = false;
+	while (written < size && !util::atomicGet(closed)) {
+
+		// Throttle producer above high watermark
+		size_t level = getLevel();
+		if (level >= (size_t)util::atomicGet(high) || level >= capacity) {
+			if (!throttled) {
+				util::atomicInc(overruns);
+				throttled = true;
+			}
+			if (!sleep())
+				break;
+			continue;
+		}
+
+		// Copy data into ring, may wrap around
+		size_t n = std::min(capacity - level, size - written);
+		size_t pos = (size_t)util::atomicGet(head) & mask;
+		size_t first = std::min(n, capacity - pos);
+		memcpy(&ring[pos], p, first);
+		if (n > first)
+			memcpy(&ring[0], p + first, n - first);
+		__sync_synchronize();
+		__sync_fetch_and_add(&head, n);
+		p += n;
+		written += n;
+
+		level += n;
+		if (level > util::atomicGet(maxLevel))
+			__sync_lock_test_and_set(&maxLevel, level);
+		if (util::atomicGet(waiting))
+			notify();
+	}
+	return written;
+}
+
+size_t TJitterBuffer::read(void *const data, const size_t size) {
+	uint8_t* p = (uint8_t*)data;
+	size_t capacity = ring.size();
+	while (!util::atomicGet(closed)) {
+		size_t level = getLevel();
+
+		// Wait for low watermark after start or stall
+		if (prefilling) {
+			if (level >= (size_t)util::atomicGet(low) || level >= capacity) {
+				prefilling = false;
+				stable = getMilliSeconds();
+				empty = 0;
+			} else {
+				if (!sleep())
+					break;
+				continue;
+			}
+		}
+
+		// Detect stall when no data received for some time
+		if (level <= 0) {
+			util::TTimePart now = getMilliSeconds();
+			if (empty <= 0) {
+				empty = now;
+			} else if ((now - empty) > JITTER_STALL_TIME) {
+				// Raise low watermark for next prefill
+				size_t prefill = std::min((size_t)util::atomicGet(low) * 2, capacity / 2);
+				updateWatermarks(prefill);
+				util::atomicInc(stalls);
+				prefilling = true;
+				stable = now;
+				continue;
+			}
+			if (!sleep())
+				break;
+			continue;
+		}
+		empty = 0;
+
+		// Copy data from ring, may wrap around
+		size_t n = std::min(level, size);
+		size_t pos = (size_t)util::atomicGet(tail) & mask;
+		size_t first = std::min(n, capacity - pos);
+		__sync_synchronize();
+		memcpy(p, &ring[pos], first);
+		if (n > first)
+			memcpy(p + first, &ring[0], n - first);
+		__sync_synchronize();
+		__sync_fetch_and_add(&tail, n);
+
+		if (level < util::atomicGet(minLevel))
+			__sync_lock_test_and_set(&minLevel, level);
+		if (util::atomicGet(waiting))
+			notify();
+
+		// Lower low watermark again after stable period
+		util::TTimePart now = getMilliSeconds();
+		if ((now - stable) > JITTER_STABLE_PERIOD) {
+			stable = now;
+			size_t prefill = getPrefillSize();
+			size_t current = util::atomicGet(low);
+			if (current > prefill)
+				updateWatermarks(std::max(prefill, current * 3 / 4));
+		}
+
+		return n;
+	}
+	return 0;
+}
+
+void TJitterBuffer::getStatistics(TJitterStatistics& statistics) {
+	statistics.clear();
+	statistics.capacity = ring.size();
+	statistics.level = getLevel();
+	statistics.minLevel = util::atomicGet(minLevel) == (uint64_t)-1 ? 0 : util::atomicGet(minLevel);
+	statistics.maxLevel = util::atomicGet(maxLevel);
+	statistics.lowWatermark = util::atomicGet(low);
+	statistics.highWatermark = util::atomicGet(high);
+	statistics.stalls = util::atomicGet(stalls);
+	statistics.overruns = util::atomicGet(overruns);
+	statistics.received = util::atomicGet(head);
+	statistics.consumed = util::atomicGet(tail);
+}
+
+} /* namespace inet */
@@ -0,0 +1,113 @@
+/*
+ * jitterbuffer.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: Dirk Brinkmeier
+ */
+
+#ifndef JITTERBUFFER_H_
+#define JITTERBUFFER_H_
+
+#include <vector>
+#include "gcc.h"
+#include "atomic.h"
+#include "datetime.h"
+#include "semaphores.h"
+
+namespace inet {
+
+STATIC_CONST size_t JITTER_BUFFER_SIZE = 1024 * 1024; // Must be power of two
+STATIC_CONST size_t JITTER_DEFAULT_BYTE_RATE = 320 * 1000 / 8; // Assume 320 kBit/sec until stream bitrate is known
+STATIC_CONST size_t JITTER_MIN_PREFILL = 4 * 1024;
+STATIC_CONST util::TTimePart JITTER_DEFAULT_PREFILL_TIME = 1000; // Milliseconds
+STATIC_CONST util::TTimePart JITTER_DEFAULT_BUFFER_TIME = 8000; // Milliseconds
+STATIC_CONST util::TTimePart JITTER_STALL_TIME = 500; // Milliseconds without data until consumer rebuffers
+STATIC_CONST util::TTimePart JITTER_STABLE_PERIOD = 60000; // Milliseconds without stall before low watermark is lowered again
+STATIC_CONST util::TTimePart JITTER_WAIT_DELAY = 50; // Milliseconds
+
+typedef struct CJitterStatistics {
+	size_t level;
+	size_t minLevel;
+	size_t maxLevel;
+	size_t capacity;
+	size_t lowWatermark;
+	size_t highWatermark;
+	size_t stalls;    // Consumer ran empty and waits for prefill
+	size_t overruns;  // Producer waits for free space above high watermark
+	size_t received;
+	size_t consumed;
+
+	void clear() {
+		level = 0;
+		minLevel = 0;
+		maxLevel = 0;
+		capacity = 0;
+		lowWatermark = 0;
+		highWatermark = 0;
+		stalls = 0;
+		overruns = 0;
+		received = 0;
+		consumed = 0;
+	}
+
+	CJitterStatistics() {
+		clear();
+	}
+} TJitterStatistics;
+
+
+// Single producer single consumer byte ring between network receiver and stream decoder
+// --> Data path is lock free, the condition is only used to sleep on empty or full ring
+// --> Consumer waits until low watermark (prefill) is reached after start and after every stall,
+//     a stall is an empty ring for more than JITTER_STALL_TIME, short gaps are normal since decoding is faster than realtime
+// --> Low watermark is raised on every stall and lowered again after a stable period,
+//     producer is throttled when the ring is filled above the high watermark
+class TJitterBuffer {
+private:
+	std::vector<uint8_t> ring;
+	size_t mask;
+	atomic_uint64 head;     // Bytes written in total by producer
+	atomic_uint64 tail;     // Bytes read in total by consumer
+	atomic_uint64 low;
+	atomic_uint64 high;
+	atomic_uint64 stalls;
+	atomic_uint64 overruns;
+	atomic_uint64 minLevel;
+	atomic_uint64 maxLevel;
+	atomic_bool closed;
+	atomic_bool waiting;
+	bool prefilling;
+	size_t byteRate;
+	util::TTimePart prefillTime;
+	util::TTimePart bufferTime;
+	util::TTimePart stable;
+	util::TTimePart empty;
+	app::TCondition event;
+
+	size_t getLevel();
+	size_t getPrefillSize() const;
+	void updateWatermarks(const size_t prefill);
+	void notify();
+	bool sleep();
+
+public:
+	void configure(const util::TTimePart prefillTime, const util::TTimePart bufferTime);
+	void setByteRate(const size_t value);
+
+	void reset();
+	void close();
+	bool isClosed();
+
+	size_t write(const void *const data, const size_t size);
+	size_t read(void *const data, const size_t size);
+
+	size_t level() { return getLevel(); };
+	void getStatistics(TJitterStatistics& statistics);
+
+	TJitterBuffer();
+	virtual ~TJitterBuffer();
+};
+
+} /* namespace inet */
+
+#endif /* JITTERBUFFER_H_ */
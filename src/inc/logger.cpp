@@ -20,6 +20,7 @@
 #include "exception.h"
 #include "fileutils.h"
 #include "htmlutils.h"
+#include "threadpool.h"
 #include "../config.h"
 
 
@@ -66,6 +67,7 @@ void TLogFile::init() {
 	thread.setExecHandler(&app::TLogFile::unlinkThreadMethod, this);
 	thread.setName("Unlink-" + name);
 	thread.setErrorLog(*this);
+	thread.setPriority(app::ETP_LOW);
 
 	logFolder = util::filePath(logFile);
 	fileName = util::fileExtName(logFile);
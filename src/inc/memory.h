@@ -11,6 +11,9 @@
 #include <unistd.h>
 #include <sys/mman.h>
 #include <sys/stat.h>	/* For mode constants */
+#include <sys/syscall.h>
+#include <sys/resource.h>
+#include <linux/mempolicy.h>
 #include <fcntl.h>		/* For O_* constants */
 #include <string>
 #include <memory>
@@ -336,6 +339,31 @@ protected:
 };
 
 
+enum EMappedPages {
+	EMP_DEFAULT,
+	EMP_TRANSPARENT,
+	EMP_HUGETLB
+};
+
+typedef struct CMappedOptions {
+	bool hugepages;      // Use huge pages, reserved pages first, then transparent huge pages
+	bool populate;       // Prefault pages on creation
+	size_t hugePageSize; // System default huge page size
+	int node;            // Bind memory to NUMA node, -1 = no binding
+
+	void clear() {
+		hugepages = false;
+		populate = false;
+		hugePageSize = 0;
+		node = -1;
+	}
+
+	CMappedOptions() {
+		clear();
+	}
+} TMappedOptions;
+
+
 template<typename T>
 class TMappedMemory : public app::TObject, private TMemoryLock {
 private:
@@ -347,12 +375,48 @@ private:
 	bool locked;
 	int errval;
 	std::string errmsg;
+	TMappedOptions options;
+	EMappedPages pages;
+	size_t pagesize;
+	size_t faults;
+	int node;
 
 	void clear() {
 		mmem = nil;
 		errval = EXIT_SUCCESS;
 		size = 0;
 		locked = false;
+		pages = EMP_DEFAULT;
+		pagesize = 0;
+		faults = 0;
+		node = -1;
+	}
+
+	static size_t getMinorFaults() {
+		struct rusage usage;
+		if (EXIT_SUCCESS == getrusage(RUSAGE_THREAD, &usage))
+			return (size_t)usage.ru_minflt;
+		return 0;
+	}
+
+	bool bind(void* addr, const size_t size, const int node) {
+		// Prefer memory of given node, but allow allocation on other nodes if node is exhausted
+#ifdef SYS_mbind
+		unsigned long mask[4] = { 0, 0, 0, 0 };
+		size_t bits = 8 * sizeof(unsigned long);
+		if (node >= 0 && (size_t)node < (bits * 4)) {
+			mask[node / bits] = 1UL << (node % bits);
+			return EXIT_SUCCESS == syscall(SYS_mbind, addr, size, MPOL_PREFERRED, mask, bits * 4, 0);
+		}
+#endif
+		return false;
+	}
+
+	void prefault(void* addr, const size_t size, const size_t step) {
+		// Touch every page to get physical memory assigned before first use
+		volatile char* p = (char*)addr;
+		for (size_t i=0; i<size; i+=step)
+			p[i] = 0;
 	}
 
 public:
@@ -361,6 +425,12 @@ public:
 	bool empty() const { return !util::assigned(mmem); }
 	buffer_t* data() const { return mmem; }
 
+	void configure(const TMappedOptions& options) { this->options = options; }
+	EMappedPages getPages() const { return pages; }
+	size_t getPageSize() const { return pagesize; }
+	size_t getFaults() const { return faults; }
+	int getNode() const { return node; }
+
 	int create(buffer_t** addr, const size_t size) {
 		int r;
 		*addr = nil;
@@ -382,21 +452,60 @@ public:
 			errval = EINVAL;
 			return EXIT_FAILURE;
 		}
+		// Align region to huge page size to be usable for huge pages
+		bool huge = options.hugepages && options.hugePageSize > (size_t)alignment;
+		if (huge)
+			alignment = (ssize_t)options.hugePageSize;
 		size_t bytes = size * sizeof(buffer_t);
 		size_t carry = bytes % (size_t)alignment;
 		aligned = carry > 0 ? bytes + (size_t)alignment - carry : bytes;
 
+		// Pages can be populated by mmap() only if not bound to NUMA node afterwards
+		bool binding = options.node >= 0;
+		bool populated = options.populate && !binding;
+		int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+		size_t minflt = getMinorFaults();
+
 		// Map memory region
-		void* p = nil;
-		p = mmap(NULL, aligned, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		// --> Try reserved huge pages first (see /proc/sys/vm/nr_hugepages)
+		void* p = MAP_FAILED;
+		pages = EMP_DEFAULT;
+		pagesize = (size_t)sysconf(_SC_PAGE_SIZE);
+		if (huge) {
+			p = mmap(NULL, aligned, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB | (populated ? MAP_POPULATE : 0), -1, 0);
+			if (MAP_FAILED != p) {
+				pages = EMP_HUGETLB;
+				pagesize = options.hugePageSize;
+			}
+		}
 		if (MAP_FAILED == p) {
-			errmsg = "TMappedMemory::create()::mmap() failed.";
-			errval = errno;
-			return EXIT_FAILURE;
+			// Transparent huge pages must be advised before pages are populated
+			if (huge)
+				populated = false;
+			p = mmap(NULL, aligned, PROT_READ | PROT_WRITE, flags | (populated ? MAP_POPULATE : 0), -1, 0);
+			if (MAP_FAILED == p) {
+				errmsg = "TMappedMemory::create()::mmap() failed.";
+				errval = errno;
+				return EXIT_FAILURE;
+			}
+			if (huge) {
+				if (EXIT_SUCCESS == madvise(p, aligned, MADV_HUGEPAGE)) {
+					pages = EMP_TRANSPARENT;
+					pagesize = options.hugePageSize;
+				}
+			}
 		}
 
 		// Return pointer to memory map
 		if (util::assigned(p)) {
+			node = -1;
+			if (binding) {
+				if (bind(p, aligned, options.node))
+					node = options.node;
+			}
+			if (options.populate && !populated)
+				prefault(p, aligned, pagesize);
+			faults = getMinorFaults() - minflt;
 			this->size = size;
 			*addr = mmem = (buffer_t*)p;
 			return EXIT_SUCCESS;
@@ -688,6 +797,9 @@ public:
 	bool lock() { return mmem.lock(); }
 	bool unlock() { return mmem.unlock(); }
 
+	void configure(const TMappedOptions& options) { mmem.configure(options); }
+	const TMappedMemory<buffer_t>& memory() const { return mmem; }
+
 	TMappedBuffer() : TBuffer(0) {
 		mptr = nil;
 		this->init(0, 0);
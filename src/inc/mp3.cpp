@@ -5,6 +5,7 @@
  *      Author: Dirk Brinkmeier
  */
 
+#include <cstring>
 #include "gcc.h"
 #include "audiobuffer.h"
 #include "audioconsts.h"
@@ -133,6 +134,33 @@ bool TMP3FrameReader::findMP3Frame(const void* buffer, size_t size, off_t& offse
 }
 
 
+size_t TMP3FrameReader::getSamplesPerFrame(const TMP3FrameHeader& frame) const {
+	switch (frame.stream.layer) {
+		case MP1:
+			return 384;
+		case MP2:
+			return 1152;
+		case MP3:
+			// MPEG 2 and 2.5 use half the granules per frame
+			return (frame.stream.version == 1) ? 1152 : 576;
+		default:
+			return 0;
+	}
+}
+
+size_t TMP3FrameReader::getSideInfoSize(const TMP3FrameHeader& frame) const {
+	// Side information follows frame header and optional CRC
+	// --> Protection bit not set means frame is protected by 16 bit CRC
+	size_t crc = frame.values.protection ? 0 : 2;
+	if (frame.stream.layer == MP3) {
+		if (frame.stream.version == 1)
+			return ((frame.stream.channels == 1) ? 17 : 32) + crc;
+		return ((frame.stream.channels == 1) ? 9 : 17) + crc;
+	}
+	return crc;
+}
+
+
 MPEGLayer TMP3FrameReader::getMPEGLayer(int layerIndex) const {
 	// Layer index values:
 	// 0 0 - Not defined, invalid
@@ -281,12 +309,75 @@ void TMP3FrameReader::debugOutput(const TMP3FrameHeader& frame, const std::strin
 
 
 
+TMP3SeekTable::TMP3SeekTable() {
+	clear();
+}
+
+TMP3SeekTable::~TMP3SeekTable() {
+}
+
+void TMP3SeekTable::clear() {
+	offsets.clear();
+	step = 0.0;
+	frames = 0;
+	exact = false;
+}
+
+void TMP3SeekTable::assign(const TMP3OffsetList& offsets, const double step, const size_t frames, const bool exact) {
+	this->offsets = offsets;
+	this->step = step;
+	this->frames = frames;
+	this->exact = exact;
+}
+
+bool TMP3SeekTable::getSeekPoint(const size_t frame, size_t& offset, size_t& start) const {
+	offset = 0;
+	start = 0;
+	if (!empty() && step > 0.0 && frame < frames) {
+		double position = (double)frame / step;
+		size_t index = (size_t)position;
+		if (index >= offsets.size())
+			index = offsets.size() - 1;
+		offset = offsets[index];
+
+		// Frame offsets are exact for every table step
+		if (exact) {
+			start = (size_t)((double)index * step);
+			return true;
+		}
+
+		// Interpolate estimated position between table entries
+		if ((index + 1) < offsets.size() && offsets[index + 1] > offsets[index]) {
+			offset += (size_t)((position - (double)index) * (double)(offsets[index + 1] - offsets[index]));
+		}
+		start = frame;
+		return true;
+	}
+	return false;
+}
+
+size_t TMP3SeekTable::getSeekOffset(const double percent) const {
+	size_t offset, start;
+	double value = percent < 0.0 ? 0.0 : (percent > 100.0 ? 100.0 : percent);
+	size_t frame = (size_t)(value * (double)frames / 100.0);
+	if (frame >= frames && frames > 0)
+		frame = frames - 1;
+	if (getSeekPoint(frame, offset, start))
+		return offset;
+	return std::string::npos;
+}
+
+
+
 TMP3FrameParser::TMP3FrameParser() {
 	debug = false;
 	duration = 0;
 	sampleSize = 0;
 	sampleCount = 0;
 	frameCount = 0;
+	samplesPerFrame = 0;
+	dataOffset = 0;
+	info.clear();
 	stream.stream.bitrate = 0;
 	stream.stream.channels = 0;
 	stream.stream.samplerate = 0;
@@ -295,6 +386,160 @@ TMP3FrameParser::TMP3FrameParser() {
 TMP3FrameParser::~TMP3FrameParser() {
 }
 
+DWORD TMP3FrameParser::getValue32(const BYTE* buffer) const {
+	return (DWORD)((buffer[0] << 24) | (buffer[1] << 16) | (buffer[2] << 8) | (buffer[3]));
+}
+
+WORD TMP3FrameParser::getValue16(const BYTE* buffer) const {
+	return (WORD)((buffer[0] << 8) | (buffer[1]));
+}
+
+bool TMP3FrameParser::readInfoHeader(const util::TFile& file, const size_t offset, const TMP3FrameReader& reader) {
+	info.clear();
+	table.clear();
+
+	// Read complete first frame
+	// --> Info headers are stored in first frame of stream
+	if (stream.stream.framesize <= 4)
+		return false;
+	util::TBuffer buffer(stream.stream.framesize);
+	ssize_t r = file.read(buffer.data(), buffer.size(), offset);
+	if (r != (ssize_t)buffer.size())
+		return false;
+
+	// Xing/Info header follows side information
+	const BYTE* p = (const BYTE*)buffer.data();
+	size_t xing = 4 + reader.getSideInfoSize(stream);
+	if (readXingHeader(p + xing, buffer.size() - xing, offset))
+		return true;
+
+	// VBRI header at fixed offset
+	size_t vbri = 4 + MP3_VBRI_OFFSET;
+	if (readVBRIHeader(p + vbri, buffer.size() - vbri, offset))
+		return true;
+
+	return false;
+}
+
+bool TMP3FrameParser::readXingHeader(const BYTE* buffer, const size_t size, const size_t offset) {
+	if (size < 8)
+		return false;
+
+	// Xing header for VBR streams, Info header for CBR streams
+	EMP3InfoType type = EMI_NONE;
+	if (0 == memcmp(buffer, "Xing", 4))
+		type = EMI_XING;
+	if (0 == memcmp(buffer, "Info", 4))
+		type = EMI_INFO;
+	if (EMI_NONE == type)
+		return false;
+
+	// Values are present as given by flags
+	DWORD flags = getValue32(buffer + 4);
+	size_t pos = 8;
+	if (flags & MP3_XING_FRAMES) {
+		if ((pos + 4) > size)
+			return false;
+		info.frames = getValue32(buffer + pos);
+		pos += 4;
+	}
+	if (flags & MP3_XING_BYTES) {
+		if ((pos + 4) > size)
+			return false;
+		info.bytes = getValue32(buffer + pos);
+		pos += 4;
+	}
+	const BYTE* toc = nil;
+	if (flags & MP3_XING_TOC) {
+		if ((pos + MP3_XING_TOC_SIZE) > size)
+			return false;
+		toc = buffer + pos;
+		pos += MP3_XING_TOC_SIZE;
+	}
+	if (flags & MP3_XING_QUALITY) {
+		if ((pos + 4) > size)
+			return false;
+		info.quality = getValue32(buffer + pos);
+		pos += 4;
+	}
+
+	// Frame count is needed to calculate duration
+	if (info.frames <= 0) {
+		info.clear();
+		return false;
+	}
+	info.type = type;
+
+	// LAME extension holds encoder delay and padding:
+	// 9 bytes version, 12 bytes tag values, 3 bytes delay/padding (12 bit each)
+	if ((pos + 24) <= size) {
+		if (0 == memcmp(buffer + pos, "LAME", 4) || 0 == memcmp(buffer + pos, "Lavc", 4) || 0 == memcmp(buffer + pos, "Lavf", 4)) {
+			const BYTE* p = buffer + pos + 21;
+			info.delay = (p[0] << 4) | (p[1] >> 4);
+			info.padding = ((p[1] & 0x0F) << 8) | p[2];
+			info.lame = true;
+		}
+	}
+
+	// Table of contents:
+	// Each entry is the stream position for 1 percent of play time in 1/256 of stream size
+	// --> Positions are relative to first frame that holds the Xing header
+	if (util::assigned(toc) && info.bytes > 0) {
+		TMP3OffsetList offsets;
+		offsets.reserve(MP3_XING_TOC_SIZE + 1);
+		for (size_t i=0; i<MP3_XING_TOC_SIZE; ++i) {
+			offsets.push_back(offset + (size_t)toc[i] * info.bytes / 256);
+		}
+		offsets.push_back(offset + info.bytes);
+		table.assign(offsets, (double)info.frames / (double)MP3_XING_TOC_SIZE, info.frames, false);
+	}
+
+	return true;
+}
+
+bool TMP3FrameParser::readVBRIHeader(const BYTE* buffer, const size_t size, const size_t offset) {
+	// Fraunhofer VBRI header:
+	// 4 bytes ID, 2 bytes version, 2 bytes delay, 2 bytes quality, 4 bytes stream size,
+	// 4 bytes frame count, 2 bytes TOC entries, 2 bytes scale, 2 bytes entry size, 2 bytes frames per entry
+	if (size < 26)
+		return false;
+	if (0 != memcmp(buffer, "VBRI", 4))
+		return false;
+
+	info.delay = getValue16(buffer + 6);
+	info.quality = getValue16(buffer + 8);
+	info.bytes = getValue32(buffer + 10);
+	info.frames = getValue32(buffer + 14);
+	if (info.frames <= 0) {
+		info.clear();
+		return false;
+	}
+	info.type = EMI_VBRI;
+
+	// Table entries hold scaled byte size for given frames per entry
+	size_t entries = getValue16(buffer + 18);
+	size_t scale = getValue16(buffer + 20);
+	size_t width = getValue16(buffer + 22);
+	size_t frames = getValue16(buffer + 24);
+	if (entries > 0 && frames > 0 && width > 0 && width <= 4 && (26 + entries * width) <= size) {
+		TMP3OffsetList offsets;
+		offsets.reserve(entries + 1);
+		size_t position = offset;
+		offsets.push_back(position);
+		const BYTE* p = buffer + 26;
+		for (size_t i=0; i<entries; ++i) {
+			size_t value = 0;
+			for (size_t k=0; k<width; ++k)
+				value = (value << 8) | *p++;
+			position += value * scale;
+			offsets.push_back(position);
+		}
+		table.assign(offsets, (double)frames, info.frames, false);
+	}
+
+	return true;
+}
+
 bool TMP3FrameParser::parse(const util::TFile& file, int bitsPerSample, bool vbr, std::string& hint) {
 	if (debug)
 		std::cout << "TMP3FrameParser::parse(" << file.getName() << ")" << std::endl;
@@ -302,13 +547,17 @@ bool TMP3FrameParser::parse(const util::TFile& file, int bitsPerSample, bool vbr
 	duration = 0;
 	sampleSize = 0;
 	sampleCount = 0;
+	samplesPerFrame = 0;
+	dataOffset = 0;
+	info.clear();
+	table.clear();
 	stream.stream.bitrate = 0;
 	stream.stream.channels = 0;
 	stream.stream.samplerate = 0;
 	TMP3FrameHeader frame;
 	TMP3FrameReader reader;
 	TID3v2Header header;
-	DWORD bytes;
+	TMP3OffsetList offsets;
 	bool cbr = false;
 	size_t bytesPerSecond = 0;
 	ssize_t r = readHeader(file, 0, header, hint);
@@ -352,111 +601,155 @@ bool TMP3FrameParser::parse(const util::TFile& file, int bitsPerSample, bool vbr
 
 		// Set offset to first valid MP3 header
 		offset += offs;
+		dataOffset = offset;
+
+		// Read properties from VBR info header in first frame
+		// --> Info frame is decoded as (silent) audio frame and is part of sample count
+		if (reader.getMP3Frame(buffer.data() + offs, stream)) {
+			samplesPerFrame = reader.getSamplesPerFrame(stream);
+			if (samplesPerFrame > 0 && stream.stream.samplerate > 0 && readInfoHeader(file, offset, reader)) {
+				frameCount = info.frames + 1;
+				sampleCount = frameCount * samplesPerFrame;
+				duration = (util::TTimePart)(sampleCount * 1000 / stream.stream.samplerate);
+				sampleSize = sampleCount * stream.stream.channels * bitsPerSample / 8;
+				if (debug) {
+					std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") INFO: Header type   : " << info.type << std::endl;
+					std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") INFO: Frame count   : " << info.frames << std::endl;
+					std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") INFO: Stream size   : " << info.bytes << std::endl;
+					std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") INFO: Seek entries  : " << table.size() << std::endl;
+					std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") INFO: Duration      : " << TSong::timeToStr(duration / 1000) << " min " << duration << " ms" << std::endl;
+					std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") INFO: Sample count  : " << sampleCount << std::endl;
+					std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") INFO: Sample size   : " << sampleSize << std::endl;
+				}
+				if (!isValid()) {
+					hint = util::csnprintf("Missing or invalid sound properties from info header: Duration=% (5000), SampleSize=% (882000), SampleCount=% (220500)", duration, sampleSize, sampleCount);
+					return false;
+				}
+				return true;
+			}
+		}
 
-		// Walk through MP3 frame headers
+		// Walk through MP3 frame headers in read ahead buffer
+		// --> Refill buffer when next frame header is outside of buffered area
+		buffer.resize(MP3_FRAME_SCAN_SIZE, false);
+		size_t position = 0;
+		size_t available = 0;
 		do {
 			ok = false;
-			r = file.seek(offset);
-			if (r == (ssize_t)offset) {
-				if (offset < eof) {
-					r = file.read(&bytes, 4);
-					if (r == 4) {
-						// Read MP3 header word
-						if (reader.getMP3Frame(&bytes, frame)) {
-
-							// Frame is valid
-							ok = true;
-
-							// Offset to next MP3 frame header entry
-							offset += frame.stream.framesize;
-
-							// Check current stream params against stored values
-							if (frameCount > 1) {
-								// Check for change in bitrate:
-								// --> Detect VBR file
-								if (stream.stream.bitrate != frame.stream.bitrate) {
-									cbr = false;
-									stream = frame;
-									bytesPerSecond = stream.stream.bitrate / 8;
-									if (debug)
-										reader.debugOutput(stream, "TMP3FrameParser::parse(" + file.getBaseName() + ") Changed ");;
-								}
-
-							} else {
-								// Take over stream parameters once
-								cbr = true;
+			if (offset < eof) {
+				if (offset < position || (offset + 4) > (position + available)) {
+					available = 0;
+					position = offset;
+					r = file.seek(offset);
+					if (r == (ssize_t)offset) {
+						r = file.read(buffer.data(), buffer.size());
+						if (r > 0)
+							available = r;
+					} else {
+						if (debug)
+							std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") Seek failed (" << r << ")" << std::endl;
+					}
+				}
+				if ((offset + 4) <= (position + available)) {
+					// Read MP3 header word
+					const char* bytes = buffer.data() + (offset - position);
+					if (reader.getMP3Frame(bytes, frame)) {
+
+						// Frame is valid
+						ok = true;
+
+						// Add frame offset to seek table
+						if (((frameCount - 1) % MP3_SEEK_TABLE_STEP) == 0)
+							offsets.push_back(offset);
+
+						// Offset to next MP3 frame header entry
+						offset += frame.stream.framesize;
+
+						// Check current stream params against stored values
+						if (frameCount > 1) {
+							// Check for change in bitrate:
+							// --> Detect VBR file
+							if (stream.stream.bitrate != frame.stream.bitrate) {
+								cbr = false;
 								stream = frame;
 								bytesPerSecond = stream.stream.bitrate / 8;
 								if (debug)
-									reader.debugOutput(stream, "TMP3FrameParser::parse(" + file.getBaseName() + ") First ");;
+									reader.debugOutput(stream, "TMP3FrameParser::parse(" + file.getBaseName() + ") Changed ");;
 							}
 
-							// Calculate duration in milliseconds for current frame:
-							// --> Datasize is current framesize
-							if (bytesPerSecond > 0)
-								duration += 1000 * stream.stream.framesize / bytesPerSecond;
-
-							// Check if file has constant bit rate
-							if (!vbr) {
-								// No change after 100 frames?
-								// --> Assume file is CBR
-								if (cbr && frameCount > MP3_CBR_FRAME_THRESHOLD) {
-									// Calculate stream duration from file size
-									TID3V1TagReader reader;
-									bool hasID3V1Tags = reader.hasTags(file);
-
-									// Calculate datasize:
-									// Subtract header and MP3v1 tags if present
-									size_t dataSize = hasID3V1Tags ? file.getSize() - 128 - hsize : file.getSize() - hsize;
-
-									// Calculate duration in milliseconds:
-									//   bytesPerSecond = stream.stream.bitrate / 8
-									//   --> * 1000 (for ms) / 8 ==> * 125
-									duration = 1000 * dataSize / bytesPerSecond;
-
-									// Calculate sample count from given duration
-									// Remember duration is in milliseconds...
-									sampleCount = duration * stream.stream.samplerate / 1000;
-
-									// Calculate sample size
-									// Assume 16 Bit for now ???
-									sampleSize = sampleCount * stream.stream.channels * bitsPerSample / 8;
-
-									if (debug) {
-										std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") CBR: File size     : " << file.getSize() << std::endl;
-										std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") CBR: Data size     : " << dataSize << std::endl;
-										std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") CBR: Bytes per sec : " << bytesPerSecond << std::endl;
-										std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") CBR: Duration      : " << TSong::timeToStr(duration / 1000) << " min " << duration << " ms" << std::endl;
-										std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") CBR: Sample count  : " << sampleCount << std::endl;
-										std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") CBR: Sample size   : " << sampleSize << std::endl;
-										std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") CBR: ID3v1 header  : " << hasID3V1Tags << std::endl;
-									}
-
-									ok = false;
-								}
-							}
+						} else {
+							// Take over stream parameters once
+							cbr = true;
+							stream = frame;
+							bytesPerSecond = stream.stream.bitrate / 8;
+							if (debug)
+								reader.debugOutput(stream, "TMP3FrameParser::parse(" + file.getBaseName() + ") First ");;
+						}
 
-							// Frame is processed
-							if (ok)
-								++frameCount;
+						// Calculate duration in milliseconds for current frame:
+						// --> Datasize is current framesize
+						if (bytesPerSecond > 0)
+							duration += 1000 * stream.stream.framesize / bytesPerSecond;
+
+						// Check if file has constant bit rate
+						if (!vbr) {
+							// No change after 100 frames?
+							// --> Assume file is CBR
+							if (cbr && frameCount > MP3_CBR_FRAME_THRESHOLD) {
+								// Calculate stream duration from file size
+								TID3V1TagReader reader;
+								bool hasID3V1Tags = reader.hasTags(file);
+
+								// Calculate datasize:
+								// Subtract header and MP3v1 tags if present
+								size_t dataSize = hasID3V1Tags ? file.getSize() - 128 - hsize : file.getSize() - hsize;
+
+								// Calculate duration in milliseconds:
+								//   bytesPerSecond = stream.stream.bitrate / 8
+								//   --> * 1000 (for ms) / 8 ==> * 125
+								duration = 1000 * dataSize / bytesPerSecond;
+
+								// Calculate sample count from given duration
+								// Remember duration is in milliseconds...
+								sampleCount = duration * stream.stream.samplerate / 1000;
+
+								// Calculate sample size
+								// Assume 16 Bit for now ???
+								sampleSize = sampleCount * stream.stream.channels * bitsPerSample / 8;
+
+								if (debug) {
+									std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") CBR: File size     : " << file.getSize() << std::endl;
+									std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") CBR: Data size     : " << dataSize << std::endl;
+									std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") CBR: Bytes per sec : " << bytesPerSecond << std::endl;
+									std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") CBR: Duration      : " << TSong::timeToStr(duration / 1000) << " min " << duration << " ms" << std::endl;
+									std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") CBR: Sample count  : " << sampleCount << std::endl;
+									std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") CBR: Sample size   : " << sampleSize << std::endl;
+									std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") CBR: ID3v1 header  : " << hasID3V1Tags << std::endl;
+								}
 
-						} else {
-							if (debug) {
-								std::string hex = util::TBinaryConvert::binToHexA(&bytes, 4);
-								std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") Invalid frame: " << hex << std::endl;
+								// Partial seek table is useless
+								offsets.clear();
+								ok = false;
 							}
 						}
+
+						// Frame is processed
+						if (ok)
+							++frameCount;
+
 					} else {
-						if (debug)
-							std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") Read failed (" << r << ")" << std::endl;
+						if (debug) {
+							std::string hex = util::TBinaryConvert::binToHexA(bytes, 4);
+							std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") Invalid frame: " << hex << std::endl;
+						}
 					}
 				} else {
 					if (debug)
-						std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") EOF detected." << std::endl;
+						std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") Read failed (" << available << ")" << std::endl;
 				}
 			} else {
 				if (debug)
-					std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") Seek failed (" << r << ")" << std::endl;
+					std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") EOF detected." << std::endl;
 			}
 		} while (ok);
 
@@ -478,11 +771,16 @@ bool TMP3FrameParser::parse(const util::TFile& file, int bitsPerSample, bool vbr
 		// Assume 16 Bit for now ???
 		sampleSize = sampleCount * stream.stream.channels * bitsPerSample / 8;
 
+		// Frame offsets of scanned stream as exact seek table
+		if (!offsets.empty() && frameCount > 1)
+			table.assign(offsets, (double)MP3_SEEK_TABLE_STEP, frameCount - 1, true);
+
 		if (debug) {
 			std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") VBR: File size     : " << file.getSize() << std::endl;
 			std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") VBR: Duration      : " << TSong::timeToStr(duration / 1000) << " min " << duration << " ms" << std::endl;
 			std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") VBR: Sample count  : " << sampleCount << std::endl;
 			std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") VBR: Sample size   : " << sampleSize << std::endl;
+			std::cout << "TMP3FrameParser::parse(" << file.getBaseName() << ") VBR: Seek entries  : " << table.size() << std::endl;
 		}
 	}
 
@@ -635,6 +933,7 @@ bool TMP3Stream::getRunningValues(TDecoderParams& params) {
 
 TMP3Decoder::TMP3Decoder() {
 	sampleSize = 0;
+	indexed = false;
 	debug = false;
 }
 
@@ -658,6 +957,7 @@ bool TMP3Decoder::open(const PSong song) {
 
 bool TMP3Decoder::open(const std::string& fileName, const CStreamData& properties) {
 	sampleSize = 0;
+	indexed = false;
 	if (!opened) {
 		setRead(0);
 		if (properties.isValid()) {
@@ -673,8 +973,10 @@ bool TMP3Decoder::open(const std::string& fileName, const CStreamData& propertie
 					file.assign(fileName);
 					file.open(O_RDONLY);
 					opened = file.isOpen();
-					if (opened)
+					if (opened) {
+						reader.open(file, 0);
 						setStream(properties);
+					}
 					if (debug) {
 						std::cout << "TMP3Decoder::open() File \"" << fileName << "\", Opened = " << opened << std::endl;
 						stream.debugOutput();
@@ -745,7 +1047,7 @@ bool TMP3Decoder::update(PAudioBuffer buffer, size_t& read) {
 			// File reader may throw exception...
 			try {
 
-				r = file.read(chunk.data(), chunk.size());
+				r = reader.read(chunk.data(), chunk.size());
 				if (r > 0) {
 
 					// Check for last data chunk of file
@@ -813,8 +1115,10 @@ bool TMP3Decoder::update(PAudioBuffer buffer, size_t& read) {
 			}
 
 			// Close open file as early as possible...
-			if (eof && file.isOpen())
+			if (eof && file.isOpen()) {
+				reader.close();
 				file.close();
+			}
 			if (eof && decoder.isOpen())
 				decoder.close();
 			
@@ -835,6 +1139,7 @@ bool TMP3Decoder::update(PAudioBuffer buffer, size_t& read) {
 	// Create internal error
 	error = true;
 	setBuffer(nil);
+	reader.close();
 	file.close();
 	decoder.close();
 	return false;
@@ -908,11 +1213,89 @@ bool TMP3Decoder::update(const TSample *const data, const size_t size, PAudioBuf
 	// Create internal error
 	error = true;
 	setBuffer(nil);
+	reader.close();
 	file.close();
 	decoder.close();
 	return false;
 }
 
+bool TMP3Decoder::seek(const size_t sample, PAudioBuffer buffer, size_t& position, size_t& read) {
+	position = 0;
+	read = 0;
+
+	if (canSeek() && !error && decoder.isOpen()) {
+
+		// Read seek table from info header or frame scan on first request
+		if (!indexed) {
+			std::string hint;
+			indexed = true;
+			parser.parse(file, stream.bitsPerSample, false, hint);
+			if (debug) std::cout << "TMP3Decoder::seek() Seek table with " << parser.getSeekTable().size() << " entries created." << std::endl;
+		}
+		if (parser.hasSeekTable()) {
+			if (seekTable(sample, position))
+				return true;
+		}
+
+		// Decoder calculates input offset to feed from for given sample
+		// --> Frames before requested sample are skipped by decoder
+		off_t offset = 0;
+		off_t r = mpg123_feedseek(decoder(), (off_t)sample, SEEK_SET, &offset);
+		if (r >= 0 && offset >= 0 && (size_t)offset < file.getSize()) {
+			ssize_t s = reader.seek(offset);
+			if (s == (ssize_t)offset) {
+				if (debug) std::cout << "TMP3Decoder::seek() Seek to sample " << sample << " (" << r << ") at input offset " << offset << std::endl;
+				sampleSize = (size_t)r * getFrameSize();
+				position = sampleSize;
+				return true;
+			}
+		}
+		if (debug) {
+			std::string errmsg = mpg123_plain_strerror((int)r);
+			std::cout << "TMP3Decoder::seek() Seek to sample " << sample << " failed: \"" << errmsg << "\"" << std::endl;
+		}
+	}
+	return false;
+}
+
+bool TMP3Decoder::seekTable(const size_t sample, size_t& position) {
+	size_t spf = parser.getSamplesPerFrame();
+	if (spf <= 0)
+		return false;
+
+	// Get stream position for frame that contains the sample
+	size_t offset, start;
+	const TMP3SeekTable& table = parser.getSeekTable();
+	if (!table.getSeekPoint(sample / spf, offset, start))
+		return false;
+
+	// Position from table of contents is estimated, find next frame header
+	if (!table.isExact()) {
+		off_t offs;
+		TMP3FrameReader reader;
+		util::TBuffer buffer(2 * MP3_FRAME_PADDING_SEEK_OFFSET);
+		ssize_t r = file.read(buffer.data(), buffer.size(), offset);
+		if (r <= 4 || !reader.findMP3Frame(buffer.data(), r, offs))
+			return false;
+		offset += offs;
+	}
+	if (offset >= file.getSize())
+		return false;
+
+	// Restart feeding decoder on frame boundary
+	int r = mpg123_open_feed(decoder());
+	if (r != MPG123_OK)
+		return false;
+	ssize_t s = reader.seek(offset);
+	if (s != (ssize_t)offset)
+		return false;
+
+	if (debug) std::cout << "TMP3Decoder::seekTable() Seek to sample " << sample << " in frame " << start << " at input offset " << offset << std::endl;
+	sampleSize = start * spf * getFrameSize();
+	position = sampleSize;
+	return true;
+}
+
 bool TMP3Decoder::isEOF(PAudioBuffer buffer, size_t& read) {
 	// Detect End Of File
 	PSong song = buffer->getSong();
@@ -935,6 +1318,7 @@ bool TMP3Decoder::isEOF(PAudioBuffer buffer, size_t& read) {
 
 void TMP3Decoder::close() {
 	clear();
+	reader.close();
 	file.close();
 	decoder.close();
 	if (debug)
@@ -8,6 +8,7 @@
 #ifndef MP3_H_
 #define MP3_H_
 
+#include <vector>
 #include "audiostream.h"
 #include "audiofile.h"
 #include "tagtypes.h"
@@ -22,6 +23,17 @@
 
 namespace music {
 
+#ifdef STL_HAS_TEMPLATE_ALIAS
+
+using TMP3OffsetList = std::vector<size_t>;
+
+#else
+
+typedef std::vector<size_t> TMP3OffsetList;
+
+#endif
+
+
 class TMP3Init {
 public:
 	TMP3Init();
@@ -63,6 +75,9 @@ public:
 	bool getMP3Frame(const void* buffer, TMP3FrameHeader& frame) const ;
 	bool getMP3Frame(DWORD header, TMP3FrameHeader& frame) const ;
 
+	size_t getSamplesPerFrame(const TMP3FrameHeader& frame) const;
+	size_t getSideInfoSize(const TMP3FrameHeader& frame) const;
+
 	void debugOutput(const TMP3FrameHeader& frame, const std::string& preamble = "") const;
 
 	TMP3FrameReader();
@@ -70,15 +85,53 @@ public:
 };
 
 
+class TMP3SeekTable {
+private:
+	TMP3OffsetList offsets;
+	double step;
+	size_t frames;
+	bool exact;
+
+public:
+	void clear();
+	bool empty() const { return offsets.empty(); };
+	size_t size() const { return offsets.size(); };
+
+	// Exact tables hold frame header offsets (frame scan)
+	// Inexact tables hold estimated stream positions (Xing/VBRI TOC)
+	bool isExact() const { return exact; };
+	double getStep() const { return step; };
+	size_t getFrames() const { return frames; };
+	const TMP3OffsetList& getOffsets() const { return offsets; };
+
+	void assign(const TMP3OffsetList& offsets, const double step, const size_t frames, const bool exact);
+	bool getSeekPoint(const size_t frame, size_t& offset, size_t& start) const;
+	size_t getSeekOffset(const double percent) const;
+
+	TMP3SeekTable();
+	~TMP3SeekTable();
+};
+
+
 class TMP3FrameParser : private TID3HeaderReader {
 private:
 	TMP3FrameHeader stream;
+	TMP3InfoHeader info;
+	TMP3SeekTable table;
 	util::TTimePart duration;
 	size_t sampleCount;
 	size_t sampleSize;
 	size_t frameCount;
+	size_t samplesPerFrame;
+	size_t dataOffset;
 	bool debug;
 
+	DWORD getValue32(const BYTE* buffer) const;
+	WORD getValue16(const BYTE* buffer) const;
+	bool readInfoHeader(const util::TFile& file, const size_t offset, const TMP3FrameReader& reader);
+	bool readXingHeader(const BYTE* buffer, const size_t size, const size_t offset);
+	bool readVBRIHeader(const BYTE* buffer, const size_t size, const size_t offset);
+
 public:
 	bool isValid();
 
@@ -87,7 +140,14 @@ public:
 	size_t getSampleSize() const { return sampleSize; };
 	size_t getSampleRate() const { return stream.stream.samplerate; };
 	size_t getFrameCount() const { return frameCount; };
+	size_t getSamplesPerFrame() const { return samplesPerFrame; };
 	size_t getChannels() const { return stream.stream.channels; };
+	size_t getDataOffset() const { return dataOffset; };
+
+	const TMP3InfoHeader& getInfoHeader() const { return info; };
+	const TMP3SeekTable& getSeekTable() const { return table; };
+	bool hasInfoHeader() const { return info.type != EMI_NONE; };
+	bool hasSeekTable() const { return !table.empty(); };
 
 	bool parse(const util::TFile& file, int bitsPerSample /* = 16 */, bool vbr /* = false */, std::string& hint);
 
@@ -127,10 +187,13 @@ private:
 	util::TFile file;
 	TSampleBuffer chunk;
 	TMP3Stream decoder;
+	TMP3FrameParser parser;
 	size_t sampleSize;
+	bool indexed;
 	bool debug;
 
 	bool isEOF(PAudioBuffer buffer, size_t& read);
+	bool seekTable(const size_t sample, size_t& position);
 
 public:
 	bool open(const std::string& fileName, const CStreamData& properties);
@@ -139,8 +202,11 @@ public:
 	bool open(const TDecoderParams& params);
 	void close();
 
+	bool canSeek() const { return opened && !eof && file.isOpen(); };
+
 	bool update(PAudioBuffer buffer, size_t& read);
 	bool update(const TSample *const data, const size_t size, PAudioBuffer buffer, size_t& written, size_t& consumed);
+	bool seek(const size_t sample, PAudioBuffer buffer, size_t& position, size_t& read);
 
 	bool getConfiguredValues(TDecoderParams& params);
 	bool getRunningValues(TDecoderParams& params);
@@ -52,6 +52,43 @@ typedef struct CMP3FrameHeader {
 	TMP3FrameParams stream;
 } TMP3FrameHeader;
 
+enum EMP3InfoType {
+	EMI_NONE,
+	EMI_XING,
+	EMI_INFO,
+	EMI_VBRI
+};
+
+// VBR info header stored in first MPEG frame (Xing/Info with LAME extension or VBRI)
+typedef struct CMP3InfoHeader {
+	EMP3InfoType type;
+	size_t frames;  // Audio frames without info frame
+	size_t bytes;   // Stream size including info frame
+	size_t quality;
+	size_t delay;   // LAME encoder delay in samples
+	size_t padding; // LAME end padding in samples
+	bool lame;
+
+	void clear() {
+		type = EMI_NONE;
+		frames = 0;
+		bytes = 0;
+		quality = 0;
+		delay = 0;
+		padding = 0;
+		lame = false;
+	}
+} TMP3InfoHeader;
+
+// Xing header flags
+static const size_t MP3_XING_FRAMES  = 0x0001;
+static const size_t MP3_XING_BYTES   = 0x0002;
+static const size_t MP3_XING_TOC     = 0x0004;
+static const size_t MP3_XING_QUALITY = 0x0008;
+
+static const size_t MP3_XING_TOC_SIZE = 100; // Entries in Xing table of contents
+static const size_t MP3_VBRI_OFFSET = 32;    // Fixed offset of VBRI header behind frame header
+
 
 static const int MP3Versions[4] = {
 	2 /*2.5*/, 0, 2, 1
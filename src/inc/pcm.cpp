@@ -668,6 +668,7 @@ bool TPCMEncoder::saveToFile(const std::string& fileName, const TAudioBuffer* bu
 
 TPCMDecoder::TPCMDecoder() {
 	debug = false;
+	dataOffset = 0;
 }
 
 TPCMDecoder::~TPCMDecoder() {
@@ -708,6 +709,7 @@ bool TPCMDecoder::open(const std::string& fileName, const CStreamData& propertie
 					ssize_t r = file.seek(offset);
 					if (r != (ssize_t)offset)
 						error = true;
+					dataOffset = offset;
 				}
 
 				// Close file on error!
@@ -715,6 +717,10 @@ bool TPCMDecoder::open(const std::string& fileName, const CStreamData& propertie
 					opened = false;
 					file.close();
 				}
+
+				// Prefetch sample data ahead of decoder
+				if (opened)
+					reader.open(file, dataOffset);
 			}
 			if (opened)
 				setStream(properties);
@@ -729,6 +735,27 @@ bool TPCMDecoder::open(const std::string& fileName, const CStreamData& propertie
 	return false;
 }
 
+bool TPCMDecoder::seek(const size_t sample, PAudioBuffer buffer, size_t& position, size_t& read) {
+	position = 0;
+	read = 0;
+
+	// PCM data is stored as fixed size frames after data chunk header
+	if (canSeek() && !error) {
+		size_t offset = sample * getFrameSize();
+		if (offset < stream.sampleSize) {
+			ssize_t r = reader.seek(dataOffset + offset);
+			if (r == (ssize_t)(dataOffset + offset)) {
+				if (debug) std::cout << "TPCMDecoder::seek() Seek to sample " << sample << " at offset " << offset << std::endl;
+				setRead(offset);
+				position = offset;
+				eof = false;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
 bool TPCMDecoder::update(PAudioBuffer buffer, size_t& read) {
 	read = 0;
 
@@ -741,7 +768,7 @@ bool TPCMDecoder::update(PAudioBuffer buffer, size_t& read) {
 
 			// File reader may throw exception...
 			try {
-				r = file.read((char*)samples, song->getChunkSize());
+				r = reader.read((char*)samples, song->getChunkSize());
 				if (r > 0) {
 					//std::cout << "TPCMDecoder::update() " << r << " bytes of " << song->getChunkSize() << " read." << std::endl;
 
@@ -773,8 +800,10 @@ bool TPCMDecoder::update(PAudioBuffer buffer, size_t& read) {
 			}
 
 			// Close open file as early as possible...
-			if (eof && file.isOpen())
+			if (eof && file.isOpen()) {
+				reader.close();
 				file.close();
+			}
 
 			if (debug && eof) {
 				 std::cout << "TPCMDecoder::update() EOF detected." << std::endl;
@@ -789,12 +818,14 @@ bool TPCMDecoder::update(PAudioBuffer buffer, size_t& read) {
 	// Create internal error
 	error = true;
 	setBuffer(nil);
+	reader.close();
 	file.close();
 	return false;
 }
 
 void TPCMDecoder::close() {
 	clear();
+	reader.close();
 	file.close();
 	if (debug) std::cout << "TPCMDecoder::close()" << std::endl;
 }
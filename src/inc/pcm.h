@@ -144,6 +144,7 @@ class TPCMDecoder : private TPCMStream, public TAudioStream {
 private:
 	bool debug;
 	util::TFile file;
+	size_t dataOffset;
 
 public:
 	bool open(const std::string& fileName, const CStreamData& properties);
@@ -151,7 +152,10 @@ public:
 	bool open(const PSong song);
 	bool open(const TDecoderParams& params);
 
+	bool canSeek() const { return opened && file.isOpen(); };
+
 	bool update(PAudioBuffer buffer, size_t& read);
+	bool seek(const size_t sample, PAudioBuffer buffer, size_t& position, size_t& read);
 
 	void close();
 
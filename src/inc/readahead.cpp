@@ -0,0 +1,283 @@
+/*
+ * readahead.cpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: Dirk Brinkmeier
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <algorithm>
+#include "readahead.h"
+#include "templates.h"
+#include "exception.h"
+
+namespace util {
+
+// Read ahead worker dispatcher
+static void* readAheadThreadDispatcher(void *thread) {
+	if (util::assigned(thread)) {
+		return (void *)(long)(static_cast<PReadAhead>(thread))->readerThreadHandler();
+	} else {
+		return (void *)(long)(EXIT_FAILURE);
+	}
+}
+
+
+TReadAhead::TReadAhead() {
+	fd = INVALID_HANDLE_VALUE;
+	chunkSize = READ_AHEAD_CHUNK_SIZE;
+	depth = READ_AHEAD_DEFAULT_DEPTH;
+	workers = READ_AHEAD_DEFAULT_WORKERS;
+	fileSize = 0;
+	position = 0;
+	next = 0;
+	generation = 0;
+	terminated = false;
+	opened = false;
+}
+
+TReadAhead::~TReadAhead() {
+	close();
+}
+
+void TReadAhead::clear() {
+	util::clearObjectList(chunks);
+}
+
+void TReadAhead::configure(const size_t chunkSize, const size_t depth, const size_t workers) {
+	// Configuration is used for next opened file
+	if (!opened) {
+		this->chunkSize = chunkSize > 4096 ? chunkSize : 4096;
+		this->depth = std::max(std::min(depth, READ_AHEAD_MAX_DEPTH), (size_t)2);
+		this->workers = std::min(std::min(workers, READ_AHEAD_MAX_WORKERS), this->depth);
+	}
+}
+
+void TReadAhead::advise(const size_t offset, const size_t size, const int advice) {
+	// Hint only, result is ignored
+	if (fd != INVALID_HANDLE_VALUE)
+		posix_fadvise(fd, (off_t)offset, (off_t)size, advice);
+}
+
+bool TReadAhead::open(const util::TFile& file, const size_t offset) {
+	close();
+	if (!file.isOpen())
+		return false;
+
+	fd = file.handle();
+	name = file.getName();
+	fileSize = file.getSize();
+	terminated = false;
+
+	// Chunk buffers are freed when reader is closed
+	for (size_t i=0; i<depth; ++i) {
+		PReadAheadChunk chunk = new TReadAheadChunk;
+		chunk->data.resize(chunkSize, false);
+		chunks.push_back(chunk);
+	}
+	{
+		app::TLockGuard<app::TCondition> lock(event);
+		reset(offset);
+	}
+	advise(0, 0, POSIX_FADV_SEQUENTIAL);
+	opened = true;
+
+	// Reads are done synchronously if no worker could be started
+	for (size_t i=0; i<workers; ++i) {
+		pthread_t thread = 0;
+		if (createJoinableThread(thread, readAheadThreadDispatcher, this, "Read-Ahead"))
+			threads.push_back(thread);
+	}
+	return true;
+}
+
+void TReadAhead::close() {
+	if (!threads.empty()) {
+		{
+			app::TLockGuard<app::TCondition> lock(event);
+			terminated = true;
+			event.broadcast();
+		}
+		for (size_t i=0; i<threads.size(); ++i) {
+			terminateThread(threads[i]);
+		}
+		threads.clear();
+	}
+	clear();
+	fd = INVALID_HANDLE_VALUE;
+	fileSize = 0;
+	position = 0;
+	next = 0;
+	opened = false;
+}
+
+void TReadAhead::reset(const size_t offset) {
+	// Called with lock held
+	// --> Pending chunks are released by the worker when the read finished
+	++generation;
+	for (size_t i=0; i<chunks.size(); ++i) {
+		PReadAheadChunk chunk = chunks[i];
+		if (chunk->state != ERA_PENDING)
+			chunk->state = ERA_EMPTY;
+	}
+	position = offset;
+	next = align(offset);
+	event.broadcast();
+}
+
+bool TReadAhead::schedule(PReadAheadChunk& chunk, size_t& offset, size_t& generation) {
+	// Called with lock held
+	// --> Next chunk must be inside the read ahead window and its buffer must be consumed
+	if (next >= fileSize)
+		return false;
+	if (next >= (align(position) + depth * chunkSize))
+		return false;
+	PReadAheadChunk o = getChunk(next);
+	if (o->state != ERA_EMPTY)
+		return false;
+	o->state = ERA_PENDING;
+	o->offset = next;
+	o->size = 0;
+	o->error = EXIT_SUCCESS;
+	o->generation = this->generation;
+	chunk = o;
+	offset = next;
+	generation = this->generation;
+	next += chunkSize;
+	return true;
+}
+
+ssize_t TReadAhead::load(void *const data, const size_t size, const size_t offset) {
+	// Read until requested size is complete or end of file reached
+	size_t done = 0;
+	char* p = (char*)data;
+	while (done < size) {
+		ssize_t r;
+		do {
+			errno = EXIT_SUCCESS;
+			r = ::pread(fd, p + done, size - done, (off_t)(offset + done));
+		} while (r == (ssize_t)EXIT_ERROR && errno == EINTR);
+		if (r < 0)
+			return (ssize_t)EXIT_ERROR;
+		if (r == 0)
+			break;
+		done += r;
+	}
+	return (ssize_t)done;
+}
+
+int TReadAhead::readerThreadHandler() {
+	PReadAheadChunk chunk;
+	size_t offset, generation;
+	while (true) {
+		{
+			app::TLockGuard<app::TCondition> lock(event);
+			while (!terminated && !schedule(chunk, offset, generation)) {
+				event.wait();
+			}
+			if (terminated)
+				break;
+		}
+
+		// Announce chunk behind current read ahead window
+		advise(offset + depth * chunkSize, chunkSize, POSIX_FADV_WILLNEED);
+
+		size_t size = std::min(chunkSize, fileSize - offset);
+		ssize_t r = load(chunk->data.data(), size, offset);
+		int error = errno;
+
+		app::TLockGuard<app::TCondition> lock(event);
+		if (generation == this->generation && offset >= align(position)) {
+			if (r >= 0) {
+				chunk->size = r;
+				chunk->state = ERA_READY;
+			} else {
+				chunk->error = error;
+				chunk->state = ERA_ERROR;
+			}
+		} else {
+			// Reader was positioned meanwhile or chunk was skipped
+			chunk->state = ERA_EMPTY;
+		}
+		event.broadcast();
+	}
+	return EXIT_SUCCESS;
+}
+
+ssize_t TReadAhead::read(void *const data, const size_t size) {
+	if (!opened)
+		return (ssize_t)EXIT_ERROR;
+
+	// Synchronous read as fallback
+	if (threads.empty()) {
+		size_t count = (position < fileSize) ? std::min(size, fileSize - position) : 0;
+		ssize_t r = load(data, count, position);
+		if (r < 0)
+			throw util::sys_error("TReadAhead::read() failed for <" + name + ">");
+		position += r;
+		return r;
+	}
+
+	// Copy data from prefetched chunks
+	char* p = (char*)data;
+	size_t done = 0;
+	app::TLockGuard<app::TCondition> lock(event);
+	while (done < size && position < fileSize) {
+		size_t base = align(position);
+		PReadAheadChunk chunk = getChunk(position);
+		while (chunk->offset != base || chunk->generation != generation || !util::isMemberOf(chunk->state, ERA_READY,ERA_ERROR)) {
+			event.wait();
+		}
+		if (ERA_ERROR == chunk->state)
+			throw util::sys_error("TReadAhead::read() failed for <" + name + ">", chunk->error);
+
+		// File may be truncated meanwhile
+		size_t skip = position - base;
+		if (chunk->size <= skip)
+			break;
+
+		size_t count = std::min(chunk->size - skip, size - done);
+		memcpy(p + done, chunk->data.data() + skip, count);
+		done += count;
+		position += count;
+
+		// Release completely consumed chunk for next prefetch
+		if ((position - base) >= chunk->size) {
+			chunk->state = ERA_EMPTY;
+			event.broadcast();
+		}
+	}
+	return (ssize_t)done;
+}
+
+ssize_t TReadAhead::seek(const size_t offset) {
+	if (!opened)
+		return (ssize_t)EXIT_ERROR;
+	app::TLockGuard<app::TCondition> lock(event);
+	if (threads.empty()) {
+		position = offset;
+		return (ssize_t)position;
+	}
+
+	// Keep prefetched chunks when positioned forward inside read ahead window
+	// --> Skipped chunks are released, pending chunks are released by the worker
+	size_t base = align(offset);
+	PReadAheadChunk chunk = getChunk(offset);
+	bool valid = chunk->offset == base && chunk->generation == generation && chunk->state != ERA_EMPTY;
+	if (valid && base >= align(position)) {
+		for (size_t i=0; i<chunks.size(); ++i) {
+			PReadAheadChunk o = chunks[i];
+			if (o->offset < base && ERA_PENDING != o->state)
+				o->state = ERA_EMPTY;
+		}
+		position = offset;
+		event.broadcast();
+	} else {
+		reset(offset);
+	}
+	return (ssize_t)position;
+}
+
+} /* namespace util */
@@ -0,0 +1,124 @@
+/*
+ * readahead.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: Dirk Brinkmeier
+ */
+
+#ifndef READAHEAD_H_
+#define READAHEAD_H_
+
+#include <vector>
+#include "gcc.h"
+#include "classes.h"
+#include "nullptr.h"
+#include "memory.h"
+#include "threads.h"
+#include "semaphores.h"
+#include "fileutils.h"
+
+namespace util {
+
+STATIC_CONST size_t READ_AHEAD_CHUNK_SIZE = 256 * 1024;
+STATIC_CONST size_t READ_AHEAD_DEFAULT_DEPTH = 4;
+STATIC_CONST size_t READ_AHEAD_MAX_DEPTH = 32;
+STATIC_CONST size_t READ_AHEAD_DEFAULT_WORKERS = 2;
+STATIC_CONST size_t READ_AHEAD_MAX_WORKERS = 4;
+
+class TReadAhead;
+
+enum EReadAheadState {
+	ERA_EMPTY,
+	ERA_PENDING,
+	ERA_READY,
+	ERA_ERROR
+};
+
+typedef struct CReadAheadChunk {
+	util::TBuffer data;
+	size_t offset;
+	size_t size;
+	size_t generation;
+	EReadAheadState state;
+	int error;
+
+	CReadAheadChunk() {
+		offset = 0;
+		size = 0;
+		generation = 0;
+		state = ERA_EMPTY;
+		error = EXIT_SUCCESS;
+	}
+} TReadAheadChunk;
+
+#ifdef STL_HAS_TEMPLATE_ALIAS
+
+using PReadAhead = TReadAhead*;
+using PReadAheadChunk = TReadAheadChunk*;
+using TReadAheadChunkList = std::vector<PReadAheadChunk>;
+using TReadAheadThreadList = std::vector<pthread_t>;
+
+#else
+
+typedef TReadAhead* PReadAhead;
+typedef TReadAheadChunk* PReadAheadChunk;
+typedef std::vector<PReadAheadChunk> TReadAheadChunkList;
+typedef std::vector<pthread_t> TReadAheadThreadList;
+
+#endif
+
+
+// Prefetching sequential reader for decoder input files (e.g. music on CIFS/NFS network shares)
+// --> Worker threads keep up to "depth" chunks in flight ahead of the read position via pread()
+// --> File is opened and closed by the owner, reader must be closed before the file handle
+// --> Reads are done synchronously by the caller if no worker thread could be started
+class TReadAhead : public app::TObject, private app::TThreadUtil {
+private:
+	TReadAheadChunkList chunks;
+	TReadAheadThreadList threads;
+	app::TCondition event;
+	app::THandle fd;
+	std::string name;
+	size_t chunkSize;
+	size_t depth;
+	size_t workers;
+	size_t fileSize;
+	size_t position;
+	size_t next;
+	size_t generation;
+	bool terminated;
+	bool opened;
+
+	void clear();
+	void reset(const size_t offset);
+	size_t align(const size_t offset) const { return (offset / chunkSize) * chunkSize; };
+	PReadAheadChunk getChunk(const size_t offset) const { return chunks[(offset / chunkSize) % depth]; };
+	bool schedule(PReadAheadChunk& chunk, size_t& offset, size_t& generation);
+	void advise(const size_t offset, const size_t size, const int advice);
+
+protected:
+	// Called by worker threads and by synchronous reads,
+	// a derived class must call close() in its destructor
+	virtual ssize_t load(void *const data, const size_t size, const size_t offset);
+
+public:
+	void configure(const size_t chunkSize, const size_t depth, const size_t workers);
+	bool open(const util::TFile& file, const size_t offset);
+	bool isOpen() const { return opened; };
+	void close();
+
+	ssize_t read(void *const data, const size_t size);
+	ssize_t seek(const size_t offset);
+	size_t getPosition() const { return position; };
+	size_t getSize() const { return fileSize; };
+	bool isEOF() const { return opened && position >= fileSize; };
+
+	int readerThreadHandler();
+
+	TReadAhead();
+	virtual ~TReadAhead();
+};
+
+} /* namespace util */
+
+#endif /* READAHEAD_H_ */
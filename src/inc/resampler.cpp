@@ -0,0 +1,420 @@
+/*
+ * resampler.cpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: Dirk Brinkmeier
+ */
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include "resampler.h"
+#include "samples.h"
+#include "templates.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#  define HAS_X86_RESAMPLER_KERNELS
+#  include <immintrin.h>
+#endif
+
+// Double precision vector arithmetic is only available for 64 bit ARM
+#if (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(__aarch64__)
+#  define HAS_NEON_RESAMPLER_KERNELS
+#  include <arm_neon.h>
+#endif
+
+namespace music {
+
+typedef struct CResamplerPreset {
+	size_t taps;        // Subfilter length for upsampling
+	double attenuation; // Stopband attenuation in dB
+} TResamplerPreset;
+
+static const TResamplerPreset presets[] = {
+	{  48,  80.0 }, // ERQ_LOW
+	{  96, 100.0 }, // ERQ_MEDIUM
+	{ 160, 120.0 }  // ERQ_HIGH
+};
+
+
+/*
+ * Dot product of subfilter and input history
+ */
+static double dotProductScalar(const double* filter, const double* samples, const size_t taps) {
+	double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+	size_t i = 0;
+	for (; (i + 4) <= taps; i += 4) {
+		s0 += filter[i]   * samples[i];
+		s1 += filter[i+1] * samples[i+1];
+		s2 += filter[i+2] * samples[i+2];
+		s3 += filter[i+3] * samples[i+3];
+	}
+	for (; i < taps; ++i) {
+		s0 += filter[i] * samples[i];
+	}
+	return (s0 + s1) + (s2 + s3);
+}
+
+#ifdef HAS_X86_RESAMPLER_KERNELS
+
+__attribute__((target("sse2")))
+static double dotProductSSE2(const double* filter, const double* samples, const size_t taps) {
+	__m128d a = _mm_setzero_pd();
+	__m128d b = _mm_setzero_pd();
+	size_t i = 0;
+	for (; (i + 4) <= taps; i += 4) {
+		a = _mm_add_pd(a, _mm_mul_pd(_mm_loadu_pd(filter + i), _mm_loadu_pd(samples + i)));
+		b = _mm_add_pd(b, _mm_mul_pd(_mm_loadu_pd(filter + i + 2), _mm_loadu_pd(samples + i + 2)));
+	}
+	double sum[2];
+	_mm_storeu_pd(sum, _mm_add_pd(a, b));
+	double r = sum[0] + sum[1];
+	for (; i < taps; ++i) {
+		r += filter[i] * samples[i];
+	}
+	return r;
+}
+
+__attribute__((target("avx2")))
+static double dotProductAVX2(const double* filter, const double* samples, const size_t taps) {
+	__m256d a = _mm256_setzero_pd();
+	__m256d b = _mm256_setzero_pd();
+	size_t i = 0;
+	for (; (i + 8) <= taps; i += 8) {
+		a = _mm256_add_pd(a, _mm256_mul_pd(_mm256_loadu_pd(filter + i), _mm256_loadu_pd(samples + i)));
+		b = _mm256_add_pd(b, _mm256_mul_pd(_mm256_loadu_pd(filter + i + 4), _mm256_loadu_pd(samples + i + 4)));
+	}
+	for (; (i + 4) <= taps; i += 4) {
+		a = _mm256_add_pd(a, _mm256_mul_pd(_mm256_loadu_pd(filter + i), _mm256_loadu_pd(samples + i)));
+	}
+	a = _mm256_add_pd(a, b);
+	__m128d s = _mm_add_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1));
+	double sum[2];
+	_mm_storeu_pd(sum, s);
+	double r = sum[0] + sum[1];
+	for (; i < taps; ++i) {
+		r += filter[i] * samples[i];
+	}
+	return r;
+}
+
+#endif /* HAS_X86_RESAMPLER_KERNELS */
+
+#ifdef HAS_NEON_RESAMPLER_KERNELS
+
+static double dotProductNEON(const double* filter, const double* samples, const size_t taps) {
+	float64x2_t a = vdupq_n_f64(0.0);
+	float64x2_t b = vdupq_n_f64(0.0);
+	size_t i = 0;
+	for (; (i + 4) <= taps; i += 4) {
+		a = vfmaq_f64(a, vld1q_f64(filter + i), vld1q_f64(samples + i));
+		b = vfmaq_f64(b, vld1q_f64(filter + i + 2), vld1q_f64(samples + i + 2));
+	}
+	double r = vaddvq_f64(vaddq_f64(a, b));
+	for (; i < taps; ++i) {
+		r += filter[i] * samples[i];
+	}
+	return r;
+}
+
+#endif /* HAS_NEON_RESAMPLER_KERNELS */
+
+static TResamplerKernel selectResamplerKernel() {
+	switch (getSampleKernel()) {
+#ifdef HAS_X86_RESAMPLER_KERNELS
+		case ESK_AVX2:
+			return dotProductAVX2;
+		case ESK_SSE2:
+			return dotProductSSE2;
+#endif
+#ifdef HAS_NEON_RESAMPLER_KERNELS
+		case ESK_NEON:
+			return dotProductNEON;
+#endif
+		default:
+			break;
+	}
+	return dotProductScalar;
+}
+
+static size_t greatestCommonDivisor(size_t a, size_t b) {
+	while (b > 0) {
+		size_t r = a % b;
+		a = b;
+		b = r;
+	}
+	return a;
+}
+
+// Modified Bessel function of first kind, order 0 (power series)
+static double besselI0(const double x) {
+	double sum = 1.0;
+	double term = 1.0;
+	double q = x * x / 4.0;
+	for (size_t k=1; k<64; ++k) {
+		term *= q / (double)(k * k);
+		sum += term;
+		if (term < sum * 1e-16)
+			break;
+	}
+	return sum;
+}
+
+
+TResampler::TResampler() {
+	quality = ERQ_MEDIUM;
+	clear();
+}
+
+TResampler::~TResampler() {
+}
+
+void TResampler::clear() {
+	coefficients.clear();
+	for (size_t c=0; c<RESAMPLER_MAX_CHANNELS; ++c)
+		history[c].clear();
+	kernel = dotProductScalar;
+	inputRate = 0;
+	outputRate = 0;
+	channels = 0;
+	bytesPerSample = 0;
+	interpolation = 0;
+	decimation = 0;
+	taps = 0;
+	filled = 0;
+	index = 0;
+	phase = 0;
+}
+
+bool TResampler::isConfigured(const int inputRate, const int outputRate, const size_t channels, const size_t bitsPerSample) const {
+	return isValid() &&
+			this->inputRate == inputRate &&
+			this->outputRate == outputRate &&
+			this->channels == channels &&
+			(this->bytesPerSample * 8) == bitsPerSample;
+}
+
+bool TResampler::isSupported(const int inputRate, const int outputRate, const size_t channels, const size_t bitsPerSample) {
+	if (inputRate <= 0 || outputRate <= 0)
+		return false;
+	if (channels <= 0 || channels > RESAMPLER_MAX_CHANNELS)
+		return false;
+	if (bitsPerSample != 16 && bitsPerSample != 24)
+		return false;
+	size_t divisor = greatestCommonDivisor(inputRate, outputRate);
+	return (outputRate / divisor) <= RESAMPLER_MAX_PHASES;
+}
+
+bool TResampler::setup(const int inputRate, const int outputRate, const size_t channels, const size_t bitsPerSample, const EResamplerQuality quality) {
+	// Filter bank is only rebuilt on changed parameters
+	// --> History is kept for gapless transition between songs of same stream type
+	if (isConfigured(inputRate, outputRate, channels, bitsPerSample) && this->quality == quality)
+		return true;
+
+	clear();
+	if (!isSupported(inputRate, outputRate, channels, bitsPerSample))
+		return false;
+
+	// Reduce conversion ratio to L/M
+	size_t divisor = greatestCommonDivisor(inputRate, outputRate);
+	size_t L = outputRate / divisor;
+	size_t M = inputRate / divisor;
+
+	// Subfilter is stretched by the decimation ratio to keep the transition band relative to the lower rate
+	const TResamplerPreset& preset = presets[util::isMemberOf(quality, ERQ_LOW,ERQ_MEDIUM,ERQ_HIGH) ? quality : ERQ_MEDIUM];
+	size_t length = preset.taps;
+	if (M > L)
+		length = (preset.taps * M + L - 1) / L;
+	length = (length + 3) & ~(size_t)3;
+
+	// Kaiser estimate for transition width, stopband starts at Nyquist frequency of the lower rate
+	double transition = (preset.attenuation - 7.95) / (14.36 * (double)preset.taps);
+	double cutoff = (0.5 - transition / 2.0) * std::min(1.0, (double)L / (double)M);
+
+	this->inputRate = inputRate;
+	this->outputRate = outputRate;
+	this->channels = channels;
+	this->quality = quality;
+	bytesPerSample = bitsPerSample / 8;
+	interpolation = L;
+	decimation = M;
+	taps = length;
+	kernel = selectResamplerKernel();
+	design(preset.attenuation, cutoff);
+
+	for (size_t c=0; c<channels; ++c)
+		history[c].resize(taps + RESAMPLER_BLOCK_FRAMES, 0.0);
+	reset();
+	return true;
+}
+
+void TResampler::design(const double attenuation, const double cutoff) {
+	// Prototype lowpass at upsampled rate, cutoff is given in cycles per input sample
+	size_t length = taps * interpolation;
+	TResamplerBuffer prototype(length);
+	double beta = 0.1102 * (attenuation - 8.7);
+	double norm = besselI0(beta);
+	double center = (double)(length - 1) / 2.0;
+	for (size_t n=0; n<length; ++n) {
+		double t = ((double)n - center) / (double)interpolation;
+		double x = 2.0 * cutoff * t;
+		double sinc = (fabs(x) < 1e-12) ? 1.0 : sin(M_PI * x) / (M_PI * x);
+		double r = ((double)n - center) / center;
+		double window = besselI0(beta * sqrt(std::max(0.0, 1.0 - r * r))) / norm;
+		prototype[n] = 2.0 * cutoff * sinc * window;
+	}
+
+	// Split prototype into subfilters, taps are stored in reverse order to be used
+	// as dot product on the input history, every phase is normalized to unity gain
+	coefficients.resize(interpolation * taps);
+	for (size_t p=0; p<interpolation; ++p) {
+		double* filter = coefficients.data() + p * taps;
+		double sum = 0.0;
+		for (size_t i=0; i<taps; ++i) {
+			filter[i] = prototype[p + (taps - 1 - i) * interpolation];
+			sum += filter[i];
+		}
+		if (fabs(sum) > 1e-12) {
+			for (size_t i=0; i<taps; ++i)
+				filter[i] /= sum;
+		}
+	}
+}
+
+void TResampler::reset() {
+	// Prime history with silence for first output sample
+	for (size_t c=0; c<channels; ++c)
+		std::fill(history[c].begin(), history[c].end(), 0.0);
+	filled = taps > 0 ? taps - 1 : 0;
+	index = 0;
+	phase = 0;
+	dither.reset();
+}
+
+void TResampler::swap(TResampler& value) {
+	// Exchange filter bank without copying, used to activate a resampler prepared by another thread
+	coefficients.swap(value.coefficients);
+	for (size_t c=0; c<RESAMPLER_MAX_CHANNELS; ++c)
+		history[c].swap(value.history[c]);
+	output.swap(value.output);
+	std::swap(kernel, value.kernel);
+	std::swap(quality, value.quality);
+	std::swap(inputRate, value.inputRate);
+	std::swap(outputRate, value.outputRate);
+	std::swap(channels, value.channels);
+	std::swap(bytesPerSample, value.bytesPerSample);
+	std::swap(interpolation, value.interpolation);
+	std::swap(decimation, value.decimation);
+	std::swap(taps, value.taps);
+	std::swap(filled, value.filled);
+	std::swap(index, value.index);
+	std::swap(phase, value.phase);
+}
+
+size_t TResampler::append(const TSample* src, const size_t frames) {
+	size_t count = std::min(frames, history[0].size() - filled);
+	for (size_t i=0; i<count; ++i) {
+		for (size_t c=0; c<channels; ++c) {
+			int32_t sample;
+			if (bytesPerSample == 2) {
+				sample = (int16_t)((uint16_t)src[0] | ((uint16_t)src[1] << 8));
+			} else {
+				sample = (int32_t)(((uint32_t)src[0] << 8) | ((uint32_t)src[1] << 16) | ((uint32_t)src[2] << 24)) >> 8;
+			}
+			history[c][filled + i] = (double)sample;
+			src += bytesPerSample;
+		}
+	}
+	filled += count;
+	return count;
+}
+
+void TResampler::store(TSample*& dst, const double value) {
+	long sample = lrint(value);
+	if (bytesPerSample == 2) {
+		sample = std::max(std::min(sample, 32767L), -32768L);
+		dst[0] = (TSample)(sample & 0xFF);
+		dst[1] = (TSample)((sample >> 8) & 0xFF);
+		dst += 2;
+	} else {
+		sample = std::max(std::min(sample, 8388607L), -8388608L);
+		dst[0] = (TSample)(sample & 0xFF);
+		dst[1] = (TSample)((sample >> 8) & 0xFF);
+		dst[2] = (TSample)((sample >> 16) & 0xFF);
+		dst += 3;
+	}
+}
+
+size_t TResampler::process(const TSample* src, const size_t size, const size_t frames, size_t& consumed) {
+	consumed = 0;
+	if (!isValid() || !util::assigned(src))
+		return 0;
+
+	size_t frameSize = channels * bytesPerSample;
+	size_t required = frames * frameSize;
+	if (output.size() < required)
+		output.resize(required);
+
+	// Dither for requantization to 16 bit output, values are scaled to 1/256 LSB
+	const int32_t* noise = (bytesPerSample == 2) ? dither.generate(frames, channels) : nil;
+
+	TSample* dst = output.data();
+	size_t available = size / frameSize;
+	size_t produced = 0;
+	while (produced < frames) {
+
+		// Calculate next output frame if history holds all samples for the subfilter
+		if ((index + taps) <= filled) {
+			const double* filter = coefficients.data() + phase * taps;
+			for (size_t c=0; c<channels; ++c) {
+				double value = kernel(filter, history[c].data() + index, taps);
+				if (util::assigned(noise))
+					value += (double)*(noise++) / 256.0;
+				store(dst, value);
+			}
+			++produced;
+			phase += decimation;
+			index += phase / interpolation;
+			phase %= interpolation;
+			continue;
+		}
+
+		if (available <= 0)
+			break;
+
+		// Discard samples no longer needed and refill history from input
+		// --> Only input needed for the requested output is taken, buffer is not drained in advance
+		size_t shift = std::min(index, filled);
+		if (shift > 0) {
+			for (size_t c=0; c<channels; ++c) {
+				double* p = history[c].data();
+				memmove(p, p + shift, (filled - shift) * sizeof(double));
+			}
+			filled -= shift;
+			index -= shift;
+		}
+		size_t needed = index + (phase + (frames - produced - 1) * decimation) / interpolation + taps;
+		size_t count = append(src, std::min(available, needed - filled));
+		src += count * frameSize;
+		consumed += count * frameSize;
+		available -= count;
+	}
+
+	// Incomplete trailing frame can't be used
+	if (available <= 0)
+		consumed = size;
+
+	return produced;
+}
+
+
+std::string resamplerQualityToStr(const EResamplerQuality quality) {
+	switch (quality) {
+		case ERQ_LOW    : return "Low";
+		case ERQ_MEDIUM : return "Medium";
+		case ERQ_HIGH   : return "High";
+	}
+	return "Unknown";
+}
+
+} /* namespace music */
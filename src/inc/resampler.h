@@ -0,0 +1,97 @@
+/*
+ * resampler.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: Dirk Brinkmeier
+ */
+
+#ifndef RESAMPLER_H_
+#define RESAMPLER_H_
+
+#include <string>
+#include <vector>
+#include "gcc.h"
+#include "audiotypes.h"
+#include "dither.h"
+
+namespace music {
+
+STATIC_CONST size_t RESAMPLER_MAX_CHANNELS = 8;
+// Interpolation factor L of reduced ratio, e.g. 44.1 kHz to 384 kHz is 1280/147, 44.1 kHz to 768 kHz is 2560/147
+// --> Filter bank for 4096 phases at high quality is about 5 MB and is designed outside of the playback thread
+STATIC_CONST size_t RESAMPLER_MAX_PHASES = 4096;
+STATIC_CONST size_t RESAMPLER_BLOCK_FRAMES = 1024;
+
+#ifdef STL_HAS_TEMPLATE_ALIAS
+
+using TResamplerBuffer = std::vector<double>;
+using TResamplerOutput = std::vector<TSample>;
+using TResamplerKernel = double (*)(const double*, const double*, const size_t);
+
+#else
+
+typedef std::vector<double> TResamplerBuffer;
+typedef std::vector<TSample> TResamplerOutput;
+typedef double (*TResamplerKernel)(const double*, const double*, const size_t);
+
+#endif
+
+
+// Rational polyphase sample rate converter for interleaved 16/24 bit little endian PCM
+// --> Conversion ratio L/M is reduced from input and output rate, e.g. 44.1 kHz to 48 kHz is 160/147
+// --> Filter bank holds one Kaiser windowed sinc subfilter for each of the L phases,
+//     cutoff is placed below the Nyquist frequency of the lower rate
+// --> Samples are filtered with double precision, output is rounded and clipped to the input sample size
+//     16 bit output is requantized with triangular PDF dither, 24 bit output is rounded only
+// --> Input history is kept across calls for gapless playback, every instance is used by one thread only
+class TResampler {
+private:
+	TResamplerBuffer coefficients;
+	TResamplerBuffer history[RESAMPLER_MAX_CHANNELS];
+	TResamplerOutput output;
+	TResamplerKernel kernel;
+	TDither dither;
+	EResamplerQuality quality;
+	int inputRate;
+	int outputRate;
+	size_t channels;
+	size_t bytesPerSample;
+	size_t interpolation;
+	size_t decimation;
+	size_t taps;
+	size_t filled;
+	size_t index;
+	size_t phase;
+
+	void clear();
+	void design(const double attenuation, const double cutoff);
+	size_t append(const TSample* src, const size_t frames);
+	void store(TSample*& dst, const double value);
+
+public:
+	bool setup(const int inputRate, const int outputRate, const size_t channels, const size_t bitsPerSample, const EResamplerQuality quality);
+	bool isConfigured(const int inputRate, const int outputRate, const size_t channels, const size_t bitsPerSample) const;
+	bool isValid() const { return taps > 0; };
+	static bool isSupported(const int inputRate, const int outputRate, const size_t channels, const size_t bitsPerSample);
+	void reset();
+	void swap(TResampler& value);
+
+	// Convert up to "frames" output frames from "size" bytes of input data
+	// --> Returns number of frames stored in data(), "consumed" is the number of input bytes taken
+	size_t process(const TSample* src, const size_t size, const size_t frames, size_t& consumed);
+	const TSample* data() const { return output.data(); };
+
+	int getInputRate() const { return inputRate; };
+	int getOutputRate() const { return outputRate; };
+	size_t getTaps() const { return taps; };
+	size_t getPhases() const { return interpolation; };
+
+	TResampler();
+	virtual ~TResampler();
+};
+
+std::string resamplerQualityToStr(const EResamplerQuality quality);
+
+} /* namespace music */
+
+#endif /* RESAMPLER_H_ */
@@ -0,0 +1,713 @@
+/*
+ * samples.cpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: Dirk Brinkmeier
+ */
+
+#include <string.h>
+#include "samples.h"
+#include "templates.h"
+#include "bits.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#  define HAS_X86_SAMPLE_KERNELS
+#  include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  define HAS_NEON_SAMPLE_KERNELS
+#  include <arm_neon.h>
+#endif
+
+namespace music {
+
+static ESampleKernel detectSampleKernel() {
+#ifdef HAS_X86_SAMPLE_KERNELS
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		return ESK_AVX2;
+	if (__builtin_cpu_supports("sse2"))
+		return ESK_SSE2;
+#endif
+#ifdef HAS_NEON_SAMPLE_KERNELS
+	return ESK_NEON;
+#endif
+	return ESK_SCALAR;
+}
+
+static const ESampleKernel supportedKernel = detectSampleKernel();
+static ESampleKernel activeKernel = supportedKernel;
+
+
+/*
+ * Scalar kernels
+ */
+static inline void storeSample16(TSample*& dst, const int32_t value, const util::EEndianType endian) {
+	if (endian == util::EE_BIG_ENDIAN) {
+		*dst++ = (TSample)(value >> 8 & AUDIO_SAMPLE_MASK);
+		*dst++ = (TSample)(value & AUDIO_SAMPLE_MASK);
+	} else {
+		*dst++ = (TSample)(value & AUDIO_SAMPLE_MASK);
+		*dst++ = (TSample)(value >> 8 & AUDIO_SAMPLE_MASK);
+	}
+}
+
+static inline void storeSample24(TSample*& dst, const int32_t value, const util::EEndianType endian) {
+	if (endian == util::EE_BIG_ENDIAN) {
+		*dst++ = (TSample)(value >> 16 & AUDIO_SAMPLE_MASK);
+		*dst++ = (TSample)(value >> 8 & AUDIO_SAMPLE_MASK);
+		*dst++ = (TSample)(value & AUDIO_SAMPLE_MASK);
+	} else {
+		*dst++ = (TSample)(value & AUDIO_SAMPLE_MASK);
+		*dst++ = (TSample)(value >> 8 & AUDIO_SAMPLE_MASK);
+		*dst++ = (TSample)(value >> 16 & AUDIO_SAMPLE_MASK);
+	}
+}
+
+static inline void storeSample32(TSample*& dst, const int32_t value, const util::EEndianType endian) {
+	if (endian == util::EE_BIG_ENDIAN) {
+		*dst++ = (TSample)(value >> 24 & AUDIO_SAMPLE_MASK);
+		*dst++ = (TSample)(value >> 16 & AUDIO_SAMPLE_MASK);
+		*dst++ = (TSample)(value >> 8 & AUDIO_SAMPLE_MASK);
+		*dst++ = (TSample)(value & AUDIO_SAMPLE_MASK);
+	} else {
+		*dst++ = (TSample)(value & AUDIO_SAMPLE_MASK);
+		*dst++ = (TSample)(value >> 8 & AUDIO_SAMPLE_MASK);
+		*dst++ = (TSample)(value >> 16 & AUDIO_SAMPLE_MASK);
+		*dst++ = (TSample)(value >> 24 & AUDIO_SAMPLE_MASK);
+	}
+}
+
+static void packScalar(TSample* dst, const int32_t* const src[], const size_t channels, const size_t first, const size_t frames,
+		const size_t bitsPerSample, const util::EEndianType endian) {
+	size_t i, c;
+	switch (bitsPerSample) {
+		case 16:
+			for (i=first; i<frames; ++i)
+				for (c=0; c<channels; ++c)
+					storeSample16(dst, src[c][i], endian);
+			break;
+		case 24:
+			for (i=first; i<frames; ++i)
+				for (c=0; c<channels; ++c)
+					storeSample24(dst, src[c][i], endian);
+			break;
+		case 32:
+			for (i=first; i<frames; ++i)
+				for (c=0; c<channels; ++c)
+					storeSample32(dst, src[c][i], endian);
+			break;
+		default:
+			break;
+	}
+}
+
+static void swapScalar(TSample* dst, const TSample* src, const size_t first, const size_t size, const size_t bitsPerSample) {
+	size_t i;
+	switch (bitsPerSample) {
+		case 16:
+			for (i=first; i<size; i+=2) {
+				TSample b = src[i];
+				dst[i]   = src[i+1];
+				dst[i+1] = b;
+			}
+			break;
+		case 24:
+			for (i=first; i<size; i+=3) {
+				TSample b = src[i];
+				dst[i]   = src[i+2];
+				dst[i+1] = src[i+1];
+				dst[i+2] = b;
+			}
+			break;
+		case 32:
+			for (i=first; i<size; i+=4) {
+				TSample b0 = src[i];
+				TSample b1 = src[i+1];
+				dst[i]   = src[i+3];
+				dst[i+1] = src[i+2];
+				dst[i+2] = b1;
+				dst[i+3] = b0;
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+
+static inline TSample dsdSample(const TSample sample, const bool reverse) {
+	return reverse ? util::bitReverse(sample) : sample;
+}
+
+static void convertDSDScalar(TSample* dst, const TSample* src, const size_t first, const size_t blocks, const size_t offset, const bool reverse) {
+	// Each block holds 2 DSD bytes per channel, newest byte first
+	TSample* p = dst + first * 4;
+	if (offset > 1) {
+		const TSample* L = src;
+		const TSample* R = src + offset;
+		for (size_t i=first, idx=first*2; i<blocks; ++i, idx+=2) {
+			*p++ = dsdSample(L[idx + 1], reverse);
+			*p++ = dsdSample(L[idx], reverse);
+			*p++ = dsdSample(R[idx + 1], reverse);
+			*p++ = dsdSample(R[idx], reverse);
+		}
+	} else {
+		const TSample* q = src + first * 4;
+		for (size_t i=first; i<blocks; ++i, q+=4) {
+			*p++ = dsdSample(q[2], reverse);
+			*p++ = dsdSample(q[0], reverse);
+			*p++ = dsdSample(q[3], reverse);
+			*p++ = dsdSample(q[1], reverse);
+		}
+	}
+}
+
+
+#ifdef HAS_X86_SAMPLE_KERNELS
+
+/*
+ * SSE2 kernels, 4 stereo frames per iteration
+ */
+__attribute__((target("sse2")))
+static size_t packStereoSSE2(TSample* dst, const int32_t* const src[], const size_t frames, const size_t bitsPerSample) {
+	const int32_t* L = src[0];
+	const int32_t* R = src[1];
+	size_t i = 0;
+	switch (bitsPerSample) {
+		case 16:
+			for (; (i + 4) <= frames; i += 4) {
+				__m128i l = _mm_loadu_si128((const __m128i*)(L + i));
+				__m128i r = _mm_loadu_si128((const __m128i*)(R + i));
+				// Sign extend lower 16 bit to avoid saturation on masked FLAC samples
+				l = _mm_srai_epi32(_mm_slli_epi32(l, 16), 16);
+				r = _mm_srai_epi32(_mm_slli_epi32(r, 16), 16);
+				__m128i lo = _mm_unpacklo_epi32(l, r);
+				__m128i hi = _mm_unpackhi_epi32(l, r);
+				_mm_storeu_si128((__m128i*)dst, _mm_packs_epi32(lo, hi));
+				dst += 16;
+			}
+			break;
+		case 24:
+			// Each 64 bit lane holds 2 samples of 24 bit = 6 bytes
+			// --> Overlapping 8 byte stores, last block is left to the scalar tail
+			for (; (i + 8) <= frames; i += 4) {
+				const __m128i mlo = _mm_set1_epi64x(INT64_C(0x0000000000FFFFFF));
+				const __m128i mhi = _mm_set1_epi64x(INT64_C(0x0000FFFFFF000000));
+				__m128i l = _mm_loadu_si128((const __m128i*)(L + i));
+				__m128i r = _mm_loadu_si128((const __m128i*)(R + i));
+				__m128i lo = _mm_unpacklo_epi32(l, r);
+				__m128i hi = _mm_unpackhi_epi32(l, r);
+				lo = _mm_or_si128(_mm_and_si128(lo, mlo), _mm_and_si128(_mm_srli_epi64(lo, 8), mhi));
+				hi = _mm_or_si128(_mm_and_si128(hi, mlo), _mm_and_si128(_mm_srli_epi64(hi, 8), mhi));
+				_mm_storel_epi64((__m128i*)dst, lo);
+				_mm_storel_epi64((__m128i*)(dst + 6), _mm_srli_si128(lo, 8));
+				_mm_storel_epi64((__m128i*)(dst + 12), hi);
+				_mm_storel_epi64((__m128i*)(dst + 18), _mm_srli_si128(hi, 8));
+				dst += 24;
+			}
+			break;
+		case 32:
+			for (; (i + 4) <= frames; i += 4) {
+				__m128i l = _mm_loadu_si128((const __m128i*)(L + i));
+				__m128i r = _mm_loadu_si128((const __m128i*)(R + i));
+				_mm_storeu_si128((__m128i*)dst, _mm_unpacklo_epi32(l, r));
+				_mm_storeu_si128((__m128i*)(dst + 16), _mm_unpackhi_epi32(l, r));
+				dst += 32;
+			}
+			break;
+		default:
+			break;
+	}
+	return i;
+}
+
+__attribute__((target("sse2")))
+static size_t swapSSE2(TSample* dst, const TSample* src, const size_t size, const size_t bitsPerSample) {
+	size_t i = 0;
+	switch (bitsPerSample) {
+		case 16:
+			for (; (i + 16) <= size; i += 16) {
+				__m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+				_mm_storeu_si128((__m128i*)(dst + i), _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8)));
+			}
+			break;
+		case 32:
+			for (; (i + 16) <= size; i += 16) {
+				__m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+				v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+				v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2,3,0,1));
+				v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2,3,0,1));
+				_mm_storeu_si128((__m128i*)(dst + i), v);
+			}
+			break;
+		default:
+			break;
+	}
+	return i;
+}
+
+
+/*
+ * SSE2 DSD kernels, 8 DoP blocks per iteration
+ * --> Bit reversal by swapping nibbles, bit pairs and single bits
+ */
+__attribute__((target("sse2")))
+static inline __m128i reverseBitsSSE2(__m128i v) {
+	const __m128i m4 = _mm_set1_epi8(0x0F);
+	const __m128i m2 = _mm_set1_epi8(0x33);
+	const __m128i m1 = _mm_set1_epi8(0x55);
+	v = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(v, 4), m4), _mm_slli_epi16(_mm_and_si128(v, m4), 4));
+	v = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(v, 2), m2), _mm_slli_epi16(_mm_and_si128(v, m2), 2));
+	v = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(v, 1), m1), _mm_slli_epi16(_mm_and_si128(v, m1), 1));
+	return v;
+}
+
+__attribute__((target("sse2")))
+static size_t convertDSDSSE2(TSample* dst, const TSample* src, const size_t blocks, const size_t offset, const bool reverse) {
+	size_t i = 0;
+	if (offset > 1) {
+		// Swap byte pairs of each channel and interleave 16 bit words
+		const TSample* L = src;
+		const TSample* R = src + offset;
+		for (; (i + 8) <= blocks; i += 8) {
+			__m128i l = _mm_loadu_si128((const __m128i*)(L + i * 2));
+			__m128i r = _mm_loadu_si128((const __m128i*)(R + i * 2));
+			if (reverse) {
+				l = reverseBitsSSE2(l);
+				r = reverseBitsSSE2(r);
+			}
+			l = _mm_or_si128(_mm_slli_epi16(l, 8), _mm_srli_epi16(l, 8));
+			r = _mm_or_si128(_mm_slli_epi16(r, 8), _mm_srli_epi16(r, 8));
+			_mm_storeu_si128((__m128i*)dst, _mm_unpacklo_epi16(l, r));
+			_mm_storeu_si128((__m128i*)(dst + 16), _mm_unpackhi_epi16(l, r));
+			dst += 32;
+		}
+	} else {
+		// Reorder bytes L1 R1 L2 R2 to L2 L1 R2 R1 in each 32 bit word
+		const __m128i m0 = _mm_set1_epi32(0x000000FF);
+		const __m128i m1 = _mm_set1_epi32(0x0000FF00);
+		const __m128i m2 = _mm_set1_epi32(0x00FF0000);
+		const __m128i m3 = _mm_set1_epi32((int)0xFF000000);
+		for (; (i + 4) <= blocks; i += 4) {
+			__m128i v = _mm_loadu_si128((const __m128i*)(src + i * 4));
+			if (reverse)
+				v = reverseBitsSSE2(v);
+			v = _mm_or_si128(
+					_mm_or_si128(_mm_and_si128(_mm_srli_epi32(v, 16), m0), _mm_and_si128(_mm_slli_epi32(v, 8), m1)),
+					_mm_or_si128(_mm_and_si128(_mm_srli_epi32(v, 8), m2), _mm_and_si128(_mm_slli_epi32(v, 16), m3)));
+			_mm_storeu_si128((__m128i*)dst, v);
+			dst += 16;
+		}
+	}
+	return i;
+}
+
+
+/*
+ * AVX2 kernels, 8 stereo frames per iteration
+ */
+__attribute__((target("avx2")))
+static inline void interleaveStereoAVX2(const int32_t* L, const int32_t* R, __m256i& a, __m256i& b) {
+	__m256i l = _mm256_loadu_si256((const __m256i*)L);
+	__m256i r = _mm256_loadu_si256((const __m256i*)R);
+	__m256i lo = _mm256_unpacklo_epi32(l, r);
+	__m256i hi = _mm256_unpackhi_epi32(l, r);
+	a = _mm256_permute2x128_si256(lo, hi, 0x20);
+	b = _mm256_permute2x128_si256(lo, hi, 0x31);
+}
+
+__attribute__((target("avx2")))
+static size_t packStereoAVX2(TSample* dst, const int32_t* const src[], const size_t frames, const size_t bitsPerSample, const util::EEndianType endian) {
+	const int32_t* L = src[0];
+	const int32_t* R = src[1];
+	const bool big = (endian == util::EE_BIG_ENDIAN);
+	size_t i = 0;
+	__m256i a, b;
+	switch (bitsPerSample) {
+		case 16: {
+			const __m256i mask = big ?
+				_mm256_setr_epi8(1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14, 1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14) :
+				_mm256_setr_epi8(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15, 0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15);
+			for (; (i + 8) <= frames; i += 8) {
+				interleaveStereoAVX2(L + i, R + i, a, b);
+				a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+				b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+				__m256i p = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), _MM_SHUFFLE(3,1,2,0));
+				_mm256_storeu_si256((__m256i*)dst, _mm256_shuffle_epi8(p, mask));
+				dst += 32;
+			}
+			break;
+		}
+		case 24: {
+			// Pack 4 samples to 12 bytes per 128 bit lane
+			// --> Overlapping 16 byte stores, last block is left to the scalar tail
+			const __m256i mask = big ?
+				_mm256_setr_epi8(2,1,0,6,5,4,10,9,8,14,13,12,-1,-1,-1,-1, 2,1,0,6,5,4,10,9,8,14,13,12,-1,-1,-1,-1) :
+				_mm256_setr_epi8(0,1,2,4,5,6,8,9,10,12,13,14,-1,-1,-1,-1, 0,1,2,4,5,6,8,9,10,12,13,14,-1,-1,-1,-1);
+			for (; (i + 16) <= frames; i += 8) {
+				interleaveStereoAVX2(L + i, R + i, a, b);
+				a = _mm256_shuffle_epi8(a, mask);
+				b = _mm256_shuffle_epi8(b, mask);
+				_mm_storeu_si128((__m128i*)dst, _mm256_castsi256_si128(a));
+				_mm_storeu_si128((__m128i*)(dst + 12), _mm256_extracti128_si256(a, 1));
+				_mm_storeu_si128((__m128i*)(dst + 24), _mm256_castsi256_si128(b));
+				_mm_storeu_si128((__m128i*)(dst + 36), _mm256_extracti128_si256(b, 1));
+				dst += 48;
+			}
+			break;
+		}
+		case 32: {
+			const __m256i mask = big ?
+				_mm256_setr_epi8(3,2,1,0,7,6,5,4,11,10,9,8,15,14,13,12, 3,2,1,0,7,6,5,4,11,10,9,8,15,14,13,12) :
+				_mm256_setr_epi8(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15, 0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15);
+			for (; (i + 8) <= frames; i += 8) {
+				interleaveStereoAVX2(L + i, R + i, a, b);
+				_mm256_storeu_si256((__m256i*)dst, _mm256_shuffle_epi8(a, mask));
+				_mm256_storeu_si256((__m256i*)(dst + 32), _mm256_shuffle_epi8(b, mask));
+				dst += 64;
+			}
+			break;
+		}
+		default:
+			break;
+	}
+	return i;
+}
+
+__attribute__((target("avx2")))
+static size_t swapAVX2(TSample* dst, const TSample* src, const size_t size, const size_t bitsPerSample) {
+	size_t i = 0;
+	switch (bitsPerSample) {
+		case 16: {
+			const __m256i mask = _mm256_setr_epi8(1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14, 1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14);
+			for (; (i + 32) <= size; i += 32) {
+				__m256i v = _mm256_loadu_si256((const __m256i*)(src + i));
+				_mm256_storeu_si256((__m256i*)(dst + i), _mm256_shuffle_epi8(v, mask));
+			}
+			break;
+		}
+		case 24: {
+			// Swap 4 samples of 3 bytes in each 12 byte block
+			// --> Overlapping 16 byte loads and stores, last block is left to the scalar tail
+			const __m128i mask = _mm_setr_epi8(2,1,0,5,4,3,8,7,6,11,10,9,-1,-1,-1,-1);
+			for (; (i + 16) <= size; i += 12) {
+				__m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+				_mm_storeu_si128((__m128i*)(dst + i), _mm_shuffle_epi8(v, mask));
+			}
+			break;
+		}
+		case 32: {
+			const __m256i mask = _mm256_setr_epi8(3,2,1,0,7,6,5,4,11,10,9,8,15,14,13,12, 3,2,1,0,7,6,5,4,11,10,9,8,15,14,13,12);
+			for (; (i + 32) <= size; i += 32) {
+				__m256i v = _mm256_loadu_si256((const __m256i*)(src + i));
+				_mm256_storeu_si256((__m256i*)(dst + i), _mm256_shuffle_epi8(v, mask));
+			}
+			break;
+		}
+		default:
+			break;
+	}
+	return i;
+}
+
+
+/*
+ * AVX2 DSD kernels, 32 DoP blocks per iteration
+ * --> Bit reversal by nibble lookup tables
+ */
+__attribute__((target("avx2")))
+static inline __m256i reverseBitsAVX2(const __m256i v) {
+	const __m256i mask = _mm256_set1_epi8(0x0F);
+	const __m256i lo = _mm256_setr_epi8(
+			0x00,0x80,0x40,0xC0,0x20,0xA0,0x60,0xE0,0x10,0x90,0x50,0xD0,0x30,0xB0,0x70,0xF0,
+			0x00,0x80,0x40,0xC0,0x20,0xA0,0x60,0xE0,0x10,0x90,0x50,0xD0,0x30,0xB0,0x70,0xF0);
+	const __m256i hi = _mm256_setr_epi8(
+			0x00,0x08,0x04,0x0C,0x02,0x0A,0x06,0x0E,0x01,0x09,0x05,0x0D,0x03,0x0B,0x07,0x0F,
+			0x00,0x08,0x04,0x0C,0x02,0x0A,0x06,0x0E,0x01,0x09,0x05,0x0D,0x03,0x0B,0x07,0x0F);
+	return _mm256_or_si256(
+			_mm256_shuffle_epi8(lo, _mm256_and_si256(v, mask)),
+			_mm256_shuffle_epi8(hi, _mm256_and_si256(_mm256_srli_epi16(v, 4), mask)));
+}
+
+__attribute__((target("avx2")))
+static size_t convertDSDAVX2(TSample* dst, const TSample* src, const size_t blocks, const size_t offset, const bool reverse) {
+	size_t i = 0;
+	if (offset > 1) {
+		// Swap byte pairs of each channel and interleave 16 bit words
+		const TSample* L = src;
+		const TSample* R = src + offset;
+		const __m256i mask = _mm256_setr_epi8(1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14, 1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14);
+		for (; (i + 16) <= blocks; i += 16) {
+			__m256i l = _mm256_loadu_si256((const __m256i*)(L + i * 2));
+			__m256i r = _mm256_loadu_si256((const __m256i*)(R + i * 2));
+			if (reverse) {
+				l = reverseBitsAVX2(l);
+				r = reverseBitsAVX2(r);
+			}
+			l = _mm256_shuffle_epi8(l, mask);
+			r = _mm256_shuffle_epi8(r, mask);
+			__m256i lo = _mm256_unpacklo_epi16(l, r);
+			__m256i hi = _mm256_unpackhi_epi16(l, r);
+			_mm256_storeu_si256((__m256i*)dst, _mm256_permute2x128_si256(lo, hi, 0x20));
+			_mm256_storeu_si256((__m256i*)(dst + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+			dst += 64;
+		}
+	} else {
+		// Reorder bytes L1 R1 L2 R2 to L2 L1 R2 R1 in each 32 bit word
+		const __m256i mask = _mm256_setr_epi8(2,0,3,1,6,4,7,5,10,8,11,9,14,12,15,13, 2,0,3,1,6,4,7,5,10,8,11,9,14,12,15,13);
+		for (; (i + 8) <= blocks; i += 8) {
+			__m256i v = _mm256_loadu_si256((const __m256i*)(src + i * 4));
+			if (reverse)
+				v = reverseBitsAVX2(v);
+			_mm256_storeu_si256((__m256i*)dst, _mm256_shuffle_epi8(v, mask));
+			dst += 32;
+		}
+	}
+	return i;
+}
+
+#endif /* HAS_X86_SAMPLE_KERNELS */
+
+
+#ifdef HAS_NEON_SAMPLE_KERNELS
+
+/*
+ * NEON kernels, 4 stereo frames per iteration
+ */
+static size_t packStereoNEON(TSample* dst, const int32_t* const src[], const size_t frames, const size_t bitsPerSample) {
+	const int32_t* L = src[0];
+	const int32_t* R = src[1];
+	size_t i = 0;
+	switch (bitsPerSample) {
+		case 16:
+			for (; (i + 4) <= frames; i += 4) {
+				int16x4x2_t v;
+				v.val[0] = vmovn_s32(vld1q_s32(L + i));
+				v.val[1] = vmovn_s32(vld1q_s32(R + i));
+				vst2_s16((int16_t*)dst, v);
+				dst += 16;
+			}
+			break;
+		case 32:
+			for (; (i + 4) <= frames; i += 4) {
+				int32x4x2_t v;
+				v.val[0] = vld1q_s32(L + i);
+				v.val[1] = vld1q_s32(R + i);
+				vst2q_s32((int32_t*)dst, v);
+				dst += 32;
+			}
+			break;
+		default:
+			break;
+	}
+	return i;
+}
+
+static size_t swapNEON(TSample* dst, const TSample* src, const size_t size, const size_t bitsPerSample) {
+	size_t i = 0;
+	switch (bitsPerSample) {
+		case 16:
+			for (; (i + 16) <= size; i += 16)
+				vst1q_u8(dst + i, vrev16q_u8(vld1q_u8(src + i)));
+			break;
+		case 24:
+			for (; (i + 48) <= size; i += 48) {
+				uint8x16x3_t v = vld3q_u8(src + i);
+				uint8x16_t b = v.val[0];
+				v.val[0] = v.val[2];
+				v.val[2] = b;
+				vst3q_u8(dst + i, v);
+			}
+			break;
+		case 32:
+			for (; (i + 16) <= size; i += 16)
+				vst1q_u8(dst + i, vrev32q_u8(vld1q_u8(src + i)));
+			break;
+		default:
+			break;
+	}
+	return i;
+}
+
+
+/*
+ * NEON DSD kernels, 8 DoP blocks per iteration
+ */
+static inline uint8x16_t reverseBitsNEON(uint8x16_t v) {
+#ifdef __aarch64__
+	return vrbitq_u8(v);
+#else
+	v = vorrq_u8(vshrq_n_u8(v, 4), vshlq_n_u8(v, 4));
+	v = vorrq_u8(vandq_u8(vshrq_n_u8(v, 2), vdupq_n_u8(0x33)), vandq_u8(vshlq_n_u8(v, 2), vdupq_n_u8(0xCC)));
+	v = vorrq_u8(vandq_u8(vshrq_n_u8(v, 1), vdupq_n_u8(0x55)), vandq_u8(vshlq_n_u8(v, 1), vdupq_n_u8(0xAA)));
+	return v;
+#endif
+}
+
+static size_t convertDSDNEON(TSample* dst, const TSample* src, const size_t blocks, const size_t offset, const bool reverse) {
+	size_t i = 0;
+	uint8x16_t l, r;
+	for (; (i + 8) <= blocks; i += 8) {
+		if (offset > 1) {
+			l = vld1q_u8(src + i * 2);
+			r = vld1q_u8(src + offset + i * 2);
+		} else {
+			uint8x16x2_t v = vld2q_u8(src + i * 4);
+			l = v.val[0];
+			r = v.val[1];
+		}
+		if (reverse) {
+			l = reverseBitsNEON(l);
+			r = reverseBitsNEON(r);
+		}
+		// Swap byte pairs of each channel and interleave 16 bit words
+		uint16x8x2_t w;
+		w.val[0] = vreinterpretq_u16_u8(vrev16q_u8(l));
+		w.val[1] = vreinterpretq_u16_u8(vrev16q_u8(r));
+		vst2q_u16((uint16_t*)dst, w);
+		dst += 32;
+	}
+	return i;
+}
+
+#endif /* HAS_NEON_SAMPLE_KERNELS */
+
+
+size_t packPlanarSamples(TSample* dst, const int32_t* const src[], const size_t channels, const size_t frames,
+		const size_t bitsPerSample, const util::EEndianType endian) {
+	if (!util::isMemberOf(bitsPerSample, (size_t)16,(size_t)24,(size_t)32) || channels <= 0)
+		return (size_t)0;
+
+	// Use SIMD kernel for stereo frames
+	// --> Kernels return the number of frames converted,
+	//     remaining frames are converted by scalar code
+	size_t done = 0;
+	if (channels == 2) {
+		switch (activeKernel) {
+#ifdef HAS_X86_SAMPLE_KERNELS
+			case ESK_AVX2:
+				done = packStereoAVX2(dst, src, frames, bitsPerSample, endian);
+				break;
+			case ESK_SSE2:
+				if (endian != util::EE_BIG_ENDIAN)
+					done = packStereoSSE2(dst, src, frames, bitsPerSample);
+				break;
+#endif
+#ifdef HAS_NEON_SAMPLE_KERNELS
+			case ESK_NEON:
+				if (endian != util::EE_BIG_ENDIAN)
+					done = packStereoNEON(dst, src, frames, bitsPerSample);
+				break;
+#endif
+			default:
+				break;
+		}
+	}
+
+	size_t bytesPerFrame = channels * bitsPerSample / 8;
+	if (done < frames)
+		packScalar(dst + done * bytesPerFrame, src, channels, done, frames, bitsPerSample, endian);
+
+	return frames * bytesPerFrame;
+}
+
+
+size_t swapSampleOrder(TSample* dst, const TSample* src, const size_t size, const size_t bitsPerSample) {
+	if (!util::isMemberOf(bitsPerSample, (size_t)8,(size_t)16,(size_t)24,(size_t)32))
+		return (size_t)0;
+
+	// Nothing to swap for single byte samples
+	if (bitsPerSample == 8) {
+		memcpy(dst, src, size);
+		return size;
+	}
+
+	// Ignore trailing incomplete sample
+	size_t bytesPerSample = bitsPerSample / 8;
+	size_t count = size - (size % bytesPerSample);
+
+	size_t done = 0;
+	switch (activeKernel) {
+#ifdef HAS_X86_SAMPLE_KERNELS
+		case ESK_AVX2:
+			done = swapAVX2(dst, src, count, bitsPerSample);
+			break;
+		case ESK_SSE2:
+			done = swapSSE2(dst, src, count, bitsPerSample);
+			break;
+#endif
+#ifdef HAS_NEON_SAMPLE_KERNELS
+		case ESK_NEON:
+			done = swapNEON(dst, src, count, bitsPerSample);
+			break;
+#endif
+		default:
+			break;
+	}
+
+	if (done < count)
+		swapScalar(dst, src, done, count, bitsPerSample);
+
+	return count;
+}
+
+
+size_t convertDSDSamples(TSample* dst, const TSample* src, const size_t size, const size_t offset, const bool reverse) {
+	// Incomplete block at end of chunk is converted as well
+	size_t blocks = (size + 3) / 4;
+
+	size_t done = 0;
+	switch (activeKernel) {
+#ifdef HAS_X86_SAMPLE_KERNELS
+		case ESK_AVX2:
+			done = convertDSDAVX2(dst, src, blocks, offset, reverse);
+			break;
+		case ESK_SSE2:
+			done = convertDSDSSE2(dst, src, blocks, offset, reverse);
+			break;
+#endif
+#ifdef HAS_NEON_SAMPLE_KERNELS
+		case ESK_NEON:
+			done = convertDSDNEON(dst, src, blocks, offset, reverse);
+			break;
+#endif
+		default:
+			break;
+	}
+
+	if (done < blocks)
+		convertDSDScalar(dst, src, done, blocks, offset, reverse);
+
+	return blocks * 4;
+}
+
+
+ESampleKernel getSampleKernel() {
+	return activeKernel;
+}
+
+void setSampleKernel(const ESampleKernel kernel) {
+	// Kernel must not exceed detected CPU capabilities
+	// --> NEON and x86 kernels are mutually exclusive
+	if (kernel == ESK_SCALAR || kernel == supportedKernel) {
+		activeKernel = kernel;
+		return;
+	}
+	if (kernel == ESK_SSE2 && supportedKernel == ESK_AVX2) {
+		activeKernel = kernel;
+	}
+}
+
+std::string sampleKernelToStr(const ESampleKernel kernel) {
+	switch (kernel) {
+		case ESK_SCALAR : return "Scalar";
+		case ESK_SSE2	: return "SSE2";
+		case ESK_AVX2	: return "AVX2";
+		case ESK_NEON	: return "NEON";
+	}
+	return "unknown";
+}
+
+} /* namespace music */
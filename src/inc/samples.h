@@ -0,0 +1,51 @@
+/*
+ * samples.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: Dirk Brinkmeier
+ */
+
+#ifndef SAMPLES_H_
+#define SAMPLES_H_
+
+#include <string>
+#include "gcc.h"
+#include "audiotypes.h"
+#include "endianutils.h"
+
+namespace music {
+
+enum ESampleKernel {
+	ESK_SCALAR,
+	ESK_SSE2,
+	ESK_AVX2,
+	ESK_NEON
+};
+
+// Bulk sample conversion routines used by the decoders
+// --> Kernel is selected once at startup by CPU feature detection
+// --> SIMD kernels are used for stereo output (big endian by AVX2 only), all other layouts use scalar code
+
+// Pack planar 32 bit decoder output (e.g. FLAC frame) into interleaved 16/24/32 bit samples
+// --> Returns number of bytes written to destination, 0 on unsupported sample size
+size_t packPlanarSamples(TSample* dst, const int32_t* const src[], const size_t channels, const size_t frames,
+		const size_t bitsPerSample, const util::EEndianType endian = util::EE_LITTLE_ENDIAN);
+
+// Reverse byte order of interleaved 8/16/24/32 bit samples (e.g. big endian AIFF data to little endian PCM)
+// --> Source and destination buffers must not overlap
+// --> Returns number of bytes written to destination, 0 on unsupported sample size
+size_t swapSampleOrder(TSample* dst, const TSample* src, const size_t size, const size_t bitsPerSample);
+
+// Convert DSD data to DoP byte order (2 bytes per channel, newest byte first)
+// --> Offset > 1 is the distance of the right channel block for planar data (DSF), otherwise data is interleaved (DFF)
+// --> Bit order is reversed for LSB first data (DSF)
+// --> Returns number of bytes written to destination
+size_t convertDSDSamples(TSample* dst, const TSample* src, const size_t size, const size_t offset, const bool reverse);
+
+ESampleKernel getSampleKernel();
+void setSampleKernel(const ESampleKernel kernel);
+std::string sampleKernelToStr(const ESampleKernel kernel);
+
+} /* namespace music */
+
+#endif /* SAMPLES_H_ */
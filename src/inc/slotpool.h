@@ -0,0 +1,139 @@
+/*
+ * slotpool.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: Dirk Brinkmeier
+ */
+
+#ifndef SLOTPOOL_H_
+#define SLOTPOOL_H_
+
+#include <deque>
+#include <vector>
+#include "semaphore.h"
+#include "templates.h"
+
+namespace app {
+
+typedef struct CSlotPoolStatistics {
+	size_t size;     // Free slots in pool
+	size_t capacity;
+	size_t reused;   // Slots taken from pool
+	size_t missed;   // Requests for a slot on empty pool
+	size_t dropped;  // Slots not taken back by full pool
+	size_t shrunk;   // Slots removed by shrink()
+
+	void clear() {
+		size = 0;
+		capacity = 0;
+		reused = 0;
+		missed = 0;
+		dropped = 0;
+		shrunk = 0;
+	}
+
+	CSlotPoolStatistics() {
+		clear();
+	}
+} TSlotPoolStatistics;
+
+
+// Free list of reusable objects owned by the caller
+// --> Slots are taken in the order they were given back, the oldest released slot is reused first
+// --> Objects are not freed by the pool, slots removed by shrink() are returned to the owner
+template<typename T>
+class TSlotPool {
+public:
+	typedef T* object_p;
+	typedef std::vector<object_p> vector_t;
+
+private:
+	typedef std::deque<object_p> queue_t;
+
+	app::TMutex mtx;
+	queue_t slots;
+	size_t capacity;
+	size_t lowWater;
+	size_t reused;
+	size_t missed;
+	size_t dropped;
+	size_t shrunk;
+
+public:
+	void setCapacity(const size_t value) {
+		app::TLockGuard<app::TMutex> lock(mtx);
+		capacity = value;
+	}
+
+	object_p acquire() {
+		app::TLockGuard<app::TMutex> lock(mtx);
+		if (slots.empty()) {
+			++missed;
+			lowWater = 0;
+			return nil;
+		}
+		object_p o = slots.front();
+		slots.pop_front();
+		if (slots.size() < lowWater)
+			lowWater = slots.size();
+		++reused;
+		return o;
+	}
+
+	bool release(object_p o) {
+		// Returns false if pool is full, object stays with the caller
+		if (!util::assigned(o))
+			return false;
+		app::TLockGuard<app::TMutex> lock(mtx);
+		if (capacity > 0 && slots.size() >= capacity) {
+			++dropped;
+			return false;
+		}
+		slots.push_back(o);
+		return true;
+	}
+
+	size_t shrink(vector_t& idle) {
+		// Remove slots that were not needed since last call
+		idle.clear();
+		app::TLockGuard<app::TMutex> lock(mtx);
+		size_t count = std::min(lowWater, slots.size());
+		for (size_t i=0; i<count; ++i) {
+			idle.push_back(slots.front());
+			slots.pop_front();
+		}
+		shrunk += count;
+		lowWater = slots.size();
+		return count;
+	}
+
+	void clear() {
+		app::TLockGuard<app::TMutex> lock(mtx);
+		slots.clear();
+		lowWater = 0;
+	}
+
+	void getStatistics(TSlotPoolStatistics& statistics) {
+		app::TLockGuard<app::TMutex> lock(mtx);
+		statistics.size = slots.size();
+		statistics.capacity = capacity;
+		statistics.reused = reused;
+		statistics.missed = missed;
+		statistics.dropped = dropped;
+		statistics.shrunk = shrunk;
+	}
+
+	TSlotPool() {
+		capacity = 0;
+		lowWater = 0;
+		reused = 0;
+		missed = 0;
+		dropped = 0;
+		shrunk = 0;
+	}
+	virtual ~TSlotPool() {}
+};
+
+} /* namespace app */
+
+#endif /* SLOTPOOL_H_ */
@@ -88,7 +88,9 @@ struct CApplicationConfig {
 	bool setTempDir;
 	bool runOnce;
 	bool useDongle;
+	bool poolAffinity;
 	int affinity;
+	int poolSize;
 	int handles;
 	int nice;
 
@@ -128,6 +130,8 @@ struct CApplicationConfig {
 		defaultDatabaseName = "application";
 		defaultDatabaseType = "PGSQL"; // MSSQL, SQLITE, PGSQL, ...
 		affinity = -1;
+		poolSize = 0;
+		poolAffinity = true;
 		handles = 0;
 		heapDelay = 0;
 		nice = 0;
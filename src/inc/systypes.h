@@ -102,6 +102,7 @@ typedef struct CMemInfo {
     size_t swapTotal;
     size_t swapFree;
     size_t shmem;
+    size_t hugePageSize;
 
     void clear() {
         memTotal = 0;
@@ -112,6 +113,7 @@ typedef struct CMemInfo {
         swapTotal = 0;
         swapFree = 0;
         shmem = 0;
+        hugePageSize = 0;
     }
 
     CMemInfo() { clear(); };
@@ -273,6 +273,66 @@ size_t sysutil::getProcessorCount() {
 	return retVal;
 }
 
+static bool getNodeIndex(const char* name, int& node) {
+	// Parse entry name "node<n>"
+	if (0 == strncmp(name, "node", 4)) {
+		char* p;
+		long n = strtol(name + 4, &p, 10);
+		if (p != (name + 4) && *p == '\0' && n >= 0) {
+			node = (int)n;
+			return true;
+		}
+	}
+	return false;
+}
+
+int sysutil::getProcessorNode(const size_t cpu) {
+	// Processor folder contains link to NUMA node, e.g. /sys/devices/system/cpu/cpu2/node0
+	// --> Processor index starts with 0
+	DIR* dir;
+	struct dirent* ent;
+	size_t size = maxPathSize();
+	char buf[size+1];
+	int node = -1;
+
+	snprintf(buf, size, "/sys/devices/system/cpu/cpu%lu", (unsigned long)cpu);
+	if ((dir = opendir(buf)) == NULL) {
+		return node;
+	}
+	while((ent = readdir(dir)) != NULL) {
+		if (getNodeIndex(ent->d_name, node))
+			break;
+	}
+	closedir(dir);
+
+	return node;
+}
+
+size_t sysutil::getNodeCount() {
+	DIR* dir;
+	struct dirent* ent;
+	size_t count = 0;
+	int node;
+
+	if ((dir = opendir("/sys/devices/system/node")) == NULL) {
+		return count;
+	}
+	while((ent = readdir(dir)) != NULL) {
+		if (getNodeIndex(ent->d_name, node))
+			++count;
+	}
+	closedir(dir);
+
+	return count;
+}
+
+size_t sysutil::getHugePageSize() {
+	sysutil::TMemInfo memory;
+	if (getSystemMemory(memory))
+		return memory.hugePageSize;
+	return 0;
+}
+
 
 const char* strposlast(const char* str, char c) {
 	const char* r = str;
@@ -781,6 +841,7 @@ bool getProcItem(const std::string& line, const std::string& item, size_t& value
 }
 
 bool sysutil::getSystemMemory(sysutil::TMemInfo& memory) {
+	STATIC_CONST int entries = 10; // Number of entries read from /proc/meminfo
 	int found = 0;
 	memory.clear();
 	std::string fileName = "/proc/meminfo";
@@ -790,6 +851,7 @@ bool sysutil::getSystemMemory(sysutil::TMemInfo& memory) {
 		if (!items.empty()) {
 			// Read entries for:
 			//   MemTotal
+			//   MemAvailable
 			//   MemFree
 			//   Buffers
 			//   Cached
@@ -797,6 +859,7 @@ bool sysutil::getSystemMemory(sysutil::TMemInfo& memory) {
 			//   SwapTotal
 			//   SwapFree
 			//   Shmem
+			//   Hugepagesize
 			std::string line;
 			size_t free = 0, available = 0;
 			for (size_t i=0; i<items.size(); ++i) {
@@ -838,9 +901,13 @@ bool sysutil::getSystemMemory(sysutil::TMemInfo& memory) {
 					++found;
 					continue;
 				}
+				if (getProcItem(line, "Hugepagesize", memory.hugePageSize)) {
+					++found;
+					continue;
+				}
 
 				// All items found?
-				if (found >= 8)
+				if (found >= entries)
 					break;
 			}
 
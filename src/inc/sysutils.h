@@ -39,6 +39,9 @@ void getMemoryUsage(size_t& current, size_t& peak);
 size_t getPeakMemoryUsage();
 size_t getCurrentMemoryUsage();
 size_t getProcessorCount();
+int getProcessorNode(const size_t cpu);
+size_t getNodeCount();
+size_t getHugePageSize();
 size_t getThreadCount();
 pid_t getProcessID(const std::string& name);
 bool isProcessRunning(const long int pid);
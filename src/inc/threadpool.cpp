@@ -0,0 +1,332 @@
+/*
+ * threadpool.cpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: Dirk Brinkmeier
+ */
+
+#include <time.h>
+#include "threadpool.h"
+#include "sysutils.h"
+#include "templates.h"
+#include "exception.h"
+
+namespace app {
+
+// Thread pool worker dispatcher
+static void* poolThreadDispatcher(void *thread) {
+	if (util::assigned(thread)) {
+		PThreadPoolWorker worker = static_cast<PThreadPoolWorker>(thread);
+		return (void *)(long)(worker->owner->workerThreadHandler(*worker));
+	} else {
+		return (void *)(long)(EXIT_FAILURE);
+	}
+}
+
+// Monotonic time in microseconds for task latency
+static int64_t getMicroSeconds() {
+	struct timespec ts;
+	if (EXIT_SUCCESS == clock_gettime(CLOCK_MONOTONIC, &ts))
+		return (int64_t)ts.tv_sec * 1000000 + (int64_t)ts.tv_nsec / 1000;
+	return 0;
+}
+
+
+TThreadPool::TThreadPool(TLogFile& infoLog, TLogFile& exceptionLog) {
+	this->infoLog = &infoLog;
+	this->exceptionLog = &exceptionLog;
+	next = 0;
+	pending = 0;
+	active = 0;
+	maxPending = 0;
+	size = 0;
+	affinity = false;
+	started = false;
+	terminated = false;
+}
+
+TThreadPool::~TThreadPool() {
+	terminate();
+	waitFor();
+	clear();
+}
+
+void TThreadPool::clear() {
+	util::clearObjectList(workers);
+}
+
+void TThreadPool::configure(const size_t size, const bool affinity) {
+	app::TLockGuard<app::TMutex> lock(startMtx);
+	if (!started) {
+		this->size = size;
+		this->affinity = affinity;
+	}
+}
+
+size_t TThreadPool::getWorkerCount() const {
+	// Use one worker per processor core by default
+	size_t count = size;
+	if (count <= 0) {
+		count = sysutil::getProcessorCount();
+		if (std::string::npos == count)
+			count = 1;
+	}
+	if (count < THREAD_POOL_MIN_WORKERS)
+		count = THREAD_POOL_MIN_WORKERS;
+	if (count > THREAD_POOL_MAX_WORKERS)
+		count = THREAD_POOL_MAX_WORKERS;
+	return count;
+}
+
+void TThreadPool::getAffinityList(std::vector<size_t>& cpus) {
+	// Processor numbering as used by TThreadAffinity (1..n)
+	// --> Leave out the default core chosen by TThreadAffinity, e.g. for the ALSA thread
+	cpus.clear();
+	TThreadAffinity mask;
+	size_t numa = mask.getCoreCount();
+	if (numa > 1) {
+		size_t reserved = mask.getDefaultCore();
+		for (size_t cpu=1; cpu<=numa; ++cpu) {
+			if (cpu != reserved)
+				cpus.push_back(cpu);
+		}
+	}
+}
+
+void TThreadPool::start() {
+	// Called with start lock held
+	if (started || terminated)
+		return;
+	started = true;
+
+	std::vector<size_t> cpus;
+	if (affinity)
+		getAffinityList(cpus);
+
+	size_t count = getWorkerCount();
+	for (size_t i=0; i<count; ++i) {
+		PThreadPoolWorker worker = new TThreadPoolWorker;
+		worker->owner = this;
+		worker->index = i;
+		worker->cpu = cpus.empty() ? 0 : cpus[i % cpus.size()];
+		worker->name = "Pool-Worker-" + std::to_string((size_u)(i + 1));
+		workers.push_back(worker);
+	}
+
+	// Workers are only started when all queues exist
+	size_t created = 0;
+	for (size_t i=0; i<workers.size(); ++i) {
+		PThreadPoolWorker worker = workers[i];
+		if (createJoinableThread(worker->thread, poolThreadDispatcher, worker, worker->name.c_str())) {
+			++created;
+		}
+	}
+	infoLog->write(util::csnprintf("[Threads] Started % of % thread pool workers.", created, workers.size()));
+}
+
+bool TThreadPool::enqueue(const TThreadPoolMethod& method, const ETaskPriority priority) {
+	// Start lock is held until task is counted as pending
+	// --> Workers must not leave on termination before the task is queued
+	app::TLockGuard<app::TMutex> guard(startMtx);
+	if (!started)
+		start();
+	if (terminated || workers.empty())
+		return false;
+
+	// Do not queue high priority task behind running tasks
+	if (priority == ETP_HIGH) {
+		app::TLockGuard<app::TCondition> lock(event);
+		if ((active + pending) >= workers.size())
+			return false;
+	}
+
+	// Push task to next worker queue round robin
+	PThreadPoolWorker worker = workers[next++ % workers.size()];
+	if (worker->thread == 0)
+		return false;
+	{
+		TThreadPoolTask task;
+		task.method = method;
+		task.queued = getMicroSeconds();
+		app::TLockGuard<app::TMutex> lock(worker->mtx);
+		worker->queues[priority].push_back(task);
+	}
+
+	// Wake up one idle worker
+	app::TLockGuard<app::TCondition> lock(event);
+	++pending;
+	if (pending > maxPending)
+		maxPending = pending;
+	event.signal();
+	return true;
+}
+
+bool TThreadPool::pop(TThreadPoolWorker& worker, TThreadPoolTask& task) {
+	// Take oldest task with highest priority from own queue
+	app::TLockGuard<app::TMutex> lock(worker.mtx);
+	for (size_t p=0; p<THREAD_POOL_PRIORITIES; ++p) {
+		TThreadPoolQueue& queue = worker.queues[p];
+		if (!queue.empty()) {
+			task = queue.front();
+			queue.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+
+bool TThreadPool::steal(TThreadPoolWorker& worker, TThreadPoolTask& task) {
+	// Take newest task with highest priority from other workers
+	size_t count = workers.size();
+	for (size_t p=0; p<THREAD_POOL_PRIORITIES; ++p) {
+		for (size_t i=1; i<count; ++i) {
+			TThreadPoolWorker& victim = *workers[(worker.index + i) % count];
+			app::TLockGuard<app::TMutex> lock(victim.mtx);
+			TThreadPoolQueue& queue = victim.queues[p];
+			if (!queue.empty()) {
+				task = queue.back();
+				queue.pop_back();
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+void TThreadPool::execute(TThreadPoolWorker& worker, TThreadPoolTask& task) {
+	{
+		app::TLockGuard<app::TCondition> lock(event);
+		if (pending > 0)
+			--pending;
+		++active;
+	}
+
+	int64_t latency = getMicroSeconds() - task.queued;
+	{
+		app::TLockGuard<app::TMutex> lock(worker.mtx);
+		worker.busy = true;
+		worker.latency += latency;
+		if (latency > worker.maxLatency)
+			worker.maxLatency = latency;
+	}
+
+	try {
+		task.method();
+	} catch (const std::exception& e)	{
+		std::string sExcept = e.what();
+		exceptionLog->write("[EXCEPTION] Exception in TThreadPool::execute() of [" + worker.name + "] :\n" + sExcept + "\n");
+	} catch (...) {
+		exceptionLog->write("[EXCEPTION] Unknown exception in TThreadPool::execute() of [" + worker.name + "]");
+	}
+
+	{
+		app::TLockGuard<app::TCondition> lock(event);
+		if (active > 0)
+			--active;
+	}
+
+	app::TLockGuard<app::TMutex> lock(worker.mtx);
+	worker.busy = false;
+	++worker.executed;
+}
+
+int TThreadPool::workerThreadHandler(TThreadPoolWorker& worker) {
+	if (worker.cpu > 0) {
+		try {
+			worker.affinity.setAffinity(worker.cpu, gettid());
+		} catch (const std::exception& e)	{
+			std::string sExcept = e.what();
+			exceptionLog->write("[EXCEPTION] Set affinity for [" + worker.name + "] failed :\n" + sExcept + "\n");
+		}
+	}
+
+	TThreadPoolTask task;
+	while (true) {
+		if (pop(worker, task)) {
+			execute(worker, task);
+			continue;
+		}
+		if (steal(worker, task)) {
+			{
+				app::TLockGuard<app::TMutex> lock(worker.mtx);
+				++worker.stolen;
+			}
+			execute(worker, task);
+			continue;
+		}
+
+		// Wait for new tasks, leave when terminated and all tasks are done
+		app::TLockGuard<app::TCondition> lock(event);
+		while (pending <= 0 && !terminated) {
+			event.wait();
+		}
+		if (pending <= 0 && terminated)
+			break;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+void TThreadPool::getStatistics(TThreadPoolStatistics& statistics) {
+	statistics.clear();
+	app::TLockGuard<app::TMutex> guard(startMtx);
+	{
+		app::TLockGuard<app::TCondition> lock(event);
+		statistics.queued = pending;
+		statistics.maxQueued = maxPending;
+	}
+	int64_t latency = 0;
+	for (size_t i=0; i<workers.size(); ++i) {
+		TThreadPoolWorker& worker = *workers[i];
+		app::TLockGuard<app::TMutex> lock(worker.mtx);
+		if (worker.thread != 0)
+			++statistics.workers;
+		if (worker.busy)
+			++statistics.busy;
+		statistics.executed += worker.executed;
+		statistics.stolen += worker.stolen;
+		latency += worker.latency;
+		if (worker.maxLatency > statistics.maxLatency)
+			statistics.maxLatency = worker.maxLatency;
+	}
+	if (statistics.executed > 0)
+		statistics.latency = latency / (int64_t)statistics.executed;
+}
+
+bool TThreadPool::isTerminated() {
+	app::TLockGuard<app::TCondition> lock(event);
+	return terminated;
+}
+
+void TThreadPool::terminate() {
+	app::TLockGuard<app::TMutex> guard(startMtx);
+	app::TLockGuard<app::TCondition> lock(event);
+	if (!terminated) {
+		terminated = true;
+		event.broadcast();
+	}
+}
+
+void TThreadPool::waitFor() {
+	// Do not hold start lock while waiting, since running tasks may enqueue further tasks
+	// --> Worker list is not changed after threads are started
+	{
+		app::TLockGuard<app::TMutex> lock(startMtx);
+		if (!started)
+			return;
+	}
+	if (!workers.empty()) {
+		infoLog->write("[Threads] Waiting for thread pool workers terminated...");
+		for (size_t i=0; i<workers.size(); ++i) {
+			PThreadPoolWorker worker = workers[i];
+			if (worker->thread != 0) {
+				int r = terminateThread(worker->thread);
+				if (util::checkFailed(r))
+					infoLog->write(util::csnprintf("[Threads] Waiting for worker [%] failed (%)", worker->name, r));
+			}
+		}
+		infoLog->write("[Threads] All thread pool workers terminated.");
+	}
+}
+
+} /* namespace app */
@@ -0,0 +1,166 @@
+/*
+ * threadpool.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: Dirk Brinkmeier
+ */
+
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include <deque>
+#include <string>
+#include <vector>
+#include <functional>
+#include "gcc.h"
+#include "classes.h"
+#include "nullptr.h"
+#include "logger.h"
+#include "threads.h"
+#include "semaphores.h"
+
+namespace app {
+
+enum ETaskPriority {
+	ETP_HIGH,
+	ETP_NORMAL,
+	ETP_LOW
+};
+
+STATIC_CONST size_t THREAD_POOL_PRIORITIES = ETP_LOW + 1;
+STATIC_CONST size_t THREAD_POOL_MIN_WORKERS = 2;
+STATIC_CONST size_t THREAD_POOL_MAX_WORKERS = 8;
+
+struct CThreadPoolWorker;
+
+#ifdef STL_HAS_TEMPLATE_ALIAS
+
+using TThreadPoolMethod = std::function<void()>;
+
+#else
+
+typedef std::function<void()> TThreadPoolMethod;
+
+#endif
+
+typedef struct CThreadPoolTask {
+	TThreadPoolMethod method;
+	int64_t queued;
+} TThreadPoolTask;
+
+#ifdef STL_HAS_TEMPLATE_ALIAS
+
+using TThreadPoolQueue = std::deque<TThreadPoolTask>;
+using PThreadPoolWorker = CThreadPoolWorker*;
+using TThreadPoolWorkerList = std::vector<PThreadPoolWorker>;
+
+#else
+
+typedef std::deque<TThreadPoolTask> TThreadPoolQueue;
+typedef CThreadPoolWorker* PThreadPoolWorker;
+typedef std::vector<PThreadPoolWorker> TThreadPoolWorkerList;
+
+#endif
+
+typedef struct CThreadPoolStatistics {
+	size_t workers;
+	size_t queued;      // Tasks waiting in worker queues
+	size_t maxQueued;
+	size_t busy;        // Workers executing a task
+	size_t executed;
+	size_t stolen;      // Tasks taken from queue of other worker
+	int64_t latency;    // Average delay from enqueue to execution in microseconds
+	int64_t maxLatency;
+
+	void clear() {
+		workers = 0;
+		queued = 0;
+		maxQueued = 0;
+		busy = 0;
+		executed = 0;
+		stolen = 0;
+		latency = 0;
+		maxLatency = 0;
+	}
+
+	CThreadPoolStatistics() {
+		clear();
+	}
+} TThreadPoolStatistics;
+
+typedef struct CThreadPoolWorker {
+	TThreadPool* owner;
+	pthread_t thread;
+	size_t index;
+	size_t cpu;
+	bool busy;
+	std::string name;
+	app::TMutex mtx;
+	TThreadAffinity affinity;
+	TThreadPoolQueue queues[THREAD_POOL_PRIORITIES];
+	size_t executed;
+	size_t stolen;
+	int64_t latency;
+	int64_t maxLatency;
+
+	CThreadPoolWorker() {
+		owner = nil;
+		thread = 0;
+		index = 0;
+		cpu = 0;
+		busy = false;
+		executed = 0;
+		stolen = 0;
+		latency = 0;
+		maxLatency = 0;
+	}
+} TThreadPoolWorker;
+
+
+// Pool of worker threads for short living tasks (e.g. web actions, unlinking backup files)
+// --> Each worker has its own queue for every priority, idle workers steal tasks from other queues
+// --> Threads are created on first use, since the process may be daemonized after construction
+// --> Pending tasks are executed before the workers terminate
+// --> High priority tasks are refused if no worker is idle, the caller runs them in a detached thread
+//     so that a long running web action does not block all other actions
+class TThreadPool : public TObject, private TThreadUtil {
+private:
+	TThreadPoolWorkerList workers;
+	app::TMutex startMtx;
+	app::TCondition event;
+	size_t next;
+	size_t pending;
+	size_t active;
+	size_t maxPending;
+	size_t size;
+	bool affinity;
+	bool started;
+	bool terminated;
+	PLogFile infoLog;
+	PLogFile exceptionLog;
+
+	void start();
+	void clear();
+	size_t getWorkerCount() const;
+	void getAffinityList(std::vector<size_t>& cpus);
+	bool pop(TThreadPoolWorker& worker, TThreadPoolTask& task);
+	bool steal(TThreadPoolWorker& worker, TThreadPoolTask& task);
+	void execute(TThreadPoolWorker& worker, TThreadPoolTask& task);
+
+public:
+	bool enqueue(const TThreadPoolMethod& method, const ETaskPriority priority = ETP_NORMAL);
+	void configure(const size_t size, const bool affinity);
+	void getStatistics(TThreadPoolStatistics& statistics);
+	bool isTerminated();
+	void terminate();
+	void waitFor();
+
+	int workerThreadHandler(TThreadPoolWorker& worker);
+
+	TThreadPool(TLogFile& infoLog, TLogFile& exceptionLog);
+	virtual ~TThreadPool();
+};
+
+} /* namespace app */
+
+#endif /* THREADPOOL_H_ */
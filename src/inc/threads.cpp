@@ -15,6 +15,8 @@
 #include "ansi.h"
 #include "atomic.h"
 #include "threads.h"
+#include "threadpool.h"
+#include "detach.h"
 #include "nullptr.h"
 #include "convert.h"
 #include "sysutils.h"
@@ -169,6 +171,15 @@ void TThreadAffinity::releaseCpuMask() {
 	}
 }
 
+size_t TThreadAffinity::getDefaultCore() const {
+	// Use a fixed core depending on core count
+	if (numa > 2)
+		return numa / 2; // e.g. second CPU of 4 CPUs == 2!
+	if (numa > 1)
+		return 2;
+	return 1;
+}
+
 ssize_t TThreadAffinity::setAffinity(size_t cpu) {
 	pid_t tid = TThreadUtil::gettid();
 	return setAffinity(cpu, tid);
@@ -185,12 +196,7 @@ ssize_t TThreadAffinity::setAffinity(size_t cpu, pid_t tid) {
 		if (util::assigned(cpuset)) {
 			// CPU == 0 --> Use a fixed core depending on core count
 			if (cpu == 0 || cpu > numa) {
-				if (numa > 2) {
-					cpu = numa / 2; // e.g. second CPU of 4 CPUs == 2!
-				} else {
-					if (numa > 1) cpu = 2;
-					else cpu = 1;
-				}
+				cpu = getDefaultCore();
 			}
 			// Use core from 1 to max.core count:
 			//   - First logical core for setAffinity() is 1
@@ -706,15 +712,21 @@ void TManagedThread::waitFor() {
 TThreadController::TThreadController(TLogFile& infoLog, TLogFile& exeptionLog) {
 	this->infoLog = &infoLog;
 	this->exceptionLog = &exeptionLog;
+	pool = new TThreadPool(infoLog, exeptionLog);
 	initialize();
 }
 
 
 TThreadController::~TThreadController() {
 	clear();
+	TIntermittentThread::setThreadPool(nil);
+	util::freeAndNil(pool);
 }
 
 void TThreadController::initialize() {
+	// Execute intermittent threads via thread pool
+	TIntermittentThread::setThreadPool(pool);
+
 	// Removed signal usage, left method as an example for installing a customized signal handler
 	// addSignalHandler(signalDispatcher, SIGRTBTHREAD);
 }
@@ -783,6 +795,7 @@ void TThreadController::addSignalHandler(TSignalHandler handler, int signal)
 
 void TThreadController::terminate() {
 	infoLog->write("[Threads] Shutdown threads.");
+	pool->terminate();
 	
 #ifndef STL_HAS_RANGE_FOR
 	PBaseThread o;
@@ -826,6 +839,9 @@ void TThreadController::waitFor() {
 	}
 #endif
 
+	// Queued pool tasks are executed before workers leave
+	pool->waitFor();
+
 	infoLog->write("[Threads] All threads terminated.");
 }
 
@@ -851,6 +867,24 @@ void TThreadController::clear()
 
 
 
+// Content hash of dynamic payload for compression cache and entity tags
+static uint64_t getContentHash(const void* data, const size_t size) {
+	uLong crc = crc32(0L, Z_NULL, 0);
+	uLong adler = adler32(0L, Z_NULL, 0);
+	crc = crc32(crc, (const Bytef*)data, (uInt)size);
+	adler = adler32(adler, (const Bytef*)data, (uInt)size);
+	return ((uint64_t)(crc & 0xFFFFFFFF) << 32) | (uint64_t)(adler & 0xFFFFFFFF);
+}
+
+// CPU time of calling thread in microseconds
+static int64_t getThreadTime() {
+	struct timespec ts;
+	if (EXIT_SUCCESS == clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts))
+		return (int64_t)ts.tv_sec * 1000000 + (int64_t)ts.tv_nsec / 1000;
+	return 0;
+}
+
+
 TThreadDataItem::TThreadDataItem() {
 	prime();
 }
@@ -870,6 +904,7 @@ TThreadDataItem::~TThreadDataItem() {
 }
 
 void TThreadDataItem::prime() {
+	hash = 0;
 	refc = 0;
 	bIsZipped = false;
 	timestamp = util::now();
@@ -895,6 +930,11 @@ void TThreadDataItem::finalize(bool free) {
 	}
 }
 
+std::string TThreadDataItem::getETag() const {
+	// Strong entity tag from content hash, differs by content encoding
+	return util::cprintf("\"%016llx%s\"", (unsigned long long)hash, bIsZipped ? "-gz" : "");
+}
+
 void TThreadDataItem::getData(const void*& data, size_t& size) {
 	data = this->data.data();
 	size = this->data.size();
@@ -1124,9 +1164,25 @@ PThreadDataItem TThreadData::dataNeeded(const util::TVariantValues& params, cons
 		onDataNeeded(*this, p, n, params, session, headers, zipped, cached, error);
 		if (util::assigned(p) && n > 0) {
 			char* q = nil;
+			size_t size = n;
+			uint64_t key = getContentHash(p, n);
 			if (zipped) {
-				// GZip data to new buffer
-		    	n = zip.gzip((char*)p, q, n);
+				// Compress only if content changed since last request
+				if (lookupCache(key, q, n)) {
+					statistics.cached++;
+				} else {
+					// GZip data to new buffer
+					int64_t start = getThreadTime();
+					zip.setLevel(getCompressionLevel(n));
+					n = zip.gzip((char*)p, q, n);
+					statistics.cpuTime += getThreadTime() - start;
+					statistics.compressed++;
+					updateCache(key, q, n);
+				}
+				statistics.input += size;
+				statistics.output += n;
+				if (size > n)
+					statistics.saved += size - n;
 			} else {
 				// Just a plain copy...
 				q = new char[n];
@@ -1136,6 +1192,7 @@ PThreadDataItem TThreadData::dataNeeded(const util::TVariantValues& params, cons
 			if (util::assigned(q) && n > 0) {
 				o = new TThreadDataItem(q, n);
 				o->setZipped(zipped);
+				o->setHash(key);
 				list.push_back(o);
 			}
 		}
@@ -1148,6 +1205,85 @@ bool TThreadData::compareParams(const util::TVariantValues& params) {
 	return hash == params.hash();
 }
 
+int TThreadData::getCompressionLevel(const size_t size) const {
+	// Small payloads are compressed with best ratio, large payloads with faster levels
+	int level = Z_BEST_COMPRESSION;
+	if (size > 1024 * 1024)
+		level = 3;
+	else if (size > 256 * 1024)
+		level = 5;
+	else if (size > 64 * 1024)
+		level = 7;
+
+	// Reduce level further if system is busy
+	double load;
+	if (1 == getloadavg(&load, 1)) {
+		size_t cores = sysutil::getProcessorCount();
+		if (cores > 0 && cores != std::string::npos) {
+			double usage = load / (double)cores;
+			if (usage > 1.0)
+				level = Z_BEST_SPEED;
+			else if (usage > 0.75)
+				level = std::min(level, 4);
+		}
+	}
+	return level;
+}
+
+bool TThreadData::lookupCache(const uint64_t hash, char*& data, size_t& size) {
+	// Called with data lock held
+	for (size_t i=0; i<cache.size(); ++i) {
+		TThreadDataCacheItem& item = cache[i];
+		if (item.hash == hash && !item.data.empty()) {
+			data = new char[item.data.size()];
+			::memcpy(data, item.data.data(), item.data.size());
+			size = item.data.size();
+			item.timestamp = util::now();
+			return true;
+		}
+	}
+	return false;
+}
+
+void TThreadData::updateCache(const uint64_t hash, const char* data, const size_t size) {
+	// Called with data lock held
+	// --> Replace least recently used entry if cache is full
+	if (!util::assigned(data) || size <= 0)
+		return;
+	size_t idx = 0;
+	if (cache.size() < THREAD_DATA_CACHE_SIZE) {
+		cache.resize(cache.size() + 1);
+		idx = util::pred(cache.size());
+	} else {
+		for (size_t i=1; i<cache.size(); ++i) {
+			if (cache[i].timestamp < cache[idx].timestamp)
+				idx = i;
+		}
+	}
+	TThreadDataCacheItem& item = cache[idx];
+	item.hash = hash;
+	item.data.assign(data, size);
+	item.timestamp = util::now();
+}
+
+void TThreadData::revalidated(const size_t size) {
+	std::lock_guard<std::mutex> lock(dataMtx);
+	statistics.revalidated++;
+	statistics.saved += size;
+}
+
+void TThreadData::getStatistics(TThreadDataStatistics& statistics) {
+	// Add values to given statistics, e.g. to sum up values for all links
+	std::lock_guard<std::mutex> lock(dataMtx);
+	statistics.compressed += this->statistics.compressed;
+	statistics.cached += this->statistics.cached;
+	statistics.revalidated += this->statistics.revalidated;
+	statistics.input += this->statistics.input;
+	statistics.output += this->statistics.output;
+	statistics.saved += this->statistics.saved;
+	statistics.cpuTime += this->statistics.cpuTime;
+}
+
 void TThreadData::finalize(PThreadDataItem& data) {
 	std::lock_guard<std::mutex> lock(dataMtx);
 	bool free = delay <= 0;
@@ -1173,6 +1309,7 @@ void TThreadData::clear()
 #endif
 	hash = 0;
 	list.clear();
+	cache.clear();
 	release(true);
 }
 
@@ -152,6 +152,7 @@ public:
 	ssize_t setAffinity(size_t cpu = 0);
 	ssize_t setAffinity(size_t cpu, pid_t tid);
 	size_t getCoreCount() const { return numa; };
+	size_t getDefaultCore() const;
 
 	TThreadAffinity();
 	virtual ~TThreadAffinity();
@@ -344,6 +345,7 @@ public:
 class TThreadController : public TObject {
 private:
 	TThreadList threadList;
+	PThreadPool pool;
 	std::mutex mtx;
 	app::TLogFile *infoLog;
 	app::TLogFile *exceptionLog;
@@ -425,6 +427,8 @@ public:
 			return thread;
 		}
 
+	TThreadPool& getThreadPool() { return *pool; };
+
 	void terminate();
 	void waitFor();
 
@@ -480,9 +484,54 @@ struct TWebDataReceiver {
 };
 
 
+STATIC_CONST size_t THREAD_DATA_CACHE_SIZE = 8;
+
+typedef struct CThreadDataCacheItem {
+	uint64_t hash;
+	util::TBuffer data;
+	util::TTimePart timestamp;
+
+	CThreadDataCacheItem() {
+		hash = 0;
+		timestamp = 0;
+	}
+} TThreadDataCacheItem;
+
+typedef struct CThreadDataStatistics {
+	size_t compressed;  // Payloads compressed
+	size_t cached;      // Compressed payloads taken from cache
+	size_t revalidated; // Payloads answered by "304 Not Modified"
+	size_t input;       // Payload bytes before compression
+	size_t output;      // Payload bytes after compression
+	size_t saved;       // Bytes not transferred by compression and revalidation
+	int64_t cpuTime;    // Thread CPU time used for compression in microseconds
+
+	void clear() {
+		compressed = 0;
+		cached = 0;
+		revalidated = 0;
+		input = 0;
+		output = 0;
+		saved = 0;
+		cpuTime = 0;
+	}
+
+	CThreadDataStatistics() {
+		clear();
+	}
+} TThreadDataStatistics;
+
+#ifdef STL_HAS_TEMPLATE_ALIAS
+using TThreadDataCache = std::vector<app::TThreadDataCacheItem>;
+#else
+typedef std::vector<app::TThreadDataCacheItem> TThreadDataCache;
+#endif
+
+
 class TThreadDataItem : public TObject {
 private:
 	util::TBuffer data;
+	uint64_t hash;
 	int refc;
 	bool bIsZipped;
 	util::TTimePart timestamp;
@@ -493,6 +542,10 @@ public:
 	bool isValid() const { return hasData(); };
 	bool isZipped() const { return bIsZipped; };
 	void setZipped(const bool value) { bIsZipped = value; };
+	bool hasHash() const { return hash != 0; };
+	uint64_t getHash() const { return hash; };
+	void setHash(const uint64_t value) { hash = value; };
+	std::string getETag() const;
 	int getRefCount() const { return refc; };
 	void decRefCount() { if (refc > 0) --refc; };
 	util::TTimePart getTimeStamp() const { return timestamp; };
@@ -517,6 +570,8 @@ private:
 	mutable std::mutex dataMtx;
 	TThreadDataList list;
 	util::TZLib zip;
+	TThreadDataCache cache;
+	TThreadDataStatistics statistics;
 	size_t hash;
 	bool bUseZip;
 	util::TTimePart delay;
@@ -529,6 +584,9 @@ private:
 	PThreadDataItem dataNeeded(const util::TVariantValues& params, const util::TVariantValues& session, util::TVariantValues& headers,
 			bool& zipped, bool& cached, int& error, bool forceUpdate = false);
 	bool compareParams(const util::TVariantValues& params);
+	int getCompressionLevel(const size_t size) const;
+	bool lookupCache(const uint64_t hash, char*& data, size_t& size);
+	void updateCache(const uint64_t hash, const char* data, const size_t size);
 	size_t release(bool force = false);
 
 	void executeAction(const TThreadDataReceived& handler, util::TBuffer& data, const std::string& url,
@@ -546,6 +604,8 @@ public:
 	void setDelay(util::TTimePart delay);
 	void finalize(PThreadDataItem& data);
 	size_t garbageCollector();
+	void revalidated(const size_t size);
+	void getStatistics(TThreadDataStatistics& statistics);
 
 	PThreadDataItem setData(util::TBuffer& data, const std::string& url,
 			const util::TVariantValues& params, const util::TVariantValues& session,
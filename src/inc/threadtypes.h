@@ -57,6 +57,7 @@ class TBaseThread;
 class TManagedThread;
 class TDetachedThread;
 class TThreadController;
+class TThreadPool;
 class TThreadDataItem;
 class TThreadData;
 
@@ -70,6 +71,7 @@ using PDetachedThread = TDetachedThread*;
 using TThreadList = std::vector<app::PBaseThread>;
 
 using PThreadController = TThreadController*;
+using PThreadPool = TThreadPool*;
 using PThreadDataItem = TThreadDataItem*;
 using PThreadData = TThreadData*;
 
@@ -89,6 +91,7 @@ typedef TDetachedThread* PDetachedThread;
 typedef std::vector<app::PBaseThread> TThreadList;
 
 typedef TThreadController* PThreadController;
+typedef TThreadPool* PThreadPool;
 typedef TThreadDataItem* PThreadDataItem;
 typedef TThreadData* PThreadData;
 
@@ -124,6 +124,13 @@ STATIC_CONST size_t HTTP_WEB_SOCKET_PROTOCOL_SIZE = STR_CONST_LEN(HTTP_WEB_SOCKE
 STATIC_CONST char HTTP_WEB_SOCKET_VERSION[] = "Sec-WebSocket-Version";
 STATIC_CONST size_t HTTP_WEB_SOCKET_VERSION_SIZE = STR_CONST_LEN(HTTP_WEB_SOCKET_VERSION);
 
+STATIC_CONST char HTTP_WEB_SOCKET_EXTENSIONS[] = "Sec-WebSocket-Extensions";
+STATIC_CONST size_t HTTP_WEB_SOCKET_EXTENSIONS_SIZE = STR_CONST_LEN(HTTP_WEB_SOCKET_EXTENSIONS);
+
+// See https://tools.ietf.org/html/rfc7692
+STATIC_CONST char HTTP_WEB_SOCKET_DEFLATE[] = "permessage-deflate";
+STATIC_CONST char HTTP_WEB_SOCKET_DEFLATE_RESPONSE[] = "permessage-deflate; server_no_context_takeover; client_no_context_takeover";
+
 
 STATIC_CONST size_t HTTP_DIGEST_SIZE = 34;
 STATIC_CONST size_t HTTP_NONCE_SIZE = 256;
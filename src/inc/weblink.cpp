@@ -218,5 +218,20 @@ size_t TWebLinkList::garbageCollector() {
 	return r;
 }
 
+void TWebLinkList::getStatistics(TThreadDataStatistics& statistics) {
+	app::TReadWriteGuard<app::TReadWriteLock> lock(listLck, RWL_READ);
+	statistics.clear();
+	if (!list.empty()) {
+		PWebLink o;
+		TWebLinkMap::const_iterator it = list.begin();
+		while (it != list.end()) {
+			o = it->second;
+			if (util::assigned(o))
+				o->getDataHandler().getStatistics(statistics);
+			it++;
+		}
+	}
+}
+
 
 } /* namespace app */
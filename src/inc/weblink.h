@@ -121,6 +121,7 @@ public:
 
 	void debugOutput(const std::string& preamble);
 	size_t garbageCollector();
+	void getStatistics(TThreadDataStatistics& statistics);
 
 	template<typename request_t, typename class_t>
 		inline void addLink(const std::string& url, request_t &&onDataRequest, class_t &&owner,
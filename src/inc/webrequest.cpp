@@ -5,6 +5,8 @@
  *      Author: Dirk Brinkmeier
  */
 
+#include <fcntl.h>
+#include <unistd.h>
 #include <iostream>
 #include <cstring>
 #include "webtypes.h"
@@ -17,6 +19,7 @@
 #include "convert.h"
 #include "compare.h"
 #include "sockets.h"
+#include "websockets.h"
 #include "bitmap.h"
 #include "ASCII.h"
 #include "json.h"
@@ -108,6 +111,7 @@ namespace app {
 
 TWebRequest::TWebRequest(struct MHD_Connection *connection, TWebSessionMap& sessions, std::mutex& sessionMtx, std::mutex& requestMtx, const size_t sessionDelta, const TWebConfig& config) {
 	prime();
+	pooled = false;
 	setName("TWebServer (c) db Application [SVN" + std::string(SVN_REV) + "]");
 	setSessionDelta(sessionDelta);
 	this->sessionMtx = &sessionMtx;
@@ -115,6 +119,7 @@ TWebRequest::TWebRequest(struct MHD_Connection *connection, TWebSessionMap& sess
 	this->sessions = &sessions;
 	this->authType = config.auth;
 	this->secure = config.useHttps;
+	this->sendfile = config.sendFile && !config.useHttps;
 	this->realm = config.realm;
 	this->debug = config.debug;
 	prepare(connection);
@@ -128,10 +133,12 @@ TWebRequest::~TWebRequest() {
 void TWebRequest::prime() {
 	authenticated = false;
 	secure = false;
+	sendfile = false;
 	ranged = false;
 	multipart = false;
 	xmlRequest = false;
 	upgradeRequest = false;
+	socketDeflate = false;
 	urlEncoded = false;
 	hasModifiedIf = false;
 	zipAllowed = false;
@@ -578,6 +585,10 @@ std::string TWebRequest::getWebSocketVersion(struct MHD_Connection *connection)
 	return util::trim(getHeaderValue(connection, MHD_HEADER_KIND, HTTP_WEB_SOCKET_VERSION));
 }
 
+std::string TWebRequest::getWebSocketExtensions(struct MHD_Connection *connection) const {
+	return util::trim(getHeaderValue(connection, MHD_HEADER_KIND, HTTP_WEB_SOCKET_EXTENSIONS));
+}
+
 std::string TWebRequest::getContentType(struct MHD_Connection *connection) const {
 	std::string s = getHeaderValue(connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_CONTENT_TYPE);
 	if (!s.empty()) {
@@ -1171,7 +1182,7 @@ MHD_Result TWebRequest::sendResponseFromFile(struct MHD_Connection *connection,
 				// --> File content may have been changed!
 				if (debugger)
 					std::cout << "sendResponseFromFile[ETag](" << file->getName() << ") --> Entity tag from client = <" << ETag << ">" << std::endl;
-				if (ETag == file->getETag()) {
+				if (matchesETag(ETag, file->getETag())) {
 					if (util::isMemberOf(method, HTTP_GET, HTTP_POST)) {
 						if (debugger) {
 							std::cout << "    Entity tag from client for <" << file->getName() << "> fits file tag." << std::endl;
@@ -1313,6 +1324,19 @@ MHD_Result TWebRequest::sendResponseFromVirtualFile(struct MHD_Connection *conne
 			if (util::assigned(htmlPostBuffer)) {
 				if (debugger)
 					std::cout << "sendResponseFromVirtualFile[Data] Data for link \"" << link->getURL() << "\" received, size = " << size << std::endl;
+
+				// Content unchanged since last request: send "Not modified" for matching entity tag
+				if (htmlPostBuffer->hasHash() && util::isMemberOf(method, HTTP_GET, HTTP_HEAD)) {
+					std::string ETag = getHeaderValue(connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_IF_NONE_MATCH);
+					if (matchesETag(ETag, htmlPostBuffer->getETag())) {
+						if (debugger)
+							std::cout << "sendResponseFromVirtualFile[ETag] Content for link \"" << link->getURL() << "\" not modified [HTTP_NOT_MODIFIED/304]" << std::endl;
+						link->getDataHandler().revalidated(size);
+						error = MHD_HTTP_NOT_MODIFIED;
+						data = nil;
+						size = 0;
+					}
+				}
 			} else {
 				if (debugger)
 					std::cout << "sendResponseFromVirtualFile[Data] No data for link \"" << link->getURL() << "\" received." << std::endl;
@@ -1486,7 +1510,7 @@ MHD_Result TWebRequest::sendResponseFromDirectory(struct MHD_Connection *connect
 				// --> File content may have been changed!
 				if (debugger)
 					std::cout << "sendResponseFromDirectory[ETag](" << file.getName() << ") --> Entity tag from client = <" << ETag << ">" << std::endl;
-				if (ETag == file.getETag()) {
+				if (matchesETag(ETag, file.getETag())) {
 					if (util::isMemberOf(method, HTTP_GET, HTTP_POST)) {
 						if (debugger) {
 							std::cout << "    Entity tag from client for <" << file.getName() << "> fits file tag." << std::endl;
@@ -1734,7 +1758,7 @@ MHD_Result TWebRequest::sendResponseFromBuffer(struct MHD_Connection *connection
 }
 
 
-MHD_Result TWebRequest::sendUpgradeResponse(struct MHD_Connection *connection, MHD_UpgradeHandler method, TWebServer* owner) {
+MHD_Result TWebRequest::sendUpgradeResponse(struct MHD_Connection *connection, MHD_UpgradeHandler method, TWebServer* owner, const bool deflate) {
 	MHD_Result retVal = MHD_NO;
 	if (util::assigned(method) && util::assigned(owner)) {
 
@@ -1766,6 +1790,13 @@ MHD_Result TWebRequest::sendUpgradeResponse(struct MHD_Connection *connection, M
 				MHD_add_response_header (response, HTTP_WEB_SOCKET_PROTOCOL, "chat");
 			}
 
+			// Accept permessage-deflate if enabled and offered by client
+			// --> Negotiated compression is taken by the upgrade handler from this request
+			socketDeflate = deflate && TWebSockets::hasDeflateExtension(getWebSocketExtensions(connection));
+			if (socketDeflate) {
+				MHD_add_response_header (response, HTTP_WEB_SOCKET_EXTENSIONS, HTTP_WEB_SOCKET_DEFLATE_RESPONSE);
+			}
+
 			// Add response upgrade header
 			MHD_add_response_header (response, MHD_HTTP_HEADER_UPGRADE, "websocket");
 
@@ -1865,8 +1896,10 @@ MHD_Result TWebRequest::createResponseFromInode(struct MHD_Connection *connectio
 	MHD_Result retVal = MHD_YES;
 	PWebRange range = nil;
 	size_t size = 0;
+	size_t offset = 0;
 	bool ok = true;
 	bool changed = false;
+	bool direct = false;
 
 	// Check for ranged request
 	if (isRangedRequest()) {
@@ -1969,14 +2002,33 @@ MHD_Result TWebRequest::createResponseFromInode(struct MHD_Connection *connectio
 						end = std::min(range->end, util::pred(file.getSize()));
 					}
 					size = end - start + 1;
+					offset = start;
 				} else {
 					size = file.getSize();
 				}
-				response = MHD_create_response_from_callback (	size,
-																RESPONSE_BLOCK_SIZE,
-																&inodeReaderCallbackDispatcher,
-																this,
-																&inodeReaderFreeCallbackDispatcher );
+
+				// Plain HTTP with "UseSendFile" enabled: let the kernel send the file via sendfile() without copying to user space
+				// --> MHD takes ownership of the duplicated handle and closes it with the response
+				// --> Buffered callback is used for TLS, data must be encrypted in user space anyway
+				// --> Disabled by default, compare both paths on the target with "rmpbench transfer"
+				if (sendfile) {
+					THandle fd = currentInode.duplicate();
+					if (fd != INVALID_HANDLE_VALUE) {
+						response = MHD_create_response_from_fd_at_offset64(size, fd, offset);
+						if (util::assigned(response)) {
+							direct = true;
+						} else {
+							::close(fd);
+						}
+					}
+				}
+				if (!direct) {
+					response = MHD_create_response_from_callback (	size,
+																	RESPONSE_BLOCK_SIZE,
+																	&inodeReaderCallbackDispatcher,
+																	this,
+																	&inodeReaderFreeCallbackDispatcher );
+				}
 			} else {
 				error = MHD_HTTP_NOT_FOUND;
 				retVal = MHD_NO;
@@ -2015,6 +2067,10 @@ MHD_Result TWebRequest::createResponseFromInode(struct MHD_Connection *connectio
 		send += size;
 	}
 
+	// Inode is not needed for file handle response after range headers were added
+	if (direct)
+		currentInode.close();
+
 	if (debug)
 		std::cout << "createResponseFromInode[Build](" << file.getName() << ") Size = " << size << " Error = " << error << std::endl;
 
@@ -2271,10 +2327,27 @@ MHD_Result TWebRequest::buildResponseHeader(struct MHD_Connection *connection, s
 		// Set "Validator Header Fields" as needed
 		if (addCachingHeaders) {
 
-			if (caching) {
+			// Dynamic content with entity tag of content hash must be revalidated by client on every request
+			// --> Response can be stored by client, unchanged content is answered by "Not modified"
+			// --> Links registered as cached keep their expiration time and send the entity tag as well
+			bool tagged = !util::assigned(file) && util::assigned(link) && util::assigned(htmlPostBuffer) && htmlPostBuffer->hasHash();
+
+			if (tagged && !caching) {
 
-				if (retVal == MHD_YES && assigned(file)) {
-					s = file->getETag();
+				if (retVal == MHD_YES) {
+					s = htmlPostBuffer->getETag();
+					retVal = addResponseHeader(response, MHD_HTTP_HEADER_ETAG, s);
+				}
+
+				if (retVal == MHD_YES) {
+					s = "private, no-cache, must-revalidate";
+					retVal = addResponseHeader(response, MHD_HTTP_HEADER_CACHE_CONTROL, s);
+				}
+
+			} else if (caching) {
+
+				if (retVal == MHD_YES && (tagged || assigned(file))) {
+					s = tagged ? htmlPostBuffer->getETag() : file->getETag();
 					retVal = addResponseHeader(response, MHD_HTTP_HEADER_ETAG, s);
 				}
 
@@ -2420,6 +2493,8 @@ std::string TWebRequest::createETag(const util::TFile* file, const app::TWebLink
 
 	// 2. Return entity tag derived from virtual file link properties
 	if (util::assigned(link) && util::assigned(htmlPostBuffer)) {
+		if (htmlPostBuffer->hasHash())
+			return htmlPostBuffer->getETag();
 		return util::cprintf(fmt, link->getHash(), htmlPostBuffer->getTimeStamp(), htmlPostBuffer->getSize());
 	}
 
@@ -2456,6 +2531,17 @@ std::string TWebRequest::randomETag(bool upper)
 	return std::string(retVal, 20);
 }
 
+bool TWebRequest::matchesETag(const std::string& header, const std::string& tag) const {
+	// See https://www.rfc-editor.org/rfc/rfc9110#field.if-none-match
+	// --> "*" matches any current representation
+	// --> Header may contain a list of (weak) entity tags
+	if (header.empty() || tag.empty())
+		return false;
+	if (util::trim(header) == "*")
+		return true;
+	return std::string::npos != header.find(tag);
+}
+
 
 bool TWebRequest::hasDynamicContent(const util::TFile* file, const app::TWebLink* link) {
 	bool vary = false;
@@ -2706,6 +2792,15 @@ void TInode::close() {
 	}
 }
 
+THandle TInode::duplicate() const {
+	if (isOpen()) {
+		int fd = fileno(inode);
+		if (fd != INVALID_HANDLE_VALUE)
+			return fcntl(fd, F_DUPFD_CLOEXEC, 0);
+	}
+	return INVALID_HANDLE_VALUE;
+}
+
 bool TInode::seek(const size_t pos) {
 	if (isOpen()) {
 		if (position != pos) {
@@ -67,6 +67,7 @@ public:
 	const std::string& getBoundary() const { return boundary; };
 	bool parseRanges(const std::string header);
 
+	THandle duplicate() const;
 	bool seek(const size_t pos);
 	ssize_t read(void* buffer, const size_t position, const size_t size);
 
@@ -106,7 +107,9 @@ private:
 	int httpStatusCode;
 	bool authenticated;
 	bool finalized;
+	bool pooled;
 	bool secure;
+	bool sendfile;
 	bool debug;
 
 	mutable std::string ranges;
@@ -116,6 +119,7 @@ private:
 	mutable bool multipart;
 	mutable bool xmlRequest;
 	mutable bool upgradeRequest;
+	bool socketDeflate;
 	mutable bool urlEncoded;
 	mutable bool zipAllowed;
 	mutable bool zipContent;
@@ -172,6 +176,7 @@ private:
 	bool hasDynamicContent(const util::TFile* file, const app::TWebLink* link);
 	std::string createETag(const util::TFile* file, const app::TWebLink* link, bool upper = false);
 	std::string randomETag(bool upper);
+	bool matchesETag(const std::string& header, const std::string& tag) const;
 
 	bool hasModifiedIfHeader(struct MHD_Connection *connection) const;
 	bool isMultipartMessage(struct MHD_Connection *connection) const;
@@ -188,6 +193,7 @@ private:
 	std::string getWebSocketKey(struct MHD_Connection *connection) const;
 	std::string getWebSocketProtocol(struct MHD_Connection *connection) const;
 	std::string getWebSocketVersion(struct MHD_Connection *connection) const;
+	std::string getWebSocketExtensions(struct MHD_Connection *connection) const;
 	void findSessionValue(struct MHD_Connection *connection);
 
 	MHD_Result createPostProcessor(struct MHD_Connection *connection, const std::string& url, const EHttpMethod method, const size_t size);
@@ -208,6 +214,7 @@ public:
 	bool isMultipartMessage() const;
 	bool isXMLHttpRequest() const;
 	bool isUpgradeRequest() const;
+	bool isSocketDeflated() const { return socketDeflate; }
 	bool isZippedContent() const;
 	bool isRangedRequest() const;
 	bool isUrlEncodedMessage() const;
@@ -222,6 +229,8 @@ public:
 	std::string getSessionValue(const std::string& key) const;
 	util::PFile getFile() const { return parsedFile; }
 	int getRefCount() const { return refC; }
+	bool isPooled() const { return pooled; }
+	void setPooled(const bool value) { pooled = value; }
 	util::TTimePart getTimeStamp() const { return timestamp; }
 	void setTimeStamp() { timestamp = util::now(); }
 	int getStatusCode() const { return httpStatusCode; };
@@ -236,7 +245,7 @@ public:
 
 	MHD_Result executePostProcess(const char *upload_data, size_t *upload_data_size);
 
-	MHD_Result sendUpgradeResponse(struct MHD_Connection *connection, MHD_UpgradeHandler method, TWebServer* owner);
+	MHD_Result sendUpgradeResponse(struct MHD_Connection *connection, MHD_UpgradeHandler method, TWebServer* owner, const bool deflate = false);
 	MHD_Result sendResponseFromBuffer(struct MHD_Connection *connection, EHttpMethod method, const EWebTransferMode mode,
 			const void *const buffer, const size_t size, const util::TVariantValues& headers, const bool persist, const bool caching, const bool zipped,
 			const std::string& mime, int& error);
@@ -19,6 +19,7 @@
 #include "tables.h"
 #include "ansi.h"
 #include "credentials.h"
+#include "threadpool.h"
 #include "microhttpd/internal.h"
 #include "../config.h"
 #include <cstring>
@@ -134,6 +135,7 @@ TWebServer::TWebServer(const std::string& name, const std::string& documentRoot,
 	web.rejectedDeleteAge = sessionTimer->getDelay() * 90 / 100;
 	executer.setExecHandler(&app::TWebServer::actionAsyncExecuter, this);
 	executer.setName("Executer-" + getName());
+	executer.setPriority(app::ETP_HIGH);
 	defaultToken = new app::TWebToken("default");
 	wtAppDescription = nil;
 	wtAppJumbotron = nil;
@@ -407,9 +409,15 @@ struct MHD_Daemon* TWebServer::startServer(unsigned int flags) {
 	int connections = (numa > 1) ? web.maxConnectionsPerCPU * numa : web.maxConnectionsPerCPU;
 	data.threadLimit = connections;
 
+	// Thread pool needs internal polling threads without thread per connection
+	bool pooled = web.threading == WTH_POOL;
+	unsigned int workers = pooled ? getThreadPoolSize() : 0;
+
 	// Add standard options
 	TWebOption options;
 	options.add(MHD_OPTION_CONNECTION_LIMIT, connections, NULL);
+	if (pooled)
+		options.add(MHD_OPTION_THREAD_POOL_SIZE, workers, NULL);
 	options.add(MHD_OPTION_CONNECTION_TIMEOUT, CONNECTION_TIMEOUT, NULL);
 	options.add(MHD_OPTION_NOTIFY_COMPLETED, (intptr_t)requestCompletedCallbackDispatcher, this);
 	options.add(MHD_OPTION_EXTERNAL_LOGGER, (intptr_t)customErrorLogDispatcher, this);
@@ -444,7 +452,7 @@ struct MHD_Daemon* TWebServer::startServer(unsigned int flags) {
 	flags |= MHD_USE_INTERNAL_POLLING_THREAD;
 
 	// Use one thread per connection?
-	if (web.threaded) {
+	if (web.threading == WTH_CONNECTION) {
 		flags |= MHD_USE_THREAD_PER_CONNECTION;
 	}
 
@@ -464,7 +472,8 @@ struct MHD_Daemon* TWebServer::startServer(unsigned int flags) {
 	}
 
 #ifdef HAS_EPOLL
-	if (!web.threaded) {
+	// Every pool worker uses its own epoll set
+	if (web.threading != WTH_CONNECTION) {
 		flags |= MHD_USE_EPOLL;
 	}
 #endif
@@ -472,6 +481,11 @@ struct MHD_Daemon* TWebServer::startServer(unsigned int flags) {
 	// Get port number from protocol
 	port = web.port > 0 ? web.port : (web.useHttps ? 443 : 80);
 
+	// Pool workers inherit the affinity mask of the calling thread
+	// --> Keep workers off the core reserved for the ALSA thread
+	cpu_set_t saved;
+	bool restore = pooled && excludeReservedCore(saved);
+
 	// Start webserver with dynamic option array
 	struct MHD_Daemon* daemon = MHD_start_daemon(flags, port, // @suppress("Invalid arguments")
 												 acceptHandlerDispatcher, this,
@@ -479,6 +493,11 @@ struct MHD_Daemon* TWebServer::startServer(unsigned int flags) {
 												 MHD_OPTION_ARRAY, options(),
 												 MHD_OPTION_END);
 
+	// Restore affinity of calling thread
+	if (restore) {
+		sched_setaffinity(0, sizeof(saved), &saved);
+	}
+
 	// Set global panic callback handler
 	if (util::assigned(daemon)) {
 		MHD_set_panic_func(panicCallbackDispatcher, this);
@@ -488,6 +507,30 @@ struct MHD_Daemon* TWebServer::startServer(unsigned int flags) {
 }
 
 
+unsigned int TWebServer::getThreadPoolSize() const {
+	// Use configured size or one worker per core without the reserved ALSA core
+	if (web.threadPoolSize > 0)
+		return web.threadPoolSize;
+	return (numa > 1) ? numa - 1 : 1;
+}
+
+
+bool TWebServer::excludeReservedCore(cpu_set_t& saved) const {
+	// Processor numbering as used by TThreadAffinity (1..n)
+	TThreadAffinity affinity;
+	size_t cores = affinity.getCoreCount();
+	if (cores > 1 && cores <= CPU_SETSIZE) {
+		if (EXIT_SUCCESS == sched_getaffinity(0, sizeof(saved), &saved)) {
+			cpu_set_t mask = saved;
+			CPU_CLR(affinity.getDefaultCore() - 1, &mask);
+			if (CPU_COUNT(&mask) > 0)
+				return EXIT_SUCCESS == sched_setaffinity(0, sizeof(mask), &mask);
+		}
+	}
+	return false;
+}
+
+
 bool TWebServer::start(const bool autostart) {
 	bool retVal = false;
 
@@ -510,6 +553,12 @@ bool TWebServer::start(const bool autostart) {
 			// Check authentication algorithm
 			writeInfoLog("[Start web server] Authentication algorithm <" + getWebAuthType(web.auth) + "> in use.");
 
+			// Show threading model
+			if (web.threading == WTH_POOL)
+				writeInfoLog(util::csnprintf("[Start web server] Threading mode <%> with % workers in use.", getWebThreadingMode(web.threading), getThreadPoolSize()));
+			else
+				writeInfoLog("[Start web server] Threading mode <" + getWebThreadingMode(web.threading) + "> in use.");
+
 			// Check if upload folder exists or create it
 			if (!util::folderExists(web.uploadFolder))
 				if (!util::createDirektory(web.uploadFolder))
@@ -586,6 +635,12 @@ bool TWebServer::start(const bool autostart) {
 
 			httpServer4 = startServer(flags);
 
+			// Limit free list of finalized requests to connection limit of all daemons
+			requestPool.setCapacity(ip6start ? 2 * data.threadLimit : data.threadLimit);
+
+			// Asynchronous actions are started by requests, limit free list of actions likewise
+			actionPool.setCapacity(ip6start ? 2 * data.threadLimit : data.threadLimit);
+
 			bool running = util::assigned(httpServer4);
 			if (ip6start && running)
 				running = util::assigned(httpServer6);
@@ -732,6 +787,7 @@ void TWebServer::onSessionTimer() {
 
 void TWebServer::onRequestTimer() {
 	requestGarbageCollector();
+	actionGarbageCollector();
 	linkGarbageCollector();
 }
 
@@ -789,7 +845,10 @@ void TWebServer::addWebToken() {
 	data.wtBytesServed  = addWebToken("SEND_BYTES", "0");
 	data.wtRequestQueue = addWebToken("REQUESTS_IN_QUEUE", "0/0");
 	data.wtActionQueue  = addWebToken("ACTIONS_IN_QUEUE", "0/0");
+	data.wtThreadPool   = addWebToken("THREAD_POOL_STATUS", "-");
+	data.wtCompression  = addWebToken("COMPRESSION_STATUS", "-");
 	data.wtSocketCount  = addWebToken("WEB_SOCKET_COUNT", "-/-");
+	data.wtSocketQueue  = addWebToken("WEB_SOCKET_QUEUE", "-");
 	data.wtConnections  = addWebToken("WEB_CONNECTIONS", "0/0/-");
 	data.wtStartMemory = addWebToken("APP_START_MEMORY", "0");
 	data.wtPeakMemory  = addWebToken("APP_PEAK_MEMORY", "0");
@@ -844,6 +903,20 @@ void TWebServer::updateStatusToken() {
 	if (data.actionQueue > data.maxActionQueue) data.maxActionQueue = data.actionQueue;
 	*data.wtActionQueue  = std::to_string((size_u)data.actionQueue) + "/" + std::to_string((size_u)data.maxActionQueue);
 
+	// Get thread pool queue depth and task latency
+	if (util::assigned(threads)) {
+		app::TThreadPoolStatistics stats;
+		threads->getThreadPool().getStatistics(stats);
+		*data.wtThreadPool = util::csnprintf("% workers (% busy), % queued (max. %), % tasks (% stolen), latency % us (max. % us)",
+				stats.workers, stats.busy, stats.queued, stats.maxQueued, stats.executed, stats.stolen, stats.latency, stats.maxLatency);
+	}
+
+	// Get compression and revalidation statistics for dynamic content
+	app::TThreadDataStatistics compression;
+	rest.getStatistics(compression);
+	*data.wtCompression = util::csnprintf("% compressed, % cached, % not modified, % saved, CPU time % ms",
+			compression.compressed, compression.cached, compression.revalidated, util::sizeToStr(compression.saved), compression.cpuTime / 1000);
+
 	if (data.sessionCount > data.maxSessionCount) data.maxSessionCount = data.sessionCount;
 	*data.wtSessionCount = std::to_string((size_u)data.sessionCount) + "/" + std::to_string((size_u)data.maxSessionCount);
 
@@ -852,6 +925,12 @@ void TWebServer::updateStatusToken() {
 		data.socketCount = sockets->getEpollCounT();
 		if (data.socketCount > data.maxSocketCount) data.maxSocketCount = data.socketCount;
 		*data.wtSocketCount = std::to_string((size_u)data.socketCount) + "/" + std::to_string((size_u)data.maxSocketCount);
+
+		// Get outbound queue depth of slowest client
+		app::TWebSocketStatistics stats;
+		sockets->getStatistics(stats);
+		*data.wtSocketQueue = util::csnprintf("% queued (% bytes, max. % per client), % waiting, % coalesced, % dropped, % compressed",
+				stats.messages, stats.bytes, stats.depth, stats.pending, stats.coalesced, stats.dropped, stats.deflated);
 	}
 
 	delta = (data.requestCount - data.lastRequestCount) / (statsTimer->getDelay() / 1000);
@@ -1287,7 +1366,7 @@ struct CRequestEraser
     bool _zombies;
     bool operator()(PWebRequest o) const {
     	bool retVal = false;
-    	if (util::assigned(o)) {
+    	if (util::assigned(o) && !o->isPooled()) {
 			if (_zombies) {
 				bool permit = true;
 				PWebSession session = o->getSession();
@@ -1313,8 +1392,27 @@ void TWebServer::requestGarbageCollector(const bool cleanup) {
 			size_t count = requestList.size();
 			writeInfoLog("[Request garbage collector] " + std::to_string((size_s)count) + " requests in queue.", 3);
 			util::TTimePart now = util::now();
+			if (web.verbosity >= 3) {
+				TSlotPoolStatistics stats;
+				requestPool.getStatistics(stats);
+				writeInfoLog(util::csnprintf("[Request garbage collector] % of % requests in free list, % reused, % missed, % dropped, % shrunk.",
+						stats.size, stats.capacity, stats.reused, stats.missed, stats.dropped, stats.shrunk), 3);
+			}
+
+			// Delete requests from free list that were not needed since last run
+			TSlotPool<TWebRequest>::vector_t idle;
+			count = requestPool.shrink(idle);
+			if (count > 0) {
+				for (size_t i=0; i<idle.size(); ++i) {
+					PWebRequest o = idle[i];
+					requestList.erase(std::remove(requestList.begin(), requestList.end(), o), requestList.end());
+					util::freeAndNil(o);
+				}
+				deleted += count;
+				writeInfoLog("[Request garbage collector] " + std::to_string((size_s)count) + " idle requests deleted.", 3);
+			}
 
-			// Delete closed request by age
+			// Delete closed request not taken by full free list by age
 			count = requestList.size();
 			util::TTimePart requestDeleteAge = cleanup ? web.requestDeleteAge / 10 : web.requestDeleteAge;
 			if (requestDeleteAge < 3) requestDeleteAge = 3;
@@ -1343,6 +1441,44 @@ void TWebServer::requestGarbageCollector(const bool cleanup) {
 	}
 }
 
+void TWebServer::actionGarbageCollector() {
+	if (isResponding()) {
+		std::lock_guard<std::mutex> lock(actionMtx);
+		if (actionList.size() > 0) {
+			if (web.verbosity >= 3) {
+				TSlotPoolStatistics stats;
+				actionPool.getStatistics(stats);
+				writeInfoLog(util::csnprintf("[Action garbage collector] % of % actions in free list, % reused, % missed, % dropped, % shrunk.",
+						stats.size, stats.capacity, stats.reused, stats.missed, stats.dropped, stats.shrunk), 3);
+			}
+
+			// Remove actions from free list that were not needed since last run
+			TSlotPool<TWebAction>::vector_t idle;
+			if (actionPool.shrink(idle) > 0) {
+				for (size_t i=0; i<idle.size(); ++i)
+					idle[i]->pooled = false;
+			}
+
+			// Delete finished actions that are not in free list
+			size_t count = actionList.size();
+			PWebAction o;
+			TWebActionList::iterator it = actionList.begin();
+			while (it != actionList.end()) {
+				o = *it;
+				if (util::assigned(o) && !o->running && !o->pooled) {
+					util::freeAndNil(o);
+					it = actionList.erase(it);
+					continue;
+				}
+				++it;
+			}
+			count -= actionList.size();
+			if (count > 0)
+				writeInfoLog("[Action garbage collector] " + std::to_string((size_s)count) + " idle actions deleted.", 3);
+		}
+	}
+}
+
 void TWebServer::linkGarbageCollector() {
 	if (ESM_RUNNING == getMode()) {
 		size_t size = rest.garbageCollector();
@@ -1465,6 +1601,7 @@ void TWebServer::readConfig() {
 	config->setSection(name);
 	web.enabled = config->readBool("Enabled", web.enabled);
 	web.useHttps = config->readBool("UseHttps", web.useHttps);
+	web.sendFile = config->readBool("UseSendFile", web.sendFile);
 	web.port = config->readInteger("Port", web.port);
 	web.allowedList = config->readString("AllowedFromIP", ALLOWED_LIST);
 	web.allowManifestFiles = config->readBool("AllowManifestFiles", web.allowManifestFiles);
@@ -1494,6 +1631,9 @@ void TWebServer::readConfig() {
 	web.caching = config->readBool("EnableCaching", web.caching);
 	web.minimize = config->readBool("MinimizeHTML", web.minimize);
 	web.threaded = config->readBool("Multithreading", web.threaded);
+	web.threading = getWebThreadingMode(config->readString("ThreadingMode", getWebThreadingMode(web.threaded ? WTH_CONNECTION : WTH_SINGLE)));
+	web.threaded = web.threading == WTH_CONNECTION;
+	web.threadPoolSize = config->readInteger("ThreadPoolSize", web.threadPoolSize);
 	web.maxConnectionsPerCPU = config->readInteger("MaxConnectionsPerCPU", web.maxConnectionsPerCPU);
 	web.allowWebSockets = config->readBool("AllwoWebSockets", web.allowWebSockets);
 	web.usePortraitMode = config->readBool("UsePortraitMode", web.usePortraitMode);
@@ -1550,6 +1690,7 @@ void TWebServer::writeConfig() {
 	config->setSection(name);
 	config->writeBool("Enabled", web.enabled, INI_BLYES);
 	config->writeBool("UseHttps", web.useHttps, INI_BLYES);
+	config->writeBool("UseSendFile", web.sendFile, INI_BLYES);
 	config->writeInteger("Port", web.port);
 	config->writeString("AllowedFromIP", web.allowedList.csv());
 	config->writeBool("AllowManifestFiles", web.allowManifestFiles);
@@ -1581,6 +1722,8 @@ void TWebServer::writeConfig() {
 	config->writeBool("EnableCaching", web.caching, INI_BLYES);
 	config->writeBool("MinimizeHTML", web.minimize, INI_BLYES);
 	config->writeBool("Multithreading", web.threaded, INI_BLYES);
+	config->writeString("ThreadingMode", getWebThreadingMode(web.threading));
+	config->writeInteger("ThreadPoolSize", web.threadPoolSize);
 	config->writeInteger("MaxConnectionsPerCPU", web.maxConnectionsPerCPU);
 	config->writeBool("AllwoWebSockets", web.allowWebSockets, INI_BLYES);
 	config->writeBool("UsePortraitMode", web.usePortraitMode, INI_BLYES);
@@ -1803,6 +1946,13 @@ void TWebServer::requestCompletedCallback (	struct MHD_Connection *connection,
 		if (verbose) {
 			writeInfoLog("[Request completion callback] Request reference count is now " + std::to_string((size_s)o->getRefCount()));
 		}
+		// Give request back to free list for reuse
+		// --> Request is deleted by garbage collector if free list is full
+		if (o->getRefCount() <= 0) {
+			o->setPooled(true);
+			if (!requestPool.release(o))
+				o->setPooled(false);
+		}
 	}
 	if (verbose) {
 		std::string wsc = getWebStatusMessage((EWebStatusCode)httpStatusCode);
@@ -2038,7 +2188,7 @@ MHD_Result TWebServer::requestDispatcher( struct MHD_Connection *connection,
 
 					// Check for Websocket upgrade request
 					if (util::assigned(sockets) && request->isUpgradeRequest()) {
-						if (MHD_YES == request->sendUpgradeResponse(connection, webSocketConnectionDispatcher, this)) {
+						if (MHD_YES == request->sendUpgradeResponse(connection, webSocketConnectionDispatcher, this, sockets->getDeflate())) {
 							goon = false;
 							found = true;
 							retVal = MHD_YES;
@@ -2404,7 +2554,10 @@ void TWebServer::prepareRequest(PWebRequest request, PWebSession session, const
 
 void TWebServer::webSocketHandler(void *cls, struct MHD_Connection *connection, void *con_cls, const char *extra_in, size_t extra_in_size, MHD_socket sock, struct MHD_UpgradeResponseHandle *urh) {
 	if (util::assigned(sockets)) {
-		sockets->upgrade(sock, urh, extra_in, extra_in_size);
+		// Compression as negotiated by upgrade response of the request
+		PWebRequest request = static_cast<app::PWebRequest>(con_cls);
+		bool deflate = util::assigned(request) && request->isSocketDeflated();
+		sockets->upgrade(sock, urh, extra_in, extra_in_size, deflate);
 	}
 }
 
@@ -2780,37 +2933,23 @@ int TWebServer::getRequestDelta() const {
 }
 
 PWebRequest TWebServer::findRequestSlot(struct MHD_Connection *connection, bool& created) {
-	std::lock_guard<std::mutex> lock(requestMtx);
-	PWebRequest request = nil;
 	bool verbose = web.verbosity > 3;
 	int delta = getRequestDelta();
-	time_t now = util::now();
 	created = false;
 
-	// Reuse request if reference count == 0
-	// and request older than 2 seconds
-	size_t i,n;
-	PWebRequest o;
-	n = requestList.size();
-	for (i=0; i<n; i++) {
-		o = requestList[i];
-		if (util::assigned(o)) {
-			if ((o->getRefCount() <= 0) && ((now - o->getTimeStamp()) > 2)) {
-				if (verbose)
-					writeInfoLog("[Request slot finder] Found usable request.");
-				request = o;
-				break;
-			}
-		}
-	}
-
+	// Reuse finalized request from free list
+	PWebRequest request = requestPool.acquire();
 	if (util::assigned(request)) {
 		// Initialize reused request object
+		if (verbose)
+			writeInfoLog("[Request slot finder] Found usable request.");
 		request->initialize(connection, delta);
+		request->setPooled(false);
 	} else {
 		// Create new request object
 		request = new TWebRequest(connection, sessionMap, sessionMtx, requestMtx, delta, web);
 		if (util::assigned(request)) {
+			std::lock_guard<std::mutex> lock(requestMtx);
 			requestList.push_back(request);
 			created = true;
 			if (verbose)
@@ -2827,31 +2966,20 @@ PWebRequest TWebServer::findRequestSlot(struct MHD_Connection *connection, bool&
 
 
 PWebAction TWebServer::findActionSlot() {
-	std::lock_guard<std::mutex> lock(actionMtx);
-	PWebAction o = nil;
-	bool found = false;
-
-	// Find empty action slot
-	size_t i,n;
-	n = actionList.size();
-	for (i=0; i<n; i++) {
-		o = actionList[i];
-		if (util::assigned(o)) {
-			if (!o->running) {
-				found = true;
-				break;
-			}
-		}
-	}
+	// Take idle action from free list
+	PWebAction o = actionPool.acquire();
 
 	// Create new action object
-	if (!found) {
+	if (!util::assigned(o)) {
 		o = new TWebAction;
+		std::lock_guard<std::mutex> lock(actionMtx);
 		actionList.push_back(o);
 	}
 
 	// Set running flag as early as possible
+	std::lock_guard<std::mutex> lock(actionMtx);
 	o->running = true;
+	o->pooled = false;
 
 	return o;
 }
@@ -2899,8 +3027,17 @@ void TWebServer::executeAction(const TWebActionHandler& handler, const std::stri
 void TWebServer::actionAsyncExecuter(TWebAction& action) {
 	int error;
 	actionSyncExecuter(action.handler, action.key, action.value, action.params, action.session, error);
-	std::lock_guard<std::mutex> lock(actionMtx);
-	action.reset();
+	{
+		std::lock_guard<std::mutex> lock(actionMtx);
+		action.reset();
+		action.pooled = true;
+	}
+	// Give action back to free list for reuse
+	// --> Action is deleted by garbage collector if free list is full
+	if (!actionPool.release(&action)) {
+		std::lock_guard<std::mutex> lock(actionMtx);
+		action.pooled = false;
+	}
 }
 
 void TWebServer::actionSyncExecuter(const TWebActionHandler& handler, const std::string& key,
@@ -3799,6 +3936,7 @@ void TWebServer::clearWebActionList() {
 			util::freeAndNil(o);
 		}
 		actionList.clear();
+		actionPool.clear();
 	}
 }
 
@@ -3814,6 +3952,7 @@ void TWebServer::clearWebRequestList() {
 			util::freeAndNil(o);
 		}
 		requestList.clear();
+		requestPool.clear();
 	}
 }
 
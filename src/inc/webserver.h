@@ -22,6 +22,7 @@
 #include "websockets.h"
 #include "webtypes.h"
 #include "semaphore.h"
+#include "slotpool.h"
 #include "exception.h"
 #include "logger.h"
 #include "detach.h"
@@ -96,6 +97,8 @@ private:
 	TWebActionMap actionMap;
 	TWebActionList actionList;
 	TWebRequestList requestList;
+	TSlotPool<TWebAction> actionPool;
+	TSlotPool<TWebRequest> requestPool;
 	PTimer socketTimer;
 	PTimer sessionTimer;
 	PTimer requestTimer;
@@ -122,6 +125,8 @@ private:
 	struct MHD_Daemon* httpServer6;
 
 	struct MHD_Daemon* startServer(unsigned int flags);
+	unsigned int getThreadPoolSize() const;
+	bool excludeReservedCore(cpu_set_t& saved) const;
 
 	void readConfig();
 	void writeConfig();
@@ -146,6 +151,7 @@ private:
 	void sessionCountLimiter();
 	void sessionGarbageCollector(const bool cleanup = false);
 	void requestGarbageCollector(const bool cleanup = false);
+	void actionGarbageCollector();
 	void linkGarbageCollector();
 	void bufferGarbageCollector();
 	void deallocateHeapMemory(const size_t deleted);
@@ -8,10 +8,13 @@
  *
  */
 
+#include <string.h>
 #include "websockets.h"
+#include "webconsts.h"
 #include "compare.h"
 #include "typeid.h"
 #include "ASCII.h"
+#include "zlib/zlib.h"
 
 namespace app {
 
@@ -62,6 +65,7 @@ TWebSockets::~TWebSockets() {
 void TWebSockets::prime() {
 	debug = false;
 	secure = false;
+	deflate = false;
 	running = false;
 	shutdown = false;
 	invalidated = false;
@@ -72,6 +76,12 @@ void TWebSockets::prime() {
 	onWebSocketVariant = nil;
 	onWebSocketData = nil;
 	timeout = 720;
+	stalled = 30;
+	queueSize = WEBSOCKET_MAX_QUEUE_SIZE;
+	queueDepth = WEBSOCKET_MAX_QUEUE_DEPTH;
+	coalesced = 0;
+	dropped = 0;
+	checked = 0;
 	revents = nil;
 	logger = nil;
 	thread = nil;
@@ -86,6 +96,12 @@ void TWebSockets::readConfig() {
 	debug = config->readBool("Debug", debug);
 	timeout = config->readInteger("Timeout", timeout);
 	mtu = config->readInteger("MTU", mtu);
+	deflate = config->readBool("Deflate", deflate);
+	queueSize = config->readInteger("MaxQueueSize", queueSize);
+	queueDepth = config->readInteger("MaxQueueDepth", queueDepth);
+	stalled = config->readInteger("StallTimeout", stalled);
+	if (queueDepth < 1)
+		queueDepth = 1;
 }
 
 void TWebSockets::writeConfig() {
@@ -93,6 +109,10 @@ void TWebSockets::writeConfig() {
 	config->writeBool("Debug", debug, app::INI_BLYES);
 	config->writeInteger("Timeout", timeout);
 	config->writeInteger("MTU", mtu);
+	config->writeBool("Deflate", deflate, app::INI_BLYES);
+	config->writeInteger("MaxQueueSize", queueSize);
+	config->writeInteger("MaxQueueDepth", queueDepth);
+	config->writeInteger("StallTimeout", stalled);
 }
 
 void TWebSockets::reWriteConfig() {
@@ -150,12 +170,14 @@ void TWebSockets::closeEpollHandle() {
 }
 
 
-void TWebSockets::upgrade(MHD_socket socket, struct MHD_UpgradeResponseHandle *urh, const char *data, size_t size) {
+void TWebSockets::upgrade(MHD_socket socket, struct MHD_UpgradeResponseHandle *urh, const char *data, size_t size, const bool deflate) {
 	// Create web socket structure
 	CWebSocket* ws = new CWebSocket;
 	ws->handle = socket;
 	ws->valid = true;
 	ws->urh = urh;
+	ws->deflate = deflate;
+	if (deflate && debug) writeLogFmt("TWebSockets::upgrade() Compression enabled for client socket <%>", socket);
 
 	// Create new polling event
 	epoll_event * p = new epoll_event;
@@ -172,7 +194,7 @@ void TWebSockets::upgrade(MHD_socket socket, struct MHD_UpgradeResponseHandle *u
 		bool closed = false;
 		std::string decoded;
 		util::TVariantValues variants;
-		decodeSocketData(socket, data, size, decoded, variants, closed);
+		decodeSocketData(ws, data, size, decoded, variants, closed);
 		if (!decoded.empty()) {
 			processSocketData(socket, decoded, variants);
 		}
@@ -180,19 +202,57 @@ void TWebSockets::upgrade(MHD_socket socket, struct MHD_UpgradeResponseHandle *u
 }
 
 
-size_t TWebSockets::getSocketHandles(TWebHandleList& handles) const {
-	app::TLockGuard<app::TMutex> mtx(listMtx);
-	handles.clear();
+PWebSocket TWebSockets::findSocketWithNolock(const app::THandle handle) const {
 	if (!sockets.empty()) {
 		for (size_t i=0; i<sockets.size(); ++i) {
 			PWebSocket socket = sockets[i];
 			if (util::assigned(socket)) {
-				if (socket->handle != INVALID_HANDLE_VALUE)
-					handles.push_back(socket->handle);
+				if (socket->handle == handle)
+					return socket;
 			}
 		}
 	}
-	return handles.size();
+	return nil;
+}
+
+void TWebSockets::getStatistics(TWebSocketStatistics& statistics) const {
+	statistics.clear();
+	app::TLockGuard<app::TMutex> mtx(listMtx);
+	statistics.coalesced = coalesced;
+	statistics.dropped = dropped;
+	for (size_t i=0; i<sockets.size(); ++i) {
+		PWebSocket socket = sockets[i];
+		if (util::assigned(socket) && socket->valid) {
+			app::TLockGuard<app::TMutex> lock(socket->mtx);
+			size_t depth = socket->queue.size();
+			++statistics.sockets;
+			if (socket->writing)
+				++statistics.pending;
+			if (socket->deflate)
+				++statistics.deflated;
+			if (depth > statistics.depth)
+				statistics.depth = depth;
+			statistics.messages += depth;
+			statistics.bytes += socket->queued;
+		}
+	}
+}
+
+bool TWebSockets::hasDeflateExtension(const std::string& extensions) {
+	// Accept offer without server window size parameter only, see RFC 7692 section 7.1
+	// --> e.g. "permessage-deflate; client_max_window_bits, x-webkit-deflate-frame"
+	std::string::size_type start = 0;
+	while (start < extensions.size()) {
+		std::string::size_type end = extensions.find(',', start);
+		if (end == std::string::npos)
+			end = extensions.size();
+		std::string offer = extensions.substr(start, end - start);
+		std::string name = util::trim(offer.substr(0, offer.find(';')));
+		if (name == HTTP_WEB_SOCKET_DEFLATE && offer.find("server_max_window_bits") == std::string::npos)
+			return true;
+		start = util::succ(end);
+	}
+	return false;
 }
 
 
@@ -222,16 +282,9 @@ struct CSocketRemover {
 
 void TWebSockets::invalidateSocket(const app::THandle handle) {
 	app::TLockGuard<app::TMutex> mtx(listMtx);
-	if (!sockets.empty()) {
-		for (size_t i=0; i<sockets.size(); ++i) {
-			PWebSocket socket = sockets[i];
-			if (util::assigned(socket)) {
-				if (socket->handle == handle) {
-					invalidateSocketWithNolock(socket);
-					break;
-				}
-			}
-		}
+	PWebSocket socket = findSocketWithNolock(handle);
+	if (util::assigned(socket)) {
+		invalidateSocketWithNolock(socket);
 	}
 }
 
@@ -324,6 +377,20 @@ int TWebSockets::addEpollHandle(epoll_event* event, const app::THandle socket) {
 	return r;
 }
 
+int TWebSockets::watchSocketOutput(PWebSocket socket, const bool enabled) {
+	// Arm EPOLLOUT while messages are queued for socket
+	// --> Called with socket lock held
+	int r;
+	socket->event->events = enabled ? (mask | EPOLLOUT) : mask;
+	do {
+		errno = EXIT_SUCCESS;
+		r = ::epoll_ctl(epollfd, EPOLL_CTL_MOD, socket->handle, socket->event);
+	} while (r != EXIT_SUCCESS && errno == EINTR);
+	if (EXIT_SUCCESS == r)
+		socket->writing = enabled;
+	return r;
+}
+
 int TWebSockets::removeEpollHandle(epoll_event* event, const app::THandle socket) {
 	if (debug) writeLog("TWebSockets::removeEpollHandle() Remove handle <" + std::to_string((size_s)socket) + ">");
 	int r;
@@ -451,6 +518,10 @@ int TWebSockets::eloop(app::TManagedThread& sender) {
 		if (rcount < 0)
 			throw util::sys_error("TWebSockets::eloop()::epoll() failed.");
 
+		// Drop clients not taking queued data, even if nothing is sent to them anymore
+		if (dropStalledSockets() > 0)
+			removeInvalidatedSockets();
+
 		if (rcount > 0 && n > 0 && !shutdown && !sender.isTerminating()) {
 			if (debug) {
 				std::cout << "TWebSockets::eloop() Watched events           = " << n << std::endl;
@@ -508,6 +579,14 @@ int TWebSockets::eloop(app::TManagedThread& sender) {
 
 				} // if (p->revents & POLLIN)
 
+				// Socket is writable again, send queued messages
+				if ((p->events & EPOLLOUT) && socket->valid) {
+					if (!writeSocketData(socket)) {
+						writeLogFmt("TWebSockets::eloop() Client socket <%> closed on write error.", handle);
+						invalidateSocket(socket);
+					}
+				}
+
 				p->events = 0;
 
 			} // for (i=0; i<events.size(); ++i, ++p)
@@ -651,7 +730,7 @@ ssize_t TWebSockets::readSocketData(PWebSocket socket, bool& closed) {
 			std::string decoded;
 			util::TVariantValues variants;
 			if (received > 0) {
-				decodeSocketData(socket->handle, data.empty() ? buffer.data() : data.data(), received, decoded, variants, closed);
+				decodeSocketData(socket, data.empty() ? buffer.data() : data.data(), received, decoded, variants, closed);
 			}
 			if (!decoded.empty()) {
 				processSocketData(socket->handle, decoded, variants);
@@ -664,13 +743,23 @@ ssize_t TWebSockets::readSocketData(PWebSocket socket, bool& closed) {
 	return (ssize_t)EXIT_ERROR;
 }
 
-void TWebSockets::decodeSocketData(const app::THandle handle, const void *const data, const size_t size, std::string& output, util::TVariantValues& variants, bool& closed) {
+void TWebSockets::decodeSocketData(PWebSocket socket, const void *const data, const size_t size, std::string& output, util::TVariantValues& variants, bool& closed) {
 	if (util::assigned(data) && size > 0) {
 		// Unmask received data
-		bool ping;
+		bool ping, compressed;
 		util::TBuffer unmasked;
-		unmaskSocketData(data, size, unmasked, ping, closed);
+		unmaskSocketData(data, size, unmasked, ping, closed, compressed);
 		if (!closed && !ping) {
+			// Decompress message if RSV1 bit was set by client
+			if (compressed && !unmasked.empty()) {
+				util::TBuffer inflated;
+				if (socket->deflate && inflateSocketData(unmasked.data(), unmasked.size(), inflated)) {
+					unmasked.swap(inflated);
+				} else {
+					errorLogFmt("TWebSockets::decodeSocketData() Invalid compressed message from client socket <%>", socket->handle);
+					unmasked.clear();
+				}
+			}
 			if (debug) std::cout << "TWebSockets::decodeSocketData() Unmasked " << unmasked.size() << " bytes received." << std::endl;
 			if (!unmasked.empty()) {
 				// Websocket data should be UTF-8 by design!
@@ -683,7 +772,7 @@ void TWebSockets::decodeSocketData(const app::THandle handle, const void *const
 			if (ping) {
 				if (debug) std::cout << "TWebSockets::decodeSocketData() Ping of " << unmasked.size() << " bytes received." << std::endl;
 				if (!unmasked.empty()) {
-					sendPingResponse(handle, unmasked);
+					sendPingResponse(socket, unmasked);
 				}
 			}
 		}
@@ -703,9 +792,9 @@ void TWebSockets::parseSocketData(const void *const data, const size_t size, std
 	}
 }
 
-bool TWebSockets::unmaskSocketData(const void* data, size_t size, util::TBuffer& output, bool& ping, bool& closed) const {
+bool TWebSockets::unmaskSocketData(const void* data, size_t size, util::TBuffer& output, bool& ping, bool& closed, bool& compressed) const {
 	const uint8_t* p = (uint8_t*)data;
-	ping = closed = false;
+	ping = closed = compressed = false;
 	if (util::assigned(data) && size > 2) {
 
 		// Check for masked date
@@ -713,9 +802,10 @@ bool TWebSockets::unmaskSocketData(const void* data, size_t size, util::TBuffer&
 		size_t len = *(p+1) & ~0x80;
 		if (debug) std::cout << "TWebRequest::unmaskSocketData() Length = " << len << ", masked = " << masked << std::endl;
 
-		// Is valid header byte
-		if (*p == 0x81) {
+		// Is valid header byte, RSV1 bit is set for compressed message
+		if ((*p & ~0x40) == 0x81) {
 			bool ok = false;
+			compressed = *p & 0x40;
 			uint8_t key[4];
 
 			if (masked) {
@@ -827,105 +917,129 @@ bool TWebSockets::unmaskSocketData(const void* data, size_t size, util::TBuffer&
 	return false;
 }
 
-void TWebSockets::maskSocketData(const void* data, size_t size, util::TBuffer& output, const bool masked) const {
-	if (util::assigned(data) && size > 0) {
-		const uint8_t* q = (uint8_t*)data;
-		uint8_t* p = nil;
-		bool ok = false;
-
-		// XOR encode mask
-		uint8_t key[4];
-		if (masked) {
-			key[0] = 1 + (rand() % 255);
-			key[1] = 1 + (rand() % 255);
-			key[2] = 1 + (rand() % 255);
-			key[3] = 1 + (rand() % 255);
+void TWebSockets::encodeSocketFrame(const void* data, size_t size, util::TBuffer& output, const uint8_t opcode, const bool fin, const bool compressed) const {
+	// Append unmasked server frame to output
+	// --> Frames sent by server must not be masked, see RFC 6455 section 5.1
+	uint8_t header[10];
+	size_t len;
+	header[0] = (opcode & 0x0F) | (fin ? 0x80 : 0x00) | (compressed ? 0x40 : 0x00);
+
+	// Check for payload length byte >= 126
+	//  126 --> 2 length bytes (max. 65636 bytes block length)
+	//  127 --> 8 length bytes
+	if (size < 126) {
+		header[1] = size;
+		len = 2;
+	} else {
+		if (size <= 0xFFFF) {
+			header[1] = 0x7E;
+			header[2] = (size >> 8) & 0xFF;
+			header[3] = size & 0xFF;
+			len = 4;
+		} else {
+			header[1] = 0x7F;
+			uint64_t value = size;
+			for (size_t i=0; i<8; ++i) {
+				header[2 + i] = (value >> (56 - 8 * i)) & 0xFF;
+			}
+			len = 10;
 		}
+	}
 
-		// Encode huge block up from 0x7E == 126 bytes == ASCII "~" ?
-		if (size >= 126) {
-
-			// Set output buffer size
-			size_t len = masked ? size + 8 : size + 4;
-			output.resize(len);
-			p = (uint8_t*)output.data();
-
-			// Set header
-			*(p+0) = 0x81;
-
-			// Store payload length bytes
-			size_t lo = size & 0xFF;
-			size_t hi = (size >> 8) & 0xFF;
-			*(p+2) = hi;
-			*(p+3) = lo;
-
-			// Set masked header
-			if (masked) {
-				*(p+1) = 0xFE; // 126 + 0x80 = 0xFE --> Mask Bit 7 set!
-
-				// Store keys in result
-				*(p+4) = key[0];
-				*(p+5) = key[1];
-				*(p+6) = key[2];
-				*(p+7) = key[3];
-
-				// First payload byte
-				p = (uint8_t*)(output.data() + 8);
-
-			} else {
-				// Unmasked 2 byte size block
-				*(p+1) = 0x7E; // 126 = 0x7E
+	output.append(header, len);
+	if (util::assigned(data) && size > 0)
+		output.append(data, size);
+}
 
-				// First payload byte
-				p = (uint8_t*)(output.data() + 4);
+void TWebSockets::encodeSocketMessage(const void* data, size_t size, util::TBuffer& output, const bool compressed) const {
+	output.clear();
+	if (util::assigned(data) && size > 0) {
+		const char* p = (const char*)data;
+
+		// Compress payload if negotiated, small messages are sent uncompressed
+		util::TBuffer deflated;
+		bool rsv = false;
+		if (compressed && size >= WEBSOCKET_DEFLATE_THRESHOLD) {
+			if (deflateSocketData(data, size, deflated) && deflated.size() < size) {
+				p = deflated.data();
+				size = deflated.size();
+				rsv = true;
 			}
+		}
 
-			ok = true;
-
-		} else {
-			// Set output buffer size for block smaller that 126 bytes
-			size_t len = masked ? size + 6 : size + 2;
-			output.resize(len);
-			p = (uint8_t*)output.data();
-
-			// Set header
-			*(p+0) = 0x81;
-
-			// Set masked header
-			if (masked) {
-				*(p+1) = size | 0x80; // Mask Bit 7 set!
-
-				// Store keys in result
-				*(p+2) = key[0];
-				*(p+3) = key[1];
-				*(p+4) = key[2];
-				*(p+5) = key[3];
-
-				// First payload byte
-				p = (uint8_t*)(output.data() + 6);
+		// Split message into fragments of MTU size, see RFC 6455 section 5.4
+		// --> First frame holds text opcode and RSV1 bit, continuation frames have opcode 0
+		size_t fragment = mtu > 0 ? mtu : size;
+		size_t frames = size / fragment + 1;
+		output.reserve(size + frames * 10, false);
+		size_t offset = 0;
+		do {
+			size_t n = std::min(size - offset, fragment);
+			bool first = offset == 0;
+			bool fin = (offset + n) >= size;
+			encodeSocketFrame(p + offset, n, output, first ? 0x01 : 0x00, fin, first && rsv);
+			offset += n;
+		} while (offset < size);
+	}
+}
 
-			} else {
-				// Store native size
-				*(p+1) = size;
-				p = (uint8_t*)(output.data() + 2);
-			}
+bool TWebSockets::deflateSocketData(const void* data, size_t size, util::TBuffer& output) const {
+	// Raw deflate without context takeover, see RFC 7692 section 7.2.1
+	// --> Stream is flushed by Z_SYNC_FLUSH, trailing bytes 0x00 0x00 0xFF 0xFF are removed
+	z_stream zs;
+	memset(&zs, 0, sizeof(zs));
+	if (Z_OK != deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY))
+		return false;
+
+	output.resize(deflateBound(&zs, size) + 16, false);
+	zs.next_in = (Bytef*)data;
+	zs.avail_in = size;
+	zs.next_out = (Bytef*)output.data();
+	zs.avail_out = output.size();
+	int r = ::deflate(&zs, Z_SYNC_FLUSH);
+	size_t n = output.size() - zs.avail_out;
+	bool ok = Z_OK == r && zs.avail_in == 0 && n > 4;
+	deflateEnd(&zs);
+
+	if (ok)
+		output.resize(n - 4);
+	return ok;
+}
 
-			ok = true;
+bool TWebSockets::inflateSocketData(const void* data, size_t size, util::TBuffer& output) const {
+	// Append trailing bytes removed by sender, see RFC 7692 section 7.2.2
+	STATIC_CONST uint8_t tail[4] = { 0x00, 0x00, 0xFF, 0xFF };
+	util::TBuffer input;
+	input.reserve(size + sizeof(tail), false);
+	input.append(data, size);
+	input.append(tail, sizeof(tail));
 
-		}
+	z_stream zs;
+	memset(&zs, 0, sizeof(zs));
+	if (Z_OK != inflateInit2(&zs, -MAX_WBITS))
+		return false;
 
-		if (ok && util::assigned(p)) {
-			if (masked) {
-				// Encode bytes
-				for (size_t i=0; i<size; ++i) {
-					*p++ = *q++ ^ key[i % 4];
-				}
-			} else {
-				// Plain buffer copy...
-				memcpy(p, q, size);
-			}
-		}
-	}
+	int r;
+	bool more;
+	size_t chunk = 4 * size + 256;
+	zs.next_in = (Bytef*)input.data();
+	zs.avail_in = input.size();
+	output.clear();
+	do {
+		size_t n = output.size();
+		output.resize(n + chunk);
+		zs.next_out = (Bytef*)(output.data() + n);
+		zs.avail_out = chunk;
+		r = ::inflate(&zs, Z_SYNC_FLUSH);
+		output.resize(n + chunk - zs.avail_out);
+		more = Z_OK == r && (zs.avail_in > 0 || zs.avail_out == 0) && output.size() < WEBSOCKET_MAX_INFLATE_SIZE;
+	} while (more);
+	bool ok = (Z_OK == r || Z_STREAM_END == r || Z_BUF_ERROR == r) && zs.avail_in == 0;
+	inflateEnd(&zs);
+
+	if (!ok)
+		output.clear();
+	return ok;
 }
 
 
@@ -981,33 +1095,35 @@ void TWebSockets::onSockectConnected(const app::THandle handle) {
 ssize_t TWebSockets::write(const app::THandle handle, void const * const data, size_t const size) {
 	if (util::assigned(data) && size > 0) {
 
-		if (size > mtu)
-			throw util::app_error_fmt("TWebSockets::write() Write size % exceeds fragmentation limit %", size, mtu);
-
-		// Mask JSON text data, but do not encode it (!)
+		// Encode JSON text data as unmasked frames
 		if (debug) std::cout << "TWebSockets::write() Data \"" << util::TBinaryConvert::binToText(data, size, util::TBinaryConvert::EBT_HEX) << "\" size = " << size << std::endl;
-		util::TBuffer encoded;
-		maskSocketData(data, size, encoded, false);
-		if (!encoded.empty()) {
-			app::TLockGuard<app::TMutex> lock(sendMtx);
-			return send(handle, encoded.data(), encoded.size());
+		app::TLockGuard<app::TMutex> lock(listMtx);
+		PWebSocket socket = findSocketWithNolock(handle);
+		if (util::assigned(socket)) {
+			util::TBuffer encoded;
+			encodeSocketMessage(data, size, encoded, socket->deflate);
+			return enqueueSocketData(socket, encoded, EWM_DATA);
 		}
 	}
 	return (ssize_t)0;
 }
 
 
-ssize_t TWebSockets::sendPingResponse(const app::THandle handle, util::TBuffer& message) {
+ssize_t TWebSockets::sendPingResponse(PWebSocket socket, util::TBuffer& message) {
 	ssize_t retVal = 0;
 	if (!message.empty()) {
 		// Set "Pong" header and send unmodified data back to sender
 		uint8_t* p = (uint8_t*)message.data();
 		bool fin = *p & 0x80;
 		*p = fin ? 0x8A : 0x0A;
-		retVal = send(handle, p, message.size());
-		writeLogFmt("TWebSockets::sendPingResponse() Send pong to client <%>", handle);
+		{
+			// Queue pong behind pending messages to keep frames in order
+			app::TLockGuard<app::TMutex> lock(listMtx);
+			retVal = enqueueSocketData(socket, message, EWM_CONTROL);
+		}
+		writeLogFmt("TWebSockets::sendPingResponse() Send pong to client <%>", socket->handle);
 	}
-	return retVal;;
+	return retVal;
 }
 
 
@@ -1016,30 +1132,195 @@ ssize_t TWebSockets::broadcast(void const * const data, size_t const size) {
 	if (util::assigned(data) && size > 0) {
 		timestamp = util::now();
 
-		if (size > mtu)
-			throw util::app_error_fmt("TWebSockets::write() Write size % exceeds fragmentation limit %", size, mtu);
-
-		TWebHandleList handles;
-		size_t count = getSocketHandles(handles);
-		if (count > 0) {
+		// Encode JSON text data once for all clients
+		// --> Compressed frames are only created if compression is enabled
+		if (debug) std::cout << "TWebSockets::broadcast() Data \"" << util::TBinaryConvert::binToText(data, size, util::TBinaryConvert::EBT_HEX) << "\" size = " << size << std::endl;
+		util::TBuffer encoded, deflated;
+		encodeSocketMessage(data, size, encoded, false);
+		if (deflate && size >= WEBSOCKET_DEFLATE_THRESHOLD)
+			encodeSocketMessage(data, size, deflated, true);
 
-			// Mask JSON text data
-			if (debug) std::cout << "TWebSockets::broadcast() Data \"" << util::TBinaryConvert::binToText(data, size, util::TBinaryConvert::EBT_HEX) << "\" size = " << size << " to " << handles.size() << " clients." << std::endl;
-			util::TBuffer encoded;
-			maskSocketData(data, size, encoded, false);
-			if (!encoded.empty()) {
-				app::TLockGuard<app::TMutex> lock(sendMtx);
-				for (size_t i=0; i<handles.size(); ++i) {
-					THandle handle = handles[i];
-					ssize_t r = send(handle, encoded.data(), encoded.size());
+		// Queue message for every client, slow clients do not block the others
+		if (!encoded.empty()) {
+			app::TLockGuard<app::TMutex> lock(listMtx);
+			for (size_t i=0; i<sockets.size(); ++i) {
+				PWebSocket socket = sockets[i];
+				if (util::assigned(socket) && socket->valid && socket->handle != INVALID_HANDLE_VALUE) {
+					bool compressed = socket->deflate && !deflated.empty();
+					ssize_t r = enqueueSocketData(socket, compressed ? deflated : encoded, EWM_UPDATE);
 					if (r > 0)
 						retVal += r;
 				}
+			}
+		}
+	}
+	return retVal;
+}
+
+
+ssize_t TWebSockets::enqueueSocketData(PWebSocket socket, const util::TBuffer& message, const EWebSocketMessage kind) {
+	// Called with list lock held
+	// --> Message is sent at once if nothing is pending, the rest is sent by polling thread on EPOLLOUT
+	if (!util::assigned(socket) || !socket->valid || message.empty())
+		return (ssize_t)0;
+
+	ssize_t retVal = 0;
+	bool failed = false;
+	bool slow = false;
+	bool overflow = false;
+	size_t pending = 0;
+	{
+		app::TLockGuard<app::TMutex> lock(socket->mtx);
+		util::TTimePart now = util::now();
+
+		if (isSocketStalled(socket, now)) {
+			// Client did not take any data for a while
+			slow = true;
+			pending = socket->queued;
+
+		} else {
+			// Coalesce pending messages: an update is replaced by a newer identical update
+			// --> Control frames and data messages are never discarded
+			// --> First message stays in queue if partially sent already
+			if (kind == EWM_UPDATE) {
+				TWebSocketQueue::iterator it = socket->queue.begin();
+				if (socket->offset > 0 && it != socket->queue.end())
+					++it;
+				while (it != socket->queue.end()) {
+					if (it->kind == kind && it->data.size() == message.size() && 0 == memcmp(it->data.data(), message.data(), message.size())) {
+						socket->queued -= it->data.size();
+						it = socket->queue.erase(it);
+						++coalesced;
+					} else {
+						++it;
+					}
+				}
+			}
+
+			// Queue limit exceeded by messages that must not be lost
+			// --> Client can not follow, drop client instead of losing messages
+			if (!socket->queue.empty() && (socket->queue.size() >= queueDepth || (socket->queued + message.size()) > queueSize)) {
+				overflow = true;
+				pending = socket->queued;
+
+			} else {
+				if (socket->queue.empty())
+					socket->progress = now;
+				socket->queue.emplace_back(kind);
+				socket->queue.back().data.assign(message);
+				socket->queued += message.size();
+				retVal = (ssize_t)message.size();
+
+				// Try to send message now if socket is not watched for output
+				if (!socket->writing) {
+					if (flushSocketData(socket) < 0) {
+						failed = true;
+					} else {
+						if (!socket->queue.empty()) {
+							if (EXIT_SUCCESS != watchSocketOutput(socket, true))
+								failed = true;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	if (overflow) {
+		writeLogFmt("TWebSockets::enqueueSocketData() Client socket <%> dropped on queue overflow, % bytes pending.", socket->handle, pending);
+		invalidateSocketWithNolock(socket);
+		++dropped;
+		return (ssize_t)0;
+	}
+	if (slow) {
+		writeLogFmt("TWebSockets::enqueueSocketData() Slow client socket <%> dropped, % bytes pending.", socket->handle, pending);
+		invalidateSocketWithNolock(socket);
+		++dropped;
+		return (ssize_t)0;
+	}
+	if (failed) {
+		writeLogFmt("TWebSockets::enqueueSocketData() Client socket <%> dead.", socket->handle);
+		invalidateSocketWithNolock(socket);
+		return (ssize_t)EXIT_ERROR;
+	}
+	return retVal;
+}
+
+bool TWebSockets::isSocketStalled(PWebSocket socket, const util::TTimePart now) const {
+	// Client did not take any queued data for the configured time
+	// --> Called with socket lock held
+	return !socket->queue.empty() && stalled > 0 && (now - socket->progress) > stalled;
+}
 
+size_t TWebSockets::dropStalledSockets() {
+	// Check once per second from polling thread
+	util::TTimePart now = util::now();
+	if (stalled <= 0 || now == checked)
+		return (size_t)0;
+	checked = now;
+
+	size_t count = 0;
+	app::TLockGuard<app::TMutex> mtx(listMtx);
+	for (size_t i=0; i<sockets.size(); ++i) {
+		PWebSocket socket = sockets[i];
+		if (util::assigned(socket) && socket->valid) {
+			size_t pending = 0;
+			bool slow = false;
+			{
+				app::TLockGuard<app::TMutex> lock(socket->mtx);
+				slow = isSocketStalled(socket, now);
+				if (slow)
+					pending = socket->queued;
 			}
+			if (slow) {
+				writeLogFmt("TWebSockets::dropStalledSockets() Slow client socket <%> dropped, % bytes pending.", socket->handle, pending);
+				invalidateSocketWithNolock(socket);
+				++dropped;
+				++count;
+			}
+		}
+	}
+	return count;
+}
+
+ssize_t TWebSockets::flushSocketData(PWebSocket socket) {
+	// Send as much queued data as the socket takes without blocking
+	// --> Called with socket lock held
+	ssize_t retVal = 0;
+	while (!socket->queue.empty()) {
+		const util::TBuffer& message = socket->queue.front().data;
+		ssize_t r = send(socket->handle, message.data() + socket->offset, message.size() - socket->offset);
+		if (r < 0) {
+			socket->error = errno;
+			return (ssize_t)EXIT_ERROR;
 		}
+		if (r > 0) {
+			socket->progress = util::now();
+			socket->offset += r;
+			socket->queued -= r;
+			retVal += r;
+		}
+
+		// Socket buffer is full
+		if (socket->offset < message.size())
+			break;
+
+		socket->offset = 0;
+		socket->queue.pop_front();
+	}
+	return retVal;
+}
+
+bool TWebSockets::writeSocketData(PWebSocket socket) {
+	// Called by polling thread on EPOLLOUT
+	app::TLockGuard<app::TMutex> lock(socket->mtx);
+	if (flushSocketData(socket) < 0)
+		return false;
+	if (socket->queue.empty() && socket->writing) {
+		if (EXIT_SUCCESS != watchSocketOutput(socket, false))
+			return false;
 	}
-	return retVal;;
+	return true;
 }
 
 
@@ -1113,6 +1394,7 @@ ssize_t TWebSockets::send(const app::THandle handle, void const * const data, si
 	//	MSG_NOSIGNAL	If you send() to a remote host which is no longer recv()ing, you'll
 	//					typically get the signal SIGPIPE. Adding this flag prevents that signal
 	//					from being raised.
+	// Returns number of bytes written, remaining data must be sent when socket is writable again
     while (p < q) {
     	do {
     		errno = EXIT_SUCCESS;
@@ -1121,10 +1403,12 @@ ssize_t TWebSockets::send(const app::THandle handle, void const * const data, si
 
     	// Write failed
     	if (r == (ssize_t)EXIT_ERROR) {
+    		// Socket buffer is full
+    		if (errno == EWOULDBLOCK)
+    			break;
     		if (errno == EBADF || errno == EPIPE) {
     			// Socket not exisiting or closed...
 				writeLogFmt("TWebSockets::send() Client socket <%> dead.", handle);
-    			invalidateSocket(handle);
     		}
         	return (ssize_t)EXIT_ERROR;
     	}
@@ -1139,16 +1423,9 @@ ssize_t TWebSockets::send(const app::THandle handle, void const * const data, si
     	p += (size_t)r;
     }
 
-    // Unexpected pointer after data transfer
-    if (p != q) {
-		if (EXIT_SUCCESS == errno)
-			errno = EFAULT;
-    	return (ssize_t)EXIT_ERROR;
-    }
-
-    // Buffer has been fully written
+    // Buffer has been fully or partially written
     // Possible overflow on result value (ssize_t)size !!!
-    return (ssize_t)size;
+    return (ssize_t)(p - (char const *)data);
 }
 
 
@@ -19,6 +19,10 @@ namespace app {
 
 STATIC_CONST size_t WEBSOCKET_BUFFER_SIZE = inet::INET_DEFAULT_MTU_SIZE + 8;
 STATIC_CONST size_t WEBSOCKET_MAX_SEND_SIZE = inet::INET_DEFAULT_MTU_SIZE - 32; // Take JSON header and mask bits in account
+STATIC_CONST size_t WEBSOCKET_MAX_QUEUE_SIZE = 256 * 1024;
+STATIC_CONST size_t WEBSOCKET_MAX_QUEUE_DEPTH = 64;
+STATIC_CONST size_t WEBSOCKET_DEFLATE_THRESHOLD = 256; // Smaller messages are sent uncompressed
+STATIC_CONST size_t WEBSOCKET_MAX_INFLATE_SIZE = 1024 * 1024;
 
 class TWebSockets : public TObject {
 private:
@@ -27,10 +31,17 @@ private:
 	bool shutdown;
 	bool invalidated;
 	bool secure;
+	bool deflate;
 	int timeout;
+	int stalled;
 	size_t mtu;
 	size_t removed;
+	size_t queueSize;
+	size_t queueDepth;
+	size_t coalesced;
+	size_t dropped;
 	util::TTimePart timestamp;
+	util::TTimePart checked;
 
 	TWebSocketDataHandler onWebSocketData;
 	TWebSocketVariantHandler onWebSocketVariant;
@@ -46,7 +57,6 @@ private:
 	app::TWebSocketList reader;
 
 	mutable app::TMutex listMtx;
-	mutable app::TMutex sendMtx;
 	inet::TPollEvent events;
 	app::THandle epollfd;
 	epoll_event* revents;
@@ -73,18 +83,28 @@ private:
 	void debugOutputEpoll(size_t size);
 	void roundRobinReader();
 
-	bool unmaskSocketData(const void* data, size_t size, util::TBuffer& output, bool& ping, bool& closed) const;
-	void maskSocketData(const void* data, size_t size, util::TBuffer& output, const bool masked) const;
+	bool unmaskSocketData(const void* data, size_t size, util::TBuffer& output, bool& ping, bool& closed, bool& compressed) const;
+	void encodeSocketFrame(const void* data, size_t size, util::TBuffer& output, const uint8_t opcode, const bool fin, const bool compressed) const;
+	void encodeSocketMessage(const void* data, size_t size, util::TBuffer& output, const bool compressed) const;
+	bool deflateSocketData(const void* data, size_t size, util::TBuffer& output) const;
+	bool inflateSocketData(const void* data, size_t size, util::TBuffer& output) const;
 
 	void parseSocketData(const void *const data, const size_t size, std::string& output, util::TVariantValues& variants) const;
-	void decodeSocketData(const app::THandle handle, const void *const data, const size_t size, std::string& output, util::TVariantValues& variants, bool& closed);
+	void decodeSocketData(PWebSocket socket, const void *const data, const size_t size, std::string& output, util::TVariantValues& variants, bool& closed);
 	void processSocketData(const app::THandle handle, const std::string& output, const util::TVariantValues& variants);
 	void onSockectConnected(const app::THandle handle);
 
 	ssize_t readSocketData(PWebSocket socket, bool& closed);
 	ssize_t receive(PWebSocket socket, void * const data, size_t const size, int const flags = 0) const;
-	ssize_t send(const app::THandle handle, void const * const data, size_t const size, int const flags = 0);
-	ssize_t sendPingResponse(const app::THandle handle, util::TBuffer& message);
+	ssize_t send(const app::THandle handle, void const * const data, size_t const size, int const flags = MSG_DONTWAIT | MSG_NOSIGNAL);
+	ssize_t sendPingResponse(PWebSocket socket, util::TBuffer& message);
+
+	ssize_t enqueueSocketData(PWebSocket socket, const util::TBuffer& message, const EWebSocketMessage kind);
+	bool isSocketStalled(PWebSocket socket, const util::TTimePart now) const;
+	size_t dropStalledSockets();
+	ssize_t flushSocketData(PWebSocket socket);
+	bool writeSocketData(PWebSocket socket);
+	int watchSocketOutput(PWebSocket socket, const bool enabled);
 
 	void invalidateSocket(PWebSocket socket);
 	void invalidateSocket(const app::THandle handle);
@@ -96,7 +116,7 @@ private:
 	void addSocketHandle(PWebSocket socket);
 	void removeSocketHandle(PWebSocket socket);
 
-	size_t getSocketHandles(TWebHandleList& handles) const;
+	PWebSocket findSocketWithNolock(const app::THandle handle) const;
 
 public:
 	void start();
@@ -115,6 +135,10 @@ public:
 	bool isSecure() const { return secure; };
 	void setSecure(bool secure) { this->secure = secure; };
 
+	bool getDeflate() const { return deflate; };
+	static bool hasDeflateExtension(const std::string& extensions);
+	void getStatistics(TWebSocketStatistics& statistics) const;
+
 	void debugOutput() { events.debugOutput(); };
 	void writeLog(const std::string& s) const;
 	void errorLog(const std::string& s) const;
@@ -123,7 +147,7 @@ public:
 	int removeEpollHandle(epoll_event* event, const app::THandle socket);
 	void close(PWebSocket socket);
 
-	void upgrade(MHD_socket socket, struct MHD_UpgradeResponseHandle* urh, const char* data, size_t size);
+	void upgrade(MHD_socket socket, struct MHD_UpgradeResponseHandle* urh, const char* data, size_t size, const bool deflate = false);
 	ssize_t write(const app::THandle handle, void const * const data, size_t const size);
 	ssize_t broadcast(void const * const data, size_t const size);
 
@@ -10,6 +10,7 @@
 
 
 #include <sys/epoll.h>
+#include <list>
 #include "microhttpd/microhttpd.h"
 #include "sockettypes.h"
 #include "semaphore.h"
@@ -26,6 +27,19 @@ namespace app {
 
 struct CWebSocket;
 
+enum EWebSocketMessage {
+	EWM_CONTROL, // Control frame, e.g. pong, never discarded
+	EWM_DATA,    // Data sent to one client, must not be lost
+	EWM_UPDATE   // Broadcast notification, superseded by a newer identical one
+};
+
+typedef struct CWebSocketMessage {
+	util::TBuffer data;
+	EWebSocketMessage kind;
+
+	CWebSocketMessage(const EWebSocketMessage kind = EWM_DATA) : kind(kind) {}
+} TWebSocketMessage;
+
 
 using PWebSocket = CWebSocket*;
 using TWebSocketList = std::vector<app::PWebSocket>;
@@ -36,6 +50,34 @@ using TWebSocketDataHandlerList = std::vector<app::TWebSocketDataHandler>;
 using TWebSocketVariantHandler = std::function<void(app::THandle, const util::TVariantValues)>;
 using TWebSocketVariantHandlerList = std::vector<app::TWebSocketVariantHandler>;
 using TWebHandleList = std::vector<app::THandle>;
+using TWebSocketQueue = std::list<app::TWebSocketMessage>;
+
+
+typedef struct CWebSocketStatistics {
+	size_t sockets;    // Connected clients
+	size_t pending;    // Clients waiting for socket to become writable
+	size_t messages;   // Messages queued for all clients
+	size_t bytes;      // Bytes queued for all clients
+	size_t depth;      // Messages queued for slowest client
+	size_t coalesced;  // Queued messages replaced by newer ones
+	size_t dropped;    // Clients disconnected as slow consumer
+	size_t deflated;   // Clients using permessage-deflate
+
+	void clear() {
+		sockets = 0;
+		pending = 0;
+		messages = 0;
+		bytes = 0;
+		depth = 0;
+		coalesced = 0;
+		dropped = 0;
+		deflated = 0;
+	}
+
+	CWebSocketStatistics() {
+		clear();
+	}
+} TWebSocketStatistics;
 
 
 struct CWebSocket {
@@ -48,6 +90,15 @@ struct CWebSocket {
 	bool valid;
 	int error;
 
+	// Outbound messages, guarded by mtx
+	// --> Every queued message holds one or more complete frames
+	TWebSocketQueue queue;
+	size_t offset;    // Bytes of first queued message already sent
+	size_t queued;    // Bytes left to send
+	util::TTimePart progress;
+	bool writing;     // EPOLLOUT armed for socket
+	bool deflate;     // permessage-deflate negotiated
+
 	void prime() {
 		handle = INVALID_HANDLE_VALUE;
 		state = 0;
@@ -56,6 +107,11 @@ struct CWebSocket {
 		valid = false;
 		error = EXIT_SUCCESS;
 		timestamp = util::now();
+		progress = timestamp;
+		offset = 0;
+		queued = 0;
+		writing = false;
+		deflate = false;
 	}
 
 	CWebSocket() {
@@ -81,7 +81,17 @@ TWebAuthMap fillWebAuthTypes() {
 }
 
 
+TWebThreadingMap fillWebThreadingModes() {
+	TWebThreadingMap map;
+	map[WTH_SINGLE]     = "SINGLE";
+	map[WTH_POOL]       = "POOL";
+	map[WTH_CONNECTION] = "CONNECTION";
+	return map;
+}
+
+
 TWebAuthMap webAuthList = fillWebAuthTypes();
+TWebThreadingMap webThreadingList = fillWebThreadingModes();
 TWebStatusMap webStatusList = fillStatusMessages();
 
 
@@ -109,6 +119,30 @@ std::string app::getWebAuthType(const EHttpAuthType type) {
 }
 
 
+EWebThreadingMode app::getWebThreadingMode(const std::string& mode) {
+	if (!webThreadingList.empty()) {
+		TWebThreadingMap::const_iterator it = webThreadingList.begin();
+		do {
+			if (0 == util::strcasecmp(mode, it->second))
+				return it->first;
+			it++;
+		} while (it != webThreadingList.end());
+	}
+	// No mode found
+	return WTH_DEFAULT;
+}
+
+std::string app::getWebThreadingMode(const EWebThreadingMode mode) {
+	if (!webThreadingList.empty()) {
+		TWebThreadingMap::const_iterator it = webThreadingList.find(mode);
+		if (it != webThreadingList.end())
+			return it->second;
+	}
+	// No mode found
+	return std::to_string((size_s)mode);
+}
+
+
 std::string app::getWebStatusMessage(const EWebStatusCode status) {
 	if (!webStatusList.empty()) {
 		TWebStatusMap::const_iterator it = webStatusList.find(status);
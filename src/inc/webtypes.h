@@ -147,6 +147,13 @@ enum EWebTransferMode {
 	WTM_DEFAULT = WTM_SYNC
 };
 
+enum EWebThreadingMode {
+	WTH_SINGLE,     // One internal polling thread for all connections
+	WTH_POOL,       // Fixed pool of polling threads, each with own epoll set
+	WTH_CONNECTION, // One thread per connection
+	WTH_DEFAULT = WTH_CONNECTION
+};
+
 enum EWebActionMode {
 	WAM_SYNC,  // Execute POST action immediately
 	WAM_ASYNC  // Execute POST action asynchronously in thread
@@ -198,6 +205,11 @@ using TWebAuthMap = std::map<EHttpAuthType, std::string>;
 #else
 typedef std::map<EHttpAuthType, std::string> TWebAuthMap;
 #endif
+#ifdef STL_HAS_TEMPLATE_ALIAS
+using TWebThreadingMap = std::map<EWebThreadingMode, std::string>;
+#else
+typedef std::map<EWebThreadingMode, std::string> TWebThreadingMap;
+#endif
 
 
 enum EWebLogVerbosity {
@@ -361,6 +373,9 @@ struct CWebData {
 	PWebToken wtBytesServed;
 	PWebToken wtRequestQueue;
 	PWebToken wtActionQueue;
+	PWebToken wtThreadPool;
+	PWebToken wtCompression;
+	PWebToken wtSocketQueue;
 	PWebToken wtConnections;
 	PWebToken wtCurrentMemory;
 	PWebToken wtStartMemory;
@@ -413,6 +428,9 @@ struct CWebData {
 		wtBytesServed = nil;
 		wtRequestQueue = nil;
 		wtActionQueue = nil;
+		wtThreadPool = nil;
+		wtCompression = nil;
+		wtSocketQueue = nil;
 		wtConnections = nil;
 		wtCurrentMemory = nil;
 		wtStartMemory = nil;
@@ -431,9 +449,12 @@ struct CWebConfig {
 	bool debug;
 	bool enabled;
 	bool useHttps;
+	bool sendFile;
 	bool caching;
 	bool minimize;
 	bool threaded;
+	EWebThreadingMode threading;
+	int threadPoolSize;
 	int defaultUserLevel;
 	unsigned int port;
 	EHttpAuthType auth;
@@ -478,10 +499,13 @@ struct CWebConfig {
 		debug = false;
 		enabled = true;
 		useHttps = false;
+		sendFile = false;
 		//useAuth = false;
 		caching = true;
 		minimize = false;
 		threaded = true;
+		threading = WTH_DEFAULT;
+		threadPoolSize = 0; // 0 --> Derived from CPU count
 		allowFromAll = false;
 		allowManifestFiles = true;
 		defaultUserLevel = 0;
@@ -560,6 +584,7 @@ struct CWebSettings {
 
 struct CWebAction {
 	bool running;
+	bool pooled;
 	std::string key;
 	std::string value;
 	util::TVariantValues params;
@@ -569,6 +594,7 @@ struct CWebAction {
 	void prime() {
 		handler = nil;
 		running = false;
+		pooled = false;
 	}
 	void reset() {
 		params.clear();
@@ -1130,6 +1156,8 @@ struct CWebSocketRequest {
 
 std::string getWebAuthType(const EHttpAuthType type);
 EHttpAuthType getWebAuthType(const std::string& type);
+std::string getWebThreadingMode(const EWebThreadingMode mode);
+EWebThreadingMode getWebThreadingMode(const std::string& mode);
 std::string getWebStatusMessage(const EWebStatusCode status);
 EWebUserAgent guessUserAgent(const char *value);
 std::string userAgentToStr(const EWebUserAgent agent);